@@ -0,0 +1,381 @@
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+
+#include "dkm/util/perf_counters.h"
+
+namespace dkm
+{
+namespace bench
+{
+
+// upper bound on the number of iterations in a single run
+static const size_t MAX_ITERATIONS = 1000000000;
+
+State::State(size_t iterations, const std::vector<long>& args, PerfCounters* counters) :
+    mIterations(iterations),
+    mCount(0),
+    mArgs(args),
+    mPaused(Clock::duration::zero()),
+    mIsPaused(false),
+    mCounters(counters),
+    mBytes(0),
+    mItems(0),
+    mFlops(0),
+    mItemUnit("items")
+{
+}
+
+void State::pauseTiming()
+{
+    if (!mIsPaused) {
+        if (mCounters != nullptr) {
+            mCounters->stop();
+        }
+        mPauseStart = Clock::now();
+        mIsPaused = true;
+    }
+}
+
+void State::resumeTiming()
+{
+    if (mIsPaused) {
+        mPaused += Clock::now() - mPauseStart;
+        mIsPaused = false;
+        if (mCounters != nullptr) {
+            mCounters->start();
+        }
+    }
+}
+
+void State::setCounter(const std::string& name, double value)
+{
+    for (size_t i = 0; i < mNamedValues.size(); ++i) {
+        if (mNamedValues[i].first == name) {
+            mNamedValues[i].second = value;
+            return;
+        }
+    }
+    mNamedValues.push_back(std::make_pair(name, value));
+}
+
+void State::start()
+{
+    mPaused = Clock::duration::zero();
+    mIsPaused = false;
+    if (mCounters != nullptr) {
+        mCounters->reset();
+        mCounters->start();
+    }
+    mStart = Clock::now();
+}
+
+double State::stop()
+{
+    resumeTiming();
+    Clock::duration elapsed = Clock::now() - mStart - mPaused;
+    if (mCounters != nullptr) {
+        mCounters->stop();
+    }
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+Benchmark::Benchmark(const std::string& name, Function function) :
+    mName(name),
+    mFunction(function)
+{
+}
+
+Benchmark* Benchmark::arg(long value)
+{
+    mArgSets.push_back(std::vector<long>(1, value));
+    return this;
+}
+
+Benchmark* Benchmark::args(const std::vector<long>& values)
+{
+    mArgSets.push_back(values);
+    return this;
+}
+
+Benchmark* Benchmark::range(long lo, long hi, long mult)
+{
+    for (long v = lo; v <= hi; v *= mult) {
+        arg(v);
+    }
+    return this;
+}
+
+static std::vector<std::unique_ptr<Benchmark> >& registry()
+{
+    static std::vector<std::unique_ptr<Benchmark> > benchmarks;
+    return benchmarks;
+}
+
+Benchmark* registerBenchmark(const char* name, Function function)
+{
+    registry().push_back(std::unique_ptr<Benchmark>(new Benchmark(name, function)));
+    return registry().back().get();
+}
+
+// Formats a per-second rate with an SI prefix, e.g. "12.3M".
+static std::string formatRate(double perSecond)
+{
+    const char* prefixes[] = { "", "k", "M", "G", "T" };
+    int idx = 0;
+    while (perSecond >= 1000.0 && idx < 4) {
+        perSecond /= 1000.0;
+        ++idx;
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.2f%s", perSecond, prefixes[idx]);
+    return buf;
+}
+
+static std::string runName(const Benchmark& benchmark, const std::vector<long>& args)
+{
+    std::string name = benchmark.name();
+    for (size_t i = 0; i < args.size(); ++i) {
+        name += "/" + std::to_string(args[i]);
+    }
+    return name;
+}
+
+// Appends text to out as a quoted JSON string.
+static void appendJsonString(const std::string& text, std::string& out)
+{
+    out += '"';
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Formats a single result as a JSON object on one line.
+static std::string jsonResult(const std::string& name, const State& state, double seconds)
+{
+    std::string json = "{\"name\":";
+    appendJsonString(name, json);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), ",\"iterations\":%zu,\"ns_per_op\":%.4g",
+             state.iterations(), seconds * 1e9 / state.iterations());
+    json += buf;
+
+    if (state.bytesProcessed() > 0) {
+        snprintf(buf, sizeof(buf), ",\"bytes_per_second\":%.6g", state.bytesProcessed() / seconds);
+        json += buf;
+    }
+    if (state.itemsProcessed() > 0) {
+        snprintf(buf, sizeof(buf), ",\"items_per_second\":%.6g", state.itemsProcessed() / seconds);
+        json += buf;
+        json += ",\"item_unit\":";
+        appendJsonString(state.itemUnit(), json);
+    }
+    if (state.flopsProcessed() > 0) {
+        snprintf(buf, sizeof(buf), ",\"gflops\":%.4g", state.flopsProcessed() / seconds / 1e9);
+        json += buf;
+    }
+    for (size_t i = 0; i < state.counters().size(); ++i) {
+        json += ",";
+        appendJsonString(state.counters()[i].first, json);
+        snprintf(buf, sizeof(buf), ":%.6g", state.counters()[i].second);
+        json += buf;
+    }
+    if (!state.label().empty()) {
+        json += ",\"label\":";
+        appendJsonString(state.label(), json);
+    }
+
+    json += "}";
+    return json;
+}
+
+// Adds the per-iteration hardware counts from counters to state.
+static void addPerfCounts(State& state, const PerfCounters& counters)
+{
+    double iterations = static_cast<double>(state.iterations());
+    double cycles = static_cast<double>(counters.value(PerfEvent::CYCLES));
+    double instructions = static_cast<double>(counters.value(PerfEvent::INSTRUCTIONS));
+
+    if (counters.isAvailable(PerfEvent::CYCLES)) {
+        state.setCounter("cycles", cycles / iterations);
+    }
+    if (counters.isAvailable(PerfEvent::INSTRUCTIONS)) {
+        state.setCounter("instructions", instructions / iterations);
+    }
+    if (cycles > 0 && counters.isAvailable(PerfEvent::INSTRUCTIONS)) {
+        state.setCounter("ipc", instructions / cycles);
+    }
+    if (counters.isAvailable(PerfEvent::CACHE_MISSES)) {
+        state.setCounter("cache_misses",
+                         counters.value(PerfEvent::CACHE_MISSES) / iterations);
+    }
+    if (counters.isAvailable(PerfEvent::BRANCH_MISSES)) {
+        state.setCounter("branch_misses",
+                         counters.value(PerfEvent::BRANCH_MISSES) / iterations);
+    }
+}
+
+// Runs one benchmark with one set of arguments, prints the result and
+// adds it to results as JSON.
+static void runOne(const Benchmark& benchmark, const std::vector<long>& args, double minTime,
+                   PerfCounters* counters, std::vector<std::string>& results)
+{
+    size_t iterations = 1;
+    while (true) {
+        State state(iterations, args, counters);
+        state.start();
+        benchmark.function()(state);
+        double seconds = state.stop();
+
+        if (seconds >= minTime || iterations >= MAX_ITERATIONS) {
+            if (counters != nullptr) {
+                addPerfCounts(state, *counters);
+            }
+
+            std::string name = runName(benchmark, args);
+            std::string line;
+            char buf[128];
+
+            snprintf(buf, sizeof(buf), "%-48s %12zu %14.2f ns/op",
+                     name.c_str(), iterations, seconds * 1e9 / iterations);
+            line += buf;
+
+            if (state.bytesProcessed() > 0) {
+                snprintf(buf, sizeof(buf), " %10.2f MB/s",
+                         state.bytesProcessed() / seconds / (1024.0 * 1024.0));
+                line += buf;
+            }
+            if (state.itemsProcessed() > 0) {
+                line += " " + formatRate(state.itemsProcessed() / seconds)
+                        + " " + state.itemUnit() + "/s";
+            }
+            if (state.flopsProcessed() > 0) {
+                snprintf(buf, sizeof(buf), " %8.3f GFLOP/s",
+                         state.flopsProcessed() / seconds / 1e9);
+                line += buf;
+            }
+            for (size_t i = 0; i < state.counters().size(); ++i) {
+                snprintf(buf, sizeof(buf), " %s=%.4g",
+                         state.counters()[i].first.c_str(), state.counters()[i].second);
+                line += buf;
+            }
+            if (!state.label().empty()) {
+                line += " " + state.label();
+            }
+
+            printf("%s\n", line.c_str());
+            fflush(stdout);
+
+            results.push_back(jsonResult(name, state, seconds));
+            return;
+        }
+
+        // scale up towards the target time, growing by at least
+        // 2x and at most 10x per attempt
+        double scale = (seconds > 0) ? (minTime * 1.4 / seconds) : 10.0;
+        scale = std::max(2.0, std::min(10.0, scale));
+        iterations = std::min(MAX_ITERATIONS, static_cast<size_t>(iterations * scale));
+    }
+}
+
+int runBenchmarks(int argc, char** argv)
+{
+    std::string filter;
+    std::string jsonPath;
+    bool perf = false;
+    double minTime = 0.5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        }
+        else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+            minTime = atof(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--json=", 7) == 0) {
+            jsonPath = argv[i] + 7;
+        }
+        else if (strcmp(argv[i], "--perf") == 0) {
+            perf = true;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--filter=TEXT] [--min-time=SECS] [--json=PATH] [--perf]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    std::unique_ptr<PerfCounters> counters;
+    if (perf) {
+        counters.reset(new PerfCounters());
+        if (!counters->isAvailable()) {
+            fprintf(stderr, "hardware counters unavailable (check perf_event_paranoid); "
+                    "reporting timing only\n");
+            counters.reset();
+        }
+    }
+
+    // open the output up front so a bad path fails before the runs
+    FILE* json = nullptr;
+    if (!jsonPath.empty()) {
+        json = fopen(jsonPath.c_str(), "w");
+        if (json == nullptr) {
+            fprintf(stderr, "unable to open %s: %s\n", jsonPath.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+
+    std::vector<std::string> results;
+
+    printf("%-48s %12s %17s\n", "Benchmark", "Iterations", "Time");
+
+    const std::vector<std::unique_ptr<Benchmark> >& benchmarks = registry();
+    for (size_t i = 0; i < benchmarks.size(); ++i) {
+        const Benchmark& benchmark = *benchmarks[i];
+        if (!filter.empty() && benchmark.name().find(filter) == std::string::npos) {
+            continue;
+        }
+
+        if (benchmark.argSets().empty()) {
+            runOne(benchmark, std::vector<long>(), minTime, counters.get(), results);
+        }
+        for (size_t j = 0; j < benchmark.argSets().size(); ++j) {
+            runOne(benchmark, benchmark.argSets()[j], minTime, counters.get(), results);
+        }
+    }
+
+    if (json != nullptr) {
+        fprintf(json, "{\"benchmarks\":[\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            fprintf(json, "%s%s\n", results[i].c_str(), (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(json, "]}\n");
+        fclose(json);
+    }
+
+    return 0;
+}
+
+}
+}
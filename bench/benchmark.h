@@ -0,0 +1,231 @@
+/**
+ * benchmark.h
+ *
+ * Minimal self-contained benchmark harness. Benchmarks are plain
+ * functions taking a State reference and are registered with the
+ * DKM_BENCHMARK macro:
+ *
+ *     static void fooBench(dkm::bench::State& state) {
+ *         while (state.keepRunning()) {
+ *             foo(state.arg(0));
+ *         }
+ *         state.setItemsProcessed(state.iterations());
+ *     }
+ *     DKM_BENCHMARK(fooBench)->arg(16)->arg(256);
+ *
+ * The runner calls each function with increasing iteration counts
+ * until a run takes at least the minimum benchmark time and reports
+ * the result of that final run.
+ */
+
+#ifndef _DKM_BENCHMARK_H_
+#define _DKM_BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dkm
+{
+
+class PerfCounters;
+
+namespace bench
+{
+
+class State
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * If counters is given, hardware events are counted over the same
+     * time as the timer.
+     */
+    State(size_t iterations, const std::vector<long>& args, PerfCounters* counters = nullptr);
+
+    /**
+     * Returns true until the loop has run iterations() times.
+     */
+    bool keepRunning() {
+        if (mCount < mIterations) {
+            ++mCount;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Number of iterations the benchmark is expected to run.
+     */
+    size_t iterations() const { return mIterations; }
+
+    /**
+     * Returns the idx-th argument registered for this run.
+     */
+    long arg(size_t idx) const { return mArgs.at(idx); }
+
+    /**
+     * Excludes the code between pauseTiming() and resumeTiming()
+     * from the measured time. Use for setup and teardown work.
+     */
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * Total number of bytes processed during the run; reported as
+     * a rate.
+     */
+    void setBytesProcessed(double bytes) { mBytes = bytes; }
+
+    /**
+     * Total number of items processed during the run; reported as
+     * a rate using the given unit name.
+     */
+    void setItemsProcessed(double items, const char* unit = "items") {
+        mItems = items;
+        mItemUnit = unit;
+    }
+
+    /**
+     * Total number of floating point operations performed during the
+     * run; reported as GFLOP/s.
+     */
+    void setFlopsProcessed(double flops) { mFlops = flops; }
+
+    /**
+     * Free-form text appended to the result line.
+     */
+    void setLabel(const std::string& label) { mLabel = label; }
+
+    /**
+     * Records a named value, such as a latency percentile, shown as
+     * name=value after the rates and written as its own JSON field.
+     * Setting the same name again replaces the value.
+     */
+    void setCounter(const std::string& name, double value);
+
+    // used by the runner
+    void start();
+    double stop();
+
+    double bytesProcessed() const { return mBytes; }
+    double itemsProcessed() const { return mItems; }
+    double flopsProcessed() const { return mFlops; }
+    const std::string& itemUnit() const { return mItemUnit; }
+    const std::string& label() const { return mLabel; }
+    const std::vector<std::pair<std::string, double> >& counters() const { return mNamedValues; }
+
+private:
+    size_t mIterations;
+    size_t mCount;
+    std::vector<long> mArgs;
+
+    Clock::time_point mStart;
+    Clock::duration mPaused;
+    Clock::time_point mPauseStart;
+    bool mIsPaused;
+
+    PerfCounters* mCounters;
+
+    double mBytes;
+    double mItems;
+    double mFlops;
+    std::string mItemUnit;
+    std::string mLabel;
+    std::vector<std::pair<std::string, double> > mNamedValues;
+};
+
+typedef void (*Function)(State&);
+
+/**
+ * A registered benchmark function along with the argument sets
+ * it should be run with.
+ */
+class Benchmark
+{
+public:
+    Benchmark(const std::string& name, Function function);
+
+    /**
+     * Adds a run with a single argument.
+     */
+    Benchmark* arg(long value);
+
+    /**
+     * Adds a run with multiple arguments.
+     */
+    Benchmark* args(const std::vector<long>& values);
+
+    /**
+     * Adds runs for lo, lo*mult, lo*mult^2, ... up to and including hi.
+     */
+    Benchmark* range(long lo, long hi, long mult = 2);
+
+    const std::string& name() const { return mName; }
+    Function function() const { return mFunction; }
+    const std::vector<std::vector<long> >& argSets() const { return mArgSets; }
+
+private:
+    std::string mName;
+    Function mFunction;
+    std::vector<std::vector<long> > mArgSets;
+};
+
+/**
+ * Adds a benchmark to the global registry. The returned pointer
+ * remains valid for the life of the program.
+ */
+Benchmark* registerBenchmark(const char* name, Function function);
+
+/**
+ * Runs all registered benchmarks matching the command line options
+ * and prints the results to stdout. Returns the process exit code.
+ *
+ * Options:
+ *   --filter=TEXT     only run benchmarks whose name contains TEXT
+ *   --min-time=SECS   minimum measured time per benchmark (default 0.5)
+ *   --json=PATH       also write the results to PATH as JSON, one
+ *                     benchmark per line so runs diff cleanly
+ *   --perf            also report hardware counters per iteration:
+ *                     cycles, instructions, IPC, cache and branch
+ *                     misses. Only the thread running the benchmark
+ *                     function is counted. Falls back to timing alone
+ *                     if the counters can't be opened.
+ */
+int runBenchmarks(int argc, char** argv);
+
+/**
+ * Prevents the compiler from optimizing away the computation of value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * As above, but also makes the compiler assume value was modified, so
+ * work that depends on it can't be hoisted out of the loop.
+ */
+template<typename T>
+inline void doNotOptimize(T& value)
+{
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+}
+}
+
+#define _DKM_BENCH_CAT2(a, b) a##b
+#define _DKM_BENCH_CAT(a, b) _DKM_BENCH_CAT2(a, b)
+
+#define DKM_BENCHMARK(fn) \
+    static ::dkm::bench::Benchmark* _DKM_BENCH_CAT(_dkm_bench_, __LINE__) = \
+        ::dkm::bench::registerBenchmark(#fn, fn)
+
+#endif
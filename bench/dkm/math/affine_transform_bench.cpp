@@ -0,0 +1,171 @@
+/**
+ * affine_transform_bench.cpp
+ *
+ * Benchmarks for AffineTransform against the same operations on Mat4d.
+ * Each benchmark takes the number of transforms or points as arg 0 and
+ * reports items processed.
+ */
+
+#include "benchmark.h"
+
+#include "dkm/math/affine_transform.h"
+#include "dkm/math/math_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+// Returns count transforms filled with bench values and a weighted
+// diagonal so that they can all be inverted.
+static std::vector<AffineTransformd> benchTransforms(size_t count, unsigned int seed)
+{
+    std::vector<double> values = benchValues<double>(count * 12, seed);
+    std::vector<AffineTransformd> result(count);
+    for (size_t k = 0; k < count; ++k) {
+        result[k] = AffineTransformd(values.data() + (k * 12));
+        for (int i = 0; i < 3; ++i) {
+            result[k](i, i) += 4;
+        }
+    }
+    return result;
+}
+
+// Returns count rigid transforms with random rotations and translations.
+static std::vector<AffineTransformd> benchRigidTransforms(size_t count, unsigned int seed)
+{
+    std::vector<double> values = benchValues<double>(count * 7, seed);
+    std::vector<AffineTransformd> result(count);
+    for (size_t k = 0; k < count; ++k) {
+        const double* v = values.data() + (k * 7);
+        Quatd rotation(v[0], v[1], v[2], v[3] + 2);
+        rotation.normalize();
+        result[k] = AffineTransformd(rotation, Vec3d(v + 4));
+    }
+    return result;
+}
+
+static std::vector<Mat4d> toMatrices(const std::vector<AffineTransformd>& transforms)
+{
+    std::vector<Mat4d> result(transforms.size());
+    for (size_t k = 0; k < transforms.size(); ++k) {
+        result[k] = transforms[k].toMatrix4x4();
+    }
+    return result;
+}
+
+static void affineCompose(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<AffineTransformd> a = benchTransforms(count, 1);
+    std::vector<AffineTransformd> b = benchTransforms(count, 2);
+    std::vector<AffineTransformd> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(a[0]);
+        for (size_t k = 0; k < count; ++k) {
+            AffineTransformUtil::compose(a[k].data(), b[k].data(), out[k].data());
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 36 * count * state.iterations());
+}
+DKM_BENCHMARK(affineCompose)->arg(1024);
+
+static void matrixCompose(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<Mat4d> a = toMatrices(benchTransforms(count, 1));
+    std::vector<Mat4d> b = toMatrices(benchTransforms(count, 2));
+    std::vector<Mat4d> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(a[0]);
+        for (size_t k = 0; k < count; ++k) {
+            MatrixUtil::matrixMultiply(a[k].data(), 4, 4, b[k].data(), 4, out[k].data());
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 64 * count * state.iterations());
+}
+DKM_BENCHMARK(matrixCompose)->arg(1024);
+
+static void affineInverse(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<AffineTransformd> a = benchTransforms(count, 3);
+    std::vector<AffineTransformd> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(a[0]);
+        for (size_t k = 0; k < count; ++k) {
+            AffineTransformUtil::inverse(a[k].data(), out[k].data());
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+}
+DKM_BENCHMARK(affineInverse)->arg(1024);
+
+static void affineRigidInverse(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<AffineTransformd> a = benchRigidTransforms(count, 4);
+    std::vector<AffineTransformd> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(a[0]);
+        for (size_t k = 0; k < count; ++k) {
+            AffineTransformUtil::rigidInverse(a[k].data(), out[k].data());
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+}
+DKM_BENCHMARK(affineRigidInverse)->arg(1024);
+
+static void affineTransformPoints(State& state)
+{
+    size_t count = state.arg(0);
+    AffineTransformd t = benchTransforms(1, 5)[0];
+    std::vector<double> points = benchValues<double>(count * 3, 6);
+    std::vector<double> out(count * 3);
+
+    while (state.keepRunning()) {
+        doNotOptimize(points[0]);
+        AffineTransformUtil::transformPoints(t.data(), points.data(), out.data(), count);
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 9 * count * state.iterations());
+}
+DKM_BENCHMARK(affineTransformPoints)->arg(1024);
+
+static void matrixTransformPoints(State& state)
+{
+    size_t count = state.arg(0);
+    Mat4d m = benchTransforms(1, 5)[0].toMatrix4x4();
+    std::vector<double> values = benchValues<double>(count * 3, 6);
+    std::vector<double> points(count * 4, 1.0);
+    for (size_t k = 0; k < count; ++k) {
+        MatrixUtil::copy(values.data() + (k * 3), points.data() + (k * 4), 3);
+    }
+    std::vector<double> out(count * 4);
+
+    while (state.keepRunning()) {
+        doNotOptimize(points[0]);
+        for (size_t k = 0; k < count; ++k) {
+            MatrixUtil::matrixMultiply(m.data(), 4, 4, points.data() + (k * 4), 1, out.data() + (k * 4));
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 16 * count * state.iterations());
+}
+DKM_BENCHMARK(matrixTransformPoints)->arg(1024);
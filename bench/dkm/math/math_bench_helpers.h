@@ -0,0 +1,25 @@
+#ifndef _DKM_MATH_BENCH_HELPERS_H_
+#define _DKM_MATH_BENCH_HELPERS_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+// Returns size values in [-1, 1) from a fixed sequence, so runs are
+// repeatable and no element is zero or denormal.
+template<typename T>
+std::vector<T> benchValues(size_t size, unsigned int seed = 1)
+{
+    std::vector<T> values(size);
+    unsigned int state = seed * 2654435761U + 1;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1664525U + 1013904223U;
+        values[i] = static_cast<T>((state >> 8) / 8388608.0 - 1.0);
+        if (values[i] == static_cast<T>(0)) {
+            values[i] = static_cast<T>(0.5);
+        }
+    }
+    return values;
+}
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * matrix_batch_bench.cpp
+ *
+ * Benchmarks for MatrixBatch operations on 4x4 float matrices. Each
+ * benchmark takes the number of matrices as arg 0 and reports matrices
+ * processed. A batch with one lane is the per-matrix baseline for the
+ * same kernel; the Matrix loop benchmarks show the cost of calling the
+ * Matrix class once per matrix.
+ */
+
+#include "benchmark.h"
+
+#include "dkm/math/matrix_batch.h"
+#include "dkm/math/math_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+// Returns count 4x4 matrices filled with bench values and a weighted
+// diagonal so that they can all be inverted.
+static std::vector<Mat4f> benchMatrices(size_t count, unsigned int seed)
+{
+    std::vector<float> values = benchValues<float>(count * 16, seed);
+    std::vector<Mat4f> result(count);
+    for (size_t k = 0; k < count; ++k) {
+        result[k].copyFrom(values.data() + (k * 16));
+        for (int i = 0; i < 4; ++i) {
+            result[k](i, i) += 4;
+        }
+    }
+    return result;
+}
+
+template<unsigned int LanesArg>
+static void batchMultiply4f(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<Mat4f> a = benchMatrices(count, 1);
+    std::vector<Mat4f> b = benchMatrices(count, 2);
+    MatrixBatch<4, 4, float, LanesArg> batchA(a.data(), count);
+    MatrixBatch<4, 4, float, LanesArg> batchB(b.data(), count);
+    MatrixBatch<4, 4, float, LanesArg> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(batchA.data()[0]);
+        MatrixBatchUtil::multiply<4, 4, 4, LanesArg>(batchA.data(), batchB.data(), out.data(), out.groups());
+        doNotOptimize(out.data()[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 64 * count * state.iterations());
+}
+DKM_BENCHMARK(batchMultiply4f<1>)->arg(1024);
+DKM_BENCHMARK(batchMultiply4f<8>)->arg(1024);
+DKM_BENCHMARK(batchMultiply4f<16>)->arg(1024);
+
+static void matrixLoopMultiply4f(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<Mat4f> a = benchMatrices(count, 1);
+    std::vector<Mat4f> b = benchMatrices(count, 2);
+    std::vector<Mat4f> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(a[0]);
+        for (size_t k = 0; k < count; ++k) {
+            out[k] = a[k] * b[k];
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 64 * count * state.iterations());
+}
+DKM_BENCHMARK(matrixLoopMultiply4f)->arg(1024);
+
+template<unsigned int LanesArg>
+static void batchTransform4f(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<Mat4f> m = benchMatrices(count, 3);
+    std::vector<float> values = benchValues<float>(count * 4, 4);
+    MatrixBatch<4, 4, float, LanesArg> batch(m.data(), count);
+    MatrixBatch<4, 1, float, LanesArg> vecs(count);
+    for (size_t k = 0; k < count; ++k) {
+        vecs.set(k, Vec4f(values.data() + (k * 4)));
+    }
+    MatrixBatch<4, 1, float, LanesArg> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(vecs.data()[0]);
+        MatrixBatchUtil::transformVectors<4, 4, LanesArg>(batch.data(), vecs.data(), out.data(), out.groups());
+        doNotOptimize(out.data()[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+    state.setFlopsProcessed(2.0 * 16 * count * state.iterations());
+}
+DKM_BENCHMARK(batchTransform4f<1>)->arg(1024);
+DKM_BENCHMARK(batchTransform4f<8>)->arg(1024);
+DKM_BENCHMARK(batchTransform4f<16>)->arg(1024);
+
+template<unsigned int LanesArg>
+static void batchInverse4f(State& state)
+{
+    size_t count = state.arg(0);
+    std::vector<Mat4f> m = benchMatrices(count, 5);
+    MatrixBatch<4, 4, float, LanesArg> batch(m.data(), count);
+    MatrixBatch<4, 4, float, LanesArg> out(count);
+
+    while (state.keepRunning()) {
+        doNotOptimize(batch.data()[0]);
+        MatrixBatchUtil::inverse4x4<LanesArg>(batch.data(), out.data(), out.groups());
+        doNotOptimize(out.data()[0]);
+    }
+
+    state.setItemsProcessed(count * state.iterations());
+}
+DKM_BENCHMARK(batchInverse4f<1>)->arg(1024);
+DKM_BENCHMARK(batchInverse4f<8>)->arg(1024);
+DKM_BENCHMARK(batchInverse4f<16>)->arg(1024);
@@ -0,0 +1,177 @@
+/**
+ * matrix_bench.cpp
+ *
+ * Benchmarks for the fixed-size Matrix and Vector classes in float and
+ * double, covering the sizes used for graphics and pose work.
+ */
+
+#include "benchmark.h"
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/math_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+template<unsigned int Dim, typename T>
+static void matrixMultiply(State& state)
+{
+    std::vector<T> values = benchValues<T>(2 * Dim * Dim);
+    Matrix<Dim, Dim, T> a(values.data());
+    Matrix<Dim, Dim, T> b(values.data() + Dim * Dim);
+
+    while (state.keepRunning()) {
+        // keep the inputs opaque so the product isn't hoisted out of
+        // the loop
+        doNotOptimize(a);
+        Matrix<Dim, Dim, T> c = a.multiply(b);
+        doNotOptimize(c.data()[0]);
+    }
+
+    state.setFlopsProcessed(2.0 * Dim * Dim * Dim * state.iterations());
+}
+static void matrixMultiply2f(State& state) { matrixMultiply<2, float>(state); }
+static void matrixMultiply3f(State& state) { matrixMultiply<3, float>(state); }
+static void matrixMultiply4f(State& state) { matrixMultiply<4, float>(state); }
+static void matrixMultiply2d(State& state) { matrixMultiply<2, double>(state); }
+static void matrixMultiply3d(State& state) { matrixMultiply<3, double>(state); }
+static void matrixMultiply4d(State& state) { matrixMultiply<4, double>(state); }
+DKM_BENCHMARK(matrixMultiply2f);
+DKM_BENCHMARK(matrixMultiply3f);
+DKM_BENCHMARK(matrixMultiply4f);
+DKM_BENCHMARK(matrixMultiply2d);
+DKM_BENCHMARK(matrixMultiply3d);
+DKM_BENCHMARK(matrixMultiply4d);
+
+template<unsigned int Dim, typename T>
+static void multiplyAssign(State& state)
+{
+    std::vector<T> values = benchValues<T>(2 * Dim * Dim);
+    Matrix<Dim, Dim, T> a(values.data());
+    Matrix<Dim, Dim, T> b(values.data() + Dim * Dim);
+
+    while (state.keepRunning()) {
+        a.multiplyAssign(b);
+        doNotOptimize(a.data()[0]);
+    }
+
+    state.setFlopsProcessed(2.0 * Dim * Dim * Dim * state.iterations());
+}
+static void multiplyAssign4f(State& state) { multiplyAssign<4, float>(state); }
+static void multiplyAssign4d(State& state) { multiplyAssign<4, double>(state); }
+DKM_BENCHMARK(multiplyAssign4f);
+DKM_BENCHMARK(multiplyAssign4d);
+
+template<unsigned int Dim, typename T>
+static void transformVector(State& state)
+{
+    std::vector<T> values = benchValues<T>(Dim * Dim + Dim);
+    Matrix<Dim, Dim, T> m(values.data());
+    Vector<Dim, T> v(values.data() + Dim * Dim);
+
+    while (state.keepRunning()) {
+        doNotOptimize(v);
+        Vector<Dim, T> out = m.transformVector(v);
+        doNotOptimize(out.data()[0]);
+    }
+
+    state.setFlopsProcessed(2.0 * Dim * Dim * state.iterations());
+    state.setItemsProcessed(state.iterations(), "vectors");
+}
+static void transformVector3f(State& state) { transformVector<3, float>(state); }
+static void transformVector4f(State& state) { transformVector<4, float>(state); }
+static void transformVector3d(State& state) { transformVector<3, double>(state); }
+static void transformVector4d(State& state) { transformVector<4, double>(state); }
+DKM_BENCHMARK(transformVector3f);
+DKM_BENCHMARK(transformVector4f);
+DKM_BENCHMARK(transformVector3d);
+DKM_BENCHMARK(transformVector4d);
+
+template<unsigned int Dim, typename T>
+static void matrixTranspose(State& state)
+{
+    std::vector<T> values = benchValues<T>(Dim * Dim);
+    Matrix<Dim, Dim, T> m(values.data());
+
+    while (state.keepRunning()) {
+        doNotOptimize(m);
+        Matrix<Dim, Dim, T> t = m.transpose();
+        doNotOptimize(t.data()[0]);
+    }
+
+    state.setBytesProcessed(2.0 * Dim * Dim * sizeof(T) * state.iterations());
+}
+static void matrixTranspose4f(State& state) { matrixTranspose<4, float>(state); }
+static void matrixTranspose4d(State& state) { matrixTranspose<4, double>(state); }
+DKM_BENCHMARK(matrixTranspose4f);
+DKM_BENCHMARK(matrixTranspose4d);
+
+template<typename T>
+static void vectorCross(State& state)
+{
+    std::vector<T> values = benchValues<T>(6);
+    Vector<3, T> a(values.data());
+    Vector<3, T> b(values.data() + 3);
+
+    while (state.keepRunning()) {
+        doNotOptimize(a);
+        Vector<3, T> c = a.cross(b);
+        doNotOptimize(c.data()[0]);
+    }
+
+    state.setFlopsProcessed(9.0 * state.iterations());
+}
+DKM_BENCHMARK(vectorCross<float>);
+DKM_BENCHMARK(vectorCross<double>);
+
+// Multiplies the 3x3 rotation block of a 4x4 transform with a 3x3 matrix,
+// either through a block view (arg 0 = 0) or by first copying the block
+// into a Matrix<3, 3> (arg 0 = 1).
+static void rotationBlockMultiply(State& state)
+{
+    std::vector<double> values = benchValues<double>(16 + 9);
+    Matrix<4, 4> transform(values.data());
+    Matrix<3, 3> other(values.data() + 16);
+    bool copy = state.arg(0) != 0;
+
+    while (state.keepRunning()) {
+        doNotOptimize(transform);
+        Matrix<3, 3> c;
+        if (copy) {
+            Matrix<3, 3> rotation = transform.block<3, 3>(0, 0);
+            c = rotation.multiply(other);
+        } else {
+            c = transform.block<3, 3>(0, 0).multiply(other);
+        }
+        doNotOptimize(c.data()[0]);
+    }
+
+    state.setFlopsProcessed(2.0 * 27 * state.iterations());
+}
+DKM_BENCHMARK(rotationBlockMultiply)->arg(0)->arg(1);
+
+// Multiplies a column-major 4x4 matrix with a row-major one, either reading
+// both operands in place (arg 0 = 0) or by first converting the row-major
+// operand to column-major (arg 0 = 1).
+static void mixedLayoutMultiply(State& state)
+{
+    std::vector<float> values = benchValues<float>(32);
+    Matrix<4, 4, float, MatrixLayout::COLUMN_MAJOR> view(values.data());
+    Matrix<4, 4, float> model(values.data() + 16);
+    bool convert = state.arg(0) != 0;
+
+    while (state.keepRunning()) {
+        doNotOptimize(model);
+        Matrix<4, 4, float, MatrixLayout::COLUMN_MAJOR> c;
+        if (convert) {
+            Matrix<4, 4, float, MatrixLayout::COLUMN_MAJOR> converted(model);
+            c = view * converted;
+        } else {
+            c = view * model;
+        }
+        doNotOptimize(c.data()[0]);
+    }
+
+    state.setFlopsProcessed(2.0 * 64 * state.iterations());
+}
+DKM_BENCHMARK(mixedLayoutMultiply)->arg(0)->arg(1);
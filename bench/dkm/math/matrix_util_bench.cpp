@@ -0,0 +1,220 @@
+/**
+ * matrix_util_bench.cpp
+ *
+ * Benchmarks for the MatrixUtil array kernels in float and double.
+ * Element-wise and vector kernels take the element count as their
+ * argument; transpose and matrixMultiply take the dimension of a
+ * square matrix. Bytes processed count every element read and
+ * written once.
+ */
+
+#include "benchmark.h"
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/math_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+template<typename T>
+static void add(State& state)
+{
+    size_t n = state.arg(0);
+    std::vector<T> a = benchValues<T>(n, 1);
+    std::vector<T> b = benchValues<T>(n, 2);
+    std::vector<T> out(n);
+
+    while (state.keepRunning()) {
+        MatrixUtil::add(a.data(), b.data(), out.data(), n);
+        doNotOptimize(out[0]);
+    }
+
+    state.setFlopsProcessed(static_cast<double>(n) * state.iterations());
+    state.setBytesProcessed(3.0 * n * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(add<float>)->arg(2)->arg(16)->arg(256)->arg(4096);
+DKM_BENCHMARK(add<double>)->arg(2)->arg(16)->arg(256)->arg(4096);
+
+template<typename T>
+static void scalarMultiply(State& state)
+{
+    size_t n = state.arg(0);
+    std::vector<T> a = benchValues<T>(n);
+    std::vector<T> out(n);
+
+    while (state.keepRunning()) {
+        MatrixUtil::scalarMultiply(a.data(), static_cast<T>(1.5), out.data(), n);
+        doNotOptimize(out[0]);
+    }
+
+    state.setFlopsProcessed(static_cast<double>(n) * state.iterations());
+    state.setBytesProcessed(2.0 * n * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(scalarMultiply<float>)->arg(2)->arg(16)->arg(256)->arg(4096);
+DKM_BENCHMARK(scalarMultiply<double>)->arg(2)->arg(16)->arg(256)->arg(4096);
+
+template<typename T>
+static void vectorDotProduct(State& state)
+{
+    size_t n = state.arg(0);
+    std::vector<T> a = benchValues<T>(n, 1);
+    std::vector<T> b = benchValues<T>(n, 2);
+
+    while (state.keepRunning()) {
+        double dot = MatrixUtil::vectorDotProduct(a.data(), b.data(), n);
+        doNotOptimize(dot);
+    }
+
+    state.setFlopsProcessed(2.0 * n * state.iterations());
+    state.setBytesProcessed(2.0 * n * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(vectorDotProduct<float>)->arg(2)->arg(16)->arg(256)->arg(4096);
+DKM_BENCHMARK(vectorDotProduct<double>)->arg(2)->arg(16)->arg(256)->arg(4096);
+
+template<typename T>
+static void vectorNormalize(State& state)
+{
+    size_t n = state.arg(0);
+    std::vector<T> a = benchValues<T>(n);
+    std::vector<T> out(n);
+
+    while (state.keepRunning()) {
+        MatrixUtil::vectorNormalize(a.data(), n, out.data());
+        doNotOptimize(out[0]);
+    }
+
+    // magnitude then a divide per element; the sqrt is not counted
+    state.setFlopsProcessed(3.0 * n * state.iterations());
+    state.setBytesProcessed(3.0 * n * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(vectorNormalize<float>)->arg(2)->arg(16)->arg(256)->arg(4096);
+DKM_BENCHMARK(vectorNormalize<double>)->arg(2)->arg(16)->arg(256)->arg(4096);
+
+template<typename T>
+static void transpose(State& state)
+{
+    size_t dim = state.arg(0);
+    std::vector<T> a = benchValues<T>(dim * dim);
+    std::vector<T> out(dim * dim);
+
+    while (state.keepRunning()) {
+        MatrixUtil::transpose(a.data(), dim, dim, out.data());
+        doNotOptimize(out[0]);
+    }
+
+    state.setBytesProcessed(2.0 * dim * dim * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(transpose<float>)->arg(2)->arg(4)->arg(16)->arg(64)->arg(256)->arg(1024)->arg(4096);
+DKM_BENCHMARK(transpose<double>)->arg(2)->arg(4)->arg(16)->arg(64)->arg(256)->arg(1024)->arg(4096);
+
+// The plain row-to-column scatter MatrixUtil::transpose used before it was
+// tiled, kept as a baseline.
+template<typename T>
+static void transposeScatter(State& state)
+{
+    size_t dim = state.arg(0);
+    std::vector<T> a = benchValues<T>(dim * dim);
+    std::vector<T> out(dim * dim);
+
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < dim; ++i) {
+            for (size_t j = 0; j < dim; ++j) {
+                out[j * dim + i] = a[i * dim + j];
+            }
+        }
+        doNotOptimize(out[0]);
+    }
+
+    state.setBytesProcessed(2.0 * dim * dim * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(transposeScatter<float>)->arg(64)->arg(256)->arg(1024)->arg(4096);
+DKM_BENCHMARK(transposeScatter<double>)->arg(64)->arg(256)->arg(1024)->arg(4096);
+
+template<typename T>
+static void transposeInPlace(State& state)
+{
+    size_t dim = state.arg(0);
+    std::vector<T> a = benchValues<T>(dim * dim);
+
+    while (state.keepRunning()) {
+        MatrixUtil::transposeInPlace(a.data(), dim);
+        doNotOptimize(a[0]);
+    }
+
+    state.setBytesProcessed(2.0 * dim * dim * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(transposeInPlace<float>)->arg(64)->arg(256)->arg(1024)->arg(4096);
+DKM_BENCHMARK(transposeInPlace<double>)->arg(64)->arg(256)->arg(1024)->arg(4096);
+
+// Rectangular in-place transpose of an arg 0 x arg 1 matrix.
+template<typename T>
+static void transposeInPlaceRect(State& state)
+{
+    size_t rows = state.arg(0);
+    size_t cols = state.arg(1);
+    std::vector<T> a = benchValues<T>(rows * cols);
+
+    while (state.keepRunning()) {
+        // alternate so the matrix keeps the same shape for the next run
+        MatrixUtil::transposeInPlace(a.data(), rows, cols);
+        std::swap(rows, cols);
+        doNotOptimize(a[0]);
+    }
+
+    state.setBytesProcessed(2.0 * rows * cols * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(transposeInPlaceRect<float>)->args({64, 256})->args({512, 2048})->args({1000, 3000});
+DKM_BENCHMARK(transposeInPlaceRect<double>)->args({64, 256})->args({512, 2048})->args({1000, 3000});
+
+// The naive kernel runs at a few GFLOP/s at best, so a 4096 square
+// multiply takes close to a minute; 1024 is the largest size run.
+template<typename T>
+static void matrixMultiply(State& state)
+{
+    size_t dim = state.arg(0);
+    std::vector<T> a = benchValues<T>(dim * dim, 1);
+    std::vector<T> b = benchValues<T>(dim * dim, 2);
+    std::vector<T> out(dim * dim);
+
+    while (state.keepRunning()) {
+        MatrixUtil::matrixMultiply(a.data(), dim, dim, b.data(), dim, out.data());
+        doNotOptimize(out[0]);
+    }
+
+    double d = static_cast<double>(dim);
+    state.setFlopsProcessed(2.0 * d * d * d * state.iterations());
+    state.setBytesProcessed(3.0 * d * d * sizeof(T) * state.iterations());
+}
+DKM_BENCHMARK(matrixMultiply<float>)->arg(2)->arg(4)->arg(16)->arg(64)->arg(256)->arg(1024);
+DKM_BENCHMARK(matrixMultiply<double>)->arg(2)->arg(4)->arg(16)->arg(64)->arg(256)->arg(1024);
+
+// A * B^T, either with matrixMultiplyTransposed reading B in place
+// (arg 1 = 0) or by transposing B into a buffer first (arg 1 = 1), which
+// is what Matrix::transpose() used to do.
+template<typename T>
+static void matrixMultiplyTransposed(State& state)
+{
+    size_t dim = state.arg(0);
+    bool copy = state.arg(1) != 0;
+    std::vector<T> a = benchValues<T>(dim * dim, 1);
+    std::vector<T> b = benchValues<T>(dim * dim, 2);
+    std::vector<T> bt(dim * dim);
+    std::vector<T> out(dim * dim);
+
+    while (state.keepRunning()) {
+        if (copy) {
+            MatrixUtil::transpose(b.data(), dim, dim, bt.data());
+            MatrixUtil::matrixMultiply(a.data(), dim, dim, bt.data(), dim, out.data());
+        } else {
+            MatrixUtil::matrixMultiplyTransposed(a.data(), dim, dim, b.data(), dim, out.data());
+        }
+        doNotOptimize(out[0]);
+    }
+
+    double d = static_cast<double>(dim);
+    state.setFlopsProcessed(2.0 * d * d * d * state.iterations());
+}
+DKM_BENCHMARK(matrixMultiplyTransposed<float>)
+    ->args({4, 0})->args({4, 1})->args({64, 0})->args({64, 1})->args({512, 0})->args({512, 1});
+DKM_BENCHMARK(matrixMultiplyTransposed<double>)
+    ->args({4, 0})->args({4, 1})->args({64, 0})->args({64, 1})->args({512, 0})->args({512, 1});
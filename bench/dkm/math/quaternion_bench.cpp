@@ -0,0 +1,99 @@
+/**
+ * quaternion_bench.cpp
+ *
+ * Benchmarks for QuaternionUtil conversions and the Quaternion class
+ * in float and double. Inputs are passed through doNotOptimize() each
+ * iteration so the work can't be hoisted out of the loop.
+ */
+
+#include "benchmark.h"
+
+#include "dkm/math/quaternion.h"
+#include "dkm/math/math_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+template<typename T>
+static void quaternionMultiply(State& state)
+{
+    std::vector<T> values = benchValues<T>(8);
+    T out[4];
+
+    while (state.keepRunning()) {
+        doNotOptimize(values[0]);
+        QuaternionUtil::multiply(values.data(), values.data() + 4, out);
+        doNotOptimize(out[0]);
+    }
+
+    state.setFlopsProcessed(28.0 * state.iterations());
+}
+DKM_BENCHMARK(quaternionMultiply<float>);
+DKM_BENCHMARK(quaternionMultiply<double>);
+
+template<typename T>
+static void rotationToQuaternion(State& state)
+{
+    std::vector<T> axis = benchValues<T>(3);
+    T out[4];
+
+    while (state.keepRunning()) {
+        doNotOptimize(axis[0]);
+        QuaternionUtil::rotationToQuaternion(axis.data(), 0.75, out);
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(state.iterations(), "conversions");
+}
+DKM_BENCHMARK(rotationToQuaternion<float>);
+DKM_BENCHMARK(rotationToQuaternion<double>);
+
+template<typename T>
+static void toRotationMatrix3x3(State& state)
+{
+    std::vector<T> quat = benchValues<T>(4);
+    T out[9];
+
+    while (state.keepRunning()) {
+        doNotOptimize(quat[0]);
+        QuaternionUtil::toRotationMatrix3x3(quat.data(), out);
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(state.iterations(), "conversions");
+}
+DKM_BENCHMARK(toRotationMatrix3x3<float>);
+DKM_BENCHMARK(toRotationMatrix3x3<double>);
+
+template<typename T>
+static void toRotationMatrix4x4(State& state)
+{
+    std::vector<T> quat = benchValues<T>(4);
+    T out[16];
+
+    while (state.keepRunning()) {
+        doNotOptimize(quat[0]);
+        QuaternionUtil::toRotationMatrix4x4(quat.data(), out);
+        doNotOptimize(out[0]);
+    }
+
+    state.setItemsProcessed(state.iterations(), "conversions");
+}
+DKM_BENCHMARK(toRotationMatrix4x4<float>);
+DKM_BENCHMARK(toRotationMatrix4x4<double>);
+
+template<typename T>
+static void fromEulerAngles(State& state)
+{
+    T angles[3] = { static_cast<T>(0.1), static_cast<T>(0.2), static_cast<T>(0.3) };
+
+    while (state.keepRunning()) {
+        doNotOptimize(angles);
+        Quaternion<T> q = Quaternion<T>::fromEulerAngles(angles[0], angles[1], angles[2]);
+        doNotOptimize(q.data()[0]);
+    }
+
+    state.setItemsProcessed(state.iterations(), "conversions");
+}
+DKM_BENCHMARK(fromEulerAngles<float>);
+DKM_BENCHMARK(fromEulerAngles<double>);
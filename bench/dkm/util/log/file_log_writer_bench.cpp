@@ -0,0 +1,127 @@
+/**
+ * file_log_writer_bench.cpp
+ *
+ * Throughput benchmarks for FileLogWriter. Each run writes
+ * iterations() messages and flushes them to disk inside the
+ * timed region, so the reported MB/s and lines/s include the
+ * cost of the batch writes.
+ */
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "benchmark.h"
+
+#include "dkm/util/log/file_log_writer.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+static std::string tempLogPath()
+{
+    char dir[] = "/tmp/dkm_bench_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        abort();
+    }
+    return std::string(dir) + "/bench.log";
+}
+
+static void removeLogFiles(const std::string& path, unsigned int maxFiles)
+{
+    unlink(path.c_str());
+    for (unsigned int i = 1; i <= maxFiles; ++i) {
+        unlink((path + "." + std::to_string(i)).c_str());
+    }
+    rmdir(path.substr(0, path.rfind('/')).c_str());
+}
+
+static LogMessage makeMessage(size_t length)
+{
+    LogMessage message;
+    message.loggerName = "bench";
+    message.lineNum = 42;
+    message.logLevel = LogLevel::INFO;
+    message.message = std::string(length, 'x');
+    return message;
+}
+
+// Returns the number of bytes the writer produces for a single message.
+static size_t formattedLength(const LogMessage& message, const std::string& dir)
+{
+    std::string path = dir + "/probe.log";
+    {
+        FileLogWriter probe((FileLogWriterConfig(path)));
+        probe.write(message);
+    }
+
+    struct stat st;
+    size_t length = (stat(path.c_str(), &st) == 0) ? st.st_size : 0;
+    unlink(path.c_str());
+    return length;
+}
+
+static void runWriter(State& state, const FileLogWriterConfig& config, size_t msgLength)
+{
+    state.pauseTiming();
+    LogMessage message = makeMessage(msgLength);
+    size_t lineLength = formattedLength(message, config.path.substr(0, config.path.rfind('/')));
+    state.resumeTiming();
+
+    {
+        FileLogWriter writer(config);
+        while (state.keepRunning()) {
+            writer.write(message);
+        }
+        writer.flush();
+    }
+
+    state.setBytesProcessed(static_cast<double>(lineLength) * state.iterations());
+    state.setItemsProcessed(state.iterations(), "lines");
+
+    state.pauseTiming();
+    removeLogFiles(config.path, config.maxFiles);
+}
+
+static void fileWriterBufferSize(State& state)
+{
+    FileLogWriterConfig config(tempLogPath());
+    config.bufferSize = state.arg(0) * 1024;
+    runWriter(state, config, 100);
+}
+DKM_BENCHMARK(fileWriterBufferSize)->arg(4)->arg(64)->arg(256)->arg(1024);
+
+static void fileWriterMessageLength(State& state)
+{
+    FileLogWriterConfig config(tempLogPath());
+    runWriter(state, config, state.arg(0));
+}
+DKM_BENCHMARK(fileWriterMessageLength)->arg(16)->arg(128)->arg(1024);
+
+static void fileWriterFsyncEveryBatch(State& state)
+{
+    FileLogWriterConfig config(tempLogPath());
+    config.fsyncPolicy = FsyncPolicy::EVERY_BATCH;
+    runWriter(state, config, 100);
+}
+DKM_BENCHMARK(fileWriterFsyncEveryBatch);
+
+static void fileWriterSizeRotation(State& state)
+{
+    FileLogWriterConfig config(tempLogPath());
+    config.rotation = RotationPolicy::SIZE;
+    config.rotateSize = 4 * 1024 * 1024;
+    config.maxFiles = 2;
+    runWriter(state, config, 100);
+}
+DKM_BENCHMARK(fileWriterSizeRotation);
+
+static void fileWriterCompression(State& state)
+{
+    FileLogWriterConfig config(tempLogPath());
+    config.compression = state.arg(0) ? FileCompression::LZ : FileCompression::NONE;
+    runWriter(state, config, 100);
+}
+DKM_BENCHMARK(fileWriterCompression)->arg(0)->arg(1);
@@ -0,0 +1,19 @@
+#ifndef _DKM_LOG_BENCH_HELPERS_H_
+#define _DKM_LOG_BENCH_HELPERS_H_
+
+#include "benchmark.h"
+
+#include "dkm/util/log/log_writer.h"
+
+/**
+ * Writer that throws every message away.
+ */
+class NullLogWriter : public dkm::LogWriter
+{
+public:
+    virtual void write(const dkm::LogMessage& message) {
+        dkm::bench::doNotOptimize(message);
+    }
+};
+
+#endif
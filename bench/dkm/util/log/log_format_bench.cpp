@@ -0,0 +1,156 @@
+/**
+ * log_format_bench.cpp
+ *
+ * Compares compile-time parsed log formats against the printf style
+ * vararg path, both for formatting alone and for a full Logger call
+ * dispatched to a writer that discards the message. The same data
+ * logged as structured fields is included for comparison.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "benchmark.h"
+
+#include "dkm/util/log/log_format.h"
+#include "dkm/util/log/logging.h"
+#include "dkm/util/log/log_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+#define INT_FORMAT "request %d from %s took %u us, flags %x"
+#define FLOAT_FORMAT "step %d residual %.6f"
+
+// Formats the same way Logger::vlog() does.
+static void varargFormat(std::string& out, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void varargFormat(std::string& out, const char* fmt, ...)
+{
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (len >= 0 && static_cast<size_t>(len) < sizeof(buf)) {
+        out.assign(buf, len);
+    }
+    else if (len >= 0) {
+        out.resize(len + 1);
+        va_start(args, fmt);
+        vsnprintf(&out[0], len + 1, fmt, args);
+        va_end(args);
+        out.resize(len);
+    }
+}
+
+static void formatIntsVararg(State& state)
+{
+    int i = 0;
+    while (state.keepRunning()) {
+        std::string out;
+        varargFormat(out, INT_FORMAT, i, "10.0.0.1", 1234u + i, 0xbeefu);
+        doNotOptimize(out);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+}
+DKM_BENCHMARK(formatIntsVararg);
+
+static void formatIntsCompiled(State& state)
+{
+    int i = 0;
+    while (state.keepRunning()) {
+        std::string out;
+        DKM_FORMAT(out, INT_FORMAT, i, "10.0.0.1", 1234u + i, 0xbeefu);
+        doNotOptimize(out);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+}
+DKM_BENCHMARK(formatIntsCompiled);
+
+static void formatFloatVararg(State& state)
+{
+    int i = 0;
+    while (state.keepRunning()) {
+        std::string out;
+        varargFormat(out, FLOAT_FORMAT, i, 1.0 / (i + 1));
+        doNotOptimize(out);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+}
+DKM_BENCHMARK(formatFloatVararg);
+
+static void formatFloatCompiled(State& state)
+{
+    int i = 0;
+    while (state.keepRunning()) {
+        std::string out;
+        DKM_FORMAT(out, FLOAT_FORMAT, i, 1.0 / (i + 1));
+        doNotOptimize(out);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+}
+DKM_BENCHMARK(formatFloatCompiled);
+
+static void loggerVararg(State& state)
+{
+    NullLogWriter writer;
+    Logging::getInstance().registerLogWriter(&writer);
+    Logger logger("bench.format");
+    logger.setLogLevel(LogLevel::INFO);
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_LOG_INFO(logger, INT_FORMAT, i, "10.0.0.1", 1234u + i, 0xbeefu);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+
+    Logging::getInstance().unregisterLogWriter(&writer);
+}
+DKM_BENCHMARK(loggerVararg);
+
+static void loggerCompiled(State& state)
+{
+    NullLogWriter writer;
+    Logging::getInstance().registerLogWriter(&writer);
+    Logger logger("bench.format");
+    logger.setLogLevel(LogLevel::INFO);
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_LOGF_INFO(logger, INT_FORMAT, i, "10.0.0.1", 1234u + i, 0xbeefu);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+
+    Logging::getInstance().unregisterLogWriter(&writer);
+}
+DKM_BENCHMARK(loggerCompiled);
+
+static void loggerFields(State& state)
+{
+    NullLogWriter writer;
+    Logging::getInstance().registerLogWriter(&writer);
+    Logger logger("bench.format");
+    logger.setLogLevel(LogLevel::INFO);
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_LOG_INFO(logger, "request done", kv("request", i), kv("from", "10.0.0.1"),
+                     kv("lat_us", 1234u + i), kv("flags", 0xbeefu));
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "msgs");
+
+    Logging::getInstance().unregisterLogWriter(&writer);
+}
+DKM_BENCHMARK(loggerFields);
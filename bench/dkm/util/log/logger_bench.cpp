@@ -0,0 +1,270 @@
+/**
+ * logger_bench.cpp
+ *
+ * Cost of Logger calls as seen by the caller: a call below the
+ * logger's level, an enabled call in sync and async mode, throughput
+ * with several threads logging at once, and the distribution of
+ * per-call latency with a writer that discards messages, a
+ * FileLogWriter and a writer slower than the callers.
+ *
+ * Latency runs time every call and report the 50th, 99th and 99.9th
+ * percentiles and the maximum in nanoseconds. Each sample includes one
+ * clock read, roughly 20ns on most machines.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "dkm/util/log/file_log_writer.h"
+#include "dkm/util/log/log_format.h"
+#include "dkm/util/log/logger.h"
+#include "dkm/util/log/logging.h"
+#include "dkm/util/log/log_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Writer that spins for a fixed time on every message, standing in
+ * for a writer on a slow disk or network.
+ */
+class SlowLogWriter : public LogWriter
+{
+public:
+    explicit SlowLogWriter(std::chrono::microseconds delay) : mDelay(delay) {}
+
+    virtual void write(const LogMessage& message) {
+        Clock::time_point end = Clock::now() + mDelay;
+        while (Clock::now() < end) {
+        }
+        doNotOptimize(message);
+    }
+
+private:
+    std::chrono::microseconds mDelay;
+};
+
+static Logger benchLogger("bench.logger");
+
+// Configures the global Logging instance and sets the bench logger to
+// INFO, since reconfiguring resets logger levels.
+static void configureLogging(bool async)
+{
+    LoggingConfig config;
+    config.async = async;
+    config.queueCapacity = 8192;
+    Logging::getInstance().configure(config);
+    Logging::getInstance().init();
+    benchLogger.setLogLevel(LogLevel::INFO);
+}
+
+static void restoreLogging()
+{
+    Logging::getInstance().configure(LoggingConfig());
+}
+
+// Returns the value at fraction q of the way through sorted.
+static double percentile(const std::vector<double>& sorted, double q)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t idx = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+static void loggerDisabled(State& state)
+{
+    benchLogger.setLogLevel(LogLevel::WARN);
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_LOG_DEBUG(benchLogger, "value %d", i);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "calls");
+}
+DKM_BENCHMARK(loggerDisabled);
+
+static void loggerDisabledCompiled(State& state)
+{
+    benchLogger.setLogLevel(LogLevel::WARN);
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_LOGF_DEBUG(benchLogger, "value %d", i);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "calls");
+}
+DKM_BENCHMARK(loggerDisabledCompiled);
+
+// arg 0 is 1 for async mode
+static void loggerEnabled(State& state)
+{
+    state.pauseTiming();
+    configureLogging(state.arg(0) != 0);
+    NullLogWriter writer;
+    Logging::getInstance().registerLogWriter(&writer);
+    state.resumeTiming();
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_LOG_INFO(benchLogger, "value %d", i);
+        ++i;
+    }
+    Logging::getInstance().flush();
+
+    state.setItemsProcessed(state.iterations(), "msgs");
+
+    state.pauseTiming();
+    Logging::getInstance().unregisterLogWriter(&writer);
+    restoreLogging();
+}
+DKM_BENCHMARK(loggerEnabled)->arg(0)->arg(1);
+
+// Splits iterations() calls over arg 0 threads, sync or async per
+// arg 1, and reports the combined rate including the final flush.
+static void loggerThreads(State& state)
+{
+    state.pauseTiming();
+
+    size_t numThreads = state.arg(0);
+    size_t perThread = (state.iterations() + numThreads - 1) / numThreads;
+
+    configureLogging(state.arg(1) != 0);
+    NullLogWriter writer;
+    Logging::getInstance().registerLogWriter(&writer);
+
+    while (state.keepRunning()) { }
+
+    state.resumeTiming();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([perThread] {
+            for (size_t i = 0; i < perThread; ++i) {
+                DKM_LOG_INFO(benchLogger, "value %d", static_cast<int>(i));
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    Logging::getInstance().flush();
+
+    state.pauseTiming();
+
+    state.setItemsProcessed(static_cast<double>(perThread * numThreads), "msgs");
+    Logging::getInstance().unregisterLogWriter(&writer);
+    restoreLogging();
+}
+DKM_BENCHMARK(loggerThreads)
+    ->args({1, 0})->args({2, 0})->args({4, 0})->args({8, 0})
+    ->args({1, 1})->args({2, 1})->args({4, 1})->args({8, 1});
+
+// Times every call made by arg 1 threads to a logger writing to
+// writer, sync or async per arg 0.
+static void runLatency(State& state, LogWriter& writer)
+{
+    state.pauseTiming();
+
+    size_t numThreads = state.arg(1);
+    size_t perThread = (state.iterations() + numThreads - 1) / numThreads;
+
+    configureLogging(state.arg(0) != 0);
+    Logging::getInstance().registerLogWriter(&writer);
+
+    std::vector<std::vector<double> > samples(numThreads);
+    for (size_t t = 0; t < numThreads; ++t) {
+        samples[t].reserve(perThread);
+    }
+
+    while (state.keepRunning()) { }
+
+    state.resumeTiming();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        std::vector<double>* out = &samples[t];
+        threads.push_back(std::thread([perThread, out] {
+            for (size_t i = 0; i < perThread; ++i) {
+                Clock::time_point start = Clock::now();
+                DKM_LOG_INFO(benchLogger, "value %d", static_cast<int>(i));
+                out->push_back(std::chrono::duration<double, std::nano>(
+                    Clock::now() - start).count());
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    state.pauseTiming();
+
+    Logging::getInstance().flush();
+    Logging::getInstance().unregisterLogWriter(&writer);
+    restoreLogging();
+
+    std::vector<double> all;
+    all.reserve(perThread * numThreads);
+    for (size_t t = 0; t < numThreads; ++t) {
+        all.insert(all.end(), samples[t].begin(), samples[t].end());
+    }
+    std::sort(all.begin(), all.end());
+
+    state.setItemsProcessed(static_cast<double>(all.size()), "msgs");
+    state.setCounter("p50_ns", percentile(all, 0.50));
+    state.setCounter("p99_ns", percentile(all, 0.99));
+    state.setCounter("p999_ns", percentile(all, 0.999));
+    state.setCounter("max_ns", all.empty() ? 0 : all.back());
+}
+
+static void latencyNullWriter(State& state)
+{
+    NullLogWriter writer;
+    runLatency(state, writer);
+}
+DKM_BENCHMARK(latencyNullWriter)
+    ->args({0, 1})->args({0, 4})->args({1, 1})->args({1, 4});
+
+static void latencyFileWriter(State& state)
+{
+    state.pauseTiming();
+    char dir[] = "/tmp/dkm_bench_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        abort();
+    }
+    std::string path = std::string(dir) + "/bench.log";
+
+    {
+        FileLogWriter writer((FileLogWriterConfig(path)));
+        runLatency(state, writer);
+    }
+
+    unlink(path.c_str());
+    rmdir(dir);
+}
+DKM_BENCHMARK(latencyFileWriter)
+    ->args({0, 1})->args({0, 4})->args({1, 1})->args({1, 4});
+
+// The writer takes 10us per message, so in async mode callers fill the
+// queue and then wait on it. The dispatcher empties the whole queue at
+// once, so the waits are rare but long and show up in max_ns.
+static void latencySlowWriter(State& state)
+{
+    SlowLogWriter writer(std::chrono::microseconds(10));
+    runLatency(state, writer);
+}
+DKM_BENCHMARK(latencySlowWriter)
+    ->args({0, 1})->args({1, 1})->args({1, 4});
@@ -0,0 +1,78 @@
+/**
+ * logging_bench.cpp
+ *
+ * Async dispatch throughput as the number of producer threads grows,
+ * with one queue shared by every producer and with a queue per
+ * producer thread. Each run splits iterations() messages evenly over
+ * the threads; the reported rate is messages per second across all of
+ * them, including the time to drain the queue.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+
+#include "dkm/util/log/logging.h"
+#include "dkm/util/log/log_bench_helpers.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+static void runProducers(State& state, bool sharded)
+{
+    state.pauseTiming();
+
+    size_t numThreads = state.arg(0);
+    size_t perThread = (state.iterations() + numThreads - 1) / numThreads;
+
+    Logging logging;
+    LoggingConfig config;
+    config.async = true;
+    config.shardedQueue = sharded;
+    config.queueCapacity = sharded ? 8192 : 8192 * numThreads;
+    logging.configure(config);
+    logging.init();
+
+    NullLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    LogMessage message;
+    message.loggerName = "bench";
+    message.lineNum = 42;
+    message.message = "a message of a fairly typical length for a log line";
+
+    while (state.keepRunning()) { }
+
+    state.resumeTiming();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([&logging, &message, perThread] {
+            for (size_t i = 0; i < perThread; ++i) {
+                logging.dispatchMessage(message);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    logging.flush();
+
+    state.pauseTiming();
+
+    state.setItemsProcessed(static_cast<double>(perThread * numThreads), "msgs");
+    logging.unregisterLogWriter(&writer);
+}
+
+static void asyncSharedQueue(State& state)
+{
+    runProducers(state, false);
+}
+DKM_BENCHMARK(asyncSharedQueue)->range(1, 64);
+
+static void asyncShardedQueue(State& state)
+{
+    runProducers(state, true);
+}
+DKM_BENCHMARK(asyncShardedQueue)->range(1, 64);
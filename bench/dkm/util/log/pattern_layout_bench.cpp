@@ -0,0 +1,70 @@
+/**
+ * pattern_layout_bench.cpp
+ *
+ * Cost of formatting a message with a PatternLayout, with and without
+ * a timestamp. Messages reuse one timestamp so the per-thread date
+ * cache is hit as it would be for a busy logger. Structured fields
+ * are formatted both as logfmt and as JSON lines.
+ */
+
+#include <string>
+
+#include "benchmark.h"
+
+#include "dkm/util/log/json_layout.h"
+#include "dkm/util/log/log_fields.h"
+#include "dkm/util/log/pattern_layout.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+static void runLayout(State& state, const LogLayout& layout, bool withFields)
+{
+    LogMessage message;
+    message.loggerName = "bench.layout";
+    message.lineNum = 42;
+    message.logLevel = LogLevel::INFO;
+    message.message = std::string(80, 'x');
+
+    if (withFields) {
+        LogField fields[] = {
+            kv("lat_us", 1234), kv("path", "/index.html"), kv("ratio", 0.25), kv("ok", true)
+        };
+        LogFields::encode(fields, 4, message.fields);
+    }
+
+    std::string out;
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        out.clear();
+        layout.format(message, out);
+        bytes += out.size();
+        doNotOptimize(out);
+    }
+    state.setBytesProcessed(static_cast<double>(bytes));
+    state.setItemsProcessed(state.iterations(), "lines");
+}
+
+static void layoutDefault(State& state)
+{
+    runLayout(state, PatternLayout(PatternLayout::DEFAULT_PATTERN), false);
+}
+DKM_BENCHMARK(layoutDefault);
+
+static void layoutFull(State& state)
+{
+    runLayout(state, PatternLayout("%d{ISO8601} %-5p [%t] %c:%L - %m%n"), false);
+}
+DKM_BENCHMARK(layoutFull);
+
+static void layoutLogfmtFields(State& state)
+{
+    runLayout(state, PatternLayout("%d{ISO8601} %-5p [%t] %c:%L - %m%K%n"), true);
+}
+DKM_BENCHMARK(layoutLogfmtFields);
+
+static void layoutJsonFields(State& state)
+{
+    runLayout(state, JsonLayout(), true);
+}
+DKM_BENCHMARK(layoutJsonFields);
@@ -0,0 +1,49 @@
+/**
+ * shm_log_writer_bench.cpp
+ *
+ * Cost of publishing a message into a shared memory ring with
+ * ShmLogWriter, which is all the logging process pays when the I/O is
+ * done by a separate reader. Nothing reads the ring during the run, so
+ * it overwrites itself, which costs the producer the same as keeping up.
+ */
+
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "benchmark.h"
+
+#include "dkm/util/log/shm_log_writer.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+static void shmWriterMessageLength(State& state)
+{
+    state.pauseTiming();
+    ShmLogWriterConfig config("/dkm_bench_" + std::to_string(getpid()));
+    config.slotSize = 2048;
+
+    LogMessage message;
+    message.loggerName = "bench";
+    message.lineNum = 42;
+    message.logLevel = LogLevel::INFO;
+    message.message = std::string(state.arg(0), 'x');
+
+    // creating the ring faults in every page, which is not part of
+    // the per-message cost
+    std::unique_ptr<ShmLogWriter> writer(new ShmLogWriter(config));
+    state.resumeTiming();
+
+    while (state.keepRunning()) {
+        writer->write(message);
+    }
+
+    state.setItemsProcessed(state.iterations(), "lines");
+
+    state.pauseTiming();
+    writer.reset();
+    ShmLogWriter::unlink(config.name);
+}
+DKM_BENCHMARK(shmWriterMessageLength)->arg(16)->arg(128)->arg(1024);
@@ -0,0 +1,49 @@
+/**
+ * trace_bench.cpp
+ *
+ * Per-event cost of trace spans with each clock, and of a span
+ * while tracing is disabled. Each tracer is cleared between runs so
+ * the buffers never fill up.
+ */
+
+#include "benchmark.h"
+
+#include "dkm/util/log/trace.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+static void runSpans(State& state, Tracer& tracer)
+{
+    while (state.keepRunning()) {
+        TraceSpan span("bench", "bench", tracer);
+    }
+    state.setItemsProcessed(state.iterations(), "spans");
+
+    state.pauseTiming();
+    tracer.clear();
+}
+
+static void traceSpanDisabled(State& state)
+{
+    Tracer tracer(TraceClock::MONOTONIC);
+    runSpans(state, tracer);
+}
+DKM_BENCHMARK(traceSpanDisabled);
+
+static void traceSpanMonotonic(State& state)
+{
+    Tracer tracer(TraceClock::MONOTONIC, 1 << 24);
+    tracer.enable();
+    runSpans(state, tracer);
+}
+DKM_BENCHMARK(traceSpanMonotonic);
+
+static void traceSpanTsc(State& state)
+{
+    Tracer tracer(TraceClock::TSC, 1 << 24);
+    tracer.enable();
+    runSpans(state, tracer);
+    state.setLabel(tracer.getClock() == TraceClock::TSC ? "tsc" : "tsc unavailable");
+}
+DKM_BENCHMARK(traceSpanTsc);
@@ -0,0 +1,77 @@
+/**
+ * lz_codec_bench.cpp
+ *
+ * Throughput of LzCodec on formatted log text, in bytes of
+ * uncompressed text per second. The compression ratio is shown in the
+ * label.
+ */
+
+#include <stdio.h>
+
+#include <string>
+
+#include "benchmark.h"
+
+#include "dkm/util/lz_codec.h"
+
+using namespace dkm;
+using namespace dkm::bench;
+
+// Roughly 256K of log lines with varying numbers and levels.
+static const std::string& logText()
+{
+    static std::string text;
+    if (text.empty()) {
+        static const char* levels[] = { "INFO", "DEBUG", "WARN", "INFO" };
+        char line[256];
+        for (unsigned int i = 0; text.size() < 256 * 1024; ++i) {
+            snprintf(line, sizeof(line),
+                     "2026-10-18 13:%02u:%02u,%03u [%s] dkm.io.block_store:%u - "
+                     "wrote block %u of %u to segment %u in %u us\n",
+                     (i / 6000) % 60, (i / 100) % 60, (i * 7) % 1000, levels[i % 4],
+                     100 + i % 37, i, i * 3 + 17, i / 64, (i * 2654435761U) % 5000);
+            text += line;
+        }
+    }
+    return text;
+}
+
+static std::string ratioLabel(size_t raw, size_t compressed)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "ratio %.2f", static_cast<double>(raw) / compressed);
+    return buf;
+}
+
+static void lzCompress(State& state)
+{
+    const std::string& text = logText();
+    std::string out(LzCodec::compressBound(text.size()), '\0');
+    size_t compressed = 0;
+
+    while (state.keepRunning()) {
+        compressed = LzCodec::compress(text.data(), text.size(), &out[0]);
+        doNotOptimize(compressed);
+    }
+
+    state.setBytesProcessed(static_cast<double>(text.size()) * state.iterations());
+    state.setLabel(ratioLabel(text.size(), compressed));
+}
+DKM_BENCHMARK(lzCompress);
+
+static void lzDecompress(State& state)
+{
+    const std::string& text = logText();
+    std::string block(LzCodec::compressBound(text.size()), '\0');
+    block.resize(LzCodec::compress(text.data(), text.size(), &block[0]));
+    std::string out(text.size(), '\0');
+
+    while (state.keepRunning()) {
+        bool ok = LzCodec::decompress(block.data(), block.size(), &out[0], out.size());
+        doNotOptimize(ok);
+    }
+
+    state.setBytesProcessed(static_cast<double>(text.size()) * state.iterations());
+    state.setLabel(ratioLabel(text.size(), block.size()));
+}
+DKM_BENCHMARK(lzDecompress);
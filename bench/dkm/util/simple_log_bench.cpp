@@ -0,0 +1,54 @@
+/**
+ * simple_log_bench.cpp
+ *
+ * Cost of the simple_log.h console macros. INFO is enabled and DEBUG
+ * compiled out. The enabled run writes to /dev/null in place of
+ * stdout so the terminal doesn't skew the result.
+ */
+
+#define DKM_LOG_LEVEL 3
+#include "dkm/util/simple_log.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+
+using namespace dkm::bench;
+
+static void simpleLogDisabled(State& state)
+{
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_DEBUG("value %d", i);
+        doNotOptimize(i);
+        ++i;
+    }
+    state.setItemsProcessed(state.iterations(), "calls");
+}
+DKM_BENCHMARK(simpleLogDisabled);
+
+static void simpleLogEnabled(State& state)
+{
+    state.pauseTiming();
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+    state.resumeTiming();
+
+    int i = 0;
+    while (state.keepRunning()) {
+        DKM_INFO("value %d", i);
+        ++i;
+    }
+    fflush(stdout);
+
+    state.pauseTiming();
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    state.setItemsProcessed(state.iterations(), "msgs");
+}
+DKM_BENCHMARK(simpleLogEnabled);
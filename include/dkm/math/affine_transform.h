@@ -0,0 +1,474 @@
+/**
+ * affine_transform.h
+ *
+ * Contains a template class for affine transforms in three dimensions,
+ * stored as the top three rows of the equivalent 4x4 matrix.
+ */
+
+#ifndef _DKM_AFFINE_TRANSFORM_H_
+#define _DKM_AFFINE_TRANSFORM_H_
+
+#include "matrix.h"
+#include "quaternion.h"
+
+// darkma773r namespace
+namespace dkm {
+
+/**
+Namespace containing array-based versions of the affine transform
+operations. A transform is an array of 12 elements holding a row-major
+3x4 matrix [ L | t ]: the 3x3 linear part L followed in each row by one
+component of the translation t. This is the 4x4 matrix of the transform
+without its constant bottom row of 0 0 0 1, so a point p is mapped to
+L*p + t and a direction v to L*v. For consistency with MatrixUtil, any
+function that writes data to an external array returns the number of
+elements written to that array. Unless otherwise noted, the output may
+be the same array as an input.
+*/
+namespace AffineTransformUtil {
+
+/**
+Writes the identity transform to dest. Returns 12.
+*/
+template<typename T>
+size_t identity(T* dest) {
+    MatrixUtil::set(dest, static_cast<T>(0), 12);
+    dest[0] = static_cast<T>(1);
+    dest[5] = static_cast<T>(1);
+    dest[10] = static_cast<T>(1);
+    return 12;
+}
+
+/**
+Composes the transforms a and b into dest, such that applying dest is the
+same as applying b and then a (dest = a * b in 4x4 matrix terms). Only
+the 36 multiplies the non-constant elements need are made, against 64 for
+the full 4x4 product. Returns 12.
+*/
+template<typename T>
+size_t compose(const T* a, const T* b, T* dest) {
+    T b00 = b[0], b01 = b[1], b02 = b[2],  b03 = b[3];
+    T b10 = b[4], b11 = b[5], b12 = b[6],  b13 = b[7];
+    T b20 = b[8], b21 = b[9], b22 = b[10], b23 = b[11];
+
+    for (int i=0; i<3; ++i) {
+        T a0 = a[i*4];
+        T a1 = a[i*4 + 1];
+        T a2 = a[i*4 + 2];
+        T a3 = a[i*4 + 3];
+
+        dest[i*4]     = a0*b00 + a1*b10 + a2*b20;
+        dest[i*4 + 1] = a0*b01 + a1*b11 + a2*b21;
+        dest[i*4 + 2] = a0*b02 + a1*b12 + a2*b22;
+        dest[i*4 + 3] = a0*b03 + a1*b13 + a2*b23 + a3;
+    }
+    return 12;
+}
+
+/**
+Writes the inverse of the transform a to dest. The linear part is
+inverted through its cofactors and the translation becomes -L^-1 * t.
+The function does not branch on the determinant, so a singular linear
+part produces non-finite elements. Returns 12.
+*/
+template<typename T>
+size_t inverse(const T* a, T* dest) {
+    T a00 = a[0], a01 = a[1], a02 = a[2],  t0 = a[3];
+    T a10 = a[4], a11 = a[5], a12 = a[6],  t1 = a[7];
+    T a20 = a[8], a21 = a[9], a22 = a[10], t2 = a[11];
+
+    T c00 = a11*a22 - a12*a21;
+    T c01 = a12*a20 - a10*a22;
+    T c02 = a10*a21 - a11*a20;
+    T invDet = static_cast<T>(1) / (a00*c00 + a01*c01 + a02*c02);
+
+    // the inverse of the linear part is the transposed cofactors over the determinant
+    T i00 = c00 * invDet;
+    T i01 = (a02*a21 - a01*a22) * invDet;
+    T i02 = (a01*a12 - a02*a11) * invDet;
+    T i10 = c01 * invDet;
+    T i11 = (a00*a22 - a02*a20) * invDet;
+    T i12 = (a02*a10 - a00*a12) * invDet;
+    T i20 = c02 * invDet;
+    T i21 = (a01*a20 - a00*a21) * invDet;
+    T i22 = (a00*a11 - a01*a10) * invDet;
+
+    dest[0] = i00; dest[1] = i01; dest[2]  = i02; dest[3]  = -(i00*t0 + i01*t1 + i02*t2);
+    dest[4] = i10; dest[5] = i11; dest[6]  = i12; dest[7]  = -(i10*t0 + i11*t1 + i12*t2);
+    dest[8] = i20; dest[9] = i21; dest[10] = i22; dest[11] = -(i20*t0 + i21*t1 + i22*t2);
+    return 12;
+}
+
+/**
+Writes the inverse of the rigid transform a, whose linear part is a
+rotation, to dest. The inverse of a rotation is its transpose, so this
+takes 9 multiplies with no division; the result is only correct when the
+linear part is orthonormal. Returns 12.
+*/
+template<typename T>
+size_t rigidInverse(const T* a, T* dest) {
+    T a00 = a[0], a01 = a[1], a02 = a[2],  t0 = a[3];
+    T a10 = a[4], a11 = a[5], a12 = a[6],  t1 = a[7];
+    T a20 = a[8], a21 = a[9], a22 = a[10], t2 = a[11];
+
+    dest[0] = a00; dest[1] = a10; dest[2]  = a20; dest[3]  = -(a00*t0 + a10*t1 + a20*t2);
+    dest[4] = a01; dest[5] = a11; dest[6]  = a21; dest[7]  = -(a01*t0 + a11*t1 + a21*t2);
+    dest[8] = a02; dest[9] = a12; dest[10] = a22; dest[11] = -(a02*t0 + a12*t1 + a22*t2);
+    return 12;
+}
+
+/**
+Applies the transform a to the point p (3 elements) and writes the result
+to dest. Returns 3.
+*/
+template<typename T>
+size_t transformPoint(const T* a, const T* p, T* dest) {
+    T x = p[0], y = p[1], z = p[2];
+    dest[0] = a[0]*x + a[1]*y + a[2]*z  + a[3];
+    dest[1] = a[4]*x + a[5]*y + a[6]*z  + a[7];
+    dest[2] = a[8]*x + a[9]*y + a[10]*z + a[11];
+    return 3;
+}
+
+/**
+Applies the linear part of the transform a to the direction v (3 elements)
+and writes the result to dest. The translation does not apply to
+directions. Returns 3.
+*/
+template<typename T>
+size_t transformDirection(const T* a, const T* v, T* dest) {
+    T x = v[0], y = v[1], z = v[2];
+    dest[0] = a[0]*x + a[1]*y + a[2]*z;
+    dest[1] = a[4]*x + a[5]*y + a[6]*z;
+    dest[2] = a[8]*x + a[9]*y + a[10]*z;
+    return 3;
+}
+
+/**
+Applies the transform a to count points packed x, y, z one after another
+in points and writes them to dest in the same order. The transform is
+loaded once for the whole array. Returns 3*count.
+*/
+template<typename T>
+size_t transformPoints(const T* a, const T* points, T* dest, size_t count) {
+    T a00 = a[0], a01 = a[1], a02 = a[2],  a03 = a[3];
+    T a10 = a[4], a11 = a[5], a12 = a[6],  a13 = a[7];
+    T a20 = a[8], a21 = a[9], a22 = a[10], a23 = a[11];
+
+    for (size_t k=0; k<count; ++k) {
+        T x = points[k*3], y = points[k*3 + 1], z = points[k*3 + 2];
+        dest[k*3]     = a00*x + a01*y + a02*z + a03;
+        dest[k*3 + 1] = a10*x + a11*y + a12*z + a13;
+        dest[k*3 + 2] = a20*x + a21*y + a22*z + a23;
+    }
+    return count * 3;
+}
+
+/**
+Applies the linear part of the transform a to count directions packed as
+in transformPoints(). Returns 3*count.
+*/
+template<typename T>
+size_t transformDirections(const T* a, const T* dirs, T* dest, size_t count) {
+    T a00 = a[0], a01 = a[1], a02 = a[2];
+    T a10 = a[4], a11 = a[5], a12 = a[6];
+    T a20 = a[8], a21 = a[9], a22 = a[10];
+
+    for (size_t k=0; k<count; ++k) {
+        T x = dirs[k*3], y = dirs[k*3 + 1], z = dirs[k*3 + 2];
+        dest[k*3]     = a00*x + a01*y + a02*z;
+        dest[k*3 + 1] = a10*x + a11*y + a12*z;
+        dest[k*3 + 2] = a20*x + a21*y + a22*z;
+    }
+    return count * 3;
+}
+
+/**
+Builds the transform that rotates by the quaternion quat and then
+translates by vec3, writing it to dest. Returns 12.
+*/
+template<typename T>
+size_t fromRotationTranslation(const T* quat, const T* vec3, T* dest) {
+    T rot[9];
+    QuaternionUtil::toRotationMatrix3x3(quat, rot);
+    MatrixUtil::copy(rot, 3, dest, 4, 3, 3);
+    dest[3] = vec3[0];
+    dest[7] = vec3[1];
+    dest[11] = vec3[2];
+    return 12;
+}
+
+/**
+Writes the row-major 4x4 matrix of the transform a to dest. dest must not
+be a. Returns 16.
+*/
+template<typename T>
+size_t toMatrix4x4(const T* a, T* dest) {
+    MatrixUtil::copy(a, dest, 12);
+    dest[12] = static_cast<T>(0);
+    dest[13] = static_cast<T>(0);
+    dest[14] = static_cast<T>(0);
+    dest[15] = static_cast<T>(1);
+    return 16;
+}
+
+/**
+Writes the transform held in the row-major 4x4 matrix mat to dest. The
+bottom row of mat is assumed to be 0 0 0 1 and is not read. Returns 12.
+*/
+template<typename T>
+size_t fromMatrix4x4(const T* mat, T* dest) {
+    return MatrixUtil::copy(mat, dest, 12);
+}
+
+} // end AffineTransformUtil namespace
+
+/**
+Affine transform in three dimensions, i.e. a linear map followed by a
+translation. Rigid and affine transforms are often kept as a full
+Matrix<4, 4>, but the bottom row of such a matrix is always 0 0 0 1.
+AffineTransform stores only the top three rows (see AffineTransformUtil)
+and skips the constant row in every operation: composing two transforms
+takes 36 multiplies instead of 64.
+
+    AffineTransformd bodyToWorld(orientation, position);
+    AffineTransformd cameraToWorld = bodyToWorld * cameraToBody;
+    Vec3d p = cameraToWorld.rigidInverse().transformPoint(target);
+
+Transforms compose like matrices: (a * b) applies b first, then a.
+inverse() handles any invertible transform; when the linear part is known
+to be a rotation, rigidInverse() is much cheaper. Use transformPoint() for
+positions and transformDirection() for directions, which the translation
+does not affect.
+*/
+template<typename T = double>
+class AffineTransform {
+
+    typedef AffineTransform<T> ThisType;
+
+public:
+    /**
+    If elements is NULL, every element is set to zero. Otherwise, the 12
+    elements are copied from the array; see AffineTransformUtil for the
+    order.
+    */
+    AffineTransform(const T* elements = NULL) {
+        if (elements != NULL) {
+            MatrixUtil::copy(elements, mData, 12);
+        } else {
+            MatrixUtil::set(mData, static_cast<T>(0), 12);
+        }
+    }
+
+    /**
+    Creates the transform held in the top three rows of mat, in either
+    layout. The bottom row is assumed to be 0 0 0 1.
+    */
+    template<MatrixLayout LayoutArg, typename StorageType>
+    explicit AffineTransform(const Matrix<4, 4, T, LayoutArg, StorageType>& mat) {
+        MatrixUtil::copy(mat.data(), mat.rowStride(), mat.colStride(), mData, 4, 1, 3, 4);
+    }
+
+    /**
+    Creates the transform that applies the linear map linear and then
+    translates by translation.
+    */
+    template<MatrixLayout LayoutArg, typename MatrixStorage, typename VectorStorage>
+    AffineTransform(const Matrix<3, 3, T, LayoutArg, MatrixStorage>& linear,
+                    const Vector<3, T, VectorStorage>& translation) {
+        MatrixUtil::copy(linear.data(), linear.rowStride(), linear.colStride(), mData, 4, 1, 3, 3);
+        this->translation(translation);
+    }
+
+    /**
+    Creates the rigid transform that rotates by rotation and then translates
+    by translation.
+    */
+    template<typename QuaternionStorage, typename VectorStorage>
+    AffineTransform(const Quaternion<T, QuaternionStorage>& rotation,
+                    const Vector<3, T, VectorStorage>& translation) {
+        AffineTransformUtil::fromRotationTranslation(rotation.data(), translation.data(), mData);
+    }
+
+    /**
+    Returns a pointer to the 12 elements of the transform.
+    */
+    T* data() { return mData; }
+    const T* data() const { return mData; }
+
+    /**
+    Accessors for the element at row, col of the 3x4 matrix [ L | t ].
+    */
+    T& operator()(int row, int col) { return mData[row*4 + col]; }
+    const T& operator()(int row, int col) const { return mData[row*4 + col]; }
+
+    /**
+    Returns a 3x4 Matrix over the elements of the transform.
+    */
+    MatrixMap<3, 4, T> matrix() { return MatrixMap<3, 4, T>(mData); }
+    MatrixMap<3, 4, const T> matrix() const { return MatrixMap<3, 4, const T>(mData); }
+
+    /**
+    Returns a copy of the 3x3 linear part.
+    */
+    Matrix<3, 3, T> linear() const {
+        Matrix<3, 3, T> result;
+        MatrixUtil::copy(mData, 4, result.data(), 3, 3, 3);
+        return result;
+    }
+
+    /**
+    Setter for the 3x3 linear part.
+    */
+    template<MatrixLayout LayoutArg, typename StorageType>
+    void linear(const Matrix<3, 3, T, LayoutArg, StorageType>& value) {
+        MatrixUtil::copy(value.data(), value.rowStride(), value.colStride(), mData, 4, 1, 3, 3);
+    }
+
+    /**
+    Returns a copy of the translation.
+    */
+    Vector<3, T> translation() const {
+        return Vector<3, T>(mData[3], mData[7], mData[11]);
+    }
+
+    /**
+    Setter for the translation.
+    */
+    template<typename StorageType>
+    void translation(const Vector<3, T, StorageType>& value) {
+        mData[3] = value.data()[0];
+        mData[7] = value.data()[1];
+        mData[11] = value.data()[2];
+    }
+
+    /**
+    Returns the rotation of a rigid transform as a Quaternion. The linear
+    part must be a rotation.
+    */
+    Quaternion<T> rotation() const {
+        Quaternion<T> result;
+        QuaternionUtil::rotationMatrixToQuaternion(mData, 4, result.data());
+        return result;
+    }
+
+    /**
+    Returns the 4x4 matrix of the transform.
+    */
+    Matrix<4, 4, T> toMatrix4x4() const {
+        Matrix<4, 4, T> result;
+        AffineTransformUtil::toMatrix4x4(mData, result.data());
+        return result;
+    }
+
+    /**
+    Returns the transform that applies other and then this transform.
+    */
+    ThisType compose(const ThisType& other) const {
+        ThisType result;
+        AffineTransformUtil::compose(mData, other.mData, result.mData);
+        return result;
+    }
+
+    ThisType operator*(const ThisType& other) const {
+        return compose(other);
+    }
+
+    /**
+    Replaces this transform with this * other.
+    */
+    ThisType& operator*=(const ThisType& other) {
+        AffineTransformUtil::compose(mData, other.mData, mData);
+        return *this;
+    }
+
+    /**
+    Returns the inverse of the transform. A singular linear part produces
+    non-finite elements.
+    */
+    ThisType inverse() const {
+        ThisType result;
+        AffineTransformUtil::inverse(mData, result.mData);
+        return result;
+    }
+
+    /**
+    Returns the inverse of a rigid transform, whose linear part must be a
+    rotation. No division is needed; see AffineTransformUtil::rigidInverse().
+    */
+    ThisType rigidInverse() const {
+        ThisType result;
+        AffineTransformUtil::rigidInverse(mData, result.mData);
+        return result;
+    }
+
+    /**
+    Returns point transformed by the linear part and the translation.
+    */
+    template<typename StorageType>
+    Vector<3, T> transformPoint(const Vector<3, T, StorageType>& point) const {
+        Vector<3, T> result;
+        AffineTransformUtil::transformPoint(mData, point.data(), result.data());
+        return result;
+    }
+
+    /**
+    Returns direction transformed by the linear part only.
+    */
+    template<typename StorageType>
+    Vector<3, T> transformDirection(const Vector<3, T, StorageType>& direction) const {
+        Vector<3, T> result;
+        AffineTransformUtil::transformDirection(mData, direction.data(), result.data());
+        return result;
+    }
+
+    /**
+    Transforms the count points in points and writes them to dest, which
+    may be points.
+    */
+    template<typename StorageType>
+    void transformPoints(const Vector<3, T, StorageType>* points, Vector<3, T>* dest, size_t count) const {
+        for (size_t k=0; k<count; ++k) {
+            AffineTransformUtil::transformPoint(mData, points[k].data(), dest[k].data());
+        }
+    }
+
+    /**
+    Transforms the count directions in directions and writes them to dest,
+    which may be directions.
+    */
+    template<typename StorageType>
+    void transformDirections(const Vector<3, T, StorageType>* directions, Vector<3, T>* dest, size_t count) const {
+        for (size_t k=0; k<count; ++k) {
+            AffineTransformUtil::transformDirection(mData, directions[k].data(), dest[k].data());
+        }
+    }
+
+    /**
+    Returns a string representation of the 3x4 matrix of the transform.
+    */
+    std::string toString() const {
+        return MatrixUtil::toString(mData, 3, 4);
+    }
+
+    /**
+    Returns a new transform set to the identity.
+    */
+    static ThisType identity() {
+        ThisType result;
+        AffineTransformUtil::identity(result.mData);
+        return result;
+    }
+
+private:
+    // row-major 3x4 elements [ L | t ]
+    T mData[12];
+};
+
+// create some useful typedefs
+typedef AffineTransform<double> AffineTransformd;
+typedef AffineTransform<float> AffineTransformf;
+
+} // end dkm namespace
+
+#endif
@@ -9,12 +9,34 @@
 
 #include <cmath>
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // darkma773r namespace
 namespace dkm {
 
+/**
+Order in which the elements of a Matrix are stored. ROW_MAJOR keeps each
+row together, so element (i, j) of an R x C matrix is at i*C + j.
+COLUMN_MAJOR keeps each column together, with element (i, j) at j*R + i,
+which is the order expected by OpenGL and most Fortran-derived numeric
+code.
+*/
+enum class MatrixLayout
+{
+    ROW_MAJOR,
+    COLUMN_MAJOR
+};
+
 /**
 Namespace containing commonly used matrix and vector operations.
 Unless otherwise noted, all functions in this namespace operate
@@ -87,6 +109,96 @@ size_t scalarMultiply(const T* a, T val, T* dest, size_t size) {
     return size;
 }
 
+/**
+Edge length, in elements, of the square tiles used by the transpose
+functions. A tile of the source and one of the destination fit in a 32KB
+L1 cache together for element types of up to 8 bytes.
+*/
+const size_t TRANSPOSE_TILE_SIZE = 32;
+
+/**
+Transposes the rows x cols block in src into dest one element at a time.
+Used for tiles and tile edges by the transpose functions.
+*/
+template<typename T>
+void _transposeTile(const T* src, size_t srcStride, size_t rows, size_t cols,
+                    T* dest, size_t destStride) {
+    for (int i=0; i<rows; ++i) {
+        for (int j=0; j<cols; ++j) {
+            dest[j*destStride + i] = src[i*srcStride + j];
+        }
+    }
+}
+
+#if defined(__SSE2__)
+/**
+Float tiles are transposed 4x4 at a time in SSE registers.
+*/
+inline void _transposeTile(const float* src, size_t srcStride, size_t rows, size_t cols,
+                           float* dest, size_t destStride) {
+    size_t rows4 = rows & ~static_cast<size_t>(3);
+    size_t cols4 = cols & ~static_cast<size_t>(3);
+    for (int i=0; i<rows4; i+=4) {
+        for (int j=0; j<cols4; j+=4) {
+            const float* s = src + i*srcStride + j;
+            __m128 r0 = _mm_loadu_ps(s);
+            __m128 r1 = _mm_loadu_ps(s + srcStride);
+            __m128 r2 = _mm_loadu_ps(s + 2*srcStride);
+            __m128 r3 = _mm_loadu_ps(s + 3*srcStride);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            float* d = dest + j*destStride + i;
+            _mm_storeu_ps(d, r0);
+            _mm_storeu_ps(d + destStride, r1);
+            _mm_storeu_ps(d + 2*destStride, r2);
+            _mm_storeu_ps(d + 3*destStride, r3);
+        }
+    }
+    // right and bottom edges
+    _transposeTile<float>(src + cols4, srcStride, rows4, cols - cols4, dest + cols4*destStride, destStride);
+    _transposeTile<float>(src + rows4*srcStride, srcStride, rows - rows4, cols, dest + rows4, destStride);
+}
+
+/**
+Double tiles are transposed 2x2 at a time in SSE registers.
+*/
+inline void _transposeTile(const double* src, size_t srcStride, size_t rows, size_t cols,
+                           double* dest, size_t destStride) {
+    size_t rows2 = rows & ~static_cast<size_t>(1);
+    size_t cols2 = cols & ~static_cast<size_t>(1);
+    for (int i=0; i<rows2; i+=2) {
+        for (int j=0; j<cols2; j+=2) {
+            const double* s = src + i*srcStride + j;
+            __m128d r0 = _mm_loadu_pd(s);
+            __m128d r1 = _mm_loadu_pd(s + srcStride);
+            double* d = dest + j*destStride + i;
+            _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+            _mm_storeu_pd(d + destStride, _mm_unpackhi_pd(r0, r1));
+        }
+    }
+    // right and bottom edges
+    _transposeTile<double>(src + cols2, srcStride, rows2, cols - cols2, dest + cols2*destStride, destStride);
+    _transposeTile<double>(src + rows2*srcStride, srcStride, rows - rows2, cols, dest + rows2, destStride);
+}
+#endif
+
+/**
+Transposes the rows x cols block in src into dest tile by tile, so that
+both the reads and the scattered writes stay within a few cache lines and
+pages at a time.
+*/
+template<typename T>
+void _transposeBlocked(const T* src, size_t srcStride, size_t rows, size_t cols,
+                       T* dest, size_t destStride) {
+    for (size_t i=0; i<rows; i+=TRANSPOSE_TILE_SIZE) {
+        size_t tileRows = std::min(TRANSPOSE_TILE_SIZE, rows - i);
+        for (size_t j=0; j<cols; j+=TRANSPOSE_TILE_SIZE) {
+            size_t tileCols = std::min(TRANSPOSE_TILE_SIZE, cols - j);
+            _transposeTile(src + i*srcStride + j, srcStride, tileRows, tileCols,
+                           dest + j*destStride + i, destStride);
+        }
+    }
+}
+
 /**
 Treats the src array as a matrix with rows number of rows and cols
 number of columns and writes the transposed matrix to dest. The dest
@@ -94,15 +206,73 @@ array will then contain a matrix with cols number of rows and rows
 number of columns. The caller is responsible for making sure that dest
 is large enough to contain at least rows*cols number of elements. The function
 returns the number of elements written to dest, which is equal to rows*cols.
+The src and dest arrays must not overlap; see transposeInPlace() for that.
+The work is done in tiles of TRANSPOSE_TILE_SIZE x TRANSPOSE_TILE_SIZE
+elements.
 */
 template<typename T>
 size_t transpose(const T* src, size_t rows, size_t cols, T* dest) {
-    for (int i=0; i<rows; ++i) {
-        for (int j=0; j<cols; ++j) {
-            dest[j*rows + i] = src[i*cols + j];
+    _transposeBlocked(src, cols, rows, cols, dest, rows);
+    return rows * cols;
+}
+
+/**
+Transposes the dimension x dimension matrix in data in place by swapping
+pairs of tiles across the diagonal. Returns the number of elements in the
+matrix.
+*/
+template<typename T>
+size_t transposeInPlace(T* data, size_t dimension) {
+    for (size_t ib=0; ib<dimension; ib+=TRANSPOSE_TILE_SIZE) {
+        size_t iEnd = std::min(ib + TRANSPOSE_TILE_SIZE, dimension);
+        for (size_t jb=ib; jb<dimension; jb+=TRANSPOSE_TILE_SIZE) {
+            size_t jEnd = std::min(jb + TRANSPOSE_TILE_SIZE, dimension);
+            for (size_t i=ib; i<iEnd; ++i) {
+                // on a diagonal tile only the elements above the diagonal are swapped
+                for (size_t j=std::max(jb, i + 1); j<jEnd; ++j) {
+                    std::swap(data[i*dimension + j], data[j*dimension + i]);
+                }
+            }
         }
     }
-    return rows * cols;
+    return dimension * dimension;
+}
+
+/**
+Transposes the rows x cols matrix in data in place, leaving a cols x rows
+matrix. Square matrices are handed to the two argument version. Otherwise
+the element at index k moves to index k*rows mod (rows*cols - 1), and each
+cycle of that permutation is followed once, moving every element straight
+to its final position. Besides the matrix, this uses one bit of scratch
+memory per element to remember which elements have been moved. Returns
+the number of elements in the matrix.
+*/
+template<typename T>
+size_t transposeInPlace(T* data, size_t rows, size_t cols) {
+    if (rows == cols) {
+        return transposeInPlace(data, rows);
+    }
+
+    size_t size = rows * cols;
+    if (rows < 2 || cols < 2) {
+        return size; // a single row or column is its own transpose
+    }
+
+    // the first and last elements never move
+    std::vector<bool> moved(size, false);
+    for (size_t start=1; start<size-1; ++start) {
+        if (moved[start]) {
+            continue;
+        }
+        T val = data[start];
+        size_t k = start;
+        do {
+            k = (k * rows) % (size - 1);
+            std::swap(val, data[k]);
+            moved[k] = true;
+        } while (k != start);
+    }
+    return size;
 }
 
 /**
@@ -137,6 +307,64 @@ size_t matrixMultiply(const T* a, size_t aRows, size_t aCols,
     return aRows * bCols;
 }
 
+/**
+Multiplies the aRows x aCols matrix A by the transpose of the bRows x aCols
+matrix B and writes the aRows x bRows result to out, i.e. out = A * B^T.
+Both matrices are read along their rows, so no transposed copy of B is
+needed. The out array must not overlap A or B. The function returns the
+number of elements written to out, which is aRows*bRows in normal
+situations but will be zero if any of the given matrix dimensions are
+invalid (i.e. less than 1).
+*/
+template<typename T>
+size_t matrixMultiplyTransposed(const T* a, size_t aRows, size_t aCols,
+                                const T* b, size_t bRows,
+                                T* out) {
+    if (aRows < 1 || aCols < 1 || bRows < 1) {
+        return 0; // invalid dimensions
+    }
+
+    for (int i=0; i<aRows; ++i) {
+        for (int j=0; j<bRows; ++j) {
+            T val = static_cast<T>(0);
+            for (int m=0; m<aCols; ++m) {
+                val = val + a[i*aCols + m] * b[j*aCols + m];
+            }
+            out[i*bRows + j] = val;
+        }
+    }
+    return aRows * bRows;
+}
+
+/**
+Multiplies the transpose of the aRows x aCols matrix A by the aRows x bCols
+matrix B and writes the aCols x bCols result to out, i.e. out = A^T * B.
+Each row of A is combined with the matching row of B, so both are read
+along their rows. The out array must not overlap A or B. The function
+returns the number of elements written to out, which is aCols*bCols in
+normal situations but will be zero if any of the given matrix dimensions
+are invalid (i.e. less than 1).
+*/
+template<typename T>
+size_t transposedMatrixMultiply(const T* a, size_t aRows, size_t aCols,
+                                const T* b, size_t bCols,
+                                T* out) {
+    if (aRows < 1 || aCols < 1 || bCols < 1) {
+        return 0; // invalid dimensions
+    }
+
+    set(out, static_cast<T>(0), aCols * bCols);
+    for (int m=0; m<aRows; ++m) {
+        for (int i=0; i<aCols; ++i) {
+            T aVal = a[m*aCols + i];
+            for (int j=0; j<bCols; ++j) {
+                out[i*bCols + j] = out[i*bCols + j] + aVal * b[m*bCols + j];
+            }
+        }
+    }
+    return aCols * bCols;
+}
+
 /**
 Creates an identity matrix in dest of size dimension x dimension.
 Returns the number of elements written into dest.  
@@ -152,460 +380,1786 @@ size_t identity(size_t dimension, T* dest){
 }
 
 /**
-Returns the magnitude of the vector in the vec array with size number of
-elements.
+The following overloads operate on rows x cols blocks that may be part
+of a larger row-major matrix. Each block is given by a pointer to its
+first element and a stride, the number of elements between the starts
+of consecutive rows. A block that spans whole rows of its matrix has a
+stride equal to cols and is contiguous; when every block involved is
+contiguous the overloads hand the whole array to the plain kernels
+above. Otherwise the work is done one row at a time. As with the plain
+kernels, the return value is the number of elements written to dest.
+*/
+
+/**
+Copies a rows x cols block from src to dest.
 */
 template<typename T>
-double vectorMagnitude(const T* vec, size_t size) {
-    double mag = 0.0;
-    for (int i=0; i<size; ++i) {
-        mag = mag + (vec[i] * vec[i]);
+size_t copy(const T* src, size_t srcStride, T* dest, size_t destStride,
+            size_t rows, size_t cols) {
+    if (srcStride == cols && destStride == cols) {
+        return copy(src, dest, rows * cols);
     }
-    return sqrt(mag);
+    for (int i=0; i<rows; ++i) {
+        copy(src + i*srcStride, dest + i*destStride, cols);
+    }
+    return rows * cols;
 }
 
 /**
-Returns true if the given vector is normalized with the given
-epsilon range.
+Sets every element of a rows x cols block in dest to val.
 */
 template<typename T>
-bool isVectorNormalized(const T* vec, size_t size, double epsilon) {
-    T total = static_cast<T>(0);
-    for (int i=0; i<size; i++) {
-        total = total + (vec[i] * vec[i]);
+size_t set(T* dest, size_t destStride, T val, size_t rows, size_t cols) {
+    if (destStride == cols) {
+        return set(dest, val, rows * cols);
     }
-    return std::abs(1.0 - total) < epsilon;
+    for (int i=0; i<rows; ++i) {
+        set(dest + i*destStride, val, cols);
+    }
+    return rows * cols;
 }
 
 /**
-The default value to use when calling isVectorNormalized
+Adds the rows x cols blocks A and B and places the result in dest.
 */
-const double DEFAULT_NORMALIZED_EPSILON = 1e-6;
+template<typename T>
+size_t add(const T* a, size_t aStride, const T* b, size_t bStride,
+           T* dest, size_t destStride, size_t rows, size_t cols) {
+    if (aStride == cols && bStride == cols && destStride == cols) {
+        return add(a, b, dest, rows * cols);
+    }
+    for (int i=0; i<rows; ++i) {
+        add(a + i*aStride, b + i*bStride, dest + i*destStride, cols);
+    }
+    return rows * cols;
+}
 
 /**
-Returns true if the given vector is normalized within the
-DefaultNormalizedDelta range.
+Subtracts the rows x cols block B from A and places the result in dest.
 */
 template<typename T>
-bool isVectorNormalized(const T* vec, size_t size) {
-    return isVectorNormalized(vec, size, DEFAULT_NORMALIZED_EPSILON);
+size_t subtract(const T* a, size_t aStride, const T* b, size_t bStride,
+                T* dest, size_t destStride, size_t rows, size_t cols) {
+    if (aStride == cols && bStride == cols && destStride == cols) {
+        return subtract(a, b, dest, rows * cols);
+    }
+    for (int i=0; i<rows; ++i) {
+        subtract(a + i*aStride, b + i*bStride, dest + i*destStride, cols);
+    }
+    return rows * cols;
 }
 
 /**
-Normalizes the vector with size number of elements found in
-the src array and places the results in dest. Returns the
-number of elements written to dest. If the vector cannot be
-normalized (i.e., it's magnitude is zero), zero is returned.
+Multiplies every element of the rows x cols block A by val and places
+the result in dest.
 */
 template<typename T>
-size_t vectorNormalize(const T* src, size_t size, T* dest) {
-    double mag = vectorMagnitude(src, size);
-    if (mag > 0.0) {
-        for (int i=0; i<size; ++i) {
-            dest[i] = src[i] / mag;
+size_t scalarMultiply(const T* a, size_t aStride, T val, T* dest, size_t destStride,
+                      size_t rows, size_t cols) {
+    if (aStride == cols && destStride == cols) {
+        return scalarMultiply(a, val, dest, rows * cols);
+    }
+    for (int i=0; i<rows; ++i) {
+        scalarMultiply(a + i*aStride, val, dest + i*destStride, cols);
+    }
+    return rows * cols;
+}
+
+/**
+Writes the transpose of the rows x cols block in src to the cols x rows
+block in dest.
+*/
+template<typename T>
+size_t transpose(const T* src, size_t srcStride, size_t rows, size_t cols,
+                 T* dest, size_t destStride) {
+    _transposeBlocked(src, srcStride, rows, cols, dest, destStride);
+    return rows * cols;
+}
+
+/**
+Multiplies the aRows x aCols block A by the aCols x bCols block B and
+writes the aRows x bCols result to the block in out, which must not
+overlap A or B. Returns zero if any dimension is less than 1.
+*/
+template<typename T>
+size_t matrixMultiply(const T* a, size_t aRows, size_t aCols, size_t aStride,
+                      const T* b, size_t bCols, size_t bStride,
+                      T* out, size_t outStride) {
+    if (aStride == aCols && bStride == bCols && outStride == bCols) {
+        return matrixMultiply(a, aRows, aCols, b, bCols, out);
+    }
+    if (aRows < 1 || aCols < 1 || bCols < 1) {
+        return 0; // invalid dimensions
+    }
+
+    for (int i=0; i<aRows; ++i) {
+        for (int j=0; j<bCols; ++j) {
+            T val = static_cast<T>(0);
+            for (int m=0; m<aCols; ++m) {
+                val = val + a[i*aStride + m] * b[m*bStride + j];
+            }
+            out[i*outStride + j] = val;
         }
-        return size;
     }
-    return 0;
+    return aRows * bCols;
 }
 
 /**
-Returns the dot product of the vectors with size elements
-found in arrays A and B.
+Strided version of matrixMultiplyTransposed(): writes A * B^T for the
+aRows x aCols block A and the bRows x aCols block B to the aRows x bRows
+block in out, which must not overlap A or B.
 */
 template<typename T>
-double vectorDotProduct(const T* a, const T* b, size_t size) {
-    double dot = 0.0;
-    for (int i=0; i<size; ++i) {
-        dot = dot + (a[i] * b[i]);
+size_t matrixMultiplyTransposed(const T* a, size_t aRows, size_t aCols, size_t aStride,
+                                const T* b, size_t bRows, size_t bStride,
+                                T* out, size_t outStride) {
+    if (aStride == aCols && bStride == aCols && outStride == bRows) {
+        return matrixMultiplyTransposed(a, aRows, aCols, b, bRows, out);
     }
-    return dot;
+    if (aRows < 1 || aCols < 1 || bRows < 1) {
+        return 0; // invalid dimensions
+    }
+
+    for (int i=0; i<aRows; ++i) {
+        for (int j=0; j<bRows; ++j) {
+            T val = static_cast<T>(0);
+            for (int m=0; m<aCols; ++m) {
+                val = val + a[i*aStride + m] * b[j*bStride + m];
+            }
+            out[i*outStride + j] = val;
+        }
+    }
+    return aRows * bRows;
 }
 
 /**
-Calculates the cross product of the vectors with 3 elements
-found in the arrays A and B and places the result in dest.
-Since the cross product is only defined on vectors with 3 elements,
-this method accepts no size parameter. Retuns the number of
-elements written to dest, which will always be 3.
+Strided version of transposedMatrixMultiply(): writes A^T * B for the
+aRows x aCols block A and the aRows x bCols block B to the aCols x bCols
+block in out, which must not overlap A or B.
 */
 template<typename T>
-size_t vectorCrossProduct(const T* a, const T* b, T* dest) {
-    dest[0] = a[1]*b[2] - a[2]*b[1];
-    dest[1] = a[2]*b[0] - a[0]*b[2];
-    dest[2] = a[0]*b[1] - a[1]*b[0];
+size_t transposedMatrixMultiply(const T* a, size_t aRows, size_t aCols, size_t aStride,
+                                const T* b, size_t bCols, size_t bStride,
+                                T* out, size_t outStride) {
+    if (aStride == aCols && bStride == bCols && outStride == bCols) {
+        return transposedMatrixMultiply(a, aRows, aCols, b, bCols, out);
+    }
+    if (aRows < 1 || aCols < 1 || bCols < 1) {
+        return 0; // invalid dimensions
+    }
 
-    return 3;
+    set(out, outStride, static_cast<T>(0), aCols, bCols);
+    for (int m=0; m<aRows; ++m) {
+        for (int i=0; i<aCols; ++i) {
+            T aVal = a[m*aStride + i];
+            for (int j=0; j<bCols; ++j) {
+                out[i*outStride + j] = out[i*outStride + j] + aVal * b[m*bStride + j];
+            }
+        }
+    }
+    return aCols * bCols;
 }
 
 /**
-Returns a string representation of a matrix with rows number of rows
-and cols number of columns from the src array.
+The following overloads take a row stride and a column stride for each
+matrix, the number of elements between vertically and horizontally
+adjacent elements. A row-major matrix has strides (cols, 1), a
+column-major one (1, rows) and a transposed view swaps the strides of
+its source, so any mix of layouts can be handled without copying. The
+work is passed to the kernels above whenever the strides match one of
+their access patterns.
+*/
+
+/**
+Copies a rows x cols matrix from src to dest, changing its layout if
+the strides differ. src and dest must not overlap.
 */
 template<typename T>
-std::string toString(const T* src, size_t rows, size_t cols) {
-    int size = rows * cols;
+size_t copy(const T* src, size_t srcRowStride, size_t srcColStride,
+            T* dest, size_t destRowStride, size_t destColStride,
+            size_t rows, size_t cols) {
+    if (srcColStride == 1 && destColStride == 1) {
+        return copy(src, srcRowStride, dest, destRowStride, rows, cols);
+    }
+    if (srcRowStride == 1 && destRowStride == 1) {
+        return copy(src, srcColStride, dest, destColStride, cols, rows);
+    }
+    if (srcColStride == 1 && destRowStride == 1) {
+        return transpose(src, srcRowStride, rows, cols, dest, destColStride);
+    }
+    if (srcRowStride == 1 && destColStride == 1) {
+        return transpose(src, srcColStride, cols, rows, dest, destRowStride);
+    }
+    for (int i=0; i<rows; ++i) {
+        for (int j=0; j<cols; ++j) {
+            dest[i*destRowStride + j*destColStride] = src[i*srcRowStride + j*srcColStride];
+        }
+    }
+    return rows * cols;
+}
 
-    std::stringstream ss;
-    ss << std::fixed;
-    ss.precision(2);
+/**
+Element-wise loop shared by the mixed-stride add() and subtract(). Walks
+dest in storage order.
+*/
+template<typename T, typename Op>
+size_t _elementWise(const T* a, size_t aRowStride, size_t aColStride,
+                    const T* b, size_t bRowStride, size_t bColStride,
+                    T* dest, size_t destRowStride, size_t destColStride,
+                    size_t rows, size_t cols, Op op) {
+    if (destColStride == 1) {
+        for (int i=0; i<rows; ++i) {
+            for (int j=0; j<cols; ++j) {
+                dest[i*destRowStride + j] = op(a[i*aRowStride + j*aColStride], b[i*bRowStride + j*bColStride]);
+            }
+        }
+    } else {
+        for (int j=0; j<cols; ++j) {
+            for (int i=0; i<rows; ++i) {
+                dest[i*destRowStride + j*destColStride] = op(a[i*aRowStride + j*aColStride],
+                                                             b[i*bRowStride + j*bColStride]);
+            }
+        }
+    }
+    return rows * cols;
+}
 
-    ss << "[";
+/**
+Adds the rows x cols matrices A and B and places the result in dest.
+*/
+template<typename T>
+size_t add(const T* a, size_t aRowStride, size_t aColStride,
+           const T* b, size_t bRowStride, size_t bColStride,
+           T* dest, size_t destRowStride, size_t destColStride,
+           size_t rows, size_t cols) {
+    if (aColStride == 1 && bColStride == 1 && destColStride == 1) {
+        return add(a, aRowStride, b, bRowStride, dest, destRowStride, rows, cols);
+    }
+    if (aRowStride == 1 && bRowStride == 1 && destRowStride == 1) {
+        return add(a, aColStride, b, bColStride, dest, destColStride, cols, rows);
+    }
+    return _elementWise(a, aRowStride, aColStride, b, bRowStride, bColStride,
+                        dest, destRowStride, destColStride, rows, cols, std::plus<T>());
+}
 
-    for (int i=0; i<size; ++i) {
-        if (i > 0 && i % cols == 0) {
-            ss << "\n ";
+/**
+Subtracts the rows x cols matrix B from A and places the result in dest.
+*/
+template<typename T>
+size_t subtract(const T* a, size_t aRowStride, size_t aColStride,
+                const T* b, size_t bRowStride, size_t bColStride,
+                T* dest, size_t destRowStride, size_t destColStride,
+                size_t rows, size_t cols) {
+    if (aColStride == 1 && bColStride == 1 && destColStride == 1) {
+        return subtract(a, aRowStride, b, bRowStride, dest, destRowStride, rows, cols);
+    }
+    if (aRowStride == 1 && bRowStride == 1 && destRowStride == 1) {
+        return subtract(a, aColStride, b, bColStride, dest, destColStride, cols, rows);
+    }
+    return _elementWise(a, aRowStride, aColStride, b, bRowStride, bColStride,
+                        dest, destRowStride, destColStride, rows, cols, std::minus<T>());
+}
+
+/**
+Multiplies the aRows x aCols matrix A by the aCols x bCols matrix B and
+writes the aRows x bCols result to out, which must not overlap A or B.
+A column-major result is computed as out^T = B^T * A^T. Each combination
+of row-major and transposed operands is handed to matrixMultiply(),
+matrixMultiplyTransposed() or transposedMatrixMultiply(), so that both
+operands are read along their storage rows. Returns zero if any
+dimension is less than 1.
+*/
+template<typename T>
+inline size_t matrixMultiply(const T* a, size_t aRows, size_t aCols, size_t aRowStride, size_t aColStride,
+                      const T* b, size_t bCols, size_t bRowStride, size_t bColStride,
+                      T* out, size_t outRowStride, size_t outColStride) {
+    if (aRows < 1 || aCols < 1 || bCols < 1) {
+        return 0; // invalid dimensions
+    }
+    if (outColStride != 1 && outRowStride == 1) {
+        // swap the operands in place rather than recursing so that the
+        // whole call can still be inlined for fixed-size matrices
+        std::swap(a, b);
+        std::swap(aRows, bCols);
+        std::swap(aRowStride, bColStride);
+        std::swap(aColStride, bRowStride);
+        std::swap(outRowStride, outColStride);
+    }
+
+    if (outColStride == 1) {
+        if (aColStride == 1 && bColStride == 1) {
+            return matrixMultiply(a, aRows, aCols, aRowStride, b, bCols, bRowStride, out, outRowStride);
         }
-        ss << " " << src[i];
-        if (i < size - 1) {
-            ss << ",";
+        if (aColStride == 1 && bRowStride == 1) {
+            return matrixMultiplyTransposed(a, aRows, aCols, aRowStride, b, bCols, bColStride, out, outRowStride);
         }
+        if (aRowStride == 1 && bColStride == 1) {
+            return transposedMatrixMultiply(a, aCols, aRows, aColStride, b, bCols, bRowStride, out, outRowStride);
+        }
+    }
+
+    for (int i=0; i<aRows; ++i) {
+        for (int j=0; j<bCols; ++j) {
+            T val = static_cast<T>(0);
+            for (int m=0; m<aCols; ++m) {
+                val = val + a[i*aRowStride + m*aColStride] * b[m*bRowStride + j*bColStride];
+            }
+            out[i*outRowStride + j*outColStride] = val;
+        }
+    }
+    return aRows * bCols;
+}
+
+/**
+Returns the row stride of a matrix with the given number of columns, stored
+with the given layout.
+*/
+inline size_t rowStride(MatrixLayout layout, size_t cols) {
+    return (layout == MatrixLayout::ROW_MAJOR) ? cols : 1;
+}
+
+/**
+Returns the column stride of a matrix with the given number of rows, stored
+with the given layout.
+*/
+inline size_t colStride(MatrixLayout layout, size_t rows) {
+    return (layout == MatrixLayout::ROW_MAJOR) ? 1 : rows;
+}
+
+/**
+Copies the rows x cols matrix in src to dest, converting between layouts
+with a transpose if they differ.
+*/
+template<typename T>
+size_t copy(const T* src, MatrixLayout srcLayout, T* dest, MatrixLayout destLayout,
+            size_t rows, size_t cols) {
+    return copy(src, rowStride(srcLayout, cols), colStride(srcLayout, rows),
+                dest, rowStride(destLayout, cols), colStride(destLayout, rows),
+                rows, cols);
+}
+
+/**
+Adds the rows x cols matrices A and B, each in its own layout, and places
+the result in dest.
+*/
+template<typename T>
+size_t add(const T* a, MatrixLayout aLayout, const T* b, MatrixLayout bLayout,
+           T* dest, MatrixLayout destLayout, size_t rows, size_t cols) {
+    return add(a, rowStride(aLayout, cols), colStride(aLayout, rows),
+               b, rowStride(bLayout, cols), colStride(bLayout, rows),
+               dest, rowStride(destLayout, cols), colStride(destLayout, rows),
+               rows, cols);
+}
+
+/**
+Subtracts the rows x cols matrix B from A, each in its own layout, and
+places the result in dest.
+*/
+template<typename T>
+size_t subtract(const T* a, MatrixLayout aLayout, const T* b, MatrixLayout bLayout,
+                T* dest, MatrixLayout destLayout, size_t rows, size_t cols) {
+    return subtract(a, rowStride(aLayout, cols), colStride(aLayout, rows),
+                    b, rowStride(bLayout, cols), colStride(bLayout, rows),
+                    dest, rowStride(destLayout, cols), colStride(destLayout, rows),
+                    rows, cols);
+}
+
+/**
+Multiplies the aRows x aCols matrix A by the aCols x bCols matrix B, each
+in its own layout, and writes the aRows x bCols result to out in
+outLayout. out must not overlap A or B.
+*/
+template<typename T>
+size_t matrixMultiply(const T* a, MatrixLayout aLayout, size_t aRows, size_t aCols,
+                      const T* b, MatrixLayout bLayout, size_t bCols,
+                      T* out, MatrixLayout outLayout) {
+    return matrixMultiply(a, aRows, aCols, rowStride(aLayout, aCols), colStride(aLayout, aRows),
+                          b, bCols, rowStride(bLayout, bCols), colStride(bLayout, aCols),
+                          out, rowStride(outLayout, bCols), colStride(outLayout, aRows));
+}
+
+/**
+Returns the magnitude of the vector in the vec array with size number of
+elements.
+*/
+template<typename T>
+double vectorMagnitude(const T* vec, size_t size) {
+    double mag = 0.0;
+    for (int i=0; i<size; ++i) {
+        mag = mag + (vec[i] * vec[i]);
+    }
+    return sqrt(mag);
+}
+
+/**
+Returns true if the given vector is normalized with the given
+epsilon range.
+*/
+template<typename T>
+bool isVectorNormalized(const T* vec, size_t size, double epsilon) {
+    T total = static_cast<T>(0);
+    for (int i=0; i<size; i++) {
+        total = total + (vec[i] * vec[i]);
+    }
+    return std::abs(1.0 - total) < epsilon;
+}
+
+/**
+The default value to use when calling isVectorNormalized
+*/
+const double DEFAULT_NORMALIZED_EPSILON = 1e-6;
+
+/**
+Returns true if the given vector is normalized within the
+DefaultNormalizedDelta range.
+*/
+template<typename T>
+bool isVectorNormalized(const T* vec, size_t size) {
+    return isVectorNormalized(vec, size, DEFAULT_NORMALIZED_EPSILON);
+}
+
+/**
+Normalizes the vector with size number of elements found in
+the src array and places the results in dest. Returns the
+number of elements written to dest. If the vector cannot be
+normalized (i.e., it's magnitude is zero), zero is returned.
+*/
+template<typename T>
+size_t vectorNormalize(const T* src, size_t size, T* dest) {
+    double mag = vectorMagnitude(src, size);
+    if (mag > 0.0) {
+        for (int i=0; i<size; ++i) {
+            dest[i] = src[i] / mag;
+        }
+        return size;
+    }
+    return 0;
+}
+
+/**
+Returns the dot product of the vectors with size elements
+found in arrays A and B.
+*/
+template<typename T>
+double vectorDotProduct(const T* a, const T* b, size_t size) {
+    double dot = 0.0;
+    for (int i=0; i<size; ++i) {
+        dot = dot + (a[i] * b[i]);
+    }
+    return dot;
+}
+
+/**
+Calculates the cross product of the vectors with 3 elements
+found in the arrays A and B and places the result in dest.
+Since the cross product is only defined on vectors with 3 elements,
+this method accepts no size parameter. Retuns the number of
+elements written to dest, which will always be 3.
+*/
+template<typename T>
+size_t vectorCrossProduct(const T* a, const T* b, T* dest) {
+    dest[0] = a[1]*b[2] - a[2]*b[1];
+    dest[1] = a[2]*b[0] - a[0]*b[2];
+    dest[2] = a[0]*b[1] - a[1]*b[0];
+
+    return 3;
+}
+
+/**
+Returns a string representation of a matrix with rows number of rows
+and cols number of columns from the src array.
+*/
+template<typename T>
+std::string toString(const T* src, size_t rows, size_t cols) {
+    int size = rows * cols;
+
+    std::stringstream ss;
+    ss << std::fixed;
+    ss.precision(2);
+
+    ss << "[";
+
+    for (int i=0; i<size; ++i) {
+        if (i > 0 && i % cols == 0) {
+            ss << "\n ";
+        }
+        ss << " " << src[i];
+        if (i < size - 1) {
+            ss << ",";
+        }
+    }
+    ss << " ]";
+
+    return ss.str();
+}
+
+} // end namespace MatrixUtil
+
+/**
+Storage policy for classes that keep their elements in an internal
+array. Constructing from an element pointer copies the elements.
+*/
+template<unsigned int SizeArg, typename T>
+class _ArrayStorage {
+public:
+    typedef T Element;
+    typedef T* Pointer;
+    typedef T& Reference;
+    typedef const T* InitPointer;
+
+protected:
+    // internal data array
+    T mData[SizeArg];
+
+    /**
+    If elements is NULL, every element in the internal array
+    is set to the zero representation of type T. Otherwise,
+    the data from elements is copied into the internal array.
+    */
+    _ArrayStorage(InitPointer elements) {
+        if (elements != NULL) {
+            MatrixUtil::copy(elements, mData, SizeArg);
+        } else {
+            MatrixUtil::set(mData, static_cast<T>(0), SizeArg);
+        }
+    }
+};
+
+/**
+Storage policy for classes that operate directly on memory owned by
+the caller. T may be const, in which case the elements can be read
+but not written. Nothing is copied on construction; the caller must
+keep the memory alive for as long as the object uses it.
+*/
+template<typename T>
+class _MappedStorage {
+public:
+    typedef T Element;
+    typedef T* Pointer;
+    typedef T& Reference;
+    typedef T* InitPointer;
+
+protected:
+    // caller-owned elements
+    T* mData;
+
+    _MappedStorage(InitPointer elements) : mData(elements) { }
+};
+
+/**
+Base type for classes that contain an array of elements. The elements
+are either held internally (_ArrayStorage) or mapped from caller memory
+(_MappedStorage). Assignment always copies elements, so assigning to a
+mapped object writes through to the mapped memory. Operations that
+produce a new object return ValueType, which always owns its elements.
+The template uses the "Curiously Recurring Template Pattern", aka
+CRTP (see http://en.wikipedia.org/wiki/Curiously_recurring_template_pattern)
+*/
+template<unsigned int SizeArg, typename T, typename DerivedType, typename ValueType,
+         typename StorageType = _ArrayStorage<SizeArg, T> >
+class _ElementArrayBase : public StorageType {
+
+    typedef _ElementArrayBase<SizeArg, T, DerivedType, ValueType, StorageType> ThisType;
+
+protected:
+    /**
+    Protected constructor for use in derived classes. Depending on
+    StorageType, elements is either copied or mapped.
+    */
+    _ElementArrayBase(typename StorageType::InitPointer elements = NULL) : StorageType(elements) { }
+
+public:
+    virtual ~_ElementArrayBase() { }
+
+    /**
+    Copies the elements of other into this object.
+    */
+    ThisType& operator=(const ThisType& other) {
+        copyFrom(other.data());
+        return *this;
+    }
+    template<typename OtherDerived, typename OtherStorage>
+    DerivedType& operator=(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) {
+        copyFrom(other.data());
+        return *static_cast<DerivedType*>(this);
+    }
+
+    /**
+    Returns a pointer to the element array.
+    */
+    typename StorageType::Pointer data() {
+        return this->mData;
+    }
+    const T* data() const {
+        return this->mData;
+    }
+
+    /**
+    Returns the size of the element array.
+    */
+    size_t size() const {
+        return SizeArg;
+    }
+
+    /**
+    Copies the entirety of the element array to dest. The caller is responsible
+    for making sure that dest is large enough to contain the copied data.
+    */
+    void copyTo(T* dest) const {
+        MatrixUtil::copy(data(), dest, SizeArg);
+    }
+
+    /**
+    Copies data from src into the element array.
+    */
+    void copyFrom(const T* src) {
+        MatrixUtil::copy(src, this->mData, SizeArg);
+    }
+
+    /**
+    Same as add() but assigns the answer to the caller. This can be used to
+    avoid unneccessary copying of array data.
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    void addAssign(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) {
+        MatrixUtil::add(data(), other.data(), this->mData, SizeArg);
+    }
+    /**
+    Adds the elements from the argument and the caller and returns a new object
+    with the results.
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    ValueType add(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) const {
+        ValueType result(data());
+        MatrixUtil::add(data(), other.data(), result.data(), SizeArg);
+        return result;
+    }
+    /**
+    Alias for add()
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    ValueType operator+(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) const {
+        return add(other);
+    }
+    /**
+    Alias for addAssign()
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    DerivedType& operator+=(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) {
+        addAssign(other);
+        return *static_cast<DerivedType*>(this);
+    }
+
+    /**
+    Same as subtract() but assigns the answer to the caller. This can be used to
+    avoid unneccessary copying of array data.
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    void subtractAssign(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) {
+        MatrixUtil::subtract(data(), other.data(), this->mData, SizeArg);
+    }
+    /**
+    Adds the elements of the argument from the caller and returns a new element-based object
+    with the results.
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    ValueType subtract(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) const {
+        ValueType result(data());
+        MatrixUtil::subtract(data(), other.data(), result.data(), SizeArg);
+        return result;
+    }
+    /**
+    Alias for Subtract()
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    ValueType operator-(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) const {
+        return subtract(other);
+    }
+    /**
+    Alias for subtractAssign()
+    */
+    template<typename OtherDerived, typename OtherStorage>
+    DerivedType& operator-=(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) {
+        subtractAssign(other);
+        return *static_cast<DerivedType*>(this);
+    }
+
+    /**
+    Same as scalarMultiply() but assigns the answer to the caller. This can be
+    used to avoid unneccessary copying of array data.
+    */
+    void scalarMultiplyAssign(T val) {
+        MatrixUtil::scalarMultiply(data(), val, this->mData, SizeArg);
+    }
+    /**
+    Multiplies every element of the array by val and returns a new element-based object
+    with the results.
+    */
+    ValueType scalarMultiply(T val) const {
+        ValueType result(data());
+        MatrixUtil::scalarMultiply(data(), val, result.data(), SizeArg);
+        return result;
+    }
+    /**
+    Alias for scalarMultiply()
+    */
+    ValueType operator*(T val) const {
+        return scalarMultiply(val);
+    }
+    /**
+    Alias for scalarMultiplyAssign()
+    */
+    DerivedType& operator*=(T val) {
+        scalarMultiplyAssign(val);
+        return *static_cast<DerivedType*>(this);
+    }
+};
+
+// forward-declare Vector class
+template<unsigned int SizeArg, typename T = double, typename StorageType = _ArrayStorage<SizeArg, T> >
+class Vector;
+
+// forward-declare MatrixBlock class
+template<unsigned int RowsArg, unsigned int ColsArg, typename T = double>
+class MatrixBlock;
+
+// forward-declare MatrixTranspose class
+template<unsigned int RowsArg, unsigned int ColsArg, typename T = double>
+class MatrixTranspose;
+
+// forward-declare Matrix class
+template<unsigned int RowsArg, unsigned int ColsArg, typename T = double,
+         MatrixLayout LayoutArg = MatrixLayout::ROW_MAJOR,
+         typename StorageType = _ArrayStorage<RowsArg * ColsArg, T> >
+class Matrix;
+
+/**
+Selects the type returned by Matrix::transpose() for a RowsArg x ColsArg
+source in the given layout. A row-major source is read through a
+MatrixTranspose view. The elements of a column-major source are already
+the row-major elements of its transpose, so it is returned as a read-only
+row-major map of the same memory.
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, typename T, MatrixLayout LayoutArg>
+struct _TransposeView {
+    typedef MatrixTranspose<ColsArg, RowsArg, T> Type;
+
+    static Type create(const T* source) {
+        return Type(source, ColsArg);
+    }
+};
+template<unsigned int RowsArg, unsigned int ColsArg, typename T>
+struct _TransposeView<RowsArg, ColsArg, T, MatrixLayout::COLUMN_MAJOR> {
+    typedef Matrix<ColsArg, RowsArg, T, MatrixLayout::ROW_MAJOR, _MappedStorage<const T> > Type;
+
+    static Type create(const T* source) {
+        return Type(source);
+    }
+};
+
+/**
+Template class representing a RowsArg x ColsArg matrix of type T. With the
+default StorageType the Matrix owns its elements; see MatrixMap for a Matrix
+over caller memory. LayoutArg gives the order of the elements in memory;
+see MatrixLayout. Element access, arithmetic and multiplication all
+honor the layout, and operands of different layouts can be combined
+directly, with the result taking the layout of the left operand:
+
+    Matrix<4, 4, float, MatrixLayout::COLUMN_MAJOR> view = ...;
+    Matrix<4, 4, float> model = ...;
+    Matrix<4, 4, float, MatrixLayout::COLUMN_MAJOR> modelView = view * model;
+    glUniformMatrix4fv(location, 1, GL_FALSE, modelView.data());
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, typename T, MatrixLayout LayoutArg, typename StorageType>
+class Matrix : public _ElementArrayBase<RowsArg * ColsArg, T, Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType>,
+                                        Matrix<RowsArg, ColsArg, T, LayoutArg>, StorageType> {
+
+    typedef Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType> ThisType;
+    typedef Matrix<RowsArg, ColsArg, T, LayoutArg> ValueType;
+    typedef _ElementArrayBase<RowsArg * ColsArg, T, ThisType, ValueType, StorageType> SuperType;
+
+    static constexpr MatrixLayout OTHER_LAYOUT =
+        (LayoutArg == MatrixLayout::ROW_MAJOR) ? MatrixLayout::COLUMN_MAJOR : MatrixLayout::ROW_MAJOR;
+    static constexpr bool IS_OWNING = std::is_same<StorageType, _ArrayStorage<RowsArg * ColsArg, T> >::value;
+
+public:
+    /**
+    Creates a Matrix with every element zero. A MatrixMap has no memory
+    to map without an element pointer, so it cannot be created this way.
+    */
+    Matrix() : SuperType() {
+        static_assert(IS_OWNING, "a MatrixMap cannot be created without an element pointer");
+    }
+
+    Matrix(typename StorageType::InitPointer elements) : SuperType(elements) { }
+
+    /**
+    Creates a Matrix from another with the same dimensions. An owning Matrix
+    copies the elements of other; a MatrixMap maps the same memory as other,
+    so it cannot be created from a temporary owning Matrix.
+    */
+    template<typename OtherStorage>
+    Matrix(const Matrix<RowsArg, ColsArg, T, LayoutArg, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Matrix(Matrix<RowsArg, ColsArg, T, LayoutArg, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Matrix(Matrix<RowsArg, ColsArg, T, LayoutArg, OtherStorage>&& other) : SuperType(other.data()) {
+        static_assert(IS_OWNING || !std::is_same<OtherStorage, _ArrayStorage<RowsArg * ColsArg, T> >::value,
+                      "a MatrixMap cannot be created from a temporary Matrix");
+    }
+
+    /**
+    Creates a Matrix holding a copy of the elements of a Matrix with the
+    other layout, rearranged into this layout.
+    */
+    template<typename OtherStorage>
+    Matrix(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) : SuperType() {
+        static_assert(IS_OWNING, "a MatrixMap cannot be created from a Matrix with a different layout");
+        MatrixUtil::copy(other.data(), OTHER_LAYOUT, this->mData, LayoutArg, RowsArg, ColsArg);
+    }
+
+    /**
+    Creates a Matrix holding a copy of the elements of block.
+    */
+    template<typename BlockT>
+    Matrix(const MatrixBlock<RowsArg, ColsArg, BlockT>& block) : SuperType() {
+        static_assert(IS_OWNING, "a MatrixMap cannot be created from a MatrixBlock");
+        copyFrom(block.data(), block.stride(), 1);
+    }
+
+    /**
+    Creates a Matrix holding the transposed elements of view.
+    */
+    Matrix(const MatrixTranspose<RowsArg, ColsArg, T>& view) : SuperType() {
+        static_assert(IS_OWNING, "a MatrixMap cannot be created from a MatrixTranspose");
+        copyFrom(view.data(), 1, view.stride());
+    }
+
+    virtual ~Matrix() { }
+
+    using SuperType::operator=;
+    using SuperType::copyFrom;
+
+    /**
+    Copies the elements of a Matrix with the other layout into this Matrix.
+    A map of this Matrix's own memory, which reads it as its transpose, is
+    transposed in place.
+    */
+    template<typename OtherStorage>
+    ThisType& operator=(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) {
+        if (other.data() == this->data()) {
+            // the source storage is a row-major matrix of its major dimension
+            if (LayoutArg == MatrixLayout::ROW_MAJOR) {
+                MatrixUtil::transposeInPlace(this->mData, ColsArg, RowsArg);
+            } else {
+                MatrixUtil::transposeInPlace(this->mData, RowsArg, ColsArg);
+            }
+        } else {
+            MatrixUtil::copy(other.data(), OTHER_LAYOUT, this->mData, LayoutArg, RowsArg, ColsArg);
+        }
+        return *this;
+    }
+
+    /**
+    Copies the elements of block into this Matrix.
+    */
+    template<typename BlockT>
+    ThisType& operator=(const MatrixBlock<RowsArg, ColsArg, BlockT>& block) {
+        copyFrom(block.data(), block.stride(), 1);
+        return *this;
+    }
+
+    /**
+    Writes the transposed elements of view into this Matrix. This is where a
+    transpose view is materialized. A view of this Matrix itself, as in
+    m = m.transpose(), is transposed in place.
+    */
+    ThisType& operator=(const MatrixTranspose<RowsArg, ColsArg, T>& view) {
+        if (LayoutArg == MatrixLayout::ROW_MAJOR && RowsArg == ColsArg &&
+                view.data() == this->data() && view.stride() == ColsArg) {
+            MatrixUtil::transposeInPlace(this->mData, RowsArg);
+        } else if (view.overlaps(this->data(), RowsArg * ColsArg)) {
+            T temp[RowsArg*ColsArg];
+            MatrixUtil::copy(view.data(), 1, view.stride(), temp, rowStride(), colStride(), RowsArg, ColsArg);
+            copyFrom(temp);
+        } else {
+            copyFrom(view.data(), 1, view.stride());
+        }
+        return *this;
+    }
+
+    /**
+    Returns the number of rows in this Matrix.
+    */
+    size_t rows() const {
+        return RowsArg;
+    }
+
+    /**
+    Returns the number of columns in this Matrix.
+    */
+    size_t cols() const {
+        return ColsArg;
+    }
+
+    /**
+    Returns the order of the elements in memory.
+    */
+    static MatrixLayout layout() {
+        return LayoutArg;
+    }
+
+    /**
+    Returns the number of elements between vertically adjacent elements,
+    i.e. ColsArg for a row-major Matrix and 1 for a column-major one.
+    */
+    static size_t rowStride() {
+        return (LayoutArg == MatrixLayout::ROW_MAJOR) ? ColsArg : 1;
+    }
+
+    /**
+    Returns the number of elements between horizontally adjacent elements,
+    i.e. 1 for a row-major Matrix and RowsArg for a column-major one.
+    */
+    static size_t colStride() {
+        return (LayoutArg == MatrixLayout::ROW_MAJOR) ? 1 : RowsArg;
+    }
+
+    /**
+    Copies the elements of the RowsArg x ColsArg matrix at src, with the
+    given row and column strides, into this Matrix.
+    */
+    void copyFrom(const T* src, size_t srcRowStride, size_t srcColStride) {
+        MatrixUtil::copy(src, srcRowStride, srcColStride, this->mData, rowStride(), colStride(), RowsArg, ColsArg);
+    }
+
+    /**
+    Same as add() but assigns the answer to the caller. The base class
+    versions handle operands with the same layout.
+    */
+    using SuperType::addAssign;
+    template<typename OtherStorage>
+    void addAssign(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) {
+        MatrixUtil::add(this->data(), LayoutArg, other.data(), OTHER_LAYOUT, this->mData, LayoutArg,
+                        RowsArg, ColsArg);
+    }
+    /**
+    Adds a Matrix with the other layout to the caller and returns a new
+    Matrix, in the caller's layout, with the results.
+    */
+    using SuperType::add;
+    template<typename OtherStorage>
+    ValueType add(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) const {
+        ValueType result;
+        MatrixUtil::add(this->data(), LayoutArg, other.data(), OTHER_LAYOUT, result.data(), LayoutArg,
+                        RowsArg, ColsArg);
+        return result;
+    }
+    using SuperType::operator+;
+    template<typename OtherStorage>
+    ValueType operator+(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) const {
+        return add(other);
+    }
+    using SuperType::operator+=;
+    template<typename OtherStorage>
+    ThisType& operator+=(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) {
+        addAssign(other);
+        return *this;
+    }
+
+    /**
+    Same as subtract() but assigns the answer to the caller.
+    */
+    using SuperType::subtractAssign;
+    template<typename OtherStorage>
+    void subtractAssign(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) {
+        MatrixUtil::subtract(this->data(), LayoutArg, other.data(), OTHER_LAYOUT, this->mData, LayoutArg,
+                             RowsArg, ColsArg);
+    }
+    /**
+    Subtracts a Matrix with the other layout from the caller and returns a
+    new Matrix, in the caller's layout, with the results.
+    */
+    using SuperType::subtract;
+    template<typename OtherStorage>
+    ValueType subtract(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) const {
+        ValueType result;
+        MatrixUtil::subtract(this->data(), LayoutArg, other.data(), OTHER_LAYOUT, result.data(), LayoutArg,
+                             RowsArg, ColsArg);
+        return result;
+    }
+    using SuperType::operator-;
+    template<typename OtherStorage>
+    ValueType operator-(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) const {
+        return subtract(other);
+    }
+    using SuperType::operator-=;
+    template<typename OtherStorage>
+    ThisType& operator-=(const Matrix<RowsArg, ColsArg, T, OTHER_LAYOUT, OtherStorage>& other) {
+        subtractAssign(other);
+        return *this;
+    }
+
+    /**
+    Returns a view representing the transposition of the calling Matrix. No
+    elements are moved; multiply() and transformVector() read the view in
+    place, and the transposed elements are only written out when the view is
+    assigned to a Matrix:
+
+        Matrix<4, 4> c = a * b.transpose();   // no transposed copy of b
+        Matrix<4, 4> t = b.transpose();       // transposes into t
+
+    The transpose of a column-major Matrix is a read-only row-major map of
+    its elements.
+    */
+    typename _TransposeView<RowsArg, ColsArg, T, LayoutArg>::Type transpose() const {
+        return _TransposeView<RowsArg, ColsArg, T, LayoutArg>::create(this->data());
+    }
+
+    /**
+    Transposes a square Matrix in place.
+    */
+    void transposeInPlace() {
+        static_assert(RowsArg == ColsArg, "only a square Matrix can be transposed in place");
+        MatrixUtil::transposeInPlace(this->mData, RowsArg);
+    }
+
+    /**
+    Same as Matrix version of Multiply() but assigns the answer to the caller. This is useful in
+    order to avoid unneccessary copying of array data. This function only accepts square matrices
+    with the same number of columns as the caller. Otherwise, the resulting Matrix size would be
+    incompatible with the caller.
+    */
+    template<MatrixLayout OtherLayout, typename OtherStorage>
+    void multiplyAssign(const Matrix<ColsArg, ColsArg, T, OtherLayout, OtherStorage>& other) {
+        T temp[RowsArg*ColsArg];
+        MatrixUtil::matrixMultiply(this->data(), LayoutArg, RowsArg, ColsArg,
+                                   other.data(), OtherLayout, ColsArg,
+                                   temp, LayoutArg);
+        MatrixUtil::copy(temp, this->mData, RowsArg*ColsArg);
+    }
+    void multiplyAssign(const MatrixTranspose<ColsArg, ColsArg, T>& other) {
+        T temp[RowsArg*ColsArg];
+        MatrixUtil::matrixMultiply(this->data(), RowsArg, ColsArg, rowStride(), colStride(),
+                                   other.data(), ColsArg, 1, other.stride(),
+                                   temp, rowStride(), colStride());
+        MatrixUtil::copy(temp, this->mData, RowsArg*ColsArg);
+    }
+    /**
+    Multiplies the calling Matrix with the argument and returns a new Matrix with the result.
+    Matrix multiplication is only defined where the second matrix has the same number of
+    rows as the first matrix. The operands may have different layouts; each is read in
+    place and the result has the layout of the caller.
+    */
+    template<unsigned int OtherColsArg, MatrixLayout OtherLayout, typename OtherStorage>
+    Matrix<RowsArg, OtherColsArg, T, LayoutArg> multiply(
+            const Matrix<ColsArg, OtherColsArg, T, OtherLayout, OtherStorage> &other) const {
+        Matrix<RowsArg, OtherColsArg, T, LayoutArg> result;
+        MatrixUtil::matrixMultiply(this->data(), LayoutArg, RowsArg, ColsArg,
+                                   other.data(), OtherLayout, OtherColsArg,
+                                   result.data(), LayoutArg);
+        return result;
+    }
+
+    /**
+    Treats the given vector as a column matrix and performs a matrix multiplication.
+    */
+    template<typename OtherStorage>
+    Vector<RowsArg, T> transformVector(const Vector<ColsArg, T, OtherStorage>& other) const {
+        Vector<RowsArg, T> result;
+        MatrixUtil::matrixMultiply(this->data(), RowsArg, ColsArg, rowStride(), colStride(),
+                                   other.data(), 1, 1, 1,
+                                   result.data(), 1, 1);
+        return result;
+    }
+
+    /**
+    Multiplies the calling Matrix with a block of another matrix and returns a new Matrix
+    with the result.
+    */
+    template<unsigned int OtherColsArg, typename BlockT>
+    Matrix<RowsArg, OtherColsArg, T, LayoutArg> multiply(
+            const MatrixBlock<ColsArg, OtherColsArg, BlockT> &other) const {
+        Matrix<RowsArg, OtherColsArg, T, LayoutArg> result;
+        MatrixUtil::matrixMultiply(this->data(), RowsArg, ColsArg, rowStride(), colStride(),
+                                   other.data(), OtherColsArg, other.stride(), 1,
+                                   result.data(), result.rowStride(), result.colStride());
+        return result;
+    }
+
+    /**
+    Multiplies the calling Matrix with a transposed matrix and returns a new Matrix with
+    the result. Both operands are read in place.
+    */
+    template<unsigned int OtherColsArg>
+    Matrix<RowsArg, OtherColsArg, T, LayoutArg> multiply(
+            const MatrixTranspose<ColsArg, OtherColsArg, T> &other) const {
+        Matrix<RowsArg, OtherColsArg, T, LayoutArg> result;
+        MatrixUtil::matrixMultiply(this->data(), RowsArg, ColsArg, rowStride(), colStride(),
+                                   other.data(), OtherColsArg, 1, other.stride(),
+                                   result.data(), result.rowStride(), result.colStride());
+        return result;
+    }
+
+    // make sure the multiplication operator from the base class is still visible
+    using SuperType::operator*;
+
+    /**
+    Alias for the Matrix version of Multiply()
+    */
+    template<unsigned int OtherColsArg, MatrixLayout OtherLayout, typename OtherStorage>
+    Matrix<RowsArg, OtherColsArg, T, LayoutArg> operator*(
+            const Matrix<ColsArg, OtherColsArg, T, OtherLayout, OtherStorage> &rh) const {
+        return multiply(rh);
+    }
+
+    /**
+    Alias for the MatrixBlock version of Multiply()
+    */
+    template<unsigned int OtherColsArg, typename BlockT>
+    Matrix<RowsArg, OtherColsArg, T, LayoutArg> operator*(const MatrixBlock<ColsArg, OtherColsArg, BlockT> &rh) const {
+        return multiply(rh);
+    }
+
+    /**
+    Alias for the MatrixTranspose version of Multiply()
+    */
+    template<unsigned int OtherColsArg>
+    Matrix<RowsArg, OtherColsArg, T, LayoutArg> operator*(const MatrixTranspose<ColsArg, OtherColsArg, T> &rh) const {
+        return multiply(rh);
+    }
+
+    // make sure the multiplication equals operator from the base class is still visible
+    using SuperType::operator*=;
+
+    /**
+    Alias for the Matrix version of multiplyAssign()
+    */
+    template<MatrixLayout OtherLayout, typename OtherStorage>
+    ThisType& operator*=(const Matrix<ColsArg, ColsArg, T, OtherLayout, OtherStorage>& other) {
+        multiplyAssign(other);
+        return *this;
+    }
+    ThisType& operator*=(const MatrixTranspose<ColsArg, ColsArg, T>& other) {
+        multiplyAssign(other);
+        return *this;
+    }
+
+    /**
+    Array index operator allowing the Matrix to be used directly as a 2 dimensional array.
+    The index selects along the major dimension, so a row-major Matrix is indexed as
+    m[row][col] and a column-major one as m[col][row]. Callers are resposible for staying
+    within the bounds of the array.
+    */
+    typename StorageType::Pointer operator[](size_t majorIdx) {
+        return this->mData + (majorIdx * ((LayoutArg == MatrixLayout::ROW_MAJOR) ? ColsArg : RowsArg));
+    }
+    const T* operator[](size_t majorIdx) const {
+        return this->mData + (majorIdx * ((LayoutArg == MatrixLayout::ROW_MAJOR) ? ColsArg : RowsArg));
+    }
+
+    /**
+    Overload the "()" operator to allow direct access by row and column. Callers
+    are responsible for staying within the bounds of the array.
+     */
+    typename StorageType::Reference operator()(size_t rowIdx, size_t colIdx) {
+        return this->mData[(rowIdx * rowStride()) + (colIdx * colStride())];
+    }
+    const T operator()(size_t rowIdx, size_t colIdx) const {
+        return this->mData[(rowIdx * rowStride()) + (colIdx * colStride())];
+    }
+
+    /**
+    Returns a view of the BlockRows x BlockCols block whose top left element
+    is at rowIdx, colIdx. Callers are responsible for keeping the block within
+    the bounds of the Matrix. A block of a column-major Matrix must be a
+    single column.
+    */
+    template<unsigned int BlockRows, unsigned int BlockCols>
+    MatrixBlock<BlockRows, BlockCols, typename StorageType::Element> block(size_t rowIdx, size_t colIdx) {
+        static_assert(LayoutArg == MatrixLayout::ROW_MAJOR || BlockCols == 1,
+                      "only single column blocks can be taken from a column-major Matrix");
+        return MatrixBlock<BlockRows, BlockCols, typename StorageType::Element>(
+            this->mData + (rowIdx * rowStride()) + (colIdx * colStride()), rowStride());
+    }
+    template<unsigned int BlockRows, unsigned int BlockCols>
+    MatrixBlock<BlockRows, BlockCols, const T> block(size_t rowIdx, size_t colIdx) const {
+        static_assert(LayoutArg == MatrixLayout::ROW_MAJOR || BlockCols == 1,
+                      "only single column blocks can be taken from a column-major Matrix");
+        return MatrixBlock<BlockRows, BlockCols, const T>(
+            this->data() + (rowIdx * rowStride()) + (colIdx * colStride()), rowStride());
+    }
+
+    /**
+    Returns a view of the given row as a 1 x ColsArg block.
+    */
+    MatrixBlock<1, ColsArg, typename StorageType::Element> row(size_t rowIdx) {
+        return block<1, ColsArg>(rowIdx, 0);
+    }
+    MatrixBlock<1, ColsArg, const T> row(size_t rowIdx) const {
+        return block<1, ColsArg>(rowIdx, 0);
+    }
+
+    /**
+    Returns a view of the given column as a RowsArg x 1 block.
+    */
+    MatrixBlock<RowsArg, 1, typename StorageType::Element> col(size_t colIdx) {
+        return block<RowsArg, 1>(0, colIdx);
+    }
+    MatrixBlock<RowsArg, 1, const T> col(size_t colIdx) const {
+        return block<RowsArg, 1>(0, colIdx);
+    }
+
+    /**
+    Returns a view of the main diagonal as a column block. Consecutive
+    diagonal elements are rowStride() + colStride() elements apart.
+    */
+    MatrixBlock<(RowsArg < ColsArg ? RowsArg : ColsArg), 1, typename StorageType::Element> diagonal() {
+        return MatrixBlock<(RowsArg < ColsArg ? RowsArg : ColsArg), 1, typename StorageType::Element>(
+            this->mData, rowStride() + colStride());
+    }
+    MatrixBlock<(RowsArg < ColsArg ? RowsArg : ColsArg), 1, const T> diagonal() const {
+        return MatrixBlock<(RowsArg < ColsArg ? RowsArg : ColsArg), 1, const T>(
+            this->data(), rowStride() + colStride());
+    }
+
+    /**
+    Returns a string representation of the Matrix, row by row in either layout.
+    */
+    std::string toString() const {
+        if (LayoutArg == MatrixLayout::ROW_MAJOR) {
+            return MatrixUtil::toString(this->data(), RowsArg, ColsArg);
+        }
+        T temp[RowsArg*ColsArg];
+        MatrixUtil::copy(this->data(), LayoutArg, temp, MatrixLayout::ROW_MAJOR, RowsArg, ColsArg);
+        return MatrixUtil::toString(temp, RowsArg, ColsArg);
+    }
+
+    /**
+    Returns a matrix I that when multiplied by a matrix A of this type
+    returns the same matrix, i.e. A*I = A. The returned matrix has dimensions
+    ColsArg x ColsArg.
+    */
+    static Matrix<ColsArg, ColsArg, T, LayoutArg> identity(){
+	    Matrix<ColsArg, ColsArg, T, LayoutArg> result;
+	    MatrixUtil::identity(ColsArg, result.data());
+	    return result;
     }
-    ss << " ]";
+};
 
-    return ss.str();
+/**
+Global function allowing scalar multiplication to occur when the scalar comes
+before the Matrix.
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, typename T, MatrixLayout LayoutArg, typename StorageType>
+Matrix<RowsArg, ColsArg, T, LayoutArg> operator*(T scalar, const Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType> &mat) {
+    return mat * scalar;
 }
 
-} // end namespace MatrixUtil
-
 /**
-Base type for classes that contain an internal array of elements.
-Since all data is kept in the internal array, the default copy
-constructor and assignment operators are used where possible.
-The template uses the "Curiously Recurring Template Pattern", aka
-CRTP (see http://en.wikipedia.org/wiki/Curiously_recurring_template_pattern)
+View of a RowsArg x ColsArg block of a row-major matrix, for example the
+rotation part or the translation column of a transform:
+
+    Mat4d transform = ...;
+    Matrix<3, 3> rotation = transform.block<3, 3>(0, 0);
+    transform.block<3, 1>(0, 3) = translation;
+
+Blocks are returned by Matrix::block(), row(), col() and diagonal(). No
+elements are copied; the view reads and writes the matrix it was taken
+from, which must outlive it. The stride is the number of elements
+between the starts of consecutive rows, i.e. the number of columns of
+the underlying matrix. T is const for a read-only view. Assigning to a
+block copies elements into it, and operations that produce a new value
+return an owning Matrix. Matrices of the same size may be used wherever
+a block operand is expected.
 */
-template<unsigned int SizeArg, typename T, typename DerivedType>
-class _ElementArrayBase {
+template<unsigned int RowsArg, unsigned int ColsArg, typename T>
+class MatrixBlock {
 
-    typedef _ElementArrayBase<SizeArg, T, DerivedType> ThisType;
+    typedef MatrixBlock<RowsArg, ColsArg, T> ThisType;
+    typedef typename std::remove_const<T>::type ElementType;
+    typedef MatrixBlock<RowsArg, ColsArg, const ElementType> ConstType;
+    typedef Matrix<RowsArg, ColsArg, ElementType> ValueType;
 
-protected:
-    // internal data array
-    T mData[SizeArg];
+public:
+    MatrixBlock(T* elements, size_t stride) : mData(elements), mStride(stride) { }
 
     /**
-    Protected constructor for use in derived classes. If
-    elements is NULL, every element in the internal array
-    is set to the zero representation of type T. Otherwise,
-    the data from elements is copied into the internal array.
+    Creates a view of the same elements as other, e.g. a read-only view
+    from a mutable one.
     */
-    _ElementArrayBase(const T* elements = NULL) {
-        if (elements != NULL) {
-            MatrixUtil::copy(elements, mData, SizeArg);
-        } else {
-            MatrixUtil::set(mData, static_cast<T>(0), SizeArg);
-        }
+    template<typename OtherT>
+    MatrixBlock(const MatrixBlock<RowsArg, ColsArg, OtherT>& other) :
+        mData(other.data()), mStride(other.stride()) { }
+
+    /**
+    Creates a view of the whole of a row-major mat.
+    */
+    template<typename StorageType>
+    MatrixBlock(const Matrix<RowsArg, ColsArg, ElementType, MatrixLayout::ROW_MAJOR, StorageType>& mat) :
+        mData(mat.data()), mStride(ColsArg) { }
+    template<typename StorageType>
+    MatrixBlock(Matrix<RowsArg, ColsArg, ElementType, MatrixLayout::ROW_MAJOR, StorageType>& mat) :
+        mData(mat.data()), mStride(ColsArg) { }
+
+    /**
+    Copies the elements of other into the block.
+    */
+    ThisType& operator=(const ThisType& other) {
+        MatrixUtil::copy(other.data(), other.stride(), mData, mStride, RowsArg, ColsArg);
+        return *this;
+    }
+    template<typename OtherT>
+    ThisType& operator=(const MatrixBlock<RowsArg, ColsArg, OtherT>& other) {
+        MatrixUtil::copy(other.data(), other.stride(), mData, mStride, RowsArg, ColsArg);
+        return *this;
+    }
+    template<MatrixLayout LayoutArg, typename StorageType>
+    ThisType& operator=(const Matrix<RowsArg, ColsArg, ElementType, LayoutArg, StorageType>& other) {
+        MatrixUtil::copy(other.data(), other.rowStride(), other.colStride(), mData, mStride, 1, RowsArg, ColsArg);
+        return *this;
     }
 
-public:
-    virtual ~_ElementArrayBase() { }
+    /**
+    Copies the elements of vec into a single row or column block.
+    */
+    template<typename StorageType>
+    ThisType& operator=(const Vector<RowsArg * ColsArg, ElementType, StorageType>& vec) {
+        static_assert(RowsArg == 1 || ColsArg == 1, "only a row or column block can be assigned a Vector");
+        copyFrom(vec.data());
+        return *this;
+    }
 
     /**
-    Returns a pointer to the internal element array.
+    Returns the number of rows in the block.
     */
-    T* data() {
-        return mData;
+    size_t rows() const {
+        return RowsArg;
     }
-    const T* data() const {
-        return mData;
+
+    /**
+    Returns the number of columns in the block.
+    */
+    size_t cols() const {
+        return ColsArg;
     }
 
     /**
-    Returns the size of the internal array.
+    Returns the number of elements in the block.
     */
     size_t size() const {
-        return SizeArg;
+        return RowsArg * ColsArg;
     }
 
     /**
-    Copies the entirety of the internal array to dest. The caller is responsible
-    for making sure that dest is large enough to contain the copied data.
+    Returns the number of elements between the starts of consecutive rows.
     */
-    void copyTo(T* dest) const {
-        MatrixUtil::copy(mData, dest, SizeArg);
+    size_t stride() const {
+        return mStride;
     }
 
     /**
-    Copies data from src into the internal array.
+    Returns true if the elements of the block are contiguous in memory, in
+    which case they can also be used as a plain array through data().
     */
-    void copyFrom(const T* src) {
-        MatrixUtil::copy(src, mData, SizeArg);
+    bool isContiguous() const {
+        return mStride == ColsArg || RowsArg == 1;
     }
 
     /**
-    Same as add() but assigns the answer to the caller. This can be used to 
-    avoid unneccessary copying of array data.
+    Returns a pointer to the first element of the block.
     */
-    void addAssign(const DerivedType &other) {
-        MatrixUtil::add(mData, other.mData, mData, SizeArg);
+    T* data() {
+        return mData;
+    }
+    const ElementType* data() const {
+        return mData;
     }
+
     /**
-    Adds the elements from the argument and the caller and returns a new object
-    with the results.
+    Copies the block to the contiguous array dest, row by row. The caller is
+    responsible for making sure that dest is large enough to contain the data.
     */
-    DerivedType add(const DerivedType &other) const {
-        DerivedType result(mData);
-        MatrixUtil::add(mData, other.mData, result.data(), SizeArg);
+    void copyTo(ElementType* dest) const {
+        MatrixUtil::copy(data(), mStride, dest, ColsArg, RowsArg, ColsArg);
+    }
+
+    /**
+    Copies the contiguous array src into the block, row by row.
+    */
+    void copyFrom(const ElementType* src) {
+        MatrixUtil::copy(src, ColsArg, mData, mStride, RowsArg, ColsArg);
+    }
+
+    /**
+    Same as add() but assigns the answer to the block.
+    */
+    void addAssign(const ConstType& other) {
+        MatrixUtil::add(data(), mStride, other.data(), other.stride(), mData, mStride, RowsArg, ColsArg);
+    }
+    /**
+    Adds the elements of the argument and the block and returns a new Matrix with the results.
+    */
+    ValueType add(const ConstType& other) const {
+        ValueType result;
+        MatrixUtil::add(data(), mStride, other.data(), other.stride(), result.data(), ColsArg, RowsArg, ColsArg);
         return result;
     }
     /**
     Alias for add()
     */
-    DerivedType operator+(const DerivedType &other) const {
+    ValueType operator+(const ConstType& other) const {
         return add(other);
     }
     /**
     Alias for addAssign()
     */
-    DerivedType& operator+=(const DerivedType &other) {
+    ThisType& operator+=(const ConstType& other) {
         addAssign(other);
-        return *static_cast<DerivedType*>(this);
+        return *this;
     }
 
     /**
-    Same as subtract() but assigns the answer to the caller. This can be used to 
-    avoid unneccessary copying of array data.
+    Same as subtract() but assigns the answer to the block.
     */
-    void subtractAssign(const DerivedType &other) {
-        MatrixUtil::subtract(mData, other.mData, mData, SizeArg);
+    void subtractAssign(const ConstType& other) {
+        MatrixUtil::subtract(data(), mStride, other.data(), other.stride(), mData, mStride, RowsArg, ColsArg);
     }
     /**
-    Adds the elements of the argument from the caller and returns a new element-based object
-    with the results.
+    Subtracts the elements of the argument from the block and returns a new Matrix with the results.
     */
-    DerivedType subtract(const DerivedType &other) const {
-        DerivedType result(mData);
-        MatrixUtil::subtract(mData, other.mData, result.mData, SizeArg);
+    ValueType subtract(const ConstType& other) const {
+        ValueType result;
+        MatrixUtil::subtract(data(), mStride, other.data(), other.stride(), result.data(), ColsArg, RowsArg, ColsArg);
         return result;
     }
     /**
-    Alias for Subtract()
+    Alias for subtract()
     */
-    DerivedType operator-(const DerivedType &other) const {
+    ValueType operator-(const ConstType& other) const {
         return subtract(other);
     }
     /**
     Alias for subtractAssign()
     */
-    DerivedType& operator-=(const DerivedType &other) {
+    ThisType& operator-=(const ConstType& other) {
         subtractAssign(other);
-        return *static_cast<DerivedType*>(this);
+        return *this;
     }
 
     /**
-    Same as scalarMultiply() but assigns the answer to the caller. This can be 
-    used to avoid unneccessary copying of array data.
+    Same as scalarMultiply() but assigns the answer to the block.
     */
-    void scalarMultiplyAssign(T val) {
-        MatrixUtil::scalarMultiply(mData, val, mData, SizeArg);
+    void scalarMultiplyAssign(ElementType val) {
+        MatrixUtil::scalarMultiply(data(), mStride, val, mData, mStride, RowsArg, ColsArg);
     }
     /**
-    Multiplies every element of the internal array by val and returns a new element-based object
-    with the results.
+    Multiplies every element of the block by val and returns a new Matrix with the results.
     */
-    DerivedType scalarMultiply(T val) const {
-        DerivedType result(mData);
-        MatrixUtil::scalarMultiply(mData, val, result.mData, SizeArg);
+    ValueType scalarMultiply(ElementType val) const {
+        ValueType result;
+        MatrixUtil::scalarMultiply(data(), mStride, val, result.data(), ColsArg, RowsArg, ColsArg);
         return result;
     }
     /**
     Alias for scalarMultiply()
     */
-    DerivedType operator*(T val) const {
+    ValueType operator*(ElementType val) const {
         return scalarMultiply(val);
     }
     /**
     Alias for scalarMultiplyAssign()
     */
-    DerivedType& operator*=(T val) {
+    ThisType& operator*=(ElementType val) {
         scalarMultiplyAssign(val);
-        return *static_cast<DerivedType*>(this);
+        return *this;
     }
-};
 
-// forward-declare Vector class
-template<unsigned int SizeArg, typename T = double>
-class Vector;
+    /**
+    Multiplies the block with the argument and returns a new Matrix with the result.
+    */
+    template<unsigned int OtherColsArg, typename OtherT>
+    Matrix<RowsArg, OtherColsArg, ElementType> multiply(const MatrixBlock<ColsArg, OtherColsArg, OtherT>& other) const {
+        Matrix<RowsArg, OtherColsArg, ElementType> result;
+        MatrixUtil::matrixMultiply(data(), RowsArg, ColsArg, mStride,
+                                   other.data(), OtherColsArg, other.stride(),
+                                   result.data(), OtherColsArg);
+        return result;
+    }
+    template<unsigned int OtherColsArg, MatrixLayout LayoutArg, typename StorageType>
+    Matrix<RowsArg, OtherColsArg, ElementType> multiply(
+            const Matrix<ColsArg, OtherColsArg, ElementType, LayoutArg, StorageType>& other) const {
+        Matrix<RowsArg, OtherColsArg, ElementType> result;
+        MatrixUtil::matrixMultiply(data(), RowsArg, ColsArg, mStride, 1,
+                                   other.data(), OtherColsArg, other.rowStride(), other.colStride(),
+                                   result.data(), OtherColsArg, 1);
+        return result;
+    }
 
-// Template class representing a RowsArg x ColsArg matrix of type T.
-template<unsigned int RowsArg, unsigned int ColsArg, typename T = double>
-class Matrix : public _ElementArrayBase<RowsArg * ColsArg, T, Matrix<RowsArg, ColsArg, T> > {
+    /**
+    Alias for multiply()
+    */
+    template<unsigned int OtherColsArg, typename OtherT>
+    Matrix<RowsArg, OtherColsArg, ElementType> operator*(const MatrixBlock<ColsArg, OtherColsArg, OtherT>& rh) const {
+        return multiply(rh);
+    }
+    template<unsigned int OtherColsArg, MatrixLayout LayoutArg, typename StorageType>
+    Matrix<RowsArg, OtherColsArg, ElementType> operator*(
+            const Matrix<ColsArg, OtherColsArg, ElementType, LayoutArg, StorageType>& rh) const {
+        return multiply(rh);
+    }
 
-    typedef Matrix<RowsArg, ColsArg, T> ThisType;
-    typedef _ElementArrayBase<RowsArg * ColsArg, T, ThisType> SuperType;
+    /**
+    Multiplies the block with a transposed matrix and returns a new Matrix with the result.
+    */
+    template<unsigned int OtherColsArg>
+    Matrix<RowsArg, OtherColsArg, ElementType> multiply(
+            const MatrixTranspose<ColsArg, OtherColsArg, ElementType>& other) const {
+        Matrix<RowsArg, OtherColsArg, ElementType> result;
+        MatrixUtil::matrixMultiplyTransposed(data(), RowsArg, ColsArg, mStride,
+                                             other.data(), OtherColsArg, other.stride(),
+                                             result.data(), OtherColsArg);
+        return result;
+    }
+    template<unsigned int OtherColsArg>
+    Matrix<RowsArg, OtherColsArg, ElementType> operator*(
+            const MatrixTranspose<ColsArg, OtherColsArg, ElementType>& rh) const {
+        return multiply(rh);
+    }
 
-public:
-    Matrix(const T* elements = NULL) : SuperType(elements) { }
+    /**
+    Returns a view representing the transposition of the block. See
+    Matrix::transpose().
+    */
+    MatrixTranspose<ColsArg, RowsArg, ElementType> transpose() const {
+        return MatrixTranspose<ColsArg, RowsArg, ElementType>(data(), mStride);
+    }
 
-    virtual ~Matrix() { }
+    /**
+    Overload the "()" operator to allow direct access by row and column. Callers
+    are responsible for staying within the bounds of the block.
+     */
+    T& operator()(size_t rowIdx, size_t colIdx) {
+        return mData[(rowIdx * mStride) + colIdx];
+    }
+    const ElementType operator()(size_t rowIdx, size_t colIdx) const {
+        return mData[(rowIdx * mStride) + colIdx];
+    }
 
     /**
-    Returns the number of rows in this Matrix.
+    Returns a string representation of the block.
+    */
+    std::string toString() const {
+        return ValueType(*this).toString();
+    }
+
+private:
+    T* mData;
+    size_t mStride;
+};
+
+/**
+Read-only view of the transpose of a matrix or block, returned by
+Matrix::transpose() and MatrixBlock::transpose(). RowsArg and ColsArg are
+the dimensions of the transposed matrix, so the viewed source is a
+ColsArg x RowsArg row-major matrix with the given row stride. Multiplying
+by a view or transforming a vector with one reads the source in place
+with a kernel suited to its layout; the transposed elements are only
+written out when the view is assigned to a Matrix. The source must
+outlive the view.
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, typename T>
+class MatrixTranspose {
+
+    typedef Matrix<RowsArg, ColsArg, T> ValueType;
+
+public:
+    MatrixTranspose(const T* source, size_t stride) : mData(source), mStride(stride) { }
+
+    /**
+    Returns the number of rows in the transposed matrix.
     */
     size_t rows() const {
         return RowsArg;
     }
 
     /**
-    Returns the number of columns in this Matrix.
+    Returns the number of columns in the transposed matrix.
     */
     size_t cols() const {
         return ColsArg;
     }
 
     /**
-    Returns a new Matrix representing the transposition of the calling Matrix.
+    Returns the number of elements in the transposed matrix.
     */
-    Matrix<ColsArg, RowsArg, T> transpose() const {
-        Matrix<ColsArg, RowsArg, T> result;
-        MatrixUtil::transpose(this->mData, RowsArg, ColsArg, result.data());
-        return result;
+    size_t size() const {
+        return RowsArg * ColsArg;
     }
 
     /**
-    Same as Matrix version of Multiply() but assigns the answer to the caller. This is useful in 
-    order to avoid unneccessary copying of array data. This function only accepts square matrices 
-    with the same number of columns as the caller. Otherwise, the resulting Matrix size would be 
-    incompatible with the caller.
+    Returns a pointer to the first element of the source.
     */
-    void multiplyAssign(const Matrix<ColsArg, ColsArg, T>& other) {
-        T temp[RowsArg*ColsArg];
-        MatrixUtil::matrixMultiply(this->mData, RowsArg, ColsArg,
-                                   other.data(), ColsArg,
-                                   temp);
-        MatrixUtil::copy(temp, this->mData, RowsArg*ColsArg);
+    const T* data() const {
+        return mData;
     }
+
     /**
-    Multiplies the calling Matrix with the argument and returns a new Matrix with the result.
-    Matrix multiplication is only defined where the second matrix has the same number of
-    rows as the first matrix.
+    Returns the number of elements between the starts of consecutive rows
+    of the source.
     */
-    template<unsigned int OtherColsArg>
-    Matrix<RowsArg, OtherColsArg, T> multiply(const Matrix<ColsArg, OtherColsArg, T> &other) const {
-        Matrix<RowsArg, OtherColsArg, T> result;
-        MatrixUtil::matrixMultiply(this->mData, RowsArg, ColsArg,
-                                   other.data(), OtherColsArg,
-                                   result.data());
-        return result;
+    size_t stride() const {
+        return mStride;
     }
 
     /**
-    Treats the given vector as a column matrix and performs a matrix multiplication.
+    Returns the element at the given row and column of the transposed matrix.
+    Callers are responsible for staying within the bounds of the matrix.
     */
-    Vector<RowsArg, T> transformVector(const Vector<ColsArg, T>& other) {
-        Vector<RowsArg, T> result;
-        MatrixUtil::matrixMultiply(this->mData, RowsArg, ColsArg,
-                                   other.data(), 1,
-                                   result.data());
-        return result;
+    const T operator()(size_t rowIdx, size_t colIdx) const {
+        return mData[(colIdx * mStride) + rowIdx];
     }
 
-    // make sure the multiplication operator from the base class is still visible
-    using SuperType::operator*;
-
     /**
-    Alias for the Matrix version of Multiply()
+    Writes the transposed matrix to the contiguous array dest, row by row.
+    The caller is responsible for making sure that dest is large enough to
+    contain the data and does not overlap the source.
     */
-    template<unsigned int OtherColsArg>
-    Matrix<RowsArg, OtherColsArg, T> operator*(const Matrix<ColsArg, OtherColsArg, T> &rh) {
-        return multiply(rh);
+    void copyTo(T* dest) const {
+        MatrixUtil::transpose(mData, mStride, ColsArg, RowsArg, dest, ColsArg);
     }
 
-    // make sure the multiplication equals operator from the base class is still visible
-    using SuperType::operator*=;
+    /**
+    Returns true if the source shares memory with the size elements starting
+    at elements.
+    */
+    bool overlaps(const T* elements, size_t size) const {
+        std::less<const T*> before;
+        const T* end = mData + ((ColsArg - 1) * mStride) + RowsArg;
+        return before(mData, elements + size) && before(elements, end);
+    }
 
     /**
-    Alias for the Matrix version of multiplyAssign()
+    Returns a view of the source, i.e. the transpose of this view.
     */
-    ThisType& operator*=(const Matrix<ColsArg, ColsArg, T>& other) {
-        multiplyAssign(other);
-        return *this;
+    MatrixBlock<ColsArg, RowsArg, const T> transpose() const {
+        return MatrixBlock<ColsArg, RowsArg, const T>(mData, mStride);
     }
 
     /**
-    Array index operator allowing the Matrix to be used directly as a 2 dimensional array.
-    Callers are resposible for staying within the bounds of the array.
+    Multiplies the transposed matrix with the argument and returns a new
+    Matrix with the result. The source and the argument are both read along
+    their rows.
     */
-    T* operator[](size_t rowIdx) {
-        return this->mData + (rowIdx * ColsArg);
+    template<unsigned int OtherColsArg, MatrixLayout LayoutArg, typename StorageType>
+    Matrix<RowsArg, OtherColsArg, T> multiply(
+            const Matrix<ColsArg, OtherColsArg, T, LayoutArg, StorageType>& other) const {
+        Matrix<RowsArg, OtherColsArg, T> result;
+        MatrixUtil::matrixMultiply(mData, RowsArg, ColsArg, 1, mStride,
+                                   other.data(), OtherColsArg, other.rowStride(), other.colStride(),
+                                   result.data(), OtherColsArg, 1);
+        return result;
     }
-    const T* operator[](size_t rowIdx) const {
-        return this->mData + (rowIdx * ColsArg);
+    template<unsigned int OtherColsArg, typename BlockT>
+    Matrix<RowsArg, OtherColsArg, T> multiply(const MatrixBlock<ColsArg, OtherColsArg, BlockT>& other) const {
+        Matrix<RowsArg, OtherColsArg, T> result;
+        MatrixUtil::transposedMatrixMultiply(mData, ColsArg, RowsArg, mStride,
+                                             other.data(), OtherColsArg, other.stride(),
+                                             result.data(), OtherColsArg);
+        return result;
+    }
+    /**
+    Multiplies two transposed matrices using A^T * B^T = (B * A)^T.
+    */
+    template<unsigned int OtherColsArg>
+    Matrix<RowsArg, OtherColsArg, T> multiply(const MatrixTranspose<ColsArg, OtherColsArg, T>& other) const {
+        T temp[OtherColsArg*RowsArg];
+        MatrixUtil::matrixMultiply(other.data(), OtherColsArg, ColsArg, other.stride(),
+                                   mData, RowsArg, mStride,
+                                   temp, RowsArg);
+        Matrix<RowsArg, OtherColsArg, T> result;
+        MatrixUtil::transpose(temp, OtherColsArg, RowsArg, result.data());
+        return result;
     }
 
     /**
-    Overload the "()" operator to allow direct access by row and column. Callers
-    are responsible for staying within the bounds of the array.
-     */
-    T& operator()(size_t rowIdx, size_t colIdx) {
-        return this->mData[(rowIdx * ColsArg) + colIdx];
+    Alias for multiply()
+    */
+    template<unsigned int OtherColsArg, MatrixLayout LayoutArg, typename StorageType>
+    Matrix<RowsArg, OtherColsArg, T> operator*(
+            const Matrix<ColsArg, OtherColsArg, T, LayoutArg, StorageType>& rh) const {
+        return multiply(rh);
     }
-    const T operator()(size_t rowIdx, size_t colIdx) const {
-        return this->mData[(rowIdx * ColsArg) + colIdx];
+    template<unsigned int OtherColsArg, typename BlockT>
+    Matrix<RowsArg, OtherColsArg, T> operator*(const MatrixBlock<ColsArg, OtherColsArg, BlockT>& rh) const {
+        return multiply(rh);
+    }
+    template<unsigned int OtherColsArg>
+    Matrix<RowsArg, OtherColsArg, T> operator*(const MatrixTranspose<ColsArg, OtherColsArg, T>& rh) const {
+        return multiply(rh);
     }
 
     /**
-    Returns a string representation of the Matrix.
+    Treats the given vector as a column matrix and multiplies the transposed
+    matrix with it.
     */
-    std::string toString() const {
-        return MatrixUtil::toString(this->mData, RowsArg, ColsArg);
+    template<typename StorageType>
+    Vector<RowsArg, T> transformVector(const Vector<ColsArg, T, StorageType>& other) const {
+        Vector<RowsArg, T> result;
+        MatrixUtil::transposedMatrixMultiply(mData, ColsArg, RowsArg, mStride,
+                                             other.data(), 1, 1,
+                                             result.data(), 1);
+        return result;
     }
 
     /**
-    Returns a matrix I that when multiplied by a matrix A of this type
-    returns the same matrix, i.e. A*I = A. The returned matrix has dimensions
-    ColsArg x ColsArg. 
+    Returns a string representation of the transposed matrix.
     */
-    static Matrix<ColsArg, ColsArg, T> identity(){
-	    Matrix<ColsArg, ColsArg, T> result;
-	    MatrixUtil::identity(ColsArg, result.data());
-	    return result;
+    std::string toString() const {
+        return ValueType(*this).toString();
     }
-};
 
-/**
-Global function allowing scalar multiplication to occur when the scalar comes
-before the Matrix.
-*/
-template<unsigned int RowsArg, unsigned int ColsArg, typename T>
-Matrix<RowsArg, ColsArg, T> operator*(T scalar, const Matrix<RowsArg, ColsArg, T> &mat) {
-    return mat * scalar;
-}
+private:
+    const T* mData;
+    size_t mStride;
+};
 
 /**
 Base class for different vector types, allowing reuse of common vector code.
 */
-template<unsigned int SizeArg, typename T, typename DerivedType>
-class _VectorBase : public _ElementArrayBase<SizeArg, T, DerivedType> {
+template<unsigned int SizeArg, typename T, typename DerivedType, typename ValueType,
+         typename StorageType = _ArrayStorage<SizeArg, T> >
+class _VectorBase : public _ElementArrayBase<SizeArg, T, DerivedType, ValueType, StorageType> {
 
-    typedef _VectorBase<SizeArg, T, DerivedType> ThisType;
-    typedef _ElementArrayBase<SizeArg, T, DerivedType> SuperType;
+    typedef _VectorBase<SizeArg, T, DerivedType, ValueType, StorageType> ThisType;
+    typedef _ElementArrayBase<SizeArg, T, DerivedType, ValueType, StorageType> SuperType;
 
 public:
-    _VectorBase(const T* elements = NULL) : SuperType(elements) { }
+    _VectorBase(typename StorageType::InitPointer elements = NULL) : SuperType(elements) { }
 
     virtual ~_VectorBase() { }
 
+    using SuperType::operator=;
+
     /**
     Returns the magnitude of the Vector as a double.
     */
     double magnitude() const {
-        return MatrixUtil::vectorMagnitude(this->mData, SizeArg);
+        return MatrixUtil::vectorMagnitude(this->data(), SizeArg);
     }
 
     /**
     Returns true if this Vector is normalized within the MatrixUtil::DefaultNormalizedDelta range.
     */
     bool isNormalized() const {
-        return MatrixUtil::isVectorNormalized(this->mData, SizeArg);
+        return MatrixUtil::isVectorNormalized(this->data(), SizeArg);
     }
 
     /**
     Returns true if this Vector is normalized within the given delta range.
     */
     bool isNormalized(double delta) const {
-        return MatrixUtil::isVectorNormalized(this->mData, SizeArg, delta);
+        return MatrixUtil::isVectorNormalized(this->data(), SizeArg, delta);
     }
 
     /**
@@ -614,7 +2168,7 @@ public:
     (i.e., the Vector had a magnitude of 0). Otherwise, returns true.
     */
     bool normalize() {
-        return MatrixUtil::vectorNormalize(this->mData, SizeArg, this->mData) != 0;
+        return MatrixUtil::vectorNormalize(this->data(), SizeArg, this->mData) != 0;
     }
 
     /**
@@ -624,15 +2178,16 @@ public:
     if negative => the angle between the two vectors is more than 90 degrees
     if zero => the two vectors are perpendicular
     */
-    double dot(const ThisType& other) const {
-        return MatrixUtil::vectorDotProduct(this->mData, other.mData, SizeArg);
+    template<typename OtherDerived, typename OtherStorage>
+    double dot(const _ElementArrayBase<SizeArg, T, OtherDerived, ValueType, OtherStorage>& other) const {
+        return MatrixUtil::vectorDotProduct(this->data(), other.data(), SizeArg);
     }
 
     /**
     Array index operator, allowing the Vector to be treated as a single-dimensional array.
     Callers are responsible for making sure they do not exceed the length of the array.
     */
-    T& operator[](int idx) {
+    typename StorageType::Reference operator[](int idx) {
         return this->mData[idx];
     }
     const T operator[](int idx) const {
@@ -643,41 +2198,90 @@ public:
     Returns a string representation of the Vector.
     */
     std::string toString() const {
-        return MatrixUtil::toString(this->mData, 1, SizeArg);
+        return MatrixUtil::toString(this->data(), 1, SizeArg);
     }
 };
 
-// Primary vector template.
-template<unsigned int SizeArg, typename T>
-class Vector : public _VectorBase<SizeArg, T, Vector<SizeArg, T> > {
+/**
+Primary vector template. With the default StorageType the Vector owns its
+elements; see VectorMap for a Vector over caller memory.
+*/
+template<unsigned int SizeArg, typename T, typename StorageType>
+class Vector : public _VectorBase<SizeArg, T, Vector<SizeArg, T, StorageType>, Vector<SizeArg, T>, StorageType> {
 
-    typedef _VectorBase<SizeArg, T, Vector<SizeArg, T> > SuperType;
+    typedef Vector<SizeArg, T, StorageType> ThisType;
+    typedef _VectorBase<SizeArg, T, ThisType, Vector<SizeArg, T>, StorageType> SuperType;
+
+    static constexpr bool IS_OWNING = std::is_same<StorageType, _ArrayStorage<SizeArg, T> >::value;
 
 public:
-    Vector(const T* elements = NULL) : SuperType(elements) { }
+    /**
+    Creates a Vector with every element zero. A VectorMap has no memory
+    to map without an element pointer, so it cannot be created this way.
+    */
+    Vector() : SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created without an element pointer");
+    }
+
+    Vector(typename StorageType::InitPointer elements) : SuperType(elements) { }
+
+    /**
+    Creates a Vector from another of the same size. An owning Vector copies
+    the elements of other; a VectorMap maps the same memory as other, so it
+    cannot be created from a temporary owning Vector.
+    */
+    template<typename OtherStorage>
+    Vector(const Vector<SizeArg, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<SizeArg, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<SizeArg, T, OtherStorage>&& other) : SuperType(other.data()) {
+        static_assert(IS_OWNING || !std::is_same<OtherStorage, _ArrayStorage<SizeArg, T> >::value,
+                      "a VectorMap cannot be created from a temporary Vector");
+    }
 
     virtual ~Vector() { }
+
+    using SuperType::operator=;
 };
 
 // Global function allowing scalar Vector multiplication to occur when
 // the scalar comes before the Vector.
-template<unsigned int SizeArg, typename T>
-Vector<SizeArg, T> operator*(T scalar, const Vector<SizeArg, T> &vec) {
+template<unsigned int SizeArg, typename T, typename StorageType>
+Vector<SizeArg, T> operator*(T scalar, const Vector<SizeArg, T, StorageType> &vec) {
     return vec * scalar;
 }
 
 // Vector specialization with size 2.
-template<typename T>
-class Vector<2, T> : public _VectorBase<2, T, Vector<2, T> > {
+template<typename T, typename StorageType>
+class Vector<2, T, StorageType> : public _VectorBase<2, T, Vector<2, T, StorageType>, Vector<2, T>, StorageType> {
 
-    typedef Vector<2, T> ThisType;
-    typedef _VectorBase<2, T, ThisType> SuperType;
+    typedef Vector<2, T, StorageType> ThisType;
+    typedef Vector<2, T> ValueType;
+    typedef _VectorBase<2, T, ThisType, ValueType, StorageType> SuperType;
+
+    static constexpr bool IS_OWNING = std::is_same<StorageType, _ArrayStorage<2, T> >::value;
 
 public:
-    Vector(const T* elements = NULL) : SuperType(elements) { }
+    Vector() : SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created without an element pointer");
+    }
+
+    Vector(typename StorageType::InitPointer elements) : SuperType(elements) { }
+
+    template<typename OtherStorage>
+    Vector(const Vector<2, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<2, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<2, T, OtherStorage>&& other) : SuperType(other.data()) {
+        static_assert(IS_OWNING || !std::is_same<OtherStorage, _ArrayStorage<2, T> >::value,
+                      "a VectorMap cannot be created from a temporary Vector");
+    }
 
     Vector(T xValue, T yValue) :
         SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created from component values");
 
         this->mData[0] = xValue;
         this->mData[1] = yValue;
@@ -685,57 +2289,77 @@ public:
 
     virtual ~Vector() { }
 
+    using SuperType::operator=;
+
     /**
     Setter for the x value
     */
-    void x(T value) { 
+    void x(T value) {
         this->mData[0] = value;
     }
 
     /**
     Accessors for the x value.
      */
-    T& x() { return this->mData[0]; }
+    typename StorageType::Reference x() { return this->mData[0]; }
     const T x() const { return this->mData[0]; }
 
     /**
     Setter for the y value
     */
-    void y(T value) { 
+    void y(T value) {
         this->mData[1] = value;
     }
 
     /**
     Accessors for the y value.
      */
-    T& y() { return this->mData[1]; }
+    typename StorageType::Reference y() { return this->mData[1]; }
     const T y() const { return this->mData[1]; }
 
     // Returns a unit vector representing the X axis.
-    static ThisType xAxis() {
-        return ThisType(static_cast<T>(1), static_cast<T>(0));
+    static ValueType xAxis() {
+        return ValueType(static_cast<T>(1), static_cast<T>(0));
     }
 
     // Returns a unit vector representing the Y axis.
-    static ThisType yAxis() {
-        return ThisType(static_cast<T>(0), static_cast<T>(1));
+    static ValueType yAxis() {
+        return ValueType(static_cast<T>(0), static_cast<T>(1));
     }
 };
 
 
 // Vector specialization with 3 elements.
-template<typename T>
-class Vector<3, T> : public _VectorBase<3, T, Vector<3, T> > {
+template<typename T, typename StorageType>
+class Vector<3, T, StorageType> : public _VectorBase<3, T, Vector<3, T, StorageType>, Vector<3, T>, StorageType> {
+
+    typedef Vector<3, T, StorageType> ThisType;
+    typedef Vector<3, T> ValueType;
+    typedef _VectorBase<3, T, ThisType, ValueType, StorageType> SuperType;
 
-    typedef Vector<3, T> ThisType;
-    typedef _VectorBase<3, T, ThisType> SuperType;
+    static constexpr bool IS_OWNING = std::is_same<StorageType, _ArrayStorage<3, T> >::value;
 
 public:
-    
-    Vector(const T* elements = NULL) : SuperType(elements) { }
+
+    Vector() : SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created without an element pointer");
+    }
+
+    Vector(typename StorageType::InitPointer elements) : SuperType(elements) { }
+
+    template<typename OtherStorage>
+    Vector(const Vector<3, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<3, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<3, T, OtherStorage>&& other) : SuperType(other.data()) {
+        static_assert(IS_OWNING || !std::is_same<OtherStorage, _ArrayStorage<3, T> >::value,
+                      "a VectorMap cannot be created from a temporary Vector");
+    }
 
     Vector(T xValue, T yValue, T zValue) :
         SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created from component values");
 
         this->mData[0] = xValue;
         this->mData[1] = yValue;
@@ -744,81 +2368,102 @@ public:
 
     virtual ~Vector() { }
 
+    using SuperType::operator=;
+
     /**
     Setter for the x value
     */
-    void x(T value) { 
+    void x(T value) {
         this->mData[0] = value;
     }
 
     /**
     Accessors for the x value.
      */
-    T& x() { return this->mData[0]; }
+    typename StorageType::Reference x() { return this->mData[0]; }
     const T x() const { return this->mData[0]; }
 
     /**
     Setter for the y value
     */
-    void y(T value) { 
+    void y(T value) {
         this->mData[1] = value;
     }
 
     /**
     Accessors for the y value.
      */
-    T& y() { return this->mData[1]; }
+    typename StorageType::Reference y() { return this->mData[1]; }
     const T y() const { return this->mData[1]; }
 
     /**
     Setter for the z value
     */
-    void z(T value) { 
+    void z(T value) {
         this->mData[2] = value;
     }
 
     /**
     Accessors for the z value.
      */
-    T& z() { return this->mData[2]; }
+    typename StorageType::Reference z() { return this->mData[2]; }
     const T z() const { return this->mData[2]; }
 
-    ThisType cross(const ThisType& other) const {
-        ThisType result;
-        MatrixUtil::vectorCrossProduct(this->mData, other.mData, result.data());
+    template<typename OtherStorage>
+    ValueType cross(const Vector<3, T, OtherStorage>& other) const {
+        ValueType result;
+        MatrixUtil::vectorCrossProduct(this->data(), other.data(), result.data());
         return result;
     }
 
     // Returns a unit vector representing the X axis.
-    static ThisType xAxis() {
-        return ThisType(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
+    static ValueType xAxis() {
+        return ValueType(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
     }
 
     // Returns a unit vector representing the Y axis.
-    static ThisType yAxis() {
-        return ThisType(static_cast<T>(0), static_cast<T>(1), static_cast<T>(0));
+    static ValueType yAxis() {
+        return ValueType(static_cast<T>(0), static_cast<T>(1), static_cast<T>(0));
     }
 
     // Returns a unit vector representing the Z axis.
-    static ThisType zAxis() {
-        return ThisType(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1));
+    static ValueType zAxis() {
+        return ValueType(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1));
     }
 };
 
 
 // Vector specialization with 4 elements.
-template<typename T>
-class Vector<4, T> : public _VectorBase<4, T, Vector<4, T> > {
+template<typename T, typename StorageType>
+class Vector<4, T, StorageType> : public _VectorBase<4, T, Vector<4, T, StorageType>, Vector<4, T>, StorageType> {
+
+    typedef Vector<4, T, StorageType> ThisType;
+    typedef Vector<4, T> ValueType;
+    typedef _VectorBase<4, T, ThisType, ValueType, StorageType> SuperType;
 
-    typedef Vector<4, T> ThisType;
-    typedef _VectorBase<4, T, ThisType > SuperType;
+    static constexpr bool IS_OWNING = std::is_same<StorageType, _ArrayStorage<4, T> >::value;
 
 public:
 
-    Vector(const T* elements = NULL) : SuperType(elements) { }
+    Vector() : SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created without an element pointer");
+    }
+
+    Vector(typename StorageType::InitPointer elements) : SuperType(elements) { }
+
+    template<typename OtherStorage>
+    Vector(const Vector<4, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<4, T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Vector(Vector<4, T, OtherStorage>&& other) : SuperType(other.data()) {
+        static_assert(IS_OWNING || !std::is_same<OtherStorage, _ArrayStorage<4, T> >::value,
+                      "a VectorMap cannot be created from a temporary Vector");
+    }
 
     Vector(T xValue, T yValue, T zValue, T wValue) :
         SuperType() {
+        static_assert(IS_OWNING, "a VectorMap cannot be created from component values");
 
         this->mData[0] = xValue;
         this->mData[1] = yValue;
@@ -828,79 +2473,102 @@ public:
 
     virtual ~Vector() { }
 
+    using SuperType::operator=;
+
     /**
     Setter for the x value
     */
-    void x(T value) { 
+    void x(T value) {
         this->mData[0] = value;
     }
 
     /**
     Accessors for the x value.
      */
-    T& x() { return this->mData[0]; }
+    typename StorageType::Reference x() { return this->mData[0]; }
     const T x() const { return this->mData[0]; }
 
     /**
     Setter for the y value
     */
-    void y(T value) { 
+    void y(T value) {
         this->mData[1] = value;
     }
 
     /**
     Accessors for the y value.
      */
-    T& y() { return this->mData[1]; }
+    typename StorageType::Reference y() { return this->mData[1]; }
     const T y() const { return this->mData[1]; }
 
     /**
     Setter for the z value
     */
-    void z(T value) { 
+    void z(T value) {
         this->mData[2] = value;
     }
 
     /**
     Accessors for the z value.
      */
-    T& z() { return this->mData[2]; }
+    typename StorageType::Reference z() { return this->mData[2]; }
     const T z() const { return this->mData[2]; }
 
     /**
     Setter for the w value
     */
-    void w(T value) { 
+    void w(T value) {
         this->mData[3] = value;
     }
 
     /**
     Accessors for the w value.
      */
-    T& w() { return this->mData[3]; }
+    typename StorageType::Reference w() { return this->mData[3]; }
     const T w() const { return this->mData[3]; }
 
     // Returns a unit vector representing the X axis.
-    static ThisType xAxis() {
-        return ThisType(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0));
+    static ValueType xAxis() {
+        return ValueType(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0));
     }
 
     // Returns a unit vector representing the Y axis.
-    static ThisType yAxis() {
-        return ThisType(static_cast<T>(0), static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
+    static ValueType yAxis() {
+        return ValueType(static_cast<T>(0), static_cast<T>(1), static_cast<T>(0), static_cast<T>(0));
     }
 
     // Returns a unit vector representing the Z axis.
-    static ThisType zAxis() {
-        return ThisType(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1), static_cast<T>(0));
+    static ValueType zAxis() {
+        return ValueType(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1), static_cast<T>(0));
     }
 
     // Returns a unit vector representing the W axis.
-    static ThisType wAxis() {
-        return ThisType(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(1));
+    static ValueType wAxis() {
+        return ValueType(static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(1));
     }
 };
 
+/**
+Matrix over caller memory holding RowsArg * ColsArg elements in the given
+layout, row-major by default. No elements are copied when the map is created; reads and writes
+go straight to the caller's memory, which must outlive the map. Use a
+const T for a read-only map, e.g. MatrixMap<4, 4, const float>.
+Arithmetic that produces a new value returns an owning Matrix.
+
+    float buffer[16];
+    MatrixMap<4, 4, float> m(buffer);
+    m *= rotation;   // buffer now holds the product
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, typename T = double,
+         MatrixLayout LayoutArg = MatrixLayout::ROW_MAJOR>
+using MatrixMap = Matrix<RowsArg, ColsArg, typename std::remove_const<T>::type, LayoutArg, _MappedStorage<T> >;
+
+/**
+Vector over caller memory holding SizeArg elements. See MatrixMap.
+*/
+template<unsigned int SizeArg, typename T = double>
+using VectorMap = Vector<SizeArg, typename std::remove_const<T>::type, _MappedStorage<T> >;
+
 // create some useful typedefs
 typedef Matrix<4, 4, double> Mat4d;
 typedef Matrix<4, 4, float> Mat4f;
@@ -0,0 +1,618 @@
+/**
+ * matrix_batch.h
+ *
+ * Contains a container and kernels for operating on many small matrices
+ * at once, with the matrices interleaved element by element so that each
+ * operation runs across a whole group of matrices per instruction.
+ */
+
+#ifndef _DKM_MATRIX_BATCH_H_
+#define _DKM_MATRIX_BATCH_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "matrix.h"
+
+// darkma773r namespace
+namespace dkm {
+
+/**
+Default number of matrices interleaved in each group of a MatrixBatch.
+Eight floats fill an AVX register; 16 fill an AVX-512 register, or two
+AVX registers.
+*/
+const unsigned int DEFAULT_BATCH_LANES = 8;
+
+/**
+Namespace containing array-based versions of the batch operations. The
+arrays hold groups of LanesArg matrices in "array of structures of
+arrays" (AoSoA) order: within a group, element e of the matrix in lane l
+is at e*LanesArg + l, with e counted in row-major order. A group of
+RowsArg x ColsArg matrices therefore takes RowsArg*ColsArg*LanesArg
+elements, and the groups follow one another. Every kernel loops over the
+lanes innermost, so each step is a single SIMD operation across the
+group. For consistency with MatrixUtil, any function that writes data to
+an external array returns the number of elements written to that array.
+Output arrays must not overlap the inputs.
+*/
+namespace MatrixBatchUtil {
+
+/**
+Writes a[l]*b[l] - c[l]*d[l] to dest[l] for each of the LanesArg lanes.
+The lane helpers below are the building blocks of the kernels; each is a
+single loop over the lanes that the compiler turns into SIMD operations.
+*/
+template<unsigned int LanesArg, typename T>
+inline void _lanesDifferenceOfProducts(const T* a, const T* b, const T* c, const T* d, T* dest) {
+    for (int l=0; l<LanesArg; ++l) {
+        dest[l] = a[l]*b[l] - c[l]*d[l];
+    }
+}
+
+/**
+Writes (a[l]*x[l] - b[l]*y[l] + c[l]*z[l]) * scale[l] to dest[l] for each
+of the LanesArg lanes.
+*/
+template<unsigned int LanesArg, typename T>
+inline void _lanesScaledCofactor(const T* a, const T* x, const T* b, const T* y, const T* c, const T* z,
+                                 const T* scale, T* dest) {
+    for (int l=0; l<LanesArg; ++l) {
+        dest[l] = (a[l]*x[l] - b[l]*y[l] + c[l]*z[l]) * scale[l];
+    }
+}
+
+/**
+Multiplies each RowsArg x InnerArg matrix of a with the InnerArg x ColsArg
+matrix in the same lane of b and writes the RowsArg x ColsArg products to
+out, for the given number of groups. Each row of a group of A is loaded
+once and reused for every column of B.
+*/
+template<unsigned int RowsArg, unsigned int InnerArg, unsigned int ColsArg, unsigned int LanesArg, typename T>
+size_t multiply(const T* a, const T* b, T* out, size_t groups) {
+    for (size_t g=0; g<groups; ++g) {
+        const T* ga = a + (g * RowsArg * InnerArg * LanesArg);
+        const T* gb = b + (g * InnerArg * ColsArg * LanesArg);
+        T* gout = out + (g * RowsArg * ColsArg * LanesArg);
+
+        for (int i=0; i<RowsArg; ++i) {
+            T aRow[InnerArg * LanesArg];
+            for (int e=0; e<InnerArg * LanesArg; ++e) {
+                aRow[e] = ga[i * InnerArg * LanesArg + e];
+            }
+
+            for (int j=0; j<ColsArg; ++j) {
+                T acc[LanesArg];
+                for (int l=0; l<LanesArg; ++l) {
+                    acc[l] = aRow[l] * gb[j * LanesArg + l];
+                }
+                for (int m=1; m<InnerArg; ++m) {
+                    const T* bCol = gb + (m * ColsArg + j) * LanesArg;
+                    for (int l=0; l<LanesArg; ++l) {
+                        acc[l] = acc[l] + aRow[m * LanesArg + l] * bCol[l];
+                    }
+                }
+                T* dest = gout + (i * ColsArg + j) * LanesArg;
+                for (int l=0; l<LanesArg; ++l) {
+                    dest[l] = acc[l];
+                }
+            }
+        }
+    }
+    return groups * RowsArg * ColsArg * LanesArg;
+}
+
+/**
+Treats each group of ColsArg-element vectors in vecs as column matrices
+and multiplies them with the RowsArg x ColsArg matrices in the same lanes
+of m, writing the RowsArg-element results to out. Component k of the
+vector in lane l is at k*LanesArg + l within its group.
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, unsigned int LanesArg, typename T>
+size_t transformVectors(const T* m, const T* vecs, T* out, size_t groups) {
+    return multiply<RowsArg, ColsArg, 1, LanesArg>(m, vecs, out, groups);
+}
+
+/**
+Fills cof with the cofactors of the first column of each 3x3 matrix in the
+group a, three rows of LanesArg elements, and det with the determinants.
+*/
+template<unsigned int LanesArg, typename T>
+inline void _cofactors3x3(const T* a, T* cof, T* det) {
+    const T* a00 = a;               const T* a01 = a + LanesArg;     const T* a02 = a + 2*LanesArg;
+    const T* a10 = a + 3*LanesArg;  const T* a11 = a + 4*LanesArg;  const T* a12 = a + 5*LanesArg;
+    const T* a20 = a + 6*LanesArg;  const T* a21 = a + 7*LanesArg;  const T* a22 = a + 8*LanesArg;
+
+    _lanesDifferenceOfProducts<LanesArg>(a11, a22, a12, a21, cof);
+    _lanesDifferenceOfProducts<LanesArg>(a12, a20, a10, a22, cof + LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a10, a21, a11, a20, cof + 2*LanesArg);
+    for (int l=0; l<LanesArg; ++l) {
+        det[l] = a00[l]*cof[l] + a01[l]*cof[LanesArg + l] + a02[l]*cof[2*LanesArg + l];
+    }
+}
+
+/**
+Writes the determinant of each 3x3 matrix of m to dest, which holds
+LanesArg elements per group.
+*/
+template<unsigned int LanesArg, typename T>
+size_t determinant3x3(const T* m, T* dest, size_t groups) {
+    for (size_t g=0; g<groups; ++g) {
+        T cof[3 * LanesArg];
+        _cofactors3x3<LanesArg>(m + (g * 9 * LanesArg), cof, dest + (g * LanesArg));
+    }
+    return groups * LanesArg;
+}
+
+/**
+Inverts each 3x3 matrix of m by the adjugate method and writes the
+results to out. The kernel does not branch on the determinant, so a
+singular matrix produces non-finite elements in its lane only; use
+determinant3x3() to check beforehand where that matters.
+*/
+template<unsigned int LanesArg, typename T>
+size_t inverse3x3(const T* m, T* out, size_t groups) {
+    for (size_t g=0; g<groups; ++g) {
+        // work on a local copy so that the lane loops don't have to allow
+        // for out overlapping m
+        T a[9 * LanesArg];
+        for (int e=0; e<9 * LanesArg; ++e) {
+            a[e] = m[g * 9 * LanesArg + e];
+        }
+        T* gout = out + (g * 9 * LanesArg);
+
+        const T* a00 = a;               const T* a01 = a + LanesArg;     const T* a02 = a + 2*LanesArg;
+        const T* a10 = a + 3*LanesArg;  const T* a11 = a + 4*LanesArg;  const T* a12 = a + 5*LanesArg;
+        const T* a20 = a + 6*LanesArg;  const T* a21 = a + 7*LanesArg;  const T* a22 = a + 8*LanesArg;
+
+        T cof[3 * LanesArg];
+        T invDet[LanesArg];
+        _cofactors3x3<LanesArg>(a, cof, invDet);
+        for (int l=0; l<LanesArg; ++l) {
+            invDet[l] = static_cast<T>(1) / invDet[l];
+        }
+
+        T adj[9 * LanesArg];
+        _lanesDifferenceOfProducts<LanesArg>(a02, a21, a01, a22, adj + 1*LanesArg);
+        _lanesDifferenceOfProducts<LanesArg>(a01, a12, a02, a11, adj + 2*LanesArg);
+        _lanesDifferenceOfProducts<LanesArg>(a00, a22, a02, a20, adj + 4*LanesArg);
+        _lanesDifferenceOfProducts<LanesArg>(a02, a10, a00, a12, adj + 5*LanesArg);
+        _lanesDifferenceOfProducts<LanesArg>(a01, a20, a00, a21, adj + 7*LanesArg);
+        _lanesDifferenceOfProducts<LanesArg>(a00, a11, a01, a10, adj + 8*LanesArg);
+        for (int l=0; l<LanesArg; ++l) {
+            adj[l] = cof[l];
+            adj[3*LanesArg + l] = cof[LanesArg + l];
+            adj[6*LanesArg + l] = cof[2*LanesArg + l];
+        }
+
+        for (int e=0; e<9; ++e) {
+            for (int l=0; l<LanesArg; ++l) {
+                gout[e * LanesArg + l] = adj[e * LanesArg + l] * invDet[l];
+            }
+        }
+    }
+    return groups * 9 * LanesArg;
+}
+
+/**
+Fills s and c with the 2x2 minors of the top and bottom row pairs of each
+4x4 matrix in the group a, six rows of LanesArg elements each, and det
+with the determinants (Laplace expansion).
+*/
+template<unsigned int LanesArg, typename T>
+inline void _minors4x4(const T* a, T* s, T* c, T* det) {
+    const T* a00 = a;                const T* a01 = a + LanesArg;      const T* a02 = a + 2*LanesArg;
+    const T* a03 = a + 3*LanesArg;   const T* a10 = a + 4*LanesArg;    const T* a11 = a + 5*LanesArg;
+    const T* a12 = a + 6*LanesArg;   const T* a13 = a + 7*LanesArg;    const T* a20 = a + 8*LanesArg;
+    const T* a21 = a + 9*LanesArg;   const T* a22 = a + 10*LanesArg;   const T* a23 = a + 11*LanesArg;
+    const T* a30 = a + 12*LanesArg;  const T* a31 = a + 13*LanesArg;   const T* a32 = a + 14*LanesArg;
+    const T* a33 = a + 15*LanesArg;
+
+    _lanesDifferenceOfProducts<LanesArg>(a00, a11, a10, a01, s);
+    _lanesDifferenceOfProducts<LanesArg>(a00, a12, a10, a02, s + 1*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a00, a13, a10, a03, s + 2*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a01, a12, a11, a02, s + 3*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a01, a13, a11, a03, s + 4*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a02, a13, a12, a03, s + 5*LanesArg);
+
+    _lanesDifferenceOfProducts<LanesArg>(a20, a31, a30, a21, c);
+    _lanesDifferenceOfProducts<LanesArg>(a20, a32, a30, a22, c + 1*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a20, a33, a30, a23, c + 2*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a21, a32, a31, a22, c + 3*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a21, a33, a31, a23, c + 4*LanesArg);
+    _lanesDifferenceOfProducts<LanesArg>(a22, a33, a32, a23, c + 5*LanesArg);
+
+    for (int l=0; l<LanesArg; ++l) {
+        det[l] = s[l] * c[5*LanesArg + l] - s[LanesArg + l] * c[4*LanesArg + l] +
+                 s[2*LanesArg + l] * c[3*LanesArg + l] + s[3*LanesArg + l] * c[2*LanesArg + l] -
+                 s[4*LanesArg + l] * c[LanesArg + l] + s[5*LanesArg + l] * c[l];
+    }
+}
+
+/**
+Writes the determinant of each 4x4 matrix of m to dest, which holds
+LanesArg elements per group.
+*/
+template<unsigned int LanesArg, typename T>
+size_t determinant4x4(const T* m, T* dest, size_t groups) {
+    for (size_t g=0; g<groups; ++g) {
+        T s[6 * LanesArg];
+        T c[6 * LanesArg];
+        _minors4x4<LanesArg>(m + (g * 16 * LanesArg), s, c, dest + (g * LanesArg));
+    }
+    return groups * LanesArg;
+}
+
+/**
+Inverts each 4x4 matrix of m and writes the results to out. The inverse
+is built from the 2x2 minors of the top and bottom row pairs, which needs
+about a third of the multiplications of a cofactor expansion. As with
+inverse3x3(), singular matrices produce non-finite elements in their own
+lanes.
+*/
+template<unsigned int LanesArg, typename T>
+size_t inverse4x4(const T* m, T* out, size_t groups) {
+    for (size_t g=0; g<groups; ++g) {
+        // work on a local copy so that the lane loops don't have to allow
+        // for out overlapping m
+        T a[16 * LanesArg];
+        for (int e=0; e<16 * LanesArg; ++e) {
+            a[e] = m[g * 16 * LanesArg + e];
+        }
+        T* gout = out + (g * 16 * LanesArg);
+
+        const T* a00 = a;                const T* a01 = a + LanesArg;      const T* a02 = a + 2*LanesArg;
+        const T* a03 = a + 3*LanesArg;   const T* a10 = a + 4*LanesArg;    const T* a11 = a + 5*LanesArg;
+        const T* a12 = a + 6*LanesArg;   const T* a13 = a + 7*LanesArg;    const T* a20 = a + 8*LanesArg;
+        const T* a21 = a + 9*LanesArg;   const T* a22 = a + 10*LanesArg;   const T* a23 = a + 11*LanesArg;
+        const T* a30 = a + 12*LanesArg;  const T* a31 = a + 13*LanesArg;   const T* a32 = a + 14*LanesArg;
+        const T* a33 = a + 15*LanesArg;
+
+        T s[6 * LanesArg];
+        T c[6 * LanesArg];
+        T invDet[LanesArg];
+        T negInvDet[LanesArg];
+        _minors4x4<LanesArg>(a, s, c, invDet);
+        for (int l=0; l<LanesArg; ++l) {
+            invDet[l] = static_cast<T>(1) / invDet[l];
+            negInvDet[l] = -invDet[l];
+        }
+
+        const T* s0 = s;                const T* s1 = s + LanesArg;     const T* s2 = s + 2*LanesArg;
+        const T* s3 = s + 3*LanesArg;   const T* s4 = s + 4*LanesArg;   const T* s5 = s + 5*LanesArg;
+        const T* c0 = c;                const T* c1 = c + LanesArg;     const T* c2 = c + 2*LanesArg;
+        const T* c3 = c + 3*LanesArg;   const T* c4 = c + 4*LanesArg;   const T* c5 = c + 5*LanesArg;
+
+        _lanesScaledCofactor<LanesArg>(a11, c5, a12, c4, a13, c3, invDet, gout + 0*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a01, c5, a02, c4, a03, c3, negInvDet, gout + 1*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a31, s5, a32, s4, a33, s3, invDet, gout + 2*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a21, s5, a22, s4, a23, s3, negInvDet, gout + 3*LanesArg);
+
+        _lanesScaledCofactor<LanesArg>(a10, c5, a12, c2, a13, c1, negInvDet, gout + 4*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a00, c5, a02, c2, a03, c1, invDet, gout + 5*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a30, s5, a32, s2, a33, s1, negInvDet, gout + 6*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a20, s5, a22, s2, a23, s1, invDet, gout + 7*LanesArg);
+
+        _lanesScaledCofactor<LanesArg>(a10, c4, a11, c2, a13, c0, invDet, gout + 8*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a00, c4, a01, c2, a03, c0, negInvDet, gout + 9*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a30, s4, a31, s2, a33, s0, invDet, gout + 10*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a20, s4, a21, s2, a23, s0, negInvDet, gout + 11*LanesArg);
+
+        _lanesScaledCofactor<LanesArg>(a10, c3, a11, c1, a12, c0, negInvDet, gout + 12*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a00, c3, a01, c1, a02, c0, invDet, gout + 13*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a30, s3, a31, s1, a32, s0, negInvDet, gout + 14*LanesArg);
+        _lanesScaledCofactor<LanesArg>(a20, s3, a21, s1, a22, s0, invDet, gout + 15*LanesArg);
+    }
+    return groups * 16 * LanesArg;
+}
+
+} // end MatrixBatchUtil namespace
+
+/**
+Selects the square matrix kernels of MatrixBatchUtil for a given
+dimension. Only 3x3 and 4x4 matrices are supported.
+*/
+template<unsigned int DimArg>
+struct _BatchSquareKernels;
+
+template<>
+struct _BatchSquareKernels<3> {
+    template<unsigned int LanesArg, typename T>
+    static void determinant(const T* m, T* dest, size_t groups) {
+        MatrixBatchUtil::determinant3x3<LanesArg>(m, dest, groups);
+    }
+    template<unsigned int LanesArg, typename T>
+    static void inverse(const T* m, T* out, size_t groups) {
+        MatrixBatchUtil::inverse3x3<LanesArg>(m, out, groups);
+    }
+};
+
+template<>
+struct _BatchSquareKernels<4> {
+    template<unsigned int LanesArg, typename T>
+    static void determinant(const T* m, T* dest, size_t groups) {
+        MatrixBatchUtil::determinant4x4<LanesArg>(m, dest, groups);
+    }
+    template<unsigned int LanesArg, typename T>
+    static void inverse(const T* m, T* out, size_t groups) {
+        MatrixBatchUtil::inverse4x4<LanesArg>(m, out, groups);
+    }
+};
+
+/**
+Container for a number of independent RowsArg x ColsArg matrices stored
+in groups of LanesArg, interleaved element by element (see
+MatrixBatchUtil). A single Matrix<4, 4> operation is too small to fill a
+SIMD register, while the same operation on a batch runs across LanesArg
+matrices at a time:
+
+    std::vector<Mat4f> bones = ...;
+    std::vector<Mat4f> bindInverses = ...;
+    MatrixBatch<4, 4, float> skin(bones.data(), bones.size());
+    skin *= MatrixBatch<4, 4, float>(bindInverses.data(), bindInverses.size());
+    skin.copyTo(bones.data());
+
+Matrices are converted from and to arrays of Matrix objects of either
+layout, or accessed one at a time with get() and set(). Batch operations
+pair up matrices by index. If the operands hold different numbers of
+matrices, the result holds as many as the smaller operand. The last group
+is padded to a full LanesArg matrices; the padding lanes take part in
+every operation and their contents are unspecified.
+*/
+template<unsigned int RowsArg, unsigned int ColsArg, typename T = double,
+         unsigned int LanesArg = DEFAULT_BATCH_LANES>
+class MatrixBatch {
+
+    typedef MatrixBatch<RowsArg, ColsArg, T, LanesArg> ThisType;
+
+public:
+    /**
+    Creates a batch of count zero matrices.
+    */
+    MatrixBatch(size_t count = 0) : mSize(0) {
+        resize(count);
+    }
+
+    /**
+    Creates a batch holding copies of the count matrices in matrices.
+    */
+    template<MatrixLayout LayoutArg, typename StorageType>
+    MatrixBatch(const Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType>* matrices, size_t count) : mSize(0) {
+        copyFrom(matrices, count);
+    }
+
+    /**
+    Creates a batch of column matrices holding copies of the count vectors
+    in vectors.
+    */
+    template<typename StorageType>
+    MatrixBatch(const Vector<RowsArg, T, StorageType>* vectors, size_t count) : mSize(0) {
+        copyFrom(vectors, count);
+    }
+
+    /**
+    Returns the number of matrices in the batch.
+    */
+    size_t size() const {
+        return mSize;
+    }
+
+    /**
+    Returns the number of groups of LanesArg matrices in the batch.
+    */
+    size_t groups() const {
+        return (mSize + LanesArg - 1) / LanesArg;
+    }
+
+    /**
+    Returns the number of matrices in each group.
+    */
+    static unsigned int lanes() {
+        return LanesArg;
+    }
+
+    /**
+    Changes the number of matrices in the batch. Matrices below the new
+    size are kept and any new ones are zero.
+    */
+    void resize(size_t count) {
+        size_t oldSize = mSize;
+        size_t oldLanes = groups() * LanesArg;
+        mSize = count;
+        mData.resize(groups() * GROUP_SIZE, static_cast<T>(0));
+
+        // the unused lanes of the old last group may still hold matrices
+        // from before an earlier shrink, so clear the ones now in use
+        for (size_t idx = oldSize; idx < count && idx < oldLanes; ++idx) {
+            T* dest = mData.data() + elementOffset(idx);
+            for (int e=0; e<RowsArg * ColsArg; ++e) {
+                dest[e * LanesArg] = static_cast<T>(0);
+            }
+        }
+    }
+
+    /**
+    Returns a pointer to the interleaved element array, which holds
+    groups() * RowsArg * ColsArg * LanesArg elements.
+    */
+    T* data() {
+        return mData.data();
+    }
+    const T* data() const {
+        return mData.data();
+    }
+
+    /**
+    Overload the "()" operator to allow direct access to the element at
+    rowIdx, colIdx of the matrix at index idx. Callers are responsible for
+    staying within the bounds of the batch.
+    */
+    T& operator()(size_t idx, size_t rowIdx, size_t colIdx) {
+        return mData[elementOffset(idx) + (rowIdx * ColsArg + colIdx) * LanesArg];
+    }
+    const T operator()(size_t idx, size_t rowIdx, size_t colIdx) const {
+        return mData[elementOffset(idx) + (rowIdx * ColsArg + colIdx) * LanesArg];
+    }
+
+    /**
+    Copies mat into the batch at index idx.
+    */
+    template<MatrixLayout LayoutArg, typename StorageType>
+    void set(size_t idx, const Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType>& mat) {
+        MatrixUtil::copy(mat.data(), mat.rowStride(), mat.colStride(),
+                         mData.data() + elementOffset(idx), ColsArg * LanesArg, LanesArg,
+                         RowsArg, ColsArg);
+    }
+
+    /**
+    Copies vec into the batch of column matrices at index idx.
+    */
+    template<typename StorageType>
+    void set(size_t idx, const Vector<RowsArg, T, StorageType>& vec) {
+        static_assert(ColsArg == 1, "only a batch of column matrices can hold a Vector");
+        MatrixUtil::copy(vec.data(), 1, 1, mData.data() + elementOffset(idx), LanesArg, LanesArg, RowsArg, 1);
+    }
+
+    /**
+    Returns a copy of the matrix at index idx.
+    */
+    Matrix<RowsArg, ColsArg, T> get(size_t idx) const {
+        Matrix<RowsArg, ColsArg, T> result;
+        MatrixUtil::copy(mData.data() + elementOffset(idx), ColsArg * LanesArg, LanesArg,
+                         result.data(), ColsArg, 1, RowsArg, ColsArg);
+        return result;
+    }
+
+    /**
+    Replaces the contents of the batch with copies of the count matrices in
+    matrices.
+    */
+    template<MatrixLayout LayoutArg, typename StorageType>
+    void copyFrom(const Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType>* matrices, size_t count) {
+        resize(count);
+        for (size_t i=0; i<count; ++i) {
+            set(i, matrices[i]);
+        }
+    }
+    template<typename StorageType>
+    void copyFrom(const Vector<RowsArg, T, StorageType>* vectors, size_t count) {
+        resize(count);
+        for (size_t i=0; i<count; ++i) {
+            set(i, vectors[i]);
+        }
+    }
+
+    /**
+    Copies every matrix of the batch into matrices, which must hold at
+    least size() elements.
+    */
+    template<MatrixLayout LayoutArg, typename StorageType>
+    void copyTo(Matrix<RowsArg, ColsArg, T, LayoutArg, StorageType>* matrices) const {
+        for (size_t i=0; i<mSize; ++i) {
+            MatrixUtil::copy(mData.data() + elementOffset(i), ColsArg * LanesArg, LanesArg,
+                             matrices[i].data(), matrices[i].rowStride(), matrices[i].colStride(),
+                             RowsArg, ColsArg);
+        }
+    }
+    template<typename StorageType>
+    void copyTo(Vector<RowsArg, T, StorageType>* vectors) const {
+        static_assert(ColsArg == 1, "only a batch of column matrices can be copied to Vectors");
+        for (size_t i=0; i<mSize; ++i) {
+            MatrixUtil::copy(mData.data() + elementOffset(i), LanesArg, LanesArg,
+                             vectors[i].data(), 1, 1, RowsArg, 1);
+        }
+    }
+
+    /**
+    Multiplies each matrix of the batch with the matrix at the same index
+    of other and returns a new batch with the products.
+    */
+    template<unsigned int OtherColsArg>
+    MatrixBatch<RowsArg, OtherColsArg, T, LanesArg> multiply(
+            const MatrixBatch<ColsArg, OtherColsArg, T, LanesArg>& other) const {
+        MatrixBatch<RowsArg, OtherColsArg, T, LanesArg> result(std::min(mSize, other.size()));
+        MatrixBatchUtil::multiply<RowsArg, ColsArg, OtherColsArg, LanesArg>(
+            data(), other.data(), result.data(), result.groups());
+        return result;
+    }
+
+    /**
+    Alias for multiply()
+    */
+    template<unsigned int OtherColsArg>
+    MatrixBatch<RowsArg, OtherColsArg, T, LanesArg> operator*(
+            const MatrixBatch<ColsArg, OtherColsArg, T, LanesArg>& rh) const {
+        return multiply(rh);
+    }
+
+    /**
+    Same as multiply() but assigns the answer to the caller. Only square
+    matrices with the same number of columns as the caller are accepted.
+    */
+    void multiplyAssign(const MatrixBatch<ColsArg, ColsArg, T, LanesArg>& other) {
+        ThisType result = multiply(other);
+        mData.swap(result.mData);
+        mSize = result.mSize;
+    }
+
+    /**
+    Alias for multiplyAssign()
+    */
+    ThisType& operator*=(const MatrixBatch<ColsArg, ColsArg, T, LanesArg>& other) {
+        multiplyAssign(other);
+        return *this;
+    }
+
+    /**
+    Treats each matrix of vecs as a column vector and multiplies it with the
+    matrix at the same index of the batch, returning the transformed vectors.
+    */
+    MatrixBatch<RowsArg, 1, T, LanesArg> transformVectors(const MatrixBatch<ColsArg, 1, T, LanesArg>& vecs) const {
+        MatrixBatch<RowsArg, 1, T, LanesArg> result(std::min(mSize, vecs.size()));
+        MatrixBatchUtil::transformVectors<RowsArg, ColsArg, LanesArg>(
+            data(), vecs.data(), result.data(), result.groups());
+        return result;
+    }
+
+    /**
+    Returns a batch of 1 x 1 matrices holding the determinant of each
+    matrix. Only 3x3 and 4x4 batches are supported.
+    */
+    MatrixBatch<1, 1, T, LanesArg> determinant() const {
+        static_assert(RowsArg == ColsArg && (RowsArg == 3 || RowsArg == 4),
+                      "determinant() is only available for batches of 3x3 and 4x4 matrices");
+        MatrixBatch<1, 1, T, LanesArg> result(mSize);
+        _BatchSquareKernels<RowsArg>::template determinant<LanesArg>(data(), result.data(), groups());
+        return result;
+    }
+
+    /**
+    Returns a batch holding the inverse of each matrix. Only 3x3 and 4x4
+    batches are supported. A singular matrix produces non-finite elements
+    in its own result without affecting the others.
+    */
+    ThisType inverse() const {
+        static_assert(RowsArg == ColsArg && (RowsArg == 3 || RowsArg == 4),
+                      "inverse() is only available for batches of 3x3 and 4x4 matrices");
+        ThisType result(mSize);
+        _BatchSquareKernels<RowsArg>::template inverse<LanesArg>(data(), result.data(), groups());
+        return result;
+    }
+
+private:
+    static const size_t GROUP_SIZE = RowsArg * ColsArg * LanesArg;
+
+    /**
+    Returns the offset of the first element of the matrix at index idx.
+    */
+    static size_t elementOffset(size_t idx) {
+        return (idx / LanesArg) * GROUP_SIZE + (idx % LanesArg);
+    }
+
+    std::vector<T> mData;
+    size_t mSize;
+};
+
+} // end dkm namespace
+
+#endif
@@ -185,26 +185,103 @@ size_t toRotationMatrix4x4(const T* quat, T* destMatrix) {
     return _ToRotationMatrixInternal(quat, destMatrix, true);
 }
 
+// Converts the 3x3 rotation matrix at the start of mat into a unit quaternion,
+// storing the result in dest. stride is the number of elements between the
+// starts of consecutive rows, so the rotation part of a 4x4 or 3x4 transform can
+// be read in place with a stride of 4. The matrix must be orthonormal. Returns the
+// number of elements written to dest, which is 4.
+template<typename T>
+size_t rotationMatrixToQuaternion(const T* mat, size_t stride, T* dest) {
+    // Shepperd's method: divide by the largest of w, x, y and z to stay accurate
+    const T* r0 = mat;
+    const T* r1 = mat + stride;
+    const T* r2 = mat + 2*stride;
+
+    double trace = r0[0] + r1[1] + r2[2];
+    if (trace > 0) {
+        double s = sqrt(trace + 1.0) * 2.0;
+        dest[0] = (r2[1] - r1[2]) / s;
+        dest[1] = (r0[2] - r2[0]) / s;
+        dest[2] = (r1[0] - r0[1]) / s;
+        dest[3] = 0.25 * s;
+    } else if (r0[0] > r1[1] && r0[0] > r2[2]) {
+        double s = sqrt(1.0 + r0[0] - r1[1] - r2[2]) * 2.0;
+        dest[0] = 0.25 * s;
+        dest[1] = (r0[1] + r1[0]) / s;
+        dest[2] = (r0[2] + r2[0]) / s;
+        dest[3] = (r2[1] - r1[2]) / s;
+    } else if (r1[1] > r2[2]) {
+        double s = sqrt(1.0 + r1[1] - r0[0] - r2[2]) * 2.0;
+        dest[0] = (r0[1] + r1[0]) / s;
+        dest[1] = 0.25 * s;
+        dest[2] = (r1[2] + r2[1]) / s;
+        dest[3] = (r0[2] - r2[0]) / s;
+    } else {
+        double s = sqrt(1.0 + r2[2] - r0[0] - r1[1]) * 2.0;
+        dest[0] = (r0[2] + r2[0]) / s;
+        dest[1] = (r1[2] + r2[1]) / s;
+        dest[2] = 0.25 * s;
+        dest[3] = (r1[0] - r0[1]) / s;
+    }
+
+    return 4;
+}
+
 
 } // end QuaternionUtil namespace
 
-template<typename T=double>
-class Quaternion : public _VectorBase<4, T, Quaternion<T> > {
+/**
+Quaternion with components x, y, z and w. With the default StorageType the
+Quaternion owns its elements; see QuaternionMap for a Quaternion over caller
+memory.
+*/
+template<typename T=double, typename StorageType = _ArrayStorage<4, T> >
+class Quaternion : public _VectorBase<4, T, Quaternion<T, StorageType>, Quaternion<T>, StorageType> {
+
+    typedef Quaternion<T, StorageType> ThisType;
+    typedef Quaternion<T> ValueType;
+    typedef _VectorBase<4, T, ThisType, ValueType, StorageType> SuperType;
 
-    typedef Quaternion<T> ThisType;
-    typedef _VectorBase<4, T, Quaternion<T> > SuperType;
+    static constexpr bool IS_OWNING = std::is_same<StorageType, _ArrayStorage<4, T> >::value;
 
 public:
 
-    Quaternion(const T* elements = NULL) : SuperType(elements) { }
+    /**
+    Creates a Quaternion with every element zero. A QuaternionMap has no
+    memory to map without an element pointer, so it cannot be created
+    this way.
+    */
+    Quaternion() : SuperType() {
+        static_assert(IS_OWNING, "a QuaternionMap cannot be created without an element pointer");
+    }
+
+    Quaternion(typename StorageType::InitPointer elements) : SuperType(elements) { }
+
+    /**
+    Creates a Quaternion from another. An owning Quaternion copies the
+    elements of other; a QuaternionMap maps the same memory as other, so
+    it cannot be created from a temporary owning Quaternion.
+    */
+    template<typename OtherStorage>
+    Quaternion(const Quaternion<T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Quaternion(Quaternion<T, OtherStorage>& other) : SuperType(other.data()) { }
+    template<typename OtherStorage>
+    Quaternion(Quaternion<T, OtherStorage>&& other) : SuperType(other.data()) {
+        static_assert(IS_OWNING || !std::is_same<OtherStorage, _ArrayStorage<4, T> >::value,
+                      "a QuaternionMap cannot be created from a temporary Quaternion");
+    }
 
-    Quaternion(const Vector<3, T>& vec3, double radians) :
+    template<typename VectorStorage>
+    Quaternion(const Vector<3, T, VectorStorage>& vec3, double radians) :
         SuperType() {
+        static_assert(IS_OWNING, "a QuaternionMap cannot be created from an axis and angle");
         QuaternionUtil::rotationToQuaternion(vec3.data(), radians, this->mData);
     }
 
     Quaternion(T xValue, T yValue, T zValue, T wValue) :
         SuperType() {
+        static_assert(IS_OWNING, "a QuaternionMap cannot be created from component values");
         this->mData[0] = xValue;
         this->mData[1] = yValue;
         this->mData[2] = zValue;
@@ -266,51 +343,55 @@ public:
     const T w() const { return this->mData[3]; }
 
     // Applies the rotation defined by the quaternion argument to this quaternion.
-    void rotate(ThisType& other) {
-        QuaternionUtil::applyQuaternionRotation(this->mData, other.data(), this->mData);
+    template<typename OtherStorage>
+    void rotate(const Quaternion<T, OtherStorage>& other) {
+        QuaternionUtil::applyQuaternionRotation(this->data(), other.data(), this->mData);
     }
 
     // Applies the rotation defined by the vector and rotation radians to this quaternion.
-    void rotate(const Vector<3, T>& axisOfRotation, double rotationRadians) {
-        QuaternionUtil::applyVectorRotation(this->mData, axisOfRotation.data(), rotationRadians, this->mData);
+    template<typename VectorStorage>
+    void rotate(const Vector<3, T, VectorStorage>& axisOfRotation, double rotationRadians) {
+        QuaternionUtil::applyVectorRotation(this->data(), axisOfRotation.data(), rotationRadians, this->mData);
     }
 
     // Returns a 3x3 rotation matrix.
     Matrix<3, 3, T> toRotationMatrix3x3() const {
         Matrix<3, 3, T> mat;
-        QuaternionUtil::toRotationMatrix3x3(this->mData, mat.data());
+        QuaternionUtil::toRotationMatrix3x3(this->data(), mat.data());
         return mat;
     }
 
     // Returns a 4x4 rotation matrix.
     Matrix<4, 4, T> toRotationMatrix4x4() const {
         Matrix<4, 4, T> mat;
-        QuaternionUtil::toRotationMatrix4x4(this->mData, mat.data());
+        QuaternionUtil::toRotationMatrix4x4(this->data(), mat.data());
         return mat;
     }
 
     // We need to override the default assignment operator
     // since we have internal reference elements.
     ThisType& operator=(const ThisType& other) {
-        MatrixUtil::copy(other.mData, this->mData, 4);
+        MatrixUtil::copy(other.data(), this->mData, 4);
         return *this;
     }
 
+    using SuperType::operator=;
+
     // Returns a new Quaternion set to the identity value.
-    static Quaternion identity() {
-        Quaternion result;
-        result.mData[0] = static_cast<T>(0);
-        result.mData[1] = static_cast<T>(0);
-        result.mData[2] = static_cast<T>(0);
-        result.mData[3] = static_cast<T>(1);
+    static ValueType identity() {
+        ValueType result;
+        result.data()[0] = static_cast<T>(0);
+        result.data()[1] = static_cast<T>(0);
+        result.data()[2] = static_cast<T>(0);
+        result.data()[3] = static_cast<T>(1);
 
         return result;
     }
 
     // Returns a new Quaternion built by constructing rotating around the X, Y, and Z
     // axes the given amount of radians in that order.
-    static Quaternion fromEulerAngles(T xRadians, T yRadians, T zRadians) {
-        Quaternion q = Quaternion::identity();
+    static ValueType fromEulerAngles(T xRadians, T yRadians, T zRadians) {
+        ValueType q = ValueType::identity();
         q.rotate(Vector<3, T>::xAxis(), xRadians);
         q.rotate(Vector<3, T>::yAxis(), yRadians);
         q.rotate(Vector<3, T>::zAxis(), zRadians);
@@ -321,11 +402,18 @@ public:
 
 // Global function allowing scalar Quaternion multiplication to occur when
 // the scalar comes before the Quaternion.
-template<typename T>
-Quaternion<T> operator*(T scalar, const Quaternion<T>& quat) {
+template<typename T, typename StorageType>
+Quaternion<T> operator*(T scalar, const Quaternion<T, StorageType>& quat) {
     return quat * scalar;
 }
 
+/**
+Quaternion over 4 elements of caller memory, without any copy. Use a
+const T for a read-only map. See MatrixMap.
+*/
+template<typename T = double>
+using QuaternionMap = Quaternion<typename std::remove_const<T>::type, _MappedStorage<T> >;
+
 
 // create some useful typedefs
 typedef Quaternion<double> Quatd;
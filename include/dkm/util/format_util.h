@@ -0,0 +1,131 @@
+#ifndef _DKM_FORMAT_UTIL_H_
+#define _DKM_FORMAT_UTIL_H_
+
+/**
+ * Integer to text conversions that append to a std::string without
+ * going through the printf machinery.
+ */
+
+#include <stddef.h>
+
+#include <string>
+
+namespace dkm
+{
+
+namespace FormatUtil
+{
+
+/**
+ * Writes the decimal digits of value so that they end just before
+ * end and returns a pointer to the first digit. The caller must
+ * provide at least 20 characters of room.
+ */
+inline char* formatDecimal(char* end, unsigned long long value)
+{
+    static const char pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    // two digits per division
+    while (value >= 100) {
+        size_t idx = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = pairs[idx + 1];
+        *--end = pairs[idx];
+    }
+
+    if (value >= 10) {
+        size_t idx = static_cast<size_t>(value) * 2;
+        *--end = pairs[idx + 1];
+        *--end = pairs[idx];
+    }
+    else {
+        *--end = static_cast<char>('0' + value);
+    }
+    return end;
+}
+
+/**
+ * Writes the hex digits of value so that they end just before end
+ * and returns a pointer to the first digit. The caller must provide
+ * at least 16 characters of room.
+ */
+inline char* formatHex(char* end, unsigned long long value, bool upper)
+{
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[value & 0xf];
+        value >>= 4;
+    } while (value != 0);
+    return end;
+}
+
+/**
+ * Writes exactly digits decimal digits of value, zero padded, so that
+ * they end just before end and returns a pointer to the first one.
+ * Higher digits that do not fit are discarded.
+ */
+inline char* formatZeroPadded(char* end, unsigned int value, int digits)
+{
+    for (int i = 0; i < digits; ++i) {
+        *--end = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return end;
+}
+
+inline void appendUnsigned(std::string& out, unsigned long long value)
+{
+    char buf[20];
+    char* end = buf + sizeof(buf);
+    char* start = formatDecimal(end, value);
+    out.append(start, end - start);
+}
+
+inline void appendSigned(std::string& out, long long value)
+{
+    char buf[21];
+    char* end = buf + sizeof(buf);
+
+    // negate in unsigned arithmetic so the most negative value works
+    unsigned long long magnitude = (value < 0) ?
+        0ULL - static_cast<unsigned long long>(value) :
+        static_cast<unsigned long long>(value);
+
+    char* start = formatDecimal(end, magnitude);
+    if (value < 0) {
+        *--start = '-';
+    }
+    out.append(start, end - start);
+}
+
+inline void appendZeroPadded(std::string& out, unsigned int value, int digits)
+{
+    char buf[10];
+    char* end = buf + sizeof(buf);
+    char* start = formatZeroPadded(end, value, digits < 10 ? digits : 10);
+    out.append(start, end - start);
+}
+
+inline void appendHex(std::string& out, unsigned long long value, bool upper = false)
+{
+    char buf[16];
+    char* end = buf + sizeof(buf);
+    char* start = formatHex(end, value, upper);
+    out.append(start, end - start);
+}
+
+} // end namespace FormatUtil
+
+}
+
+#endif
@@ -7,7 +7,12 @@
 
 #include "dkm/util/log/defs.h"
 #include "dkm/util/log/logger.h"
+#include "dkm/util/log/log_fields.h"
+#include "dkm/util/log/log_format.h"
 #include "dkm/util/log/log_writer.h"
+#include "dkm/util/log/log_layout.h"
+#include "dkm/util/log/pattern_layout.h"
+#include "dkm/util/log/json_layout.h"
 #include "dkm/util/log/logging.h"
 
 #endif
\ No newline at end of file
@@ -5,6 +5,12 @@
  * Common definitions for dkm logging.
  */
 
+#include <stddef.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
 #include <string>
 
 namespace dkm
@@ -23,15 +29,84 @@ enum class LogLevel
     TRACE
 };
 
+/**
+ * Number of values in LogLevel, for arrays indexed by level.
+ */
+const size_t NUM_LOG_LEVELS = 5;
+
+/**
+ * Returns the kernel id of the calling thread. The id is looked up
+ * once per thread and cached.
+ */
+inline unsigned long logThreadId()
+{
+    static __thread unsigned long id = 0;
+    if (id == 0) {
+        id = static_cast<unsigned long>(syscall(SYS_gettid));
+    }
+    return id;
+}
+
 struct LogMessage
 {
+    /**
+     * Stamps the message with the current time and thread.
+     */
+    LogMessage() :
+        lineNum(0),
+        logLevel(LogLevel::INFO),
+        timestamp(std::chrono::system_clock::now()),
+        threadId(logThreadId()) { }
+
     std::string loggerName;
     int lineNum;
     LogLevel logLevel;
 
     std::string message;
+
+    /**
+     * Structured fields in the binary form written by
+     * LogFields::encode(); empty if the message has none.
+     */
+    std::string fields;
+
+    /**
+     * Wall clock time the message was created.
+     */
+    std::chrono::system_clock::time_point timestamp;
+
+    /**
+     * Kernel id of the thread that created the message.
+     */
+    unsigned long threadId;
 };
 
+/**
+ * Messages handed to more than one queue or thread are shared by
+ * reference count rather than copied.
+ */
+typedef std::shared_ptr<const LogMessage> LogMessagePtr;
+
+/**
+ * Returns the upper-case name of the given log level, e.g. "WARN".
+ */
+inline const char* logLevelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::ERROR:
+        return "ERROR";
+    case LogLevel::WARN:
+        return "WARN";
+    case LogLevel::INFO:
+        return "INFO";
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::TRACE:
+        return "TRACE";
+    }
+    return "UNKNOWN";
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,272 @@
+#ifndef _DKM_FILE_LOG_WRITER_H_
+#define _DKM_FILE_LOG_WRITER_H_
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_layout.h"
+#include "dkm/util/log/log_writer.h"
+#include "dkm/util/log/pattern_layout.h"
+
+namespace dkm
+{
+
+/**
+ * Controls when a FileLogWriter asks the kernel to push written
+ * data to the storage device.
+ */
+enum class FsyncPolicy
+{
+    /** Never sync; leave it to the kernel. */
+    NEVER,
+    /** Sync at most once per configured fsync interval. */
+    INTERVAL,
+    /** Sync after every batch written. */
+    EVERY_BATCH
+};
+
+/**
+ * Controls when a FileLogWriter starts a new file.
+ */
+enum class RotationPolicy
+{
+    NONE,
+    /** Rotate once the current file reaches rotateSize bytes. */
+    SIZE,
+    /** Rotate every rotateInterval. */
+    TIME
+};
+
+/**
+ * Controls how a FileLogWriter stores what it writes.
+ */
+enum class FileCompression
+{
+    /** Plain text lines. */
+    NONE,
+    /**
+     * Each batch is compressed with LzCodec into a frame that can be
+     * decoded on its own. See log_frame.h for the file format and
+     * LogFrameReader for reading it back.
+     */
+    LZ
+};
+
+struct FileLogWriterConfig
+{
+public:
+    FileLogWriterConfig(const std::string& filePath = "");
+
+    /**
+     * Path of the active log file. Rotated files are named
+     * path.1, path.2, etc, with path.1 being the most recent.
+     */
+    std::string path;
+
+    /**
+     * Layout used to format each line, e.g. a PatternLayout or a
+     * JsonLayout. May be shared with other writers. If null, a
+     * PatternLayout with the default pattern is used.
+     */
+    std::shared_ptr<const LogLayout> layout;
+
+    /**
+     * Number of buffered bytes that triggers a batch write.
+     */
+    size_t bufferSize;
+
+    /**
+     * Maximum time a message may sit in the buffer before
+     * it is written.
+     */
+    std::chrono::milliseconds flushInterval;
+
+    RotationPolicy rotation;
+
+    /**
+     * File size that triggers rotation with RotationPolicy::SIZE.
+     */
+    size_t rotateSize;
+
+    /**
+     * File age that triggers rotation with RotationPolicy::TIME.
+     */
+    std::chrono::seconds rotateInterval;
+
+    /**
+     * Number of rotated files to keep. Older files are deleted.
+     */
+    unsigned int maxFiles;
+
+    FsyncPolicy fsyncPolicy;
+
+    /**
+     * Minimum time between syncs with FsyncPolicy::INTERVAL.
+     */
+    std::chrono::milliseconds fsyncInterval;
+
+    /**
+     * Compression applied on the background thread. A compressed
+     * writer should not append to an existing plain text file.
+     */
+    FileCompression compression;
+};
+
+/**
+ * LogWriter that appends formatted messages to an in-memory
+ * buffer and writes them to a file in large batches from a
+ * background thread. Batch writes, rotation, and syncing all
+ * happen on the background thread so callers of write() only
+ * pay for formatting and a short critical section.
+ */
+class FileLogWriter : public LogWriter
+{
+public:
+    /**
+     * Opens the configured file for appending. Throws std::system_error
+     * if the file cannot be opened.
+     */
+    FileLogWriter(const FileLogWriterConfig& config);
+
+    /**
+     * Writes all buffered data and closes the file.
+     */
+    virtual ~FileLogWriter();
+
+    virtual void write(const LogMessage& message);
+
+    /**
+     * Formats the whole batch under a single acquisition of the
+     * buffer lock.
+     */
+    virtual void writeBatch(const LogMessagePtr* messages, size_t count);
+
+    /**
+     * Blocks until everything passed to write() before this call
+     * has been handed to the kernel.
+     */
+    virtual void flush();
+
+    /**
+     * Writes the full and active buffers straight to the file without
+     * taking the buffer lock. A batch the background thread is part
+     * way through writing is left to that thread. With compression
+     * on, each buffer is written as an uncompressed frame. If the
+     * process carries on afterwards, the flushed data is dropped
+     * rather than written again and the writer stays usable.
+     */
+    virtual void emergencyFlush();
+
+    /**
+     * Formats the message as "[LEVEL] logger:line - message" into a
+     * fixed-size stack buffer, truncating long messages, and writes it
+     * straight to the file, in its own uncompressed frame if
+     * compression is on. The configured layout is not used since it
+     * allocates.
+     */
+    virtual void emergencyWrite(const LogMessage& message);
+
+    virtual std::string getName() const;
+
+    const FileLogWriterConfig& getConfig() const { return mConfig; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // formatted text along with the time range of the messages in it,
+    // in microseconds since the epoch
+    struct Buffer
+    {
+        Buffer() : firstTime(0), lastTime(0), flushed(0) { }
+        Buffer(Buffer&& other);
+        Buffer& operator=(Buffer&& other);
+
+        std::string text;
+        int64_t firstTime;
+        int64_t lastTime;
+
+        // bytes of text already written by emergencyFlush(); set
+        // without the lock, so the tag travels with the buffer however
+        // it has been moved since
+        std::atomic<size_t> flushed;
+    };
+
+    // appends to the active buffer; returns true if a buffer was
+    // handed to the background thread
+    bool append(const LogMessage& message);
+
+    // moves the active buffer to the full list; mMutex must be held
+    void queueActive();
+
+    void run();
+    void writeBuffers(std::vector<Buffer>& batch);
+    void maybeRotate(Clock::time_point now);
+    void maybeSync(Clock::time_point now, bool wroteData);
+
+    // writes all of the count buffers in iov without locking or
+    // allocating, updating iov as it goes; errors are ignored
+    void writeDirect(struct iovec* iov, int count) const;
+
+    // writes buffer as is, behind an uncompressed frame header if
+    // compression is on; signal safe
+    void writeDirectFrame(const char* data, size_t len, int64_t firstTime,
+                          int64_t lastTime) const;
+
+    void openFile();
+    void rotateFiles();
+
+    Buffer takeSpareBuffer();
+
+    // drops whatever emergencyFlush() already wrote, as tagged on each
+    // buffer; called with mMutex held
+    void dropEmergencyFlushed();
+
+    // removes the flushed part of buf; returns true if nothing is left
+    static bool dropFlushed(Buffer& buf);
+
+    const FileLogWriterConfig mConfig;
+    const std::shared_ptr<const LogLayout> mLayout;
+
+    int mFd;
+    size_t mFileSize;
+    Clock::time_point mOpenTime;
+    Clock::time_point mLastSync;
+
+    // compressed frames for the batch being written; only touched by
+    // the background thread
+    std::string mFrames;
+
+    // guards everything below
+    std::mutex mMutex;
+    std::condition_variable mWorkReady;
+    std::condition_variable mBatchDone;
+
+    Buffer mActive;
+    std::deque<Buffer> mFull;
+    std::vector<Buffer> mSpare;
+
+    unsigned long long mQueuedBatches;
+    unsigned long long mWrittenBatches;
+    bool mFlushRequested;
+    bool mStopping;
+
+    // set by emergencyFlush() once it has tagged the buffers it wrote
+    std::atomic<bool> mEmergencyFlushed;
+
+    std::thread mThread;
+};
+
+}
+
+#endif
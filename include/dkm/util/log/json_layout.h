@@ -0,0 +1,41 @@
+#ifndef _DKM_JSON_LAYOUT_H_
+#define _DKM_JSON_LAYOUT_H_
+
+#include <string>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_layout.h"
+#include "dkm/util/log/pattern_layout.h"
+
+namespace dkm
+{
+
+/**
+ * Formats each message as a single line of JSON:
+ *
+ *     {"time":"2026-10-18T13:45:07.089Z","level":"WARN","logger":"dkm.io",
+ *      "line":42,"thread":1234,"msg":"disk full","free_mb":12}
+ *
+ * Structured fields follow the standard members at the top level of
+ * the object. A field named after one of the standard members is
+ * written as a second member with the same name.
+ */
+class JsonLayout : public LogLayout
+{
+public:
+    /**
+     * Times are written in UTC unless utc is false, in which case
+     * local time is used.
+     */
+    explicit JsonLayout(bool utc = true);
+
+    virtual void format(const LogMessage& message, std::string& out) const;
+
+private:
+    // formats just the timestamp, with its per-thread date cache
+    const PatternLayout mTime;
+};
+
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef _DKM_LOG_FIELDS_H_
+#define _DKM_LOG_FIELDS_H_
+
+/**
+ * Structured key-value fields for log messages.
+ *
+ *     logger.info("request done", kv("lat_us", 123), kv("path", path));
+ *
+ * Fields are encoded into LogMessage::fields in a compact binary form
+ * when the message is created. Nothing is formatted until a layout
+ * writes them out, as logfmt with the %K conversion of a PatternLayout
+ * or as JSON with a JsonLayout, and neither has to parse any text to
+ * do so.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+
+namespace dkm
+{
+
+enum class LogFieldType : unsigned char
+{
+    INT,
+    UINT,
+    DOUBLE,
+    BOOL,
+    STRING
+};
+
+/**
+ * A named value, normally made with kv(). A field only points at its
+ * name and string value, so it must not outlive them. Fields read back
+ * with LogFields::Reader point into the encoded buffer.
+ */
+struct LogField
+{
+    const char* name;
+    size_t nameLength;
+
+    LogFieldType type;
+
+    union
+    {
+        long long i;
+        unsigned long long u;
+        double d;
+        bool b;
+    } value;
+
+    // STRING fields only
+    const char* str;
+    size_t strLength;
+};
+
+namespace LogFields
+{
+
+inline LogField make(const char* name, LogFieldType type)
+{
+    LogField field;
+    field.name = name;
+    field.nameLength = strlen(name);
+    field.type = type;
+    field.value.u = 0;
+    field.str = nullptr;
+    field.strLength = 0;
+    return field;
+}
+
+inline LogField makeInt(const char* name, long long value)
+{
+    LogField field = make(name, LogFieldType::INT);
+    field.value.i = value;
+    return field;
+}
+
+inline LogField makeUint(const char* name, unsigned long long value)
+{
+    LogField field = make(name, LogFieldType::UINT);
+    field.value.u = value;
+    return field;
+}
+
+inline LogField makeString(const char* name, const char* value, size_t length)
+{
+    LogField field = make(name, LogFieldType::STRING);
+    field.str = value;
+    field.strLength = length;
+    return field;
+}
+
+/**
+ * Appends the binary encoding of the field to out.
+ */
+void encode(const LogField& field, std::string& out);
+
+/**
+ * Appends the binary encoding of count fields to out.
+ */
+void encode(const LogField* fields, size_t count, std::string& out);
+
+/**
+ * Walks the fields in an encoded buffer. The fields returned point
+ * into the buffer, which must outlive them.
+ */
+class Reader
+{
+public:
+    explicit Reader(const std::string& encoded) :
+        mPos(encoded.data()),
+        mEnd(encoded.data() + encoded.size()) { }
+
+    /**
+     * Reads the next field into field. Returns false at the end of the
+     * buffer or if the rest of it is malformed.
+     */
+    bool next(LogField& field);
+
+private:
+    bool readVarint(unsigned long long& value);
+
+    const char* mPos;
+    const char* mEnd;
+};
+
+/**
+ * Appends each encoded field to out as " key=value" in logfmt style.
+ * Values with spaces, quotes, '=' or control characters are quoted,
+ * and characters in keys that logfmt does not allow become '_'.
+ */
+void appendLogfmt(const std::string& encoded, std::string& out);
+
+/**
+ * Appends each encoded field to out as ,"key":value so the result can
+ * follow the other members of a JSON object. Non-finite doubles are
+ * written as null.
+ */
+void appendJson(const std::string& encoded, std::string& out);
+
+/**
+ * Appends value to out as a quoted JSON string.
+ */
+void appendJsonString(const char* value, size_t length, std::string& out);
+
+/**
+ * Appends value to out with enough digits to read back as the same
+ * double. Values with at most six decimal places are written in plain
+ * decimal, e.g. 0.00001; others use printf's %g style with 15 or 17
+ * significant digits.
+ */
+void appendDouble(double value, std::string& out);
+
+} // end namespace LogFields
+
+inline LogField kv(const char* name, int value) { return LogFields::makeInt(name, value); }
+inline LogField kv(const char* name, long value) { return LogFields::makeInt(name, value); }
+inline LogField kv(const char* name, long long value) { return LogFields::makeInt(name, value); }
+
+inline LogField kv(const char* name, unsigned int value) { return LogFields::makeUint(name, value); }
+inline LogField kv(const char* name, unsigned long value) { return LogFields::makeUint(name, value); }
+inline LogField kv(const char* name, unsigned long long value) { return LogFields::makeUint(name, value); }
+
+inline LogField kv(const char* name, double value)
+{
+    LogField field = LogFields::make(name, LogFieldType::DOUBLE);
+    field.value.d = value;
+    return field;
+}
+
+inline LogField kv(const char* name, float value) { return kv(name, static_cast<double>(value)); }
+
+inline LogField kv(const char* name, bool value)
+{
+    LogField field = LogFields::make(name, LogFieldType::BOOL);
+    field.value.b = value;
+    return field;
+}
+
+// a null value is logged as "(null)", as the printf-style formatter does
+inline LogField kv(const char* name, const char* value)
+{
+    if (value == NULL) {
+        return LogFields::makeString(name, "(null)", 6);
+    }
+    return LogFields::makeString(name, value, strlen(value));
+}
+
+inline LogField kv(const char* name, const std::string& value)
+{
+    return LogFields::makeString(name, value.data(), value.size());
+}
+
+/**
+ * A string field from a pointer and length, for text that is not
+ * null-terminated.
+ */
+inline LogField kv(const char* name, const char* value, size_t length)
+{
+    return LogFields::makeString(name, value, length);
+}
+
+}
+
+#endif
@@ -0,0 +1,477 @@
+#ifndef _DKM_LOG_FORMAT_H_
+#define _DKM_LOG_FORMAT_H_
+
+/**
+ * Log format strings that are checked and parsed at compile time.
+ *
+ * DKM_LOGF(logger, level, "read %d of %s", count, name) checks each
+ * argument against its conversion while compiling, so a mismatch is
+ * a compile error instead of undefined behavior at run time. The
+ * format is split into a fixed sequence of ops, each a literal
+ * segment followed by one conversion, and the run time work is
+ * reduced to appending those segments and converting the arguments.
+ *
+ * Supported conversions:
+ *   %d %i        signed integers
+ *   %u           unsigned integers
+ *   %x %X        any integer, in hex
+ *   %c           char
+ *   %s           const char* or std::string
+ *   %p           pointers
+ *   %f %e %g     float or double, also in upper case; flags, width
+ *                and precision are passed on to snprintf
+ *   %%           a literal percent sign
+ *
+ * Length modifiers (h, l, ll, z, j, t) are accepted and ignored since
+ * the argument's own type decides how it is converted. Flags, width
+ * and precision are rejected on everything but the floating point
+ * conversions.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include "dkm/util/format_util.h"
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/logger.h"
+
+namespace dkm
+{
+
+namespace LogFormat
+{
+
+enum class OpKind
+{
+    /** End of the format; only a literal remains. */
+    END,
+    /** A literal percent sign. Consumes no argument. */
+    PERCENT,
+    SIGNED,
+    UNSIGNED,
+    HEX,
+    HEX_UPPER,
+    CHAR,
+    STRING,
+    POINTER,
+    FLOAT,
+    INVALID
+};
+
+// The parsing functions below are C++11 constexpr, so each is a
+// single return statement and loops are written as recursion.
+
+constexpr bool isLengthModifier(char c)
+{
+    return c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't';
+}
+
+constexpr bool isModifier(char c)
+{
+    return isLengthModifier(c) || c == '-' || c == '+' || c == ' ' || c == '#' ||
+        c == '.' || (c >= '0' && c <= '9');
+}
+
+constexpr bool isFloatConversion(char c)
+{
+    return c == 'f' || c == 'F' || c == 'e' || c == 'E' || c == 'g' || c == 'G';
+}
+
+// Returns the index of the next '%' at or after i, or of the terminator.
+constexpr size_t nextPercent(const char* fmt, size_t i)
+{
+    return (fmt[i] == '\0' || fmt[i] == '%') ? i : nextPercent(fmt, i + 1);
+}
+
+constexpr size_t skipModifiers(const char* fmt, size_t i)
+{
+    return isModifier(fmt[i]) ? skipModifiers(fmt, i + 1) : i;
+}
+
+// Returns the index of the conversion character of the spec at pct.
+constexpr size_t conversionIndex(const char* fmt, size_t pct)
+{
+    return fmt[pct + 1] == '%' ? pct + 1 : skipModifiers(fmt, pct + 1);
+}
+
+// Returns the index just past the spec at pct.
+constexpr size_t specEnd(const char* fmt, size_t pct)
+{
+    return fmt[pct] == '\0' ? pct :
+        fmt[conversionIndex(fmt, pct)] == '\0' ? conversionIndex(fmt, pct) :
+        conversionIndex(fmt, pct) + 1;
+}
+
+/**
+ * Returns the index where op's literal segment starts.
+ */
+constexpr size_t opBegin(const char* fmt, size_t op)
+{
+    return op == 0 ? 0 : specEnd(fmt, nextPercent(fmt, opBegin(fmt, op - 1)));
+}
+
+/**
+ * Returns the index where op's spec starts, which is also where its
+ * literal segment ends.
+ */
+constexpr size_t opSpec(const char* fmt, size_t op)
+{
+    return nextPercent(fmt, opBegin(fmt, op));
+}
+
+constexpr bool onlyLengthModifiers(const char* fmt, size_t i, size_t end)
+{
+    return i == end || (isLengthModifier(fmt[i]) && onlyLengthModifiers(fmt, i + 1, end));
+}
+
+constexpr OpKind classify(char c, bool plain)
+{
+    return isFloatConversion(c) ? OpKind::FLOAT :
+        !plain ? OpKind::INVALID :
+        (c == 'd' || c == 'i') ? OpKind::SIGNED :
+        c == 'u' ? OpKind::UNSIGNED :
+        c == 'x' ? OpKind::HEX :
+        c == 'X' ? OpKind::HEX_UPPER :
+        c == 'c' ? OpKind::CHAR :
+        c == 's' ? OpKind::STRING :
+        c == 'p' ? OpKind::POINTER :
+        OpKind::INVALID;
+}
+
+constexpr OpKind specKind(const char* fmt, size_t pct)
+{
+    return fmt[pct] == '\0' ? OpKind::END :
+        fmt[pct + 1] == '%' ? OpKind::PERCENT :
+        classify(fmt[conversionIndex(fmt, pct)],
+                 onlyLengthModifiers(fmt, pct + 1, conversionIndex(fmt, pct)));
+}
+
+constexpr OpKind opKind(const char* fmt, size_t op)
+{
+    return specKind(fmt, opSpec(fmt, op));
+}
+
+/**
+ * Returns true if every spec from op onwards is supported.
+ */
+constexpr bool isValid(const char* fmt, size_t op = 0)
+{
+    return opKind(fmt, op) == OpKind::END ||
+        (opKind(fmt, op) != OpKind::INVALID && isValid(fmt, op + 1));
+}
+
+/**
+ * Returns the number of arguments consumed from op onwards. Only
+ * meaningful for valid formats.
+ */
+constexpr size_t argCount(const char* fmt, size_t op = 0)
+{
+    return opKind(fmt, op) == OpKind::END ? 0 :
+        opKind(fmt, op) == OpKind::INVALID ? 0 :
+        (opKind(fmt, op) == OpKind::PERCENT ? 0 : 1) + argCount(fmt, op + 1);
+}
+
+/**
+ * Returns the number of literal characters produced from op onwards.
+ */
+constexpr size_t literalLength(const char* fmt, size_t op = 0)
+{
+    return (opSpec(fmt, op) - opBegin(fmt, op)) +
+        (opKind(fmt, op) == OpKind::END ? 0 :
+         opKind(fmt, op) == OpKind::INVALID ? 0 :
+         (opKind(fmt, op) == OpKind::PERCENT ? 1 : 0) + literalLength(fmt, op + 1));
+}
+
+/**
+ * Returns true if an argument of type T may be passed to a conversion
+ * of the given kind. T is the decayed argument type.
+ */
+template <typename T>
+constexpr bool accepts(OpKind kind)
+{
+    return kind == OpKind::SIGNED ?
+            std::is_integral<T>::value && std::is_signed<T>::value &&
+            !std::is_same<T, char>::value :
+        kind == OpKind::UNSIGNED ?
+            std::is_integral<T>::value && std::is_unsigned<T>::value &&
+            !std::is_same<T, bool>::value && !std::is_same<T, char>::value :
+        (kind == OpKind::HEX || kind == OpKind::HEX_UPPER) ?
+            std::is_integral<T>::value && !std::is_same<T, bool>::value :
+        kind == OpKind::CHAR ?
+            std::is_same<T, char>::value :
+        kind == OpKind::STRING ?
+            std::is_same<T, const char*>::value || std::is_same<T, char*>::value ||
+            std::is_same<T, std::string>::value :
+        kind == OpKind::POINTER ?
+            std::is_pointer<T>::value || std::is_same<T, std::nullptr_t>::value :
+        kind == OpKind::FLOAT ?
+            std::is_same<T, double>::value || std::is_same<T, float>::value :
+        false;
+}
+
+/**
+ * Converts one argument. The unspecialized template handles arguments
+ * that do not match; those have already failed a static_assert so it
+ * only exists to keep the compiler from piling on more errors.
+ */
+template <OpKind Kind, bool Accepted>
+struct ArgWriter
+{
+    template <typename T>
+    static void append(std::string&, const char*, size_t, const T&) { }
+};
+
+template <>
+struct ArgWriter<OpKind::SIGNED, true>
+{
+    template <typename T>
+    static void append(std::string& out, const char*, size_t, T value) {
+        FormatUtil::appendSigned(out, value);
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::UNSIGNED, true>
+{
+    template <typename T>
+    static void append(std::string& out, const char*, size_t, T value) {
+        FormatUtil::appendUnsigned(out, value);
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::HEX, true>
+{
+    template <typename T>
+    static void append(std::string& out, const char*, size_t, T value) {
+        // as with printf, negative values print as their two's complement
+        FormatUtil::appendHex(out, static_cast<typename std::make_unsigned<T>::type>(value));
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::HEX_UPPER, true>
+{
+    template <typename T>
+    static void append(std::string& out, const char*, size_t, T value) {
+        FormatUtil::appendHex(out, static_cast<typename std::make_unsigned<T>::type>(value), true);
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::CHAR, true>
+{
+    static void append(std::string& out, const char*, size_t, char value) {
+        out.push_back(value);
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::STRING, true>
+{
+    static void append(std::string& out, const char*, size_t, const char* value) {
+        out.append(value != NULL ? value : "(null)");
+    }
+
+    static void append(std::string& out, const char*, size_t, const std::string& value) {
+        out.append(value);
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::POINTER, true>
+{
+    static void append(std::string& out, const char*, size_t, const void* value) {
+        // match glibc's %p
+        if (value == NULL) {
+            out.append("(nil)");
+        }
+        else {
+            out.append("0x");
+            FormatUtil::appendHex(out, reinterpret_cast<uintptr_t>(value));
+        }
+    }
+};
+
+template <>
+struct ArgWriter<OpKind::FLOAT, true>
+{
+    static void append(std::string& out, const char* spec, size_t specLen, double value) {
+        // floating point conversion is left to snprintf, with the spec
+        // copied out of the format so flags and precision still apply
+        char specBuf[32];
+        if (specLen >= sizeof(specBuf)) {
+            return;
+        }
+        memcpy(specBuf, spec, specLen);
+        specBuf[specLen] = '\0';
+
+        char buf[64];
+        int len = snprintf(buf, sizeof(buf), specBuf, value);
+        if (len < 0) {
+            return;
+        }
+        if (static_cast<size_t>(len) < sizeof(buf)) {
+            out.append(buf, len);
+        }
+        else {
+            size_t start = out.size();
+            out.resize(start + len + 1);
+            snprintf(&out[start], len + 1, specBuf, value);
+            out.resize(start + len);
+        }
+    }
+};
+
+/**
+ * Appends op Op of Format and everything after it. Format is a type
+ * with a static constexpr str() member returning the format string.
+ */
+template <typename Format, size_t Op, OpKind Kind = opKind(Format::str(), Op)>
+struct Ops
+{
+    static constexpr size_t BEGIN = opBegin(Format::str(), Op);
+    static constexpr size_t SPEC = opSpec(Format::str(), Op);
+    static constexpr size_t SPEC_LEN = specEnd(Format::str(), SPEC) - SPEC;
+
+    template <typename Arg, typename... Rest>
+    static void append(std::string& out, const Arg& arg, const Rest&... rest) {
+        typedef typename std::decay<Arg>::type ArgType;
+        constexpr bool ACCEPTED = accepts<ArgType>(Kind);
+        static_assert(ACCEPTED, "log format argument does not match its conversion");
+
+        out.append(Format::str() + BEGIN, SPEC - BEGIN);
+        ArgWriter<Kind, ACCEPTED>::append(out, Format::str() + SPEC, SPEC_LEN, arg);
+
+        Ops<Format, Op + 1>::append(out, rest...);
+    }
+};
+
+template <typename Format, size_t Op>
+struct Ops<Format, Op, OpKind::PERCENT>
+{
+    static constexpr size_t BEGIN = opBegin(Format::str(), Op);
+    static constexpr size_t SPEC = opSpec(Format::str(), Op);
+
+    template <typename... Args>
+    static void append(std::string& out, const Args&... args) {
+        out.append(Format::str() + BEGIN, SPEC - BEGIN);
+        out.push_back('%');
+
+        Ops<Format, Op + 1>::append(out, args...);
+    }
+};
+
+template <typename Format, size_t Op>
+struct Ops<Format, Op, OpKind::END>
+{
+    static constexpr size_t BEGIN = opBegin(Format::str(), Op);
+    static constexpr size_t SPEC = opSpec(Format::str(), Op);
+
+    static void append(std::string& out) {
+        out.append(Format::str() + BEGIN, SPEC - BEGIN);
+    }
+};
+
+/**
+ * Only instantiates the ops for formats that passed the checks in
+ * format(), so a bad format produces one error rather than dozens.
+ */
+template <typename Format, bool Valid>
+struct Formatter
+{
+    template <typename... Args>
+    static void append(std::string&, const Args&...) { }
+};
+
+template <typename Format>
+struct Formatter<Format, true>
+{
+    static constexpr size_t LITERAL_LENGTH = literalLength(Format::str());
+
+    template <typename... Args>
+    static void append(std::string& out, const Args&... args) {
+        out.reserve(out.size() + LITERAL_LENGTH + 16 * sizeof...(Args));
+        Ops<Format, 0>::append(out, args...);
+    }
+};
+
+/**
+ * Appends the formatted arguments to out. Use this through the
+ * DKM_FORMAT and DKM_LOGF macros, which supply the Format type.
+ */
+template <typename Format, typename... Args>
+inline void format(std::string& out, const Args&... args)
+{
+    constexpr bool VALID = isValid(Format::str());
+    static_assert(VALID, "unsupported conversion in log format");
+
+    constexpr bool COUNT_MATCHES = VALID && argCount(Format::str()) == sizeof...(Args);
+    static_assert(!VALID || COUNT_MATCHES, "wrong number of arguments for log format");
+
+    Formatter<Format, COUNT_MATCHES>::append(out, args...);
+}
+
+} // end namespace LogFormat
+
+template <typename Format, typename... Args>
+void Logger::logFormatted(LogLevel level, int lineNum, const Args&... args) const
+{
+    LogMessage message;
+    message.loggerName = mName;
+    message.lineNum = lineNum;
+    message.logLevel = level;
+
+    LogFormat::format<Format>(message.message, args...);
+
+    dispatch(message);
+}
+
+}
+
+/**
+ * Declares a local type holding the format string, which is how a
+ * string literal gets into a template argument in C++11.
+ */
+#define _DKM_LOG_FORMAT_TYPE(name, fmt) \
+    struct name \
+    { \
+        static constexpr const char* str() { return fmt; } \
+    }
+
+/**
+ * Appends fmt, formatted with the remaining arguments, to the
+ * std::string out.
+ */
+#define DKM_FORMAT(out, fmt, ...) \
+    do { \
+        _DKM_LOG_FORMAT_TYPE(_DkmLogFormat, fmt); \
+        ::dkm::LogFormat::format<_DkmLogFormat>(out, ##__VA_ARGS__); \
+    } while (0)
+
+/**
+ * Call-site logging macros with compile-time checked formats. Like
+ * DKM_LOG, these check the logger's level before evaluating any
+ * arguments and record the source line number.
+ */
+#define DKM_LOGF(logger, level, fmt, ...) \
+    do { \
+        if ((logger).isEnabled(level)) { \
+            _DKM_LOG_FORMAT_TYPE(_DkmLogFormat, fmt); \
+            (logger).template logFormatted<_DkmLogFormat>(level, __LINE__, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define DKM_LOGF_ERROR(logger, fmt, ...) DKM_LOGF(logger, ::dkm::LogLevel::ERROR, fmt, ##__VA_ARGS__)
+#define DKM_LOGF_WARN(logger, fmt, ...) DKM_LOGF(logger, ::dkm::LogLevel::WARN, fmt, ##__VA_ARGS__)
+#define DKM_LOGF_INFO(logger, fmt, ...) DKM_LOGF(logger, ::dkm::LogLevel::INFO, fmt, ##__VA_ARGS__)
+#define DKM_LOGF_DEBUG(logger, fmt, ...) DKM_LOGF(logger, ::dkm::LogLevel::DEBUG, fmt, ##__VA_ARGS__)
+#define DKM_LOGF_TRACE(logger, fmt, ...) DKM_LOGF(logger, ::dkm::LogLevel::TRACE, fmt, ##__VA_ARGS__)
+
+#endif
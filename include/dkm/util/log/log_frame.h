@@ -0,0 +1,133 @@
+#ifndef _DKM_LOG_FRAME_H_
+#define _DKM_LOG_FRAME_H_
+
+/**
+ * Framed log files, as written by a FileLogWriter with compression
+ * turned on. The file is a series of frames, each a fixed-size header
+ * followed by a payload that decodes on its own to a run of complete
+ * formatted lines. The header records the payload size and the time
+ * range of the messages in the frame. A reader can therefore find the
+ * frames covering a period by reading headers and seeking past
+ * payloads, without decompressing anything it does not need.
+ *
+ * Header fields are little-endian:
+ *
+ *     offset  size
+ *          0     4  magic "DKMF"
+ *          4     1  codec (LogFrameCodec)
+ *          5     3  reserved, zero
+ *          8     4  decoded length
+ *         12     4  payload length
+ *         16     8  first message time, microseconds since the epoch
+ *         24     8  last message time, microseconds since the epoch
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "dkm/util/noncopyable.h"
+
+namespace dkm
+{
+
+enum class LogFrameCodec : unsigned char
+{
+    /** Payload is the text as is. */
+    NONE = 0,
+    /** Payload is an LzCodec block. */
+    LZ = 1
+};
+
+struct LogFrameHeader
+{
+    LogFrameCodec codec;
+    uint32_t decodedLength;
+    uint32_t payloadLength;
+    int64_t firstTime;
+    int64_t lastTime;
+};
+
+namespace LogFrame
+{
+
+const size_t HEADER_SIZE = 32;
+
+/**
+ * Writes header in its on-disk form to out, which must have room for
+ * HEADER_SIZE bytes.
+ */
+void encodeHeader(const LogFrameHeader& header, char* out);
+
+/**
+ * Reads a header written by encodeHeader(). Returns false if the
+ * magic number or codec is wrong, or the lengths are inconsistent
+ * with the codec.
+ */
+bool decodeHeader(const char* in, LogFrameHeader& header);
+
+/**
+ * Appends a complete frame holding text to out, compressed with codec.
+ * Falls back to LogFrameCodec::NONE if compression would not make the
+ * frame smaller.
+ */
+void appendFrame(const char* text, size_t length, int64_t firstTime, int64_t lastTime,
+                 LogFrameCodec codec, std::string& out);
+
+} // end namespace LogFrame
+
+/**
+ * Reads a framed log file one frame at a time.
+ */
+class LogFrameReader : NonCopyable
+{
+public:
+    /**
+     * Opens the file. Throws std::system_error if it cannot be opened.
+     */
+    explicit LogFrameReader(const std::string& path);
+
+    virtual ~LogFrameReader();
+
+    /**
+     * Reads the next frame's header and returns its offset in the file
+     * in offset, leaving the payload unread. Any unread payload of the
+     * previous frame is skipped. Returns false at the end of the file
+     * or at a truncated or corrupt frame, such as a final frame the
+     * writer has not finished.
+     */
+    bool nextHeader(LogFrameHeader& header, uint64_t& offset);
+
+    /**
+     * Decodes the payload of the frame whose header was just read and
+     * appends the text to out. Returns false if there is no such frame
+     * or its payload is corrupt.
+     */
+    bool readPayload(std::string& out);
+
+    /**
+     * Skips over any frames that end before time, so the next header
+     * read is for the first frame with messages at or after it. Only
+     * headers are read. Frames are assumed to be in time order, as the
+     * writer produces them.
+     */
+    void seek(int64_t time);
+
+private:
+    FILE* mFile;
+
+    // set once nextHeader() has read a header whose payload has not
+    // been read or skipped
+    bool mPayloadPending;
+    LogFrameHeader mPending;
+    uint64_t mPendingOffset;
+
+    // reused for compressed payloads
+    std::string mScratch;
+};
+
+}
+
+#endif
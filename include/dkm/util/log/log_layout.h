@@ -0,0 +1,29 @@
+#ifndef _DKM_LOG_LAYOUT_H_
+#define _DKM_LOG_LAYOUT_H_
+
+#include <string>
+
+#include "dkm/util/log/defs.h"
+
+namespace dkm
+{
+
+/**
+ * Turns a log message into text for a writer. Layouts are immutable
+ * once built, so one instance can be shared by any number of writers
+ * and threads.
+ */
+class LogLayout
+{
+public:
+    virtual ~LogLayout() { }
+
+    /**
+     * Appends the formatted message to out.
+     */
+    virtual void format(const LogMessage& message, std::string& out) const = 0;
+};
+
+}
+
+#endif
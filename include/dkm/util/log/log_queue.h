@@ -0,0 +1,192 @@
+#ifndef _DKM_LOG_QUEUE_H_
+#define _DKM_LOG_QUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "dkm/util/noncopyable.h"
+
+#include "dkm/util/log/defs.h"
+
+namespace dkm
+{
+
+/**
+ * What a producer does when it finds a LogQueue full.
+ */
+enum class BackpressurePolicy
+{
+    /** Wait for space, dropping the message if blockTimeout passes first. */
+    BLOCK,
+    /** Drop the message being added. */
+    DROP_NEWEST,
+    /** Drop the oldest queued message to make room. */
+    DROP_OLDEST,
+    /**
+     * Drop the message if it is at shedLevel or less severe. More
+     * severe messages evict the oldest sheddable queued message, or
+     * wait as with BLOCK if there is none.
+     */
+    DROP_BY_LEVEL
+};
+
+struct BackpressureConfig
+{
+public:
+    BackpressureConfig();
+
+    BackpressurePolicy policy;
+
+    /**
+     * Longest time a producer will wait for space. Zero means
+     * wait indefinitely.
+     */
+    std::chrono::milliseconds blockTimeout;
+
+    /**
+     * Most severe level that DROP_BY_LEVEL may discard.
+     */
+    LogLevel shedLevel;
+};
+
+/**
+ * Multi-producer, single-consumer queue of log messages, as used
+ * between Logging::dispatchMessage() and the dispatcher thread.
+ */
+class LogMessageQueue : NonCopyable
+{
+public:
+    enum class PushResult
+    {
+        /** The message was queued. */
+        QUEUED,
+        /** The message was queued and an older one was dropped. */
+        QUEUED_WITH_DROP,
+        /** The message was dropped. */
+        DROPPED,
+        /** The queue is closed; the caller still owns the message. */
+        CLOSED
+    };
+
+    virtual ~LogMessageQueue() { }
+
+    /**
+     * Replaces the capacity and backpressure settings. Messages
+     * already queued are kept.
+     */
+    virtual void configure(size_t capacity, const BackpressureConfig& config) = 0;
+
+    virtual PushResult push(const LogMessagePtr& message) = 0;
+
+    /**
+     * Moves every queued message into out, waiting up to timeout for
+     * at least one to arrive. Returns false once the queue is closed
+     * and empty.
+     */
+    virtual bool popAll(std::vector<LogMessagePtr>& out, std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * Called by the consumer once it has finished with count messages
+     * returned by popAll().
+     */
+    virtual void markDone(size_t count) = 0;
+
+    /**
+     * Blocks until every message pushed before the call has been
+     * dropped or marked done.
+     */
+    virtual void waitUntilDone() = 0;
+
+    /**
+     * Stops accepting messages. Queued messages can still be popped.
+     */
+    virtual void close() = 0;
+
+    /**
+     * Accepts messages again after close().
+     */
+    virtual void open() = 0;
+
+    virtual size_t size() const = 0;
+
+    virtual uint64_t getDropped() const = 0;
+
+    /**
+     * Passes every queued message to emergencyWrite() on each of the
+     * count writers, oldest first, without locking. Only for use from
+     * a fatal signal handler, when the process is about to die anyway
+     * and a message or two lost to a concurrent push or pop is better
+     * than a handler that deadlocks.
+     */
+    virtual void emergencyDrain(LogWriter* const* writers, size_t count) const = 0;
+};
+
+/**
+ * Bounded multi-producer queue of log messages that applies a
+ * BackpressurePolicy when full and counts the messages it drops.
+ */
+class LogQueue : public LogMessageQueue
+{
+public:
+    LogQueue(size_t capacity = 8192, const BackpressureConfig& config = BackpressureConfig());
+
+    virtual ~LogQueue();
+
+    virtual void configure(size_t capacity, const BackpressureConfig& config);
+
+    virtual PushResult push(const LogMessagePtr& message);
+
+    virtual bool popAll(std::vector<LogMessagePtr>& out, std::chrono::milliseconds timeout);
+
+    virtual void markDone(size_t count);
+
+    virtual void waitUntilDone();
+
+    virtual void close();
+
+    virtual void open();
+
+    virtual size_t size() const;
+
+    virtual uint64_t getDropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+    virtual void emergencyDrain(LogWriter* const* writers, size_t count) const;
+
+private:
+    bool isSheddable(const LogMessage& message) const {
+        return message.logLevel >= mConfig.shedLevel;
+    }
+
+    bool evictSheddable();
+    bool waitForSpace(std::unique_lock<std::mutex>& lock);
+    void dropped(uint64_t count);
+
+    mutable std::mutex mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+    std::condition_variable mDone;
+
+    size_t mCapacity;
+    BackpressureConfig mConfig;
+    bool mClosed;
+
+    std::deque<LogMessagePtr> mMessages;
+
+    // pushed counts every message accepted or dropped; finished counts
+    // those dropped or marked done
+    uint64_t mPushed;
+    uint64_t mFinished;
+
+    std::atomic<uint64_t> mDropped;
+};
+
+}
+
+#endif
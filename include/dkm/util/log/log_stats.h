@@ -0,0 +1,269 @@
+#ifndef _DKM_LOG_STATS_H_
+#define _DKM_LOG_STATS_H_
+
+/**
+ * Self-instrumentation for the logging system. Counters are kept
+ * per thread and only summed when somebody asks for them, so the
+ * cost on the logging path is a few uncontended relaxed stores.
+ */
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dkm/util/noncopyable.h"
+
+#include "dkm/util/log/defs.h"
+
+namespace dkm
+{
+
+/**
+ * Point-in-time copy of a LatencyHistogram.
+ */
+struct LatencySnapshot
+{
+public:
+    static const size_t NUM_BUCKETS = 64;
+
+    LatencySnapshot();
+
+    /**
+     * Number of samples in each bucket. Bucket 0 holds samples of 0 ns
+     * and bucket i > 0 holds samples in [2^(i-1), 2^i) ns.
+     */
+    uint64_t buckets[NUM_BUCKETS];
+
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+
+    double meanNs() const;
+
+    /**
+     * Returns an upper bound on the given percentile (0-100) in ns,
+     * accurate to within a factor of two.
+     */
+    uint64_t percentileNs(double percentile) const;
+
+    /**
+     * Returns the upper bound in ns of the values held in a bucket.
+     */
+    static uint64_t bucketLimitNs(size_t bucket);
+};
+
+/**
+ * Log-scale latency histogram that may be updated from any number
+ * of threads without locking.
+ */
+class LatencyHistogram : NonCopyable
+{
+public:
+    LatencyHistogram();
+
+    void record(uint64_t ns) {
+        size_t bucket = (ns == 0) ? 0 : 64 - __builtin_clzll(ns);
+        if (bucket >= LatencySnapshot::NUM_BUCKETS) {
+            bucket = LatencySnapshot::NUM_BUCKETS - 1;
+        }
+        mBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        mTotalNs.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t max = mMaxNs.load(std::memory_order_relaxed);
+        while (ns > max && !mMaxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    LatencySnapshot snapshot() const;
+
+private:
+    std::atomic<uint64_t> mBuckets[LatencySnapshot::NUM_BUCKETS];
+    std::atomic<uint64_t> mTotalNs;
+    std::atomic<uint64_t> mMaxNs;
+};
+
+/**
+ * Counters written by a single thread. Updates are plain relaxed
+ * load/store pairs since there is only ever one writer; readers may
+ * see slightly stale values.
+ */
+struct LogThreadCounters
+{
+public:
+    LogThreadCounters();
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> messages[NUM_LOG_LEVELS];
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> dispatchNs;
+};
+
+/**
+ * Statistics for a single registered LogWriter.
+ */
+struct LogWriterStats
+{
+public:
+    LogWriterStats();
+
+    std::string name;
+
+    /**
+     * Time spent in each call to LogWriter::write(), or to
+     * LogWriter::writeBatch() for writers with their own queue.
+     */
+    LatencySnapshot writeLatency;
+
+    /**
+     * True if the writer has its own queue and thread. The counters
+     * below are only meaningful in that case.
+     */
+    bool queued;
+
+    /**
+     * Messages dropped by the writer's own queue.
+     */
+    uint64_t dropped;
+
+    /**
+     * Messages waiting in the writer's own queue.
+     */
+    uint64_t queueDepth;
+};
+
+/**
+ * Snapshot of the logging system's counters.
+ */
+struct LoggingStats
+{
+public:
+    LoggingStats();
+
+    /**
+     * Number of messages dispatched, indexed by LogLevel.
+     */
+    uint64_t messages[NUM_LOG_LEVELS];
+
+    /**
+     * Number of messages discarded without reaching any writer.
+     */
+    uint64_t dropped;
+
+    /**
+     * Number of messages waiting to be written.
+     */
+    uint64_t queueDepth;
+
+    /**
+     * Total time spent in Logging::dispatchMessage() along with the
+     * distribution of individual calls.
+     */
+    uint64_t dispatchNs;
+    LatencySnapshot dispatchLatency;
+
+    std::vector<LogWriterStats> writers;
+
+    uint64_t totalMessages() const;
+
+    /**
+     * Returns a human readable description of the stats, one
+     * line per entry.
+     */
+    std::vector<std::string> toLines() const;
+};
+
+/**
+ * Owns the per-thread counter blocks for a Logging instance and sums
+ * them on request. Each thread finds its block through a small
+ * thread-local cache with room for THREAD_CACHE_SIZE collectors, so the
+ * registry mutex is only taken the first time a thread logs through
+ * each one. A thread that alternates between more collectors than that
+ * can miss the cache and take the mutex again. Blocks are keyed by
+ * thread id and reused when an id is recycled, which keeps memory
+ * bounded for programs that churn threads while preserving the counts
+ * of threads that have exited.
+ */
+class LogStatsCollector : NonCopyable
+{
+public:
+    LogStatsCollector();
+
+    LogThreadCounters& local() {
+        ThreadCache& cache = threadCache();
+        for (size_t i = 0; i < THREAD_CACHE_SIZE; ++i) {
+            if (cache.entries[i].ownerId == mId) {
+                return *cache.entries[i].counters;
+            }
+        }
+        return cacheMiss(cache);
+    }
+
+    void countMessage(LogLevel level) {
+        LogThreadCounters::add(local().messages[static_cast<size_t>(level)], 1);
+    }
+
+    void countDropped(uint64_t count = 1) {
+        LogThreadCounters::add(local().dropped, count);
+    }
+
+    void addDispatchTime(uint64_t ns) {
+        LogThreadCounters::add(local().dispatchNs, ns);
+    }
+
+    /**
+     * Sums the counters of every thread into stats.
+     */
+    void aggregate(LoggingStats& stats) const;
+
+    /**
+     * Number of collectors each thread keeps in its cache.
+     */
+    static const size_t THREAD_CACHE_SIZE = 4;
+
+private:
+    struct ThreadCacheEntry
+    {
+        uint64_t ownerId;
+        LogThreadCounters* counters;
+    };
+
+    struct ThreadCache
+    {
+        ThreadCacheEntry entries[THREAD_CACHE_SIZE];
+        size_t next;
+    };
+
+    static ThreadCache& threadCache() {
+        static thread_local ThreadCache cache = { };
+        return cache;
+    }
+
+    /**
+     * Looks up this thread's block and stores it in the cache, replacing
+     * the entries in turn once the cache is full.
+     */
+    LogThreadCounters& cacheMiss(ThreadCache& cache);
+
+    LogThreadCounters& lookup();
+
+    // unique across instances so a cache entry is never mistaken
+    // for one belonging to a collector at a recycled address
+    const uint64_t mId;
+
+    mutable std::mutex mMutex;
+    std::map<std::thread::id, std::unique_ptr<LogThreadCounters> > mCounters;
+};
+
+}
+
+#endif
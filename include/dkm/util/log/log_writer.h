@@ -1,6 +1,8 @@
 #ifndef _DKM_LOG_APPENDER_H_
 #define _DKM_LOG_APPENDER_H_
 
+#include <string>
+
 #include "dkm/util/noncopyable.h"
 
 #include "dkm/util/log/defs.h"
@@ -18,6 +20,40 @@ public:
     virtual ~LogWriter();
 
     virtual void write(const LogMessage& message) = 0;
+
+    /**
+     * Writes count messages at once. The default calls write() for
+     * each one; writers that can do better with a batch, e.g. by
+     * taking a lock once, should override this.
+     */
+    virtual void writeBatch(const LogMessagePtr* messages, size_t count);
+
+    /**
+     * Pushes any buffered output to the destination. Writers
+     * that do not buffer need not override this.
+     */
+    virtual void flush();
+
+    /**
+     * Called from a fatal signal handler to get buffered output to
+     * the destination before the process dies. Must be async-signal
+     * safe: no locks, no allocation, nothing beyond calls like
+     * write(2). Writers that do not buffer need not override this.
+     */
+    virtual void emergencyFlush();
+
+    /**
+     * Writes a message that was still queued when a fatal signal
+     * arrived. The same restrictions as emergencyFlush() apply. The
+     * default drops the message.
+     */
+    virtual void emergencyWrite(const LogMessage& message);
+
+    /**
+     * Returns a short description of the writer for use in
+     * diagnostics such as the logging stats.
+     */
+    virtual std::string getName() const;
 };
 
 }
@@ -2,12 +2,15 @@
 #ifndef _DKM_LOGGER_H_
 #define _DKM_LOGGER_H_
 
+#include <stdarg.h>
+
 #include <string>
 #include <atomic>
 
 #include "dkm/util/noncopyable.h"
 
 #include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_fields.h"
 
 namespace dkm 
 {
@@ -31,6 +34,73 @@ public:
     void warn(const char* fmt, ...) const;
     void error(const char* fmt, ...) const;
 
+    /**
+     * Log msg with structured fields made by kv(), e.g.
+     *
+     *     logger.info("request done", kv("lat_us", 123), kv("path", path));
+     *
+     * msg is used as is rather than as a printf format. In sync mode
+     * each thread encodes into the same message object every time, so
+     * no memory is allocated once its buffers have grown to size.
+     */
+    template <typename... Fields>
+    void trace(const char* msg, const LogField& field, const Fields&... fields) const {
+        logFields(LogLevel::TRACE, 0, msg, field, fields...);
+    }
+
+    template <typename... Fields>
+    void debug(const char* msg, const LogField& field, const Fields&... fields) const {
+        logFields(LogLevel::DEBUG, 0, msg, field, fields...);
+    }
+
+    template <typename... Fields>
+    void info(const char* msg, const LogField& field, const Fields&... fields) const {
+        logFields(LogLevel::INFO, 0, msg, field, fields...);
+    }
+
+    template <typename... Fields>
+    void warn(const char* msg, const LogField& field, const Fields&... fields) const {
+        logFields(LogLevel::WARN, 0, msg, field, fields...);
+    }
+
+    template <typename... Fields>
+    void error(const char* msg, const LogField& field, const Fields&... fields) const {
+        logFields(LogLevel::ERROR, 0, msg, field, fields...);
+    }
+
+    /**
+     * Logs a message at the given level, recording lineNum as the
+     * source line. Used by the DKM_LOG macros.
+     */
+    void log(LogLevel level, int lineNum, const char* fmt, ...) const;
+    void vlog(LogLevel level, int lineNum, const char* fmt, va_list args) const;
+
+    /**
+     * Logs msg with structured fields at the given level. Lets the
+     * DKM_LOG macros take fields, e.g.
+     * DKM_LOG_INFO(logger, "request done", kv("lat_us", 123)).
+     */
+    template <typename... Fields>
+    void log(LogLevel level, int lineNum, const char* msg,
+             const LogField& field, const Fields&... fields) const {
+        logFields(level, lineNum, msg, field, fields...);
+    }
+
+    /**
+     * Logs a message with a format that was checked and parsed at
+     * compile time. Defined in log_format.h; use the DKM_LOGF macros
+     * rather than calling this directly.
+     */
+    template <typename Format, typename... Args>
+    void logFormatted(LogLevel level, int lineNum, const Args&... args) const;
+
+    /**
+     * Returns true if messages at the given level will be dispatched.
+     */
+    bool isEnabled(LogLevel level) const {
+        return level <= mLogLevel.load(std::memory_order_relaxed);
+    }
+
     const std::string& getName() const { return mName; }
 
     LogLevel getLogLevel() const { return mLogLevel.load(); }
@@ -40,6 +110,19 @@ public:
 
 private:
 
+    void dispatch(const LogMessage& message) const;
+
+    template <typename... Fields>
+    void logFields(LogLevel level, int lineNum, const char* msg, const Fields&... fields) const {
+        if (isEnabled(level)) {
+            const LogField array[] = { fields... };
+            dispatchFields(level, lineNum, msg, array, sizeof...(Fields));
+        }
+    }
+
+    void dispatchFields(LogLevel level, int lineNum, const char* msg,
+                        const LogField* fields, size_t count) const;
+
     std::string mName;
 
     std::atomic<LogLevel> mLogLevel;
@@ -47,4 +130,21 @@ private:
 
 }
 
+/**
+ * Call-site logging macros. These check the logger's level before
+ * evaluating any arguments and record the source line number.
+ */
+#define DKM_LOG(logger, level, ...) \
+    do { \
+        if ((logger).isEnabled(level)) { \
+            (logger).log(level, __LINE__, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define DKM_LOG_ERROR(logger, ...) DKM_LOG(logger, ::dkm::LogLevel::ERROR, __VA_ARGS__)
+#define DKM_LOG_WARN(logger, ...) DKM_LOG(logger, ::dkm::LogLevel::WARN, __VA_ARGS__)
+#define DKM_LOG_INFO(logger, ...) DKM_LOG(logger, ::dkm::LogLevel::INFO, __VA_ARGS__)
+#define DKM_LOG_DEBUG(logger, ...) DKM_LOG(logger, ::dkm::LogLevel::DEBUG, __VA_ARGS__)
+#define DKM_LOG_TRACE(logger, ...) DKM_LOG(logger, ::dkm::LogLevel::TRACE, __VA_ARGS__)
+
 #endif
\ No newline at end of file
@@ -5,11 +5,16 @@
 #include <map>
 #include <vector>
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 #include "dkm/util/noncopyable.h"
 
 #include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_queue.h"
+#include "dkm/util/log/log_stats.h"
+#include "dkm/util/log/sharded_log_queue.h"
 
 namespace dkm
 {
@@ -17,6 +22,8 @@ namespace dkm
 struct LoggingConfig 
 {
 public:
+    LoggingConfig();
+
     /**
      * The root log level. This is applied to all loggers
      * not specifically mentioned in the logLevels map.
@@ -27,6 +34,62 @@ public:
      * Map of logger names to log levels.
      */
     std::map<std::string, LogLevel> logLevels;
+
+    /**
+     * If true, dispatchMessage() only queues messages and a
+     * background thread hands them to the writers.
+     */
+    bool async;
+
+    /**
+     * Maximum number of queued messages in async mode. With
+     * shardedQueue this is the limit for each producer thread.
+     */
+    size_t queueCapacity;
+
+    /**
+     * If true, async mode gives each producer thread its own queue
+     * instead of one shared by all of them, and the dispatcher merges
+     * the queues in timestamp order. This avoids contention between
+     * producers when many threads log at once.
+     */
+    bool shardedQueue;
+
+    /**
+     * What callers of dispatchMessage() do when the async queue
+     * is full.
+     */
+    BackpressureConfig backpressure;
+};
+
+/**
+ * Per-writer registration options.
+ */
+struct LogWriterOptions
+{
+public:
+    LogWriterOptions();
+
+    /**
+     * If true the writer gets its own queue and drain thread.
+     * Dispatch only adds a reference to the message to the queue,
+     * so a slow writer cannot hold up the others; it falls behind
+     * on its own and its backpressure policy decides what happens
+     * when it falls too far.
+     */
+    bool queued;
+
+    /**
+     * Maximum number of messages waiting for the writer when queued.
+     */
+    size_t queueCapacity;
+
+    /**
+     * What dispatch does when the writer's queue is full. Defaults to
+     * DROP_NEWEST, so a writer that stalls drops its own messages
+     * instead of making dispatch wait for it.
+     */
+    BackpressureConfig backpressure;
 };
 
 class Logging : NonCopyable
@@ -43,6 +106,28 @@ public:
      */
     static LogLevel DEFAULT_LOG_LEVEL;
 
+    /**
+     * Maximum number of writers that emergencyFlush() reaches. Writers
+     * registered while this many are already registered are skipped.
+     */
+    static const size_t MAX_EMERGENCY_WRITERS = 32;
+
+    /**
+     * Installs a handler for SIGSEGV, SIGBUS and SIGABRT that calls
+     * emergencyFlush() on the global instance, then restores the
+     * previous handler and raises the signal again. The handler runs on
+     * an alternate stack if the calling thread does not already have
+     * one, so a stack overflow on this thread can still be handled.
+     * Returns false if a handler could not be installed, in which case
+     * none are.
+     */
+    static bool installCrashHandler();
+
+    /**
+     * Puts back the handlers replaced by installCrashHandler().
+     */
+    static void uninstallCrashHandler();
+
     Logging();
 
     virtual ~Logging();
@@ -56,22 +141,144 @@ public:
     void registerLogger(Logger* logger);
     void unregisterLogger(Logger* logger);
 
-    void registerLogWriter(LogWriter* writer);
+    void registerLogWriter(LogWriter* writer,
+                           const LogWriterOptions& options = LogWriterOptions());
+
+    /**
+     * Removes the writer. For queued writers this first drains the
+     * writer's queue and stops its thread. The writer is not used
+     * again once this returns.
+     */
     void unregisterLogWriter(LogWriter* writer);
 
     void dispatchMessage(const LogMessage& message);
 
+    /**
+     * Blocks until every message dispatched before the call has
+     * been handed to the writers, then flushes each writer.
+     */
+    void flush();
+
+    /**
+     * Last-ditch write of everything still in memory, for use from a
+     * fatal signal handler. Each registered writer gets emergencyFlush()
+     * followed by emergencyWrite() for anything in its own queue, then
+     * every writer gets the messages waiting in the async queue. Takes
+     * no locks and allocates nothing, so it is async-signal-safe as
+     * long as the writers are. Messages held by a dispatcher or drain
+     * thread that has popped but not yet written them are lost.
+     */
+    void emergencyFlush();
+
+    /**
+     * Returns a snapshot of the logging counters and latency
+     * histograms. Counters are summed across threads at the time
+     * of the call.
+     */
+    LoggingStats getStats();
+
+    /**
+     * Writes the current stats to the given writer as INFO
+     * messages from the "dkm.logging" logger.
+     */
+    void dumpStats(LogWriter& writer);
+
 private:
 
+    /**
+     * Registration state for a LogWriter.
+     */
+    struct WriterEntry
+    {
+        LogWriter* writer;
+        LatencyHistogram writeLatency;
+
+        // set for queued writers only; mutex serializes the drain
+        // thread's writes with flush()
+        std::unique_ptr<LogQueue> queue;
+        std::thread thread;
+        std::mutex mutex;
+    };
+
+    typedef std::vector<std::shared_ptr<WriterEntry> > WriterList;
+
+    /**
+     * Lock-free copy of a registration for emergencyFlush(), which
+     * cannot go through mWriters. A null writer marks a free slot.
+     */
+    struct EmergencySlot
+    {
+        std::atomic<LogWriter*> writer;
+        std::atomic<LogMessageQueue*> queue;
+    };
+
+    std::shared_ptr<const WriterList> getWriters() const;
+
     void doInit();
     void initLogger(Logger* logger) const;
     void initLogWriter(LogWriter* writer) const;
 
+    /**
+     * Writes the message to each direct writer under mWriteMutex and
+     * then queues it for each queued one. Pushing to a writer queue can
+     * wait under its backpressure policy, so it happens after the mutex
+     * is released. shared is the message in shareable form if the
+     * caller has it; otherwise it is created on first use.
+     */
+    void writeToWriters(const LogMessage& message, LogMessagePtr shared);
+
+    /**
+     * Same as writeToWriters() for a batch from the dispatcher, taking
+     * mWriteMutex once for the whole batch.
+     */
+    void writeBatchToWriters(const std::vector<LogMessagePtr>& batch);
+
+    /**
+     * Writes the message to each direct writer. Must be called with
+     * mWriteMutex held. Returns true if any writer is queued.
+     */
+    bool writeDirect(const WriterList& writers, const LogMessage& message);
+
+    /**
+     * Queues the message for each queued writer. Must be called without
+     * mWriteMutex held.
+     */
+    static void pushToQueues(const WriterList& writers, const LogMessage& message, LogMessagePtr& shared);
+
+    void runWriterQueue(WriterEntry* entry);
+    static void stopWriterQueue(WriterEntry& entry);
+
+    void startDispatcher();
+    void stopDispatcher();
+    void runDispatcher();
+
     std::mutex mMutex;
-    bool mInitialized;
+    std::atomic<bool> mInitialized;
 
     std::set<Logger*> mLoggers;
-    std::set<LogWriter*> mWriters;
+
+    // the writer list is replaced rather than modified, so readers
+    // only hold mWritersMutex long enough to take a reference to it;
+    // mWriteMutex serializes the calls into the writers themselves
+    mutable std::mutex mWritersMutex;
+    std::shared_ptr<const WriterList> mWriters;
+    std::mutex mWriteMutex;
+
+    // updated under mWritersMutex alongside mWriters
+    EmergencySlot mEmergencySlots[MAX_EMERGENCY_WRITERS];
+
+    LogStatsCollector mStats;
+    LatencyHistogram mDispatchLatency;
+
+    // async dispatch state; mLifecycleMutex guards the thread object
+    std::atomic<bool> mAsync;
+    // mQueue points at whichever queue the config selects; it only
+    // changes while the dispatcher is stopped
+    std::atomic<LogMessageQueue*> mQueue;
+    LogQueue mSharedQueue;
+    ShardedLogQueue mShardedQueue;
+    std::mutex mLifecycleMutex;
+    std::thread mDispatcher;
 
     LoggingConfig mConfig;
 };
@@ -0,0 +1,103 @@
+#ifndef _DKM_PATTERN_LAYOUT_H_
+#define _DKM_PATTERN_LAYOUT_H_
+
+#include <string>
+#include <vector>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_layout.h"
+
+namespace dkm
+{
+
+/**
+ * Formats log messages according to a pattern such as
+ * "%d{ISO8601} %-5p [%t] %c:%L - %m%n". The pattern is parsed once,
+ * in the constructor, into a list of ops; format() only walks that
+ * list.
+ *
+ * Conversions:
+ *   %d{style}  message timestamp; style is ISO8601 (the default when
+ *              no braces follow), ABSOLUTE or UNIX
+ *   %p         log level
+ *   %t         thread id
+ *   %c         logger name
+ *   %L         source line number
+ *   %m         message text
+ *   %K         structured fields as logfmt, each preceded by a space,
+ *              e.g. " lat_us=123 path=/x"; nothing if there are none
+ *   %n         newline
+ *   %%         percent sign
+ *
+ * Any conversion may be given a minimum width, e.g. %5p. The value is
+ * padded on the left with spaces, or on the right if the width has a
+ * leading '-'.
+ */
+class PatternLayout : public LogLayout
+{
+public:
+    /**
+     * The pattern used when none is given: "[%p] %c:%L - %m%n".
+     */
+    static const char* const DEFAULT_PATTERN;
+
+    enum class DateStyle
+    {
+        /** 2026-10-18T13:45:07.123 */
+        ISO8601,
+        /** 13:45:07.123 */
+        ABSOLUTE,
+        /** Seconds since the epoch with milliseconds, e.g. 1792331107.123 */
+        UNIX
+    };
+
+    /**
+     * Parses the pattern. Times are formatted in local time unless
+     * utc is set, in which case ISO8601 dates end with 'Z'. Throws
+     * std::invalid_argument if the pattern is malformed.
+     */
+    explicit PatternLayout(const std::string& pattern = DEFAULT_PATTERN, bool utc = false);
+
+    /**
+     * Appends the formatted message to out.
+     */
+    virtual void format(const LogMessage& message, std::string& out) const;
+
+    const std::string& getPattern() const { return mPattern; }
+
+private:
+    enum class OpType
+    {
+        LITERAL,
+        DATE,
+        LEVEL,
+        THREAD,
+        LOGGER,
+        LINE,
+        MESSAGE,
+        FIELDS
+    };
+
+    struct Op
+    {
+        OpType type;
+        size_t minWidth;
+        bool leftAlign;
+        DateStyle dateStyle;
+        std::string literal;
+    };
+
+    void parse();
+    void addLiteral(const std::string& text);
+
+    void appendDate(const LogMessage& message, DateStyle style, std::string& out) const;
+
+    std::string mPattern;
+    bool mUtc;
+
+    std::vector<Op> mOps;
+};
+
+}
+
+#endif
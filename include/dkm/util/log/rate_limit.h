@@ -0,0 +1,207 @@
+#ifndef _DKM_LOG_RATE_LIMIT_H_
+#define _DKM_LOG_RATE_LIMIT_H_
+
+/**
+ * Per-call-site rate limiting and sampling for log statements.
+ * The limiter state lives in a function-local static at each call
+ * site and is updated with relaxed atomics only, so a suppressed
+ * message costs a clock read and a couple of atomic increments and
+ * never takes a lock.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/logger.h"
+
+namespace dkm
+{
+
+/**
+ * Allows at most limit messages per interval through a single
+ * call site and counts the ones it turns away. Intervals are aligned
+ * to multiples of the interval length on the monotonic clock. The
+ * interval and the number of messages let through in it share one
+ * atomic word, so the count is only ever reset together with a move
+ * to a later interval and concurrent callers cannot push it past the
+ * limit.
+ */
+class LogRateLimiter
+{
+public:
+    constexpr LogRateLimiter(uint64_t limit, int64_t intervalNs) :
+        mLimit(limit < COUNT_MASK ? limit : static_cast<uint64_t>(COUNT_MASK)),
+        mIntervalNs(intervalNs),
+        mState(0),
+        mSuppressed(0) { }
+
+    /**
+     * Returns true if a message may be logged now. The first call in
+     * a new interval sets suppressed to the number of messages turned
+     * away since the last such call, whether or not it is let through
+     * itself; every other call sets it to 0.
+     */
+    bool acquire(uint64_t& suppressed) {
+        return acquire(nowNs(), suppressed);
+    }
+
+    bool acquire(int64_t now, uint64_t& suppressed) {
+        uint64_t window = static_cast<uint64_t>(now / mIntervalNs) & WINDOW_MASK;
+        uint64_t state = mState.load(std::memory_order_relaxed);
+        for (;;) {
+            uint64_t count = state & COUNT_MASK;
+            bool rollover = windowsAfter(window, state >> COUNT_BITS) > 0;
+            if (!rollover && count >= mLimit) {
+                // the common suppressed case leaves the shared state alone
+                mSuppressed.fetch_add(1, std::memory_order_relaxed);
+                suppressed = 0;
+                return false;
+            }
+
+            uint64_t next = rollover ? (window << COUNT_BITS) : state;
+            if (mLimit > 0) {
+                next += 1;
+            }
+            if (mState.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+                suppressed = rollover ? mSuppressed.exchange(0, std::memory_order_relaxed) : 0;
+                if (mLimit == 0) {
+                    mSuppressed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Number of messages suppressed since the last summary was handed
+     * out by acquire().
+     */
+    uint64_t getSuppressed() const {
+        return mSuppressed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Monotonic time in nanoseconds from the coarse clock, which is
+     * cheap to read and accurate enough for rate windows.
+     */
+    static int64_t nowNs() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+private:
+    // the state word holds the interval number above the count
+    static const int COUNT_BITS = 24;
+    static const uint64_t COUNT_MASK = (1ULL << COUNT_BITS) - 1;
+    static const uint64_t WINDOW_MASK = (1ULL << (64 - COUNT_BITS)) - 1;
+
+    /**
+     * Number of intervals from b to a, allowing for the interval number
+     * wrapping. A caller whose clock reading is older than the current
+     * interval gets a negative result and counts against the current one.
+     */
+    static int64_t windowsAfter(uint64_t a, uint64_t b) {
+        return static_cast<int64_t>(((a - b) & WINDOW_MASK) << COUNT_BITS) >> COUNT_BITS;
+    }
+
+    const uint64_t mLimit;
+    const int64_t mIntervalNs;
+
+    std::atomic<uint64_t> mState;
+    std::atomic<uint64_t> mSuppressed;
+};
+
+/**
+ * Lets a random 1 in every n messages through a single call site and
+ * counts the ones it skips. Random numbers come from a per-thread
+ * xorshift generator so threads do not contend on shared state.
+ */
+class LogSampler
+{
+public:
+    constexpr LogSampler(uint64_t n) :
+        mN(n),
+        mSuppressed(0) { }
+
+    /**
+     * Returns true if a message should be logged.
+     */
+    bool acquire() {
+        if (mN <= 1 || nextRandom() % mN == 0) {
+            return true;
+        }
+
+        mSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * Total number of messages skipped.
+     */
+    uint64_t getSuppressed() const {
+        return mSuppressed.load(std::memory_order_relaxed);
+    }
+
+private:
+    static uint64_t nextRandom() {
+        static thread_local uint64_t state = 0;
+        if (state == 0) {
+            // seed from the address of the state and the time so each
+            // thread gets a different sequence
+            state = reinterpret_cast<uintptr_t>(&state) ^ static_cast<uint64_t>(clock());
+            state |= 1;
+        }
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    const uint64_t mN;
+
+    std::atomic<uint64_t> mSuppressed;
+};
+
+}
+
+/**
+ * Logs at most count messages every intervalMs milliseconds from this
+ * call site. The first call in each later interval logs a summary line
+ * with the number of messages suppressed before it, even if that call
+ * is suppressed too. A site that is never reached again has no call to
+ * log its last summary from.
+ */
+#define DKM_LOG_RATE_LIMITED(logger, level, count, intervalMs, ...) \
+    do { \
+        static ::dkm::LogRateLimiter _dkm_limiter(count, (intervalMs) * 1000000LL); \
+        uint64_t _dkm_suppressed; \
+        if ((logger).isEnabled(level)) { \
+            bool _dkm_allowed = _dkm_limiter.acquire(_dkm_suppressed); \
+            if (_dkm_suppressed > 0) { \
+                (logger).log(level, __LINE__, "suppressed %llu messages", \
+                             static_cast<unsigned long long>(_dkm_suppressed)); \
+            } \
+            if (_dkm_allowed) { \
+                (logger).log(level, __LINE__, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+/**
+ * Logs a random 1 in n messages from this call site. Since nearly every
+ * sampled message follows some skipped ones, no summary line is logged.
+ */
+#define DKM_LOG_SAMPLED(logger, level, n, ...) \
+    do { \
+        static ::dkm::LogSampler _dkm_sampler(n); \
+        if ((logger).isEnabled(level) && _dkm_sampler.acquire()) { \
+            (logger).log(level, __LINE__, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef _DKM_SHARDED_LOG_QUEUE_H_
+#define _DKM_SHARDED_LOG_QUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_queue.h"
+
+namespace dkm
+{
+
+/**
+ * LogMessageQueue that gives every producer thread its own LogQueue,
+ * so producers only ever share a cache line with the consumer and
+ * never with each other. popAll() drains every shard and merges the
+ * results by message timestamp.
+ *
+ * Ordering is exact within one popAll() batch. A message can still be
+ * handed out after a newer message from another thread if it was
+ * pushed after that message's batch had been drained.
+ *
+ * The capacity and backpressure settings apply to each shard
+ * separately. Shards are keyed by thread id and kept after their
+ * thread exits, so a new thread that is given a recycled id reuses
+ * the old shard.
+ */
+class ShardedLogQueue : public LogMessageQueue
+{
+public:
+    ShardedLogQueue(size_t shardCapacity = 8192,
+                    const BackpressureConfig& config = BackpressureConfig());
+
+    virtual ~ShardedLogQueue();
+
+    virtual void configure(size_t shardCapacity, const BackpressureConfig& config);
+
+    virtual PushResult push(const LogMessagePtr& message);
+
+    virtual bool popAll(std::vector<LogMessagePtr>& out, std::chrono::milliseconds timeout);
+
+    /**
+     * Marks done the messages returned by the last popAll(). Each
+     * shard is marked with the number of messages popAll() took from
+     * it, so count, the size of that batch, is not used.
+     */
+    virtual void markDone(size_t count);
+
+    virtual void waitUntilDone();
+
+    virtual void close();
+
+    virtual void open();
+
+    virtual size_t size() const;
+
+    virtual uint64_t getDropped() const;
+
+    /**
+     * Drains each shard in turn, so messages are not merged by
+     * timestamp across threads.
+     */
+    virtual void emergencyDrain(LogWriter* const* writers, size_t count) const;
+
+    /**
+     * Returns the number of shards created so far.
+     */
+    size_t getShardCount() const;
+
+private:
+    struct ThreadCache
+    {
+        uint64_t ownerId;
+        LogQueue* shard;
+    };
+
+    static ThreadCache& threadCache() {
+        static thread_local ThreadCache cache = { 0, nullptr };
+        return cache;
+    }
+
+    LogQueue& local() {
+        ThreadCache& cache = threadCache();
+        if (cache.ownerId != mId) {
+            cache.shard = &lookup();
+            cache.ownerId = mId;
+        }
+        return *cache.shard;
+    }
+
+    LogQueue& lookup();
+
+    std::vector<LogQueue*> getShards() const;
+
+    // drains every shard into out without waiting; returns the number
+    // of messages taken
+    size_t drain(const std::vector<LogQueue*>& shards, std::vector<LogMessagePtr>& out);
+
+    // unique across instances so a cache entry is never mistaken
+    // for one belonging to a queue at a recycled address
+    const uint64_t mId;
+
+    // guards the shard map and the settings new shards are created with
+    mutable std::mutex mShardsMutex;
+    std::map<std::thread::id, std::unique_ptr<LogQueue> > mShards;
+    size_t mShardCapacity;
+    BackpressureConfig mConfig;
+    bool mClosed;
+
+    // the consumer sleeps here when every shard is empty; producers
+    // only touch it while mConsumerWaiting is set
+    std::mutex mWaitMutex;
+    std::condition_variable mWorkReady;
+    std::atomic<bool> mConsumerWaiting;
+
+    // shard and message count of each part of the last popAll() batch;
+    // only used by the consumer
+    std::vector<std::pair<LogQueue*, size_t> > mPending;
+};
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef _DKM_SHM_LOG_READER_H_
+#define _DKM_SHM_LOG_READER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <chrono>
+#include <limits>
+#include <string>
+
+#include "dkm/util/noncopyable.h"
+
+#include "dkm/util/log/shm_ring.h"
+
+namespace dkm
+{
+
+/**
+ * Reads the messages ShmLogWriter publishes into a shared memory ring.
+ * There must be only one reader per ring.
+ *
+ * The reader copes with its producers coming and going. A producer
+ * that restarts with the same ring carries on its sequence, so there
+ * is nothing to do. A message claimed by a producer that died before
+ * finishing it is skipped once stallTimeout has passed. A producer
+ * that replaces the ring with a new segment is picked up by checking
+ * for a replacement every reopenInterval while idle. The reader's
+ * position is kept in the ring, so a restarted reader resumes where
+ * the last one stopped.
+ */
+class ShmLogReader : NonCopyable
+{
+public:
+    /**
+     * The ring need not exist yet; poll() attaches to it once it does.
+     */
+    ShmLogReader(const std::string& name,
+                 std::chrono::milliseconds stallTimeout = std::chrono::milliseconds(100),
+                 std::chrono::milliseconds reopenInterval = std::chrono::milliseconds(1000));
+
+    virtual ~ShmLogReader();
+
+    /**
+     * Appends up to maxMessages messages to out in the order they were
+     * published and returns the number appended. Never blocks.
+     */
+    size_t poll(std::string& out, size_t maxMessages = std::numeric_limits<size_t>::max());
+
+    bool isAttached() const { return mHeader != nullptr; }
+
+    /**
+     * Returns the number of messages skipped, either because they were
+     * overwritten before they could be read or because their producer
+     * never finished writing them.
+     */
+    uint64_t getLost() const { return mLost; }
+
+    /**
+     * Returns the number of messages read that had been truncated.
+     */
+    uint64_t getTruncated() const { return mTruncated; }
+
+    /**
+     * Returns the number of times the reader has attached to a ring,
+     * including the first.
+     */
+    uint64_t getAttachCount() const { return mAttachCount; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    enum class ReadResult
+    {
+        MESSAGE,
+        SKIPPED,
+        NONE
+    };
+
+    ReadResult readOne(std::string& out, Clock::time_point now);
+
+    // moves past messages that have been overwritten
+    ReadResult skipOverwritten();
+
+    bool attach();
+    void detach();
+    bool segmentReplaced() const;
+
+    const std::string mName;
+    const std::chrono::milliseconds mStallTimeout;
+    const std::chrono::milliseconds mReopenInterval;
+
+    void* mBase;
+    size_t mSize;
+    ShmRingHeader* mHeader;
+    dev_t mDevice;
+    ino_t mInode;
+
+    uint64_t mNext;
+
+    // first time the slot for mStallSeq was seen claimed but unfinished
+    uint64_t mStallSeq;
+    Clock::time_point mStallStart;
+
+    Clock::time_point mNextCheck;
+
+    uint64_t mLost;
+    uint64_t mTruncated;
+    uint64_t mAttachCount;
+};
+
+}
+
+#endif
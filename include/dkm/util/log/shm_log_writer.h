@@ -0,0 +1,147 @@
+#ifndef _DKM_SHM_LOG_WRITER_H_
+#define _DKM_SHM_LOG_WRITER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_layout.h"
+#include "dkm/util/log/log_writer.h"
+#include "dkm/util/log/shm_ring.h"
+
+namespace dkm
+{
+
+struct ShmLogWriterConfig
+{
+public:
+    ShmLogWriterConfig(const std::string& ringName = "");
+
+    /**
+     * Name of the POSIX shared memory object, e.g. "/myapp.log".
+     */
+    std::string name;
+
+    /**
+     * Number of messages the ring holds. Rounded up to a power of two.
+     */
+    size_t slotCount;
+
+    /**
+     * Bytes per slot, including a 16 byte slot header. Rounded up to a
+     * multiple of 64. Longer messages are truncated.
+     */
+    size_t slotSize;
+
+    /**
+     * Layout used to format each message. If null, a PatternLayout
+     * with the default pattern is used.
+     */
+    std::shared_ptr<const LogLayout> layout;
+};
+
+/**
+ * LogWriter that publishes formatted messages into a shared memory
+ * ring for another process, such as the shm_log_drain tool, to read
+ * with a ShmLogReader and write out. The logging process does no I/O:
+ * write() formats the message, claims a sequence number with a single
+ * atomic add and copies the line into its slot. It never waits for
+ * the reader. If the reader falls a whole ring behind, older messages
+ * are overwritten and counted as overruns.
+ *
+ * Any number of threads may call write() at once. The ring is left in
+ * place when the writer is destroyed so the reader can drain it, and a
+ * writer created later with the same name and geometry carries on
+ * where the last one stopped.
+ */
+class ShmLogWriter : public LogWriter
+{
+public:
+    /**
+     * Attaches to the named ring if it exists with the same geometry,
+     * or otherwise replaces it with a new, empty one. A ring that
+     * another producer is still creating is waited for rather than
+     * replaced. The whole ring is faulted in up front so write() never
+     * takes a page fault. Throws std::system_error if the ring cannot
+     * be created or mapped.
+     */
+    ShmLogWriter(const ShmLogWriterConfig& config);
+
+    /**
+     * Unmaps the ring, leaving the shared memory object in place.
+     */
+    virtual ~ShmLogWriter();
+
+    virtual void write(const LogMessage& message);
+
+    virtual std::string getName() const;
+
+    const ShmLogWriterConfig& getConfig() const { return mConfig; }
+
+    /**
+     * Returns the number of messages this writer wrote over before the
+     * reader had read them.
+     */
+    uint64_t getOverruns() const { return mOverruns.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the number of messages this writer had to truncate.
+     */
+    uint64_t getTruncated() const { return mTruncated.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the number of messages this writer gave up on because a
+     * writer a whole ring ahead took the same slot first.
+     */
+    uint64_t getLost() const { return mLost.load(std::memory_order_relaxed); }
+
+    /**
+     * Removes the named ring. Readers and writers that have it mapped
+     * keep working with the old segment. Returns false if it did not
+     * exist.
+     */
+    static bool unlink(const std::string& name);
+
+private:
+    enum class AttachResult
+    {
+        ATTACHED,
+        MISSING,
+        // created but not yet sized or given its magic
+        INITIALIZING,
+        INCOMPATIBLE
+    };
+
+    // maps the existing segment if it is compatible; inode is set to
+    // identify the segment that was looked at
+    AttachResult attachExisting(ino_t& inode);
+
+    // creates a new segment, first unlinking the one with the given
+    // inode if replace is set; returns false if another producer got
+    // there first
+    bool createSegment(bool replace, ino_t inode);
+
+    // maps size bytes of fd and closes it
+    void* map(int fd, size_t size);
+
+    const ShmLogWriterConfig mConfig;
+    const std::shared_ptr<const LogLayout> mLayout;
+    const uint32_t mSlotCount;
+    const uint32_t mSlotSize;
+
+    void* mBase;
+    size_t mSize;
+    ShmRingHeader* mHeader;
+
+    std::atomic<uint64_t> mOverruns;
+    std::atomic<uint64_t> mTruncated;
+    std::atomic<uint64_t> mLost;
+};
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef _DKM_SHM_RING_H_
+#define _DKM_SHM_RING_H_
+
+/**
+ * Layout of the POSIX shared memory ring used by ShmLogWriter and
+ * ShmLogReader. Shared between processes, so everything here must
+ * stay plain data with a fixed layout.
+ *
+ * The segment starts with a ShmRingHeader followed by slotCount slots
+ * of slotSize bytes, each beginning with a ShmRingSlot. Producers
+ * claim a sequence number from head and write into slot
+ * (sequence % slotCount), overwriting whatever was there. They never
+ * wait for the reader. Each slot's stamp works like a seqlock:
+ * writingStamp(seq) while the slot is being filled and
+ * committedStamp(seq) once it holds message seq, so the reader can
+ * tell a complete message from one that is missing, half written or
+ * already overwritten.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace dkm
+{
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "the shared memory ring needs lock-free 64-bit atomics");
+
+const uint32_t SHM_RING_MAGIC = 0x444b4d52;
+const uint32_t SHM_RING_VERSION = 1;
+
+/**
+ * Slot flag set when the message did not fit and was cut short.
+ */
+const uint32_t SHM_SLOT_TRUNCATED = 1;
+
+struct ShmRingHeader
+{
+    /** SHM_RING_MAGIC once the segment is initialized. */
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+
+    // producers and the reader each get their own cache line
+    alignas(64) std::atomic<uint64_t> head;
+
+    /**
+     * Next sequence the reader will read. Producers compare against it
+     * to count overruns, and a restarted reader resumes from it.
+     */
+    alignas(64) std::atomic<uint64_t> readPos;
+
+    /**
+     * Messages written over before the reader got to them, as seen by
+     * producers, across every producer since the ring was created.
+     */
+    alignas(64) std::atomic<uint64_t> overruns;
+};
+
+struct ShmRingSlot
+{
+    std::atomic<uint64_t> stamp;
+    uint32_t length;
+    uint32_t flags;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+    const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+};
+
+namespace ShmRing
+{
+
+/**
+ * Size of the header, rounded up so the first slot is cache line
+ * aligned.
+ */
+const size_t HEADER_SIZE = (sizeof(ShmRingHeader) + 63) & ~static_cast<size_t>(63);
+
+inline uint64_t committedStamp(uint64_t seq) { return (seq + 1) * 2; }
+inline uint64_t writingStamp(uint64_t seq) { return committedStamp(seq) - 1; }
+
+/**
+ * Bytes of message text a slot of the given size can hold.
+ */
+inline size_t slotCapacity(uint32_t slotSize) { return slotSize - sizeof(ShmRingSlot); }
+
+inline size_t segmentSize(uint32_t slotCount, uint32_t slotSize)
+{
+    return HEADER_SIZE + static_cast<size_t>(slotCount) * slotSize;
+}
+
+inline ShmRingSlot* slotAt(void* base, const ShmRingHeader& header, uint64_t seq)
+{
+    char* slots = static_cast<char*>(base) + HEADER_SIZE;
+    return reinterpret_cast<ShmRingSlot*>(
+        slots + static_cast<size_t>(seq & (header.slotCount - 1)) * header.slotSize);
+}
+
+} // end namespace ShmRing
+
+}
+
+#endif
@@ -0,0 +1,371 @@
+#ifndef _DKM_TRACE_H_
+#define _DKM_TRACE_H_
+
+/**
+ * Scoped trace spans and instant events for timing hot regions.
+ *
+ *     void solve() {
+ *         DKM_TRACE_SPAN("solve");
+ *         ...
+ *         DKM_TRACE_INSTANT("converged");
+ *     }
+ *
+ * Events go into a buffer owned by the recording thread, so recording
+ * never takes a lock: it is a timestamp read, a thread-local lookup and
+ * a store. Nothing is recorded while the Tracer is disabled, and
+ * defining DKM_TRACE_DISABLE compiles the macros out entirely. The
+ * recorded events can be written as Chrome trace-event JSON and opened
+ * in chrome://tracing or Perfetto.
+ *
+ * Event names and categories are stored as pointers, so they must be
+ * string literals or otherwise outlive the Tracer.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dkm/util/noncopyable.h"
+
+#include "dkm/util/log/defs.h"
+
+namespace dkm
+{
+
+enum class TraceClock
+{
+    /**
+     * The CPU timestamp counter. Reading it costs a few nanoseconds;
+     * ticks are converted to nanoseconds against CLOCK_MONOTONIC when
+     * events are exported. Only used on x86 CPUs with an invariant
+     * TSC; elsewhere MONOTONIC is used instead.
+     */
+    TSC,
+    /** clock_gettime(CLOCK_MONOTONIC). */
+    MONOTONIC
+};
+
+struct TraceEvent
+{
+    const char* name;
+    const char* category;
+
+    /** Start time in clock ticks. */
+    uint64_t start;
+
+    /** Duration in clock ticks; zero for instant events. */
+    uint64_t duration;
+
+    /** Chrome trace phase: 'X' for spans, 'i' for instant events. */
+    char phase;
+};
+
+/**
+ * Events recorded by a single thread. Only the owning thread appends;
+ * other threads may read concurrently. Events are stored in fixed-size
+ * blocks that are published with a release store of the block's count,
+ * so readers see only fully written events.
+ */
+class TraceBuffer : NonCopyable
+{
+public:
+    static const size_t BLOCK_EVENTS = 4096;
+
+    TraceBuffer(unsigned long threadId, size_t maxEvents);
+
+    virtual ~TraceBuffer();
+
+    void record(const TraceEvent& event) {
+        size_t count = mTail->count.load(std::memory_order_relaxed);
+        if (count == BLOCK_EVENTS) {
+            if (!grow()) {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            count = 0;
+        }
+
+        mTail->events[count] = event;
+        mTail->count.store(count + 1, std::memory_order_release);
+    }
+
+    /**
+     * Appends a copy of every published event to out.
+     */
+    void copyEvents(std::vector<TraceEvent>& out) const;
+
+    unsigned long getThreadId() const { return mThreadId; }
+
+    uint64_t getDropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Block
+    {
+        Block() : count(0), next(nullptr) { }
+
+        TraceEvent events[BLOCK_EVENTS];
+        std::atomic<size_t> count;
+        std::atomic<Block*> next;
+    };
+
+    bool grow();
+
+    const unsigned long mThreadId;
+    const size_t mMaxBlocks;
+
+    Block* mHead;
+    Block* mTail;
+    size_t mBlocks;
+
+    std::atomic<uint64_t> mDropped;
+};
+
+/**
+ * Collects trace events from every thread.
+ */
+class Tracer : NonCopyable
+{
+public:
+    /**
+     * Returns the global tracer, which uses TraceClock::TSC where
+     * available. It starts out disabled.
+     */
+    static Tracer& getInstance();
+
+    /**
+     * Creates a disabled tracer. Each thread keeps at most
+     * maxEventsPerThread events, rounded up to a whole block; further
+     * events are counted as dropped.
+     */
+    Tracer(TraceClock clock = TraceClock::TSC, size_t maxEventsPerThread = 1 << 20);
+
+    virtual ~Tracer();
+
+    void enable() { mEnabled.store(true, std::memory_order_relaxed); }
+    void disable() { mEnabled.store(false, std::memory_order_relaxed); }
+
+    bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    /**
+     * The clock actually in use, which is MONOTONIC if TSC was
+     * requested but is not usable on this machine.
+     */
+    TraceClock getClock() const { return mClock; }
+
+    /**
+     * Returns the current time in clock ticks.
+     */
+    uint64_t now() const {
+        return (mClock == TraceClock::TSC) ? readTsc() : readMonotonic();
+    }
+
+    /**
+     * Records a span that started at start, in ticks, and ends now.
+     */
+    void complete(const char* name, const char* category, uint64_t start) {
+        TraceEvent event;
+        event.name = name;
+        event.category = category;
+        event.start = start;
+        event.duration = now() - start;
+        event.phase = 'X';
+        local().record(event);
+    }
+
+    void instant(const char* name, const char* category = "dkm") {
+        TraceEvent event;
+        event.name = name;
+        event.category = category;
+        event.start = now();
+        event.duration = 0;
+        event.phase = 'i';
+        local().record(event);
+    }
+
+    /**
+     * Returns the number of events recorded across all threads.
+     */
+    size_t getEventCount() const;
+
+    /**
+     * Returns the number of events dropped because a thread's buffer
+     * was full.
+     */
+    uint64_t getDropped() const;
+
+    /**
+     * Writes every recorded event as a Chrome trace-event JSON object.
+     * Timestamps are in microseconds since the tracer was created.
+     */
+    void exportChromeJson(std::ostream& out) const;
+
+    /**
+     * Writes exportChromeJson() output to the given file. Returns false
+     * if the file could not be written.
+     */
+    bool writeChromeJson(const std::string& path) const;
+
+    /**
+     * Discards every recorded event. Must not be called while any
+     * other thread may be recording into this tracer.
+     */
+    void clear();
+
+    static uint64_t readMonotonic() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    }
+
+    static uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return readMonotonic();
+#endif
+    }
+
+    /**
+     * Number of tracers each thread keeps in its cache of buffers.
+     */
+    static const size_t THREAD_CACHE_SIZE = 4;
+
+private:
+    struct ThreadCacheEntry
+    {
+        uint64_t ownerId;
+        uint64_t generation;
+        TraceBuffer* buffer;
+    };
+
+    struct ThreadCache
+    {
+        ThreadCacheEntry entries[THREAD_CACHE_SIZE];
+        size_t next;
+    };
+
+    static ThreadCache& threadCache() {
+        static thread_local ThreadCache cache = { };
+        return cache;
+    }
+
+    TraceBuffer& local() {
+        ThreadCache& cache = threadCache();
+        uint64_t generation = mGeneration.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < THREAD_CACHE_SIZE; ++i) {
+            ThreadCacheEntry& entry = cache.entries[i];
+            if (entry.ownerId == mId) {
+                if (entry.generation != generation) {
+                    entry.buffer = &lookup();
+                    entry.generation = generation;
+                }
+                return *entry.buffer;
+            }
+        }
+        return cacheMiss(cache, generation);
+    }
+
+    /**
+     * Looks up this thread's buffer and stores it in the cache, replacing
+     * the entries in turn once the cache is full.
+     */
+    TraceBuffer& cacheMiss(ThreadCache& cache, uint64_t generation);
+
+    TraceBuffer& lookup();
+
+    /**
+     * Returns the number of nanoseconds per clock tick.
+     */
+    double nsPerTick() const;
+
+    // unique across instances so a cache entry is never mistaken
+    // for one belonging to a tracer at a recycled address
+    const uint64_t mId;
+
+    const TraceClock mClock;
+    const size_t mMaxEventsPerThread;
+
+    std::atomic<bool> mEnabled;
+
+    // bumped by clear() so threads drop their cached buffer pointers
+    std::atomic<uint64_t> mGeneration;
+
+    // reference points for converting ticks to time
+    const uint64_t mStartTicks;
+    const uint64_t mStartNs;
+
+    // keyed by kernel thread id; a recycled id shares the buffer
+    // of the exited thread that had it, as it would in a profiler
+    mutable std::mutex mMutex;
+    std::map<unsigned long, std::unique_ptr<TraceBuffer> > mBuffers;
+};
+
+/**
+ * Records a span covering its own lifetime, if the tracer is enabled
+ * when the span is created.
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category = "dkm",
+              Tracer& tracer = Tracer::getInstance()) :
+        mTracer(tracer.isEnabled() ? &tracer : nullptr),
+        mName(name),
+        mCategory(category),
+        mStart(mTracer != nullptr ? tracer.now() : 0) { }
+
+    ~TraceSpan() {
+        if (mTracer != nullptr) {
+            mTracer->complete(mName, mCategory, mStart);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    Tracer* mTracer;
+    const char* mName;
+    const char* mCategory;
+    uint64_t mStart;
+};
+
+}
+
+#define _DKM_TRACE_CONCAT2(a, b) a##b
+#define _DKM_TRACE_CONCAT(a, b) _DKM_TRACE_CONCAT2(a, b)
+
+#ifndef DKM_TRACE_DISABLE
+
+/**
+ * Traces the rest of the enclosing scope as a span with the given name.
+ */
+#define DKM_TRACE_SPAN(name) \
+    ::dkm::TraceSpan _DKM_TRACE_CONCAT(_dkmTraceSpan, __LINE__)(name)
+
+/**
+ * Records an instant event with the given name.
+ */
+#define DKM_TRACE_INSTANT(name) \
+    do { \
+        ::dkm::Tracer& _dkmTracer = ::dkm::Tracer::getInstance(); \
+        if (_dkmTracer.isEnabled()) { \
+            _dkmTracer.instant(name); \
+        } \
+    } while (0)
+
+#else
+
+#define DKM_TRACE_SPAN(name) do { } while (0)
+#define DKM_TRACE_INSTANT(name) do { } while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _DKM_LZ_CODEC_H_
+#define _DKM_LZ_CODEC_H_
+
+/**
+ * A small, fast LZ77 block codec in the style of LZ4, for data such as
+ * log text that compresses well and needs to be compressed quickly.
+ * Each block is self-contained.
+ *
+ * A block is a series of sequences. Each starts with a token byte whose
+ * high four bits are the literal count and low four bits the match
+ * length less 4; a value of 15 in either means more length bytes
+ * follow, each adding up to 255. The literals come next, then a two
+ * byte little-endian match offset and any extra match length bytes.
+ * The final sequence has literals only.
+ */
+
+#include <stddef.h>
+
+namespace dkm
+{
+
+namespace LzCodec
+{
+
+/**
+ * Largest compressed size of length bytes of input.
+ */
+inline size_t compressBound(size_t length)
+{
+    return length + length / 255 + 16;
+}
+
+/**
+ * Compresses length bytes of in into out, which must have room for
+ * compressBound(length) bytes. Returns the compressed size.
+ */
+size_t compress(const char* in, size_t length, char* out);
+
+/**
+ * Largest size a block of length bytes can decompress to. Each extra
+ * match length byte adds at most 255 bytes of output, so a reader can
+ * reject a larger claimed size before allocating for it.
+ */
+inline size_t decompressBound(size_t length)
+{
+    return length * 255;
+}
+
+/**
+ * Decompresses a block into out, which must be exactly outLength
+ * bytes, the original size. Returns false if the block is malformed
+ * or does not decompress to exactly outLength bytes.
+ */
+bool decompress(const char* in, size_t length, char* out, size_t outLength);
+
+} // end namespace LzCodec
+
+}
+
+#endif
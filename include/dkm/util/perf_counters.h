@@ -0,0 +1,92 @@
+#ifndef _DKM_PERF_COUNTERS_H_
+#define _DKM_PERF_COUNTERS_H_
+
+#include <stdint.h>
+
+#include "dkm/util/noncopyable.h"
+
+namespace dkm
+{
+
+/**
+ * Hardware events counted by PerfCounters.
+ */
+enum class PerfEvent
+{
+    CYCLES,
+    INSTRUCTIONS,
+    /** Last level cache misses. */
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    COUNT
+};
+
+/**
+ * Returns a short name for the event, e.g. "cycles".
+ */
+const char* perfEventName(PerfEvent event);
+
+/**
+ * Counts hardware events for the calling thread with perf_event_open,
+ * e.g. to tell whether a kernel is limited by compute or by memory:
+ *
+ *     PerfCounters counters;
+ *     counters.start();
+ *     kernel();
+ *     counters.stop();
+ *     uint64_t misses = counters.value(PerfEvent::CACHE_MISSES);
+ *
+ * Counters the kernel or hardware won't provide, for instance in a VM
+ * or with a restrictive perf_event_paranoid setting, are simply not
+ * available and read as zero; nothing throws. Only user space events
+ * in the thread that created the object are counted. When the kernel
+ * has to multiplex counters the values are scaled up to estimates for
+ * the whole time the counters were running.
+ */
+class PerfCounters : NonCopyable
+{
+public:
+    PerfCounters();
+
+    virtual ~PerfCounters();
+
+    /**
+     * Returns true if at least one event can be counted.
+     */
+    bool isAvailable() const { return mLeader >= 0; }
+
+    /**
+     * Returns true if the given event can be counted.
+     */
+    bool isAvailable(PerfEvent event) const;
+
+    /**
+     * Starts or resumes counting. Counts accumulate over every
+     * start()/stop() pair until reset().
+     */
+    void start();
+
+    void stop();
+
+    /**
+     * Sets every count to zero.
+     */
+    void reset();
+
+    /**
+     * Returns the count for the event so far, or zero if it is not
+     * available.
+     */
+    uint64_t value(PerfEvent event) const;
+
+private:
+    static const int EVENT_COUNT = static_cast<int>(PerfEvent::COUNT);
+
+    // group leader; -1 if nothing could be opened
+    int mLeader;
+    int mFds[EVENT_COUNT];
+};
+
+}
+
+#endif
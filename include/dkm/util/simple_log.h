@@ -6,7 +6,9 @@
  * values are 0 = NONE, 1 = ERROR, 2 = WARN, 3 = INFO, and 
  * 4 = DEBUG. By default, log messages include file names and
  * line numbers. To disable this feature, define the value
- * DKM_LOG_NO_LINE_NUM.
+ * DKM_LOG_NO_LINE_NUM. Timestamps can be disabled by defining
+ * DKM_LOG_NO_TIME or made cheaper (at tick resolution) by
+ * defining DKM_LOG_COARSE_CLOCK.
  */
 
 #ifndef _DKM_SIMPLE_LOG_H_
@@ -14,24 +16,67 @@
 
 #include <time.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 
 /*
 Create a macro for showing the current time unless we were
-told not to.
+told not to. The date and time portion of the prefix is cached
+per thread and only rebuilt with localtime_r when the second
+changes; every other message just patches in the milliseconds.
+Define DKM_LOG_COARSE_CLOCK to read the time with
+CLOCK_REALTIME_COARSE, which is cheaper but only accurate to
+the kernel tick (typically 1-4 ms).
 */
 #ifndef DKM_LOG_NO_TIME
-	#define _DKM_LOG_TIME(os) \
-		unsigned int __ms; \
-		struct tm* __tm; \
-		struct timespec __ts;	\
-		clock_gettime(CLOCK_REALTIME, &__ts);\
-		__ms = (unsigned int)(__ts.tv_nsec / 1000000); \
-		__tm = localtime(&__ts.tv_sec); \
-		fprintf(os, "[%04d-%02d-%02d %02d:%02d:%02d.%03d] ", __tm->tm_year + 1900, \
-			__tm->tm_mon + 1, __tm->tm_mday, __tm->tm_hour, __tm->tm_min, \
-			__tm->tm_sec, __ms); 
+	#ifdef DKM_LOG_COARSE_CLOCK
+		#define _DKM_LOG_CLOCK CLOCK_REALTIME_COARSE
+	#else
+		#define _DKM_LOG_CLOCK CLOCK_REALTIME
+	#endif
+
+	/* buffer size for "[YYYY-MM-DD HH:MM:SS.mmm] " plus room for wide years */
+	#define _DKM_LOG_TIME_BUF_SIZE 48
+
+	/*
+	Returns the timestamp prefix for the current time and stores its
+	length in len. The returned buffer belongs to the calling thread
+	and is overwritten by the next call.
+	*/
+	static inline const char* _dkm_log_time_prefix(size_t* len) {
+		static __thread time_t _dkm_sec = (time_t) -1;
+		static __thread size_t _dkm_len = 0;
+		static __thread char _dkm_buf[_DKM_LOG_TIME_BUF_SIZE];
+		struct timespec ts;
+		struct tm tm;
+		unsigned int ms;
+		char* msPos;
+
+		clock_gettime(_DKM_LOG_CLOCK, &ts);
+		if (ts.tv_sec != _dkm_sec) {
+			localtime_r(&ts.tv_sec, &tm);
+			_dkm_len = (size_t) snprintf(_dkm_buf, sizeof(_dkm_buf),
+				"[%04d-%02d-%02d %02d:%02d:%02d.000] ", tm.tm_year + 1900,
+				tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+			_dkm_sec = ts.tv_sec;
+		}
+
+		/* milliseconds sit just before the trailing "] " */
+		ms = (unsigned int)(ts.tv_nsec / 1000000);
+		msPos = _dkm_buf + _dkm_len - 5;
+		msPos[0] = (char)('0' + ms / 100);
+		msPos[1] = (char)('0' + (ms / 10) % 10);
+		msPos[2] = (char)('0' + ms % 10);
+
+		*len = _dkm_len;
+		return _dkm_buf;
+	}
 #else
-	#define _DKM_LOG_TIME(os)
+	static inline const char* _dkm_log_time_prefix(size_t* len) {
+		*len = 0;
+		return "";
+	}
 #endif
 
 /* 
@@ -69,14 +114,95 @@ told not to.
 	#define DKM_DEBUG_ENABLED
 #endif
 
+/*
+Size of the stack buffer each log line is formatted into. Longer
+lines fall back to a heap buffer.
+*/
+#ifndef DKM_LOG_LINE_BUF_SIZE
+	#define DKM_LOG_LINE_BUF_SIZE 512
+#endif
+
+#if defined(__GNUC__)
+	#define _DKM_LOG_PRINTF_FORMAT(fmtIdx, argIdx) \
+		__attribute__((format(printf, fmtIdx, argIdx)))
+#else
+	#define _DKM_LOG_PRINTF_FORMAT(fmtIdx, argIdx)
+#endif
+
+/*
+Formats a complete log line (timestamp, tag, message, and newline)
+and writes it to os with a single fwrite so that it takes the stream
+lock once and cannot interleave with lines from other threads.
+*/
+static inline void _dkm_log_emit(FILE* os, const char* tag, size_t tagLen,
+	const char* fmt, ...) _DKM_LOG_PRINTF_FORMAT(4, 5);
+
+static inline void _dkm_log_emit(FILE* os, const char* tag, size_t tagLen,
+	const char* fmt, ...) {
+	char stackBuf[DKM_LOG_LINE_BUF_SIZE];
+	char* buf = stackBuf;
+	char* heapBuf = NULL;
+	size_t cap = sizeof(stackBuf);
+	size_t timeLen;
+	size_t headLen;
+	const char* timePrefix;
+	va_list args;
+	int n;
+
+	timePrefix = _dkm_log_time_prefix(&timeLen);
+	headLen = timeLen + tagLen;
+	if (headLen + 1 >= cap) {
+		/* very long file names; leave some room for the message */
+		cap = headLen + DKM_LOG_LINE_BUF_SIZE;
+		heapBuf = (char*) malloc(cap);
+		if (heapBuf == NULL) {
+			return;
+		}
+		buf = heapBuf;
+	}
+	memcpy(buf, timePrefix, timeLen);
+	memcpy(buf + timeLen, tag, tagLen);
+
+	va_start(args, fmt);
+	n = vsnprintf(buf + headLen, cap - headLen, fmt, args);
+	va_end(args);
+	if (n < 0) {
+		n = 0;
+	}
+
+	if (headLen + n + 1 > cap) {
+		/* didn't fit; format again into a buffer of the right size */
+		char* bigBuf = (char*) malloc(headLen + n + 1);
+		if (bigBuf == NULL) {
+			free(heapBuf);
+			return;
+		}
+		memcpy(bigBuf, buf, headLen);
+
+		va_start(args, fmt);
+		vsnprintf(bigBuf + headLen, n + 1, fmt, args);
+		va_end(args);
+
+		free(heapBuf);
+		heapBuf = bigBuf;
+		buf = bigBuf;
+	}
+
+	/* replace the terminating null with the newline */
+	buf[headLen + n] = '\n';
+	fwrite(buf, 1, headLen + n + 1, os);
+
+	free(heapBuf);
+}
+
+#define _DKM_LOG_EMIT(os, tag, ...) \
+	_dkm_log_emit(os, tag, sizeof(tag) - 1, __VA_ARGS__)
+
 /* Create the actual logging macros */
 #ifdef DKM_ERROR_ENABLED
     #define DKM_ERROR(...) \
 		do { \
-			_DKM_LOG_TIME(stderr) \
-			fprintf(stderr, "[ERROR] " _DKM_LOG_LINE_NUM); \
-			fprintf(stderr, __VA_ARGS__ ); \
-			fprintf(stderr, "\n"); \
+			_DKM_LOG_EMIT(stderr, "[ERROR] " _DKM_LOG_LINE_NUM, __VA_ARGS__); \
 		} while(0)
 #else
     #define DKM_ERROR(...)
@@ -85,10 +211,7 @@ told not to.
 #ifdef DKM_WARN_ENABLED
     #define DKM_WARN(...) \
 		do { \
-			_DKM_LOG_TIME(stderr) \
-			fprintf(stderr, "[WARN] " _DKM_LOG_LINE_NUM); \
-			fprintf(stderr, __VA_ARGS__ ); \
-			fprintf(stderr, "\n"); \
+			_DKM_LOG_EMIT(stderr, "[WARN] " _DKM_LOG_LINE_NUM, __VA_ARGS__); \
 		} while(0)
 #else
     #define DKM_WARN(...)
@@ -97,10 +220,7 @@ told not to.
 #ifdef DKM_INFO_ENABLED
     #define DKM_INFO(...)\
 		do { \
-			_DKM_LOG_TIME(stdout) \
-			fprintf(stdout, "[INFO] " _DKM_LOG_LINE_NUM); \
-			fprintf(stdout, __VA_ARGS__ ); \
-			fprintf(stdout, "\n"); \
+			_DKM_LOG_EMIT(stdout, "[INFO] " _DKM_LOG_LINE_NUM, __VA_ARGS__); \
 		} while(0)
 #else
     #define DKM_INFO(...)
@@ -109,10 +229,7 @@ told not to.
 #ifdef DKM_DEBUG_ENABLED
     #define DKM_DEBUG(...) \
 		do { \
-			_DKM_LOG_TIME(stdout) \
-			fprintf(stdout, "[DEBUG] " _DKM_LOG_LINE_NUM); \
-			fprintf(stdout, __VA_ARGS__ ); \
-			fprintf(stdout, "\n"); \
+			_DKM_LOG_EMIT(stdout, "[DEBUG] " _DKM_LOG_LINE_NUM, __VA_ARGS__); \
 		} while(0)
 #else
     #define DKM_DEBUG(...)
@@ -0,0 +1,570 @@
+#include "dkm/util/log/file_log_writer.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#include "dkm/util/format_util.h"
+#include "dkm/util/log/log_frame.h"
+#include "dkm/util/simple_log.h"
+
+namespace dkm
+{
+
+// number of idle buffers kept around for reuse
+static const size_t MAX_SPARE_BUFFERS = 4;
+
+// longest line written by emergencyWrite()
+static const size_t EMERGENCY_LINE_SIZE = 1024;
+
+// Copies as much of text as fits into buf at pos and returns the new
+// position.
+static size_t appendTruncated(char* buf, size_t pos, const char* text, size_t len)
+{
+    size_t room = EMERGENCY_LINE_SIZE - pos;
+    if (len > room) {
+        len = room;
+    }
+    memcpy(buf + pos, text, len);
+    return pos + len;
+}
+
+static int64_t toMicros(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+FileLogWriterConfig::FileLogWriterConfig(const std::string& filePath) :
+    path(filePath),
+    bufferSize(256 * 1024),
+    flushInterval(200),
+    rotation(RotationPolicy::NONE),
+    rotateSize(64 * 1024 * 1024),
+    rotateInterval(24 * 60 * 60),
+    maxFiles(5),
+    fsyncPolicy(FsyncPolicy::NEVER),
+    fsyncInterval(1000),
+    compression(FileCompression::NONE)
+{
+}
+
+FileLogWriter::FileLogWriter(const FileLogWriterConfig& config) :
+    LogWriter(),
+    mConfig(config),
+    mLayout(config.layout ? config.layout : std::make_shared<PatternLayout>()),
+    mFd(-1),
+    mFileSize(0),
+    mQueuedBatches(0),
+    mWrittenBatches(0),
+    mFlushRequested(false),
+    mStopping(false),
+    mEmergencyFlushed(false)
+{
+    openFile();
+    mLastSync = Clock::now();
+
+    mActive = takeSpareBuffer();
+
+    mThread = std::thread(&FileLogWriter::run, this);
+}
+
+FileLogWriter::~FileLogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWorkReady.notify_one();
+    mThread.join();
+
+    if (mConfig.fsyncPolicy != FsyncPolicy::NEVER) {
+        fdatasync(mFd);
+    }
+    close(mFd);
+}
+
+void FileLogWriter::write(const LogMessage& message)
+{
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        dropEmergencyFlushed();
+        notify = append(message);
+    }
+
+    if (notify) {
+        mWorkReady.notify_one();
+    }
+}
+
+void FileLogWriter::writeBatch(const LogMessagePtr* messages, size_t count)
+{
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        dropEmergencyFlushed();
+        for (size_t i = 0; i < count; ++i) {
+            notify = append(*messages[i]) || notify;
+        }
+    }
+
+    if (notify) {
+        mWorkReady.notify_one();
+    }
+}
+
+bool FileLogWriter::append(const LogMessage& message)
+{
+    int64_t time = toMicros(message.timestamp);
+    if (mActive.text.empty()) {
+        mActive.firstTime = time;
+        mActive.lastTime = time;
+    }
+    else {
+        // messages from several threads may arrive slightly out of order
+        mActive.firstTime = std::min(mActive.firstTime, time);
+        mActive.lastTime = std::max(mActive.lastTime, time);
+    }
+
+    mLayout->format(message, mActive.text);
+
+    if (mActive.text.size() >= mConfig.bufferSize) {
+        // hand the full buffer to the background thread and
+        // keep going with an empty one
+        queueActive();
+        return true;
+    }
+    return false;
+}
+
+void FileLogWriter::queueActive()
+{
+    mFull.push_back(std::move(mActive));
+    mActive = takeSpareBuffer();
+    ++mQueuedBatches;
+}
+
+void FileLogWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    dropEmergencyFlushed();
+
+    if (!mActive.text.empty()) {
+        queueActive();
+    }
+    unsigned long long target = mQueuedBatches;
+
+    mFlushRequested = true;
+    mWorkReady.notify_one();
+
+    while (mWrittenBatches < target) {
+        mBatchDone.wait_for(lock, mConfig.flushInterval);
+    }
+}
+
+void FileLogWriter::emergencyFlush()
+{
+    // the process is going down, possibly with mMutex held by the
+    // thread that crashed, so read the buffers without it; if another
+    // thread is appending we may write a partial line
+    for (size_t i = 0; i < mFull.size(); ++i) {
+        Buffer& buf = mFull[i];
+        size_t size = buf.text.size();
+        writeDirectFrame(buf.text.data(), size, buf.firstTime, buf.lastTime);
+        buf.flushed.store(size, std::memory_order_relaxed);
+    }
+    size_t size = mActive.text.size();
+    writeDirectFrame(mActive.text.data(), size, mActive.firstTime, mActive.lastTime);
+    mActive.flushed.store(size, std::memory_order_relaxed);
+
+    // if the process survives, the next thread to take the lock drops
+    // what went out here instead of writing it a second time
+    mEmergencyFlushed.store(true, std::memory_order_release);
+}
+
+void FileLogWriter::dropEmergencyFlushed()
+{
+    if (!mEmergencyFlushed.load(std::memory_order_acquire)) {
+        return;
+    }
+    mEmergencyFlushed.store(false, std::memory_order_relaxed);
+
+    // only buffers carrying a tag are touched, so buffers queued or
+    // swapped in since the flush read them keep all of their text
+    size_t dropped = 0;
+    std::deque<Buffer>::iterator it = mFull.begin();
+    while (it != mFull.end()) {
+        if (dropFlushed(*it)) {
+            it = mFull.erase(it);
+            ++dropped;
+        }
+        else {
+            ++it;
+        }
+    }
+    dropFlushed(mActive);
+
+    // the dropped buffers count as written so flush() doesn't wait on them
+    if (dropped > 0) {
+        mWrittenBatches += dropped;
+        mBatchDone.notify_all();
+    }
+}
+
+bool FileLogWriter::dropFlushed(Buffer& buf)
+{
+    size_t flushed = buf.flushed.exchange(0, std::memory_order_relaxed);
+    if (flushed == 0) {
+        return false;
+    }
+    buf.text.erase(0, std::min(flushed, buf.text.size()));
+    return buf.text.empty();
+}
+
+void FileLogWriter::emergencyWrite(const LogMessage& message)
+{
+    char line[EMERGENCY_LINE_SIZE];
+    char digits[24];
+    char* digitsEnd = digits + sizeof(digits);
+
+    const char* level = logLevelName(message.logLevel);
+
+    size_t pos = 0;
+    pos = appendTruncated(line, pos, "[", 1);
+    pos = appendTruncated(line, pos, level, strlen(level));
+    pos = appendTruncated(line, pos, "] ", 2);
+    pos = appendTruncated(line, pos, message.loggerName.data(), message.loggerName.size());
+    pos = appendTruncated(line, pos, ":", 1);
+
+    long long lineNum = message.lineNum;
+    char* start = FormatUtil::formatDecimal(digitsEnd,
+        lineNum < 0 ? 0ULL - static_cast<unsigned long long>(lineNum) : lineNum);
+    if (lineNum < 0) {
+        *--start = '-';
+    }
+    pos = appendTruncated(line, pos, start, digitsEnd - start);
+
+    pos = appendTruncated(line, pos, " - ", 3);
+    pos = appendTruncated(line, pos, message.message.data(), message.message.size());
+
+    // always end with a newline, even if the message was cut short
+    if (pos == EMERGENCY_LINE_SIZE) {
+        --pos;
+    }
+    line[pos++] = '\n';
+
+    int64_t time = toMicros(message.timestamp);
+    writeDirectFrame(line, pos, time, time);
+}
+
+std::string FileLogWriter::getName() const
+{
+    return "file:" + mConfig.path;
+}
+
+void FileLogWriter::run()
+{
+    std::vector<Buffer> batch;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        bool woken = mWorkReady.wait_for(lock, mConfig.flushInterval, [this] {
+            return mStopping || mFlushRequested || !mFull.empty();
+        });
+
+        // the interval elapsed (or we're shutting down) so whatever is
+        // in the active buffer has waited long enough
+        if ((!woken || mStopping) && !mActive.text.empty()) {
+            queueActive();
+        }
+        mFlushRequested = false;
+        dropEmergencyFlushed();
+
+        size_t count = mFull.size();
+        while (!mFull.empty()) {
+            batch.push_back(std::move(mFull.front()));
+            mFull.pop_front();
+        }
+        bool stopping = mStopping;
+
+        // do all of the file work without holding the lock so
+        // producers can keep filling the active buffer
+        lock.unlock();
+
+        Clock::time_point now = Clock::now();
+        if (!batch.empty()) {
+            writeBuffers(batch);
+        }
+        maybeSync(now, count > 0);
+        maybeRotate(now);
+
+        lock.lock();
+
+        mWrittenBatches += count;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (mSpare.size() < MAX_SPARE_BUFFERS) {
+                batch[i].text.clear();
+                mSpare.push_back(std::move(batch[i]));
+            }
+        }
+        batch.clear();
+
+        if (count > 0) {
+            mBatchDone.notify_all();
+        }
+
+        if (stopping && mFull.empty() && mActive.text.empty()) {
+            break;
+        }
+    }
+}
+
+void FileLogWriter::writeBuffers(std::vector<Buffer>& batch)
+{
+    // gather the buffers into a single writev call; anything the
+    // kernel doesn't take the first time is retried from where it
+    // left off
+    std::vector<struct iovec> iov;
+    iov.reserve(batch.size());
+
+    if (mConfig.compression == FileCompression::LZ) {
+        // one frame per buffer so each can be decoded on its own
+        mFrames.clear();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Buffer& buf = batch[i];
+            if (!buf.text.empty()) {
+                LogFrame::appendFrame(buf.text.data(), buf.text.size(),
+                                      buf.firstTime, buf.lastTime, LogFrameCodec::LZ, mFrames);
+            }
+        }
+        if (!mFrames.empty()) {
+            struct iovec v;
+            v.iov_base = &mFrames[0];
+            v.iov_len = mFrames.size();
+            iov.push_back(v);
+        }
+    }
+    else {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!batch[i].text.empty()) {
+                struct iovec v;
+                v.iov_base = &batch[i].text[0];
+                v.iov_len = batch[i].text.size();
+                iov.push_back(v);
+            }
+        }
+    }
+
+    size_t idx = 0;
+    while (idx < iov.size()) {
+        int count = static_cast<int>(std::min(iov.size() - idx, static_cast<size_t>(IOV_MAX)));
+        ssize_t written = writev(mFd, &iov[idx], count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DKM_ERROR("write to %s failed: %s", mConfig.path.c_str(), strerror(errno));
+            return;
+        }
+
+        mFileSize += written;
+
+        // skip over whatever was fully written
+        size_t remaining = static_cast<size_t>(written);
+        while (idx < iov.size() && remaining >= iov[idx].iov_len) {
+            remaining -= iov[idx].iov_len;
+            ++idx;
+        }
+        if (idx < iov.size()) {
+            iov[idx].iov_base = static_cast<char*>(iov[idx].iov_base) + remaining;
+            iov[idx].iov_len -= remaining;
+        }
+    }
+}
+
+void FileLogWriter::writeDirect(struct iovec* iov, int count) const
+{
+    while (count > 0) {
+        ssize_t written = writev(mFd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        // skip over whatever was fully written and retry the rest
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+}
+
+void FileLogWriter::writeDirectFrame(const char* data, size_t len, int64_t firstTime,
+                                     int64_t lastTime) const
+{
+    if (len == 0) {
+        return;
+    }
+
+    // header and payload go out in one call so a concurrent write from
+    // the background thread can't land between them
+    char buf[LogFrame::HEADER_SIZE];
+    struct iovec iov[2];
+    int count = 0;
+
+    if (mConfig.compression != FileCompression::NONE) {
+        LogFrameHeader header;
+        header.codec = LogFrameCodec::NONE;
+        header.decodedLength = static_cast<uint32_t>(len);
+        header.payloadLength = static_cast<uint32_t>(len);
+        header.firstTime = firstTime;
+        header.lastTime = lastTime;
+
+        LogFrame::encodeHeader(header, buf);
+        iov[count].iov_base = buf;
+        iov[count].iov_len = sizeof(buf);
+        ++count;
+    }
+    iov[count].iov_base = const_cast<char*>(data);
+    iov[count].iov_len = len;
+    ++count;
+
+    writeDirect(iov, count);
+}
+
+void FileLogWriter::maybeSync(Clock::time_point now, bool wroteData)
+{
+    if (!wroteData) {
+        return;
+    }
+
+    bool sync = false;
+    switch (mConfig.fsyncPolicy) {
+    case FsyncPolicy::NEVER:
+        break;
+    case FsyncPolicy::INTERVAL:
+        sync = (now - mLastSync) >= mConfig.fsyncInterval;
+        break;
+    case FsyncPolicy::EVERY_BATCH:
+        sync = true;
+        break;
+    }
+
+    if (sync) {
+        fdatasync(mFd);
+        mLastSync = now;
+    }
+}
+
+void FileLogWriter::maybeRotate(Clock::time_point now)
+{
+    bool rotate = false;
+    switch (mConfig.rotation) {
+    case RotationPolicy::NONE:
+        break;
+    case RotationPolicy::SIZE:
+        rotate = mFileSize >= mConfig.rotateSize;
+        break;
+    case RotationPolicy::TIME:
+        rotate = mFileSize > 0 && (now - mOpenTime) >= mConfig.rotateInterval;
+        break;
+    }
+
+    if (rotate) {
+        rotateFiles();
+    }
+}
+
+void FileLogWriter::openFile()
+{
+    mFd = open(mConfig.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (mFd < 0) {
+        throw std::system_error(errno, std::system_category(),
+                                "unable to open log file " + mConfig.path);
+    }
+
+    struct stat st;
+    mFileSize = (fstat(mFd, &st) == 0) ? st.st_size : 0;
+    mOpenTime = Clock::now();
+}
+
+void FileLogWriter::rotateFiles()
+{
+    if (mConfig.fsyncPolicy != FsyncPolicy::NEVER) {
+        fdatasync(mFd);
+    }
+    close(mFd);
+
+    const std::string& path = mConfig.path;
+    if (mConfig.maxFiles > 0) {
+        // shift path.N-1 -> path.N, ..., path -> path.1; the oldest
+        // file is overwritten by the rename
+        for (unsigned int i = mConfig.maxFiles - 1; i > 0; --i) {
+            std::string from = path + "." + std::to_string(i);
+            std::string to = path + "." + std::to_string(i + 1);
+            rename(from.c_str(), to.c_str());
+        }
+        rename(path.c_str(), (path + ".1").c_str());
+    }
+    else {
+        unlink(path.c_str());
+    }
+
+    try {
+        openFile();
+    }
+    catch (const std::system_error& e) {
+        DKM_ERROR("%s", e.what());
+    }
+}
+
+FileLogWriter::Buffer::Buffer(Buffer&& other) :
+    text(std::move(other.text)),
+    firstTime(other.firstTime),
+    lastTime(other.lastTime),
+    flushed(other.flushed.load(std::memory_order_relaxed))
+{
+}
+
+FileLogWriter::Buffer& FileLogWriter::Buffer::operator=(Buffer&& other)
+{
+    text = std::move(other.text);
+    firstTime = other.firstTime;
+    lastTime = other.lastTime;
+    flushed.store(other.flushed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+FileLogWriter::Buffer FileLogWriter::takeSpareBuffer()
+{
+    Buffer buf;
+    if (!mSpare.empty()) {
+        buf = std::move(mSpare.back());
+        mSpare.pop_back();
+    }
+    else {
+        buf.text.reserve(mConfig.bufferSize);
+    }
+    buf.firstTime = 0;
+    buf.lastTime = 0;
+    buf.flushed.store(0, std::memory_order_relaxed);
+    return buf;
+}
+
+}
@@ -0,0 +1,33 @@
+#include "dkm/util/log/json_layout.h"
+
+#include "dkm/util/format_util.h"
+#include "dkm/util/log/log_fields.h"
+
+namespace dkm
+{
+
+JsonLayout::JsonLayout(bool utc) :
+    LogLayout(),
+    mTime("%d{ISO8601}", utc)
+{
+}
+
+void JsonLayout::format(const LogMessage& message, std::string& out) const
+{
+    out += "{\"time\":\"";
+    mTime.format(message, out);
+    out += "\",\"level\":\"";
+    out += logLevelName(message.logLevel);
+    out += "\",\"logger\":";
+    LogFields::appendJsonString(message.loggerName.data(), message.loggerName.size(), out);
+    out += ",\"line\":";
+    FormatUtil::appendSigned(out, message.lineNum);
+    out += ",\"thread\":";
+    FormatUtil::appendUnsigned(out, message.threadId);
+    out += ",\"msg\":";
+    LogFields::appendJsonString(message.message.data(), message.message.size(), out);
+    LogFields::appendJson(message.fields, out);
+    out += "}\n";
+}
+
+}
@@ -0,0 +1,337 @@
+#include "dkm/util/log/log_fields.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dkm/util/format_util.h"
+
+namespace dkm
+{
+
+namespace LogFields
+{
+
+// Each field is encoded as a type byte, the name length as a varint,
+// the name, and then the value: a varint for UINT, a zigzag varint for
+// INT, 8 raw bytes for DOUBLE, 1 byte for BOOL, and a varint length
+// followed by the bytes for STRING.
+
+static void appendVarint(unsigned long long value, std::string& out)
+{
+    char buf[10];
+    size_t len = 0;
+    while (value >= 0x80) {
+        buf[len++] = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buf[len++] = static_cast<char>(value);
+    out.append(buf, len);
+}
+
+static unsigned long long zigzag(long long value)
+{
+    return (static_cast<unsigned long long>(value) << 1) ^
+        static_cast<unsigned long long>(value >> 63);
+}
+
+static long long unzigzag(unsigned long long value)
+{
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+// Returns true if a logfmt value has to be quoted.
+static bool needsQuotes(const char* value, size_t length)
+{
+    if (length == 0) {
+        return true;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c <= ' ' || c == '=' || c == '"' || c == '\\' || c == 0x7f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void appendLogfmtKey(const char* key, size_t length, std::string& out)
+{
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(key[i]);
+        bool valid = c > ' ' && c != '=' && c != '"' && c != 0x7f;
+        out += valid ? key[i] : '_';
+    }
+}
+
+void encode(const LogField& field, std::string& out)
+{
+    out += static_cast<char>(field.type);
+    appendVarint(field.nameLength, out);
+    out.append(field.name, field.nameLength);
+
+    switch (field.type) {
+    case LogFieldType::INT:
+        appendVarint(zigzag(field.value.i), out);
+        break;
+    case LogFieldType::UINT:
+        appendVarint(field.value.u, out);
+        break;
+    case LogFieldType::DOUBLE:
+        out.append(reinterpret_cast<const char*>(&field.value.d), sizeof(double));
+        break;
+    case LogFieldType::BOOL:
+        out += field.value.b ? '\1' : '\0';
+        break;
+    case LogFieldType::STRING:
+        appendVarint(field.strLength, out);
+        out.append(field.str, field.strLength);
+        break;
+    }
+}
+
+void encode(const LogField* fields, size_t count, std::string& out)
+{
+    for (size_t i = 0; i < count; ++i) {
+        encode(fields[i], out);
+    }
+}
+
+bool Reader::next(LogField& field)
+{
+    if (mPos >= mEnd) {
+        return false;
+    }
+
+    unsigned char type = static_cast<unsigned char>(*mPos++);
+    if (type > static_cast<unsigned char>(LogFieldType::STRING)) {
+        mPos = mEnd;
+        return false;
+    }
+    field.type = static_cast<LogFieldType>(type);
+
+    unsigned long long length;
+    if (!readVarint(length) || length > static_cast<size_t>(mEnd - mPos)) {
+        mPos = mEnd;
+        return false;
+    }
+    field.name = mPos;
+    field.nameLength = length;
+    mPos += length;
+
+    field.value.u = 0;
+    field.str = nullptr;
+    field.strLength = 0;
+
+    bool ok = true;
+    switch (field.type) {
+    case LogFieldType::INT:
+        ok = readVarint(field.value.u);
+        field.value.i = unzigzag(field.value.u);
+        break;
+    case LogFieldType::UINT:
+        ok = readVarint(field.value.u);
+        break;
+    case LogFieldType::DOUBLE:
+        ok = static_cast<size_t>(mEnd - mPos) >= sizeof(double);
+        if (ok) {
+            memcpy(&field.value.d, mPos, sizeof(double));
+            mPos += sizeof(double);
+        }
+        break;
+    case LogFieldType::BOOL:
+        ok = mPos < mEnd;
+        if (ok) {
+            field.value.b = (*mPos++ != '\0');
+        }
+        break;
+    case LogFieldType::STRING:
+        ok = readVarint(length) && length <= static_cast<size_t>(mEnd - mPos);
+        if (ok) {
+            field.str = mPos;
+            field.strLength = length;
+            mPos += length;
+        }
+        break;
+    }
+
+    if (!ok) {
+        mPos = mEnd;
+    }
+    return ok;
+}
+
+bool Reader::readVarint(unsigned long long& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && mPos < mEnd; shift += 7) {
+        unsigned char c = static_cast<unsigned char>(*mPos++);
+        value |= static_cast<unsigned long long>(c & 0x7f) << shift;
+        if ((c & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void appendLogfmt(const std::string& encoded, std::string& out)
+{
+    Reader reader(encoded);
+    LogField field;
+    while (reader.next(field)) {
+        out += ' ';
+        appendLogfmtKey(field.name, field.nameLength, out);
+        out += '=';
+
+        switch (field.type) {
+        case LogFieldType::INT:
+            FormatUtil::appendSigned(out, field.value.i);
+            break;
+        case LogFieldType::UINT:
+            FormatUtil::appendUnsigned(out, field.value.u);
+            break;
+        case LogFieldType::DOUBLE:
+            appendDouble(field.value.d, out);
+            break;
+        case LogFieldType::BOOL:
+            out += field.value.b ? "true" : "false";
+            break;
+        case LogFieldType::STRING:
+            if (needsQuotes(field.str, field.strLength)) {
+                appendJsonString(field.str, field.strLength, out);
+            }
+            else {
+                out.append(field.str, field.strLength);
+            }
+            break;
+        }
+    }
+}
+
+void appendJson(const std::string& encoded, std::string& out)
+{
+    Reader reader(encoded);
+    LogField field;
+    while (reader.next(field)) {
+        out += ',';
+        appendJsonString(field.name, field.nameLength, out);
+        out += ':';
+
+        switch (field.type) {
+        case LogFieldType::INT:
+            FormatUtil::appendSigned(out, field.value.i);
+            break;
+        case LogFieldType::UINT:
+            FormatUtil::appendUnsigned(out, field.value.u);
+            break;
+        case LogFieldType::DOUBLE:
+            if (isfinite(field.value.d)) {
+                appendDouble(field.value.d, out);
+            }
+            else {
+                out += "null";
+            }
+            break;
+        case LogFieldType::BOOL:
+            out += field.value.b ? "true" : "false";
+            break;
+        case LogFieldType::STRING:
+            appendJsonString(field.str, field.strLength, out);
+            break;
+        }
+    }
+}
+
+void appendJsonString(const char* value, size_t length, std::string& out)
+{
+    out += '"';
+
+    // copy runs of plain characters in one go
+    size_t start = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        out.append(value + start, i - start);
+        start = i + 1;
+
+        out += '\\';
+        switch (c) {
+        case '"':
+            out += '"';
+            break;
+        case '\\':
+            out += '\\';
+            break;
+        case '\n':
+            out += 'n';
+            break;
+        case '\r':
+            out += 'r';
+            break;
+        case '\t':
+            out += 't';
+            break;
+        default:
+            out += "u00";
+            if (c < 0x10) {
+                out += '0';
+            }
+            FormatUtil::appendHex(out, c);
+            break;
+        }
+    }
+    out.append(value + start, length - start);
+
+    out += '"';
+}
+
+void appendDouble(double value, std::string& out)
+{
+    // most logged values have only a few decimal places; find the
+    // fewest that represent value exactly and write it as a scaled
+    // integer. Both operands of the division are exact, so it is
+    // correctly rounded and matches what strtod() would read back.
+    static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+    static const unsigned long long IPOW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    static const double MAX_SCALED = 1e15;
+
+    double magnitude = fabs(value);
+    if (magnitude < MAX_SCALED && !(value == 0 && signbit(value))) {
+        for (size_t digits = 0; digits < sizeof(POW10) / sizeof(POW10[0]); ++digits) {
+            double scaled = magnitude * POW10[digits];
+            if (scaled >= MAX_SCALED) {
+                break;
+            }
+
+            unsigned long long n = static_cast<unsigned long long>(scaled);
+            if (static_cast<double>(n) / POW10[digits] != magnitude) {
+                continue;
+            }
+
+            if (value < 0) {
+                out += '-';
+            }
+            FormatUtil::appendUnsigned(out, n / IPOW10[digits]);
+            if (digits > 0) {
+                out += '.';
+                FormatUtil::appendZeroPadded(out, static_cast<unsigned int>(n % IPOW10[digits]),
+                                             static_cast<int>(digits));
+            }
+            return;
+        }
+    }
+
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%.15g", value);
+    if (strtod(buf, nullptr) != value) {
+        len = snprintf(buf, sizeof(buf), "%.17g", value);
+    }
+    out.append(buf, len);
+}
+
+} // end namespace LogFields
+
+}
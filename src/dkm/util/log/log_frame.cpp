@@ -0,0 +1,218 @@
+#include "dkm/util/log/log_frame.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <system_error>
+
+#include "dkm/util/lz_codec.h"
+
+namespace dkm
+{
+
+namespace LogFrame
+{
+
+static const char MAGIC[4] = { 'D', 'K', 'M', 'F' };
+
+static void put32(char* out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+static void put64(char* out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+static uint32_t get32(const char* in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t get64(const char* in)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+void encodeHeader(const LogFrameHeader& header, char* out)
+{
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out[4] = static_cast<char>(header.codec);
+    out[5] = 0;
+    out[6] = 0;
+    out[7] = 0;
+    put32(out + 8, header.decodedLength);
+    put32(out + 12, header.payloadLength);
+    put64(out + 16, static_cast<uint64_t>(header.firstTime));
+    put64(out + 24, static_cast<uint64_t>(header.lastTime));
+}
+
+bool decodeHeader(const char* in, LogFrameHeader& header)
+{
+    if (memcmp(in, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    unsigned char codec = static_cast<unsigned char>(in[4]);
+    if (codec > static_cast<unsigned char>(LogFrameCodec::LZ)) {
+        return false;
+    }
+
+    header.codec = static_cast<LogFrameCodec>(codec);
+    header.decodedLength = get32(in + 8);
+    header.payloadLength = get32(in + 12);
+    header.firstTime = static_cast<int64_t>(get64(in + 16));
+    header.lastTime = static_cast<int64_t>(get64(in + 24));
+
+    if (header.codec == LogFrameCodec::NONE) {
+        return header.payloadLength == header.decodedLength;
+    }
+    // a corrupt decoded length would otherwise have the reader
+    // allocate up to 4GB before finding out the payload is bad
+    return header.decodedLength <= LzCodec::decompressBound(header.payloadLength);
+}
+
+void appendFrame(const char* text, size_t length, int64_t firstTime, int64_t lastTime,
+                 LogFrameCodec codec, std::string& out)
+{
+    LogFrameHeader header;
+    header.codec = codec;
+    header.decodedLength = static_cast<uint32_t>(length);
+    header.firstTime = firstTime;
+    header.lastTime = lastTime;
+
+    size_t start = out.size();
+
+    if (codec == LogFrameCodec::LZ) {
+        out.resize(start + HEADER_SIZE + LzCodec::compressBound(length));
+        size_t compressed = LzCodec::compress(text, length, &out[start + HEADER_SIZE]);
+        if (compressed < length) {
+            out.resize(start + HEADER_SIZE + compressed);
+            header.payloadLength = static_cast<uint32_t>(compressed);
+            encodeHeader(header, &out[start]);
+            return;
+        }
+
+        // not worth it; store the text as is
+        header.codec = LogFrameCodec::NONE;
+    }
+
+    header.payloadLength = static_cast<uint32_t>(length);
+    out.resize(start + HEADER_SIZE);
+    encodeHeader(header, &out[start]);
+    out.append(text, length);
+}
+
+} // end namespace LogFrame
+
+LogFrameReader::LogFrameReader(const std::string& path) :
+    NonCopyable(),
+    mFile(fopen(path.c_str(), "rb")),
+    mPayloadPending(false),
+    mPendingOffset(0)
+{
+    if (mFile == nullptr) {
+        throw std::system_error(errno, std::system_category(),
+                                "unable to open log file " + path);
+    }
+}
+
+LogFrameReader::~LogFrameReader()
+{
+    fclose(mFile);
+}
+
+bool LogFrameReader::nextHeader(LogFrameHeader& header, uint64_t& offset)
+{
+    if (mPayloadPending) {
+        mPayloadPending = false;
+        if (fseeko(mFile, mPendingOffset + LogFrame::HEADER_SIZE + mPending.payloadLength,
+                   SEEK_SET) != 0) {
+            return false;
+        }
+    }
+
+    off_t start = ftello(mFile);
+    char buf[LogFrame::HEADER_SIZE];
+    if (start < 0 || fread(buf, 1, sizeof(buf), mFile) != sizeof(buf) ||
+            !LogFrame::decodeHeader(buf, mPending)) {
+        return false;
+    }
+
+    // a frame still being written is treated as the end of the file
+    struct stat st;
+    if (fstat(fileno(mFile), &st) != 0 ||
+            static_cast<uint64_t>(st.st_size) <
+            static_cast<uint64_t>(start) + LogFrame::HEADER_SIZE + mPending.payloadLength) {
+        fseeko(mFile, start, SEEK_SET);
+        return false;
+    }
+
+    mPayloadPending = true;
+    mPendingOffset = start;
+    header = mPending;
+    offset = start;
+    return true;
+}
+
+bool LogFrameReader::readPayload(std::string& out)
+{
+    if (!mPayloadPending) {
+        return false;
+    }
+    mPayloadPending = false;
+
+    if (mPending.codec == LogFrameCodec::NONE) {
+        size_t start = out.size();
+        out.resize(start + mPending.payloadLength);
+        if (fread(&out[start], 1, mPending.payloadLength, mFile) != mPending.payloadLength) {
+            out.resize(start);
+            return false;
+        }
+        return true;
+    }
+
+    mScratch.resize(mPending.payloadLength);
+    if (fread(&mScratch[0], 1, mScratch.size(), mFile) != mScratch.size()) {
+        return false;
+    }
+
+    size_t start = out.size();
+    out.resize(start + mPending.decodedLength);
+    if (!LzCodec::decompress(mScratch.data(), mScratch.size(), &out[start],
+                             mPending.decodedLength)) {
+        out.resize(start);
+        return false;
+    }
+    return true;
+}
+
+void LogFrameReader::seek(int64_t time)
+{
+    LogFrameHeader header;
+    uint64_t offset;
+    while (nextHeader(header, offset)) {
+        if (header.lastTime >= time) {
+            // back up so the caller reads this frame next
+            mPayloadPending = false;
+            fseeko(mFile, offset, SEEK_SET);
+            return;
+        }
+    }
+}
+
+}
@@ -0,0 +1,216 @@
+#include "dkm/util/log/log_queue.h"
+
+#include "dkm/util/log/log_writer.h"
+
+namespace dkm
+{
+
+// how often indefinite waits wake up to re-check their condition
+static const std::chrono::milliseconds WAIT_SLICE(100);
+
+BackpressureConfig::BackpressureConfig() :
+    policy(BackpressurePolicy::BLOCK),
+    blockTimeout(0),
+    shedLevel(LogLevel::INFO)
+{
+}
+
+LogQueue::LogQueue(size_t capacity, const BackpressureConfig& config) :
+    LogMessageQueue(),
+    mCapacity(capacity),
+    mConfig(config),
+    mClosed(false),
+    mPushed(0),
+    mFinished(0),
+    mDropped(0)
+{
+}
+
+LogQueue::~LogQueue()
+{
+}
+
+void LogQueue::configure(size_t capacity, const BackpressureConfig& config)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mCapacity = capacity;
+    mConfig = config;
+
+    mNotFull.notify_all();
+}
+
+LogQueue::PushResult LogQueue::push(const LogMessagePtr& message)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (mClosed) {
+        return PushResult::CLOSED;
+    }
+
+    PushResult result = PushResult::QUEUED;
+    if (mMessages.size() >= mCapacity) {
+        bool wait = false;
+
+        switch (mConfig.policy) {
+        case BackpressurePolicy::BLOCK:
+            wait = true;
+            break;
+        case BackpressurePolicy::DROP_NEWEST:
+            ++mPushed;
+            dropped(1);
+            return PushResult::DROPPED;
+        case BackpressurePolicy::DROP_OLDEST:
+            mMessages.pop_front();
+            dropped(1);
+            result = PushResult::QUEUED_WITH_DROP;
+            break;
+        case BackpressurePolicy::DROP_BY_LEVEL:
+            if (isSheddable(*message)) {
+                ++mPushed;
+                dropped(1);
+                return PushResult::DROPPED;
+            }
+            if (evictSheddable()) {
+                dropped(1);
+                result = PushResult::QUEUED_WITH_DROP;
+            }
+            else {
+                wait = true;
+            }
+            break;
+        }
+
+        if (wait && !waitForSpace(lock)) {
+            if (mClosed) {
+                return PushResult::CLOSED;
+            }
+            ++mPushed;
+            dropped(1);
+            return PushResult::DROPPED;
+        }
+    }
+
+    mMessages.push_back(message);
+    ++mPushed;
+
+    lock.unlock();
+    mNotEmpty.notify_one();
+
+    return result;
+}
+
+bool LogQueue::popAll(std::vector<LogMessagePtr>& out, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (mMessages.empty() && !mClosed && timeout.count() > 0) {
+        mNotEmpty.wait_for(lock, timeout);
+    }
+
+    if (mMessages.empty()) {
+        return !mClosed;
+    }
+
+    out.reserve(out.size() + mMessages.size());
+    for (size_t i = 0; i < mMessages.size(); ++i) {
+        out.push_back(std::move(mMessages[i]));
+    }
+    mMessages.clear();
+
+    lock.unlock();
+    mNotFull.notify_all();
+
+    return true;
+}
+
+void LogQueue::markDone(size_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished += count;
+    }
+    mDone.notify_all();
+}
+
+void LogQueue::waitUntilDone()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    uint64_t target = mPushed;
+    while (mFinished < target) {
+        mDone.wait_for(lock, WAIT_SLICE);
+    }
+}
+
+void LogQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosed = true;
+    }
+    mNotEmpty.notify_all();
+    mNotFull.notify_all();
+}
+
+void LogQueue::open()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mClosed = false;
+}
+
+size_t LogQueue::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mMessages.size();
+}
+
+void LogQueue::emergencyDrain(LogWriter* const* writers, size_t count) const
+{
+    for (size_t i = 0; i < mMessages.size(); ++i) {
+        const LogMessagePtr& message = mMessages[i];
+        if (!message) {
+            continue;
+        }
+        for (size_t w = 0; w < count; ++w) {
+            writers[w]->emergencyWrite(*message);
+        }
+    }
+}
+
+bool LogQueue::evictSheddable()
+{
+    std::deque<LogMessagePtr>::iterator it;
+    for (it = mMessages.begin(); it != mMessages.end(); ++it) {
+        if (isSheddable(**it)) {
+            mMessages.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogQueue::waitForSpace(std::unique_lock<std::mutex>& lock)
+{
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + mConfig.blockTimeout;
+
+    while (mMessages.size() >= mCapacity && !mClosed) {
+        if (mConfig.blockTimeout.count() == 0) {
+            mNotFull.wait_for(lock, WAIT_SLICE);
+        }
+        else if (mNotFull.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return mMessages.size() < mCapacity && !mClosed;
+        }
+    }
+    return !mClosed;
+}
+
+void LogQueue::dropped(uint64_t count)
+{
+    mDropped.fetch_add(count, std::memory_order_relaxed);
+    mFinished += count;
+    mDone.notify_all();
+}
+
+}
@@ -0,0 +1,210 @@
+#include "dkm/util/log/log_stats.h"
+
+#include <stdio.h>
+
+namespace dkm
+{
+
+static std::atomic<uint64_t> nextCollectorId(1);
+
+LatencySnapshot::LatencySnapshot() :
+    count(0),
+    totalNs(0),
+    maxNs(0)
+{
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        buckets[i] = 0;
+    }
+}
+
+double LatencySnapshot::meanNs() const
+{
+    return (count > 0) ? static_cast<double>(totalNs) / count : 0.0;
+}
+
+uint64_t LatencySnapshot::percentileNs(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    // find the first bucket at which the running total reaches
+    // the requested rank
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint64_t limit = bucketLimitNs(i);
+            return (limit < maxNs) ? limit : maxNs;
+        }
+    }
+    return maxNs;
+}
+
+uint64_t LatencySnapshot::bucketLimitNs(size_t bucket)
+{
+    if (bucket == 0) {
+        return 0;
+    }
+    if (bucket >= 64) {
+        return UINT64_MAX;
+    }
+    return (static_cast<uint64_t>(1) << bucket) - 1;
+}
+
+LatencyHistogram::LatencyHistogram() :
+    NonCopyable(),
+    mTotalNs(0),
+    mMaxNs(0)
+{
+    for (size_t i = 0; i < LatencySnapshot::NUM_BUCKETS; ++i) {
+        mBuckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const
+{
+    LatencySnapshot result;
+    for (size_t i = 0; i < LatencySnapshot::NUM_BUCKETS; ++i) {
+        result.buckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+        result.count += result.buckets[i];
+    }
+    result.totalNs = mTotalNs.load(std::memory_order_relaxed);
+    result.maxNs = mMaxNs.load(std::memory_order_relaxed);
+    return result;
+}
+
+LogThreadCounters::LogThreadCounters() :
+    dropped(0),
+    dispatchNs(0)
+{
+    for (size_t i = 0; i < NUM_LOG_LEVELS; ++i) {
+        messages[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LogWriterStats::LogWriterStats() :
+    queued(false),
+    dropped(0),
+    queueDepth(0)
+{
+}
+
+LoggingStats::LoggingStats() :
+    dropped(0),
+    queueDepth(0),
+    dispatchNs(0)
+{
+    for (size_t i = 0; i < NUM_LOG_LEVELS; ++i) {
+        messages[i] = 0;
+    }
+}
+
+uint64_t LoggingStats::totalMessages() const
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < NUM_LOG_LEVELS; ++i) {
+        total += messages[i];
+    }
+    return total;
+}
+
+static std::string formatLatency(const char* label, const LatencySnapshot& latency)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "%s: count=%llu mean=%.0fns p50<=%lluns p99<=%lluns p999<=%lluns max=%lluns",
+             label,
+             static_cast<unsigned long long>(latency.count),
+             latency.meanNs(),
+             static_cast<unsigned long long>(latency.percentileNs(50)),
+             static_cast<unsigned long long>(latency.percentileNs(99)),
+             static_cast<unsigned long long>(latency.percentileNs(99.9)),
+             static_cast<unsigned long long>(latency.maxNs));
+    return buf;
+}
+
+std::vector<std::string> LoggingStats::toLines() const
+{
+    std::vector<std::string> lines;
+    char buf[256];
+
+    std::string counts = "messages:";
+    for (size_t i = 0; i < NUM_LOG_LEVELS; ++i) {
+        snprintf(buf, sizeof(buf), " %s=%llu", logLevelName(static_cast<LogLevel>(i)),
+                 static_cast<unsigned long long>(messages[i]));
+        counts += buf;
+    }
+    lines.push_back(counts);
+
+    snprintf(buf, sizeof(buf), "dropped=%llu queueDepth=%llu dispatchTotal=%lluns",
+             static_cast<unsigned long long>(dropped),
+             static_cast<unsigned long long>(queueDepth),
+             static_cast<unsigned long long>(dispatchNs));
+    lines.push_back(buf);
+
+    lines.push_back(formatLatency("dispatch", dispatchLatency));
+
+    for (size_t i = 0; i < writers.size(); ++i) {
+        std::string label = "writer " + writers[i].name;
+        lines.push_back(formatLatency(label.c_str(), writers[i].writeLatency));
+
+        if (writers[i].queued) {
+            snprintf(buf, sizeof(buf), "%s: dropped=%llu queueDepth=%llu", label.c_str(),
+                     static_cast<unsigned long long>(writers[i].dropped),
+                     static_cast<unsigned long long>(writers[i].queueDepth));
+            lines.push_back(buf);
+        }
+    }
+
+    return lines;
+}
+
+LogStatsCollector::LogStatsCollector() :
+    NonCopyable(),
+    mId(nextCollectorId.fetch_add(1))
+{
+}
+
+void LogStatsCollector::aggregate(LoggingStats& stats) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::map<std::thread::id, std::unique_ptr<LogThreadCounters> >::const_iterator it;
+    for (it = mCounters.begin(); it != mCounters.end(); ++it) {
+        const LogThreadCounters& counters = *it->second;
+        for (size_t i = 0; i < NUM_LOG_LEVELS; ++i) {
+            stats.messages[i] += counters.messages[i].load(std::memory_order_relaxed);
+        }
+        stats.dropped += counters.dropped.load(std::memory_order_relaxed);
+        stats.dispatchNs += counters.dispatchNs.load(std::memory_order_relaxed);
+    }
+}
+
+LogThreadCounters& LogStatsCollector::cacheMiss(ThreadCache& cache)
+{
+    ThreadCacheEntry& entry = cache.entries[cache.next];
+    cache.next = (cache.next + 1) % THREAD_CACHE_SIZE;
+
+    entry.counters = &lookup();
+    entry.ownerId = mId;
+    return *entry.counters;
+}
+
+LogThreadCounters& LogStatsCollector::lookup()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::unique_ptr<LogThreadCounters>& counters = mCounters[std::this_thread::get_id()];
+    if (!counters) {
+        counters.reset(new LogThreadCounters());
+    }
+    return *counters;
+}
+
+}
@@ -0,0 +1,34 @@
+#include "dkm/util/log/log_writer.h"
+
+namespace dkm
+{
+
+LogWriter::~LogWriter()
+{
+}
+
+void LogWriter::writeBatch(const LogMessagePtr* messages, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        write(*messages[i]);
+    }
+}
+
+void LogWriter::flush()
+{
+}
+
+void LogWriter::emergencyFlush()
+{
+}
+
+void LogWriter::emergencyWrite(const LogMessage& /*message*/)
+{
+}
+
+std::string LogWriter::getName() const
+{
+    return "writer";
+}
+
+}
@@ -0,0 +1,125 @@
+#include "dkm/util/log/logger.h"
+
+#include <stdio.h>
+
+#include "dkm/util/log/logging.h"
+
+namespace dkm
+{
+
+// size of the stack buffer messages are formatted into; longer
+// messages are formatted a second time directly into the string
+static const size_t FORMAT_BUF_SIZE = 512;
+
+Logger::Logger(std::string name) :
+    NonCopyable(),
+    mName(name),
+    mLogLevel(Logging::DEFAULT_LOG_LEVEL)
+{
+    Logging::getInstance().registerLogger(this);
+}
+
+Logger::~Logger()
+{
+    Logging::getInstance().unregisterLogger(this);
+}
+
+#define _DKM_LOGGER_LEVEL_METHOD(method, level) \
+    void Logger::method(const char* fmt, ...) const \
+    { \
+        if (isEnabled(level)) { \
+            va_list args; \
+            va_start(args, fmt); \
+            vlog(level, 0, fmt, args); \
+            va_end(args); \
+        } \
+    }
+
+_DKM_LOGGER_LEVEL_METHOD(trace, LogLevel::TRACE)
+_DKM_LOGGER_LEVEL_METHOD(debug, LogLevel::DEBUG)
+_DKM_LOGGER_LEVEL_METHOD(info, LogLevel::INFO)
+_DKM_LOGGER_LEVEL_METHOD(warn, LogLevel::WARN)
+_DKM_LOGGER_LEVEL_METHOD(error, LogLevel::ERROR)
+
+#undef _DKM_LOGGER_LEVEL_METHOD
+
+void Logger::log(LogLevel level, int lineNum, const char* fmt, ...) const
+{
+    if (isEnabled(level)) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(level, lineNum, fmt, args);
+        va_end(args);
+    }
+}
+
+void Logger::vlog(LogLevel level, int lineNum, const char* fmt, va_list args) const
+{
+    LogMessage message;
+    message.loggerName = mName;
+    message.lineNum = lineNum;
+    message.logLevel = level;
+
+    char buf[FORMAT_BUF_SIZE];
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    int len = vsnprintf(buf, sizeof(buf), fmt, argsCopy);
+    va_end(argsCopy);
+
+    if (len < 0) {
+        len = 0;
+    }
+    if (static_cast<size_t>(len) < sizeof(buf)) {
+        message.message.assign(buf, len);
+    }
+    else {
+        message.message.resize(len + 1);
+        vsnprintf(&message.message[0], len + 1, fmt, args);
+        message.message.resize(len);
+    }
+
+    dispatch(message);
+}
+
+// Fills in message for a structured log call.
+static void fillFields(LogMessage& message, const std::string& loggerName, LogLevel level,
+                       int lineNum, const char* msg, const LogField* fields, size_t count)
+{
+    message.loggerName.assign(loggerName);
+    message.lineNum = lineNum;
+    message.logLevel = level;
+    message.message.assign(msg);
+    message.fields.clear();
+    LogFields::encode(fields, count, message.fields);
+    message.timestamp = std::chrono::system_clock::now();
+    message.threadId = logThreadId();
+}
+
+void Logger::dispatchFields(LogLevel level, int lineNum, const char* msg,
+                            const LogField* fields, size_t count) const
+{
+    // each thread reuses one message so its strings keep their
+    // capacity from call to call; a writer that logs from inside
+    // write() gets a fresh message rather than clobbering it
+    static thread_local LogMessage reusable;
+    static thread_local bool inUse = false;
+
+    if (inUse) {
+        LogMessage message;
+        fillFields(message, mName, level, lineNum, msg, fields, count);
+        dispatch(message);
+        return;
+    }
+
+    inUse = true;
+    fillFields(reusable, mName, level, lineNum, msg, fields, count);
+    dispatch(reusable);
+    inUse = false;
+}
+
+void Logger::dispatch(const LogMessage& message) const
+{
+    Logging::getInstance().dispatchMessage(message);
+}
+
+}
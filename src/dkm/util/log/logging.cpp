@@ -1,6 +1,10 @@
 #include "dkm/util/log/logging.h"
 
+#include <signal.h>
+#include <string.h>
+
 #include <set>
+#include <chrono>
 
 #include "dkm/util/log/logger.h"
 #include "dkm/util/log/log_writer.h"
@@ -10,19 +14,96 @@ namespace dkm
 
 LogLevel Logging::DEFAULT_LOG_LEVEL = LogLevel::INFO;
 
+// how long the dispatcher waits for messages before re-checking state
+static const std::chrono::milliseconds DISPATCH_WAIT(100);
+
+// signals that get an emergency flush from installCrashHandler()
+static const int CRASH_SIGNALS[] = { SIGSEGV, SIGBUS, SIGABRT };
+static const size_t NUM_CRASH_SIGNALS = sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0]);
+
+// size of the alternate stack the crash handler runs on
+static const size_t CRASH_STACK_SIZE = 64 * 1024;
+
+// crash handler state; everything but crashFlushed is guarded by
+// crashHandlerMutex outside of the handler itself
+static std::mutex crashHandlerMutex;
+static bool crashHandlerInstalled = false;
+static struct sigaction previousActions[NUM_CRASH_SIGNALS];
+static char crashStack[CRASH_STACK_SIZE];
+static std::atomic<bool> crashFlushed(false);
+
+static void crashHandler(int signal)
+{
+    // only the first fatal signal flushes; any thread that crashes
+    // while that is going on goes straight to the previous handler
+    if (!crashFlushed.exchange(true)) {
+        Logging::getInstance().emergencyFlush();
+    }
+
+    for (size_t i = 0; i < NUM_CRASH_SIGNALS; ++i) {
+        if (CRASH_SIGNALS[i] == signal) {
+            sigaction(signal, &previousActions[i], nullptr);
+        }
+    }
+
+    // delivered once we return, since the signal is blocked while
+    // its handler runs
+    raise(signal);
+}
+
+LogWriterOptions::LogWriterOptions() :
+    queued(false),
+    queueCapacity(8192)
+{
+    // a stalled writer loses its own messages rather than holding up dispatch
+    backpressure.policy = BackpressurePolicy::DROP_NEWEST;
+}
+
+LoggingConfig::LoggingConfig() :
+    rootLogLevel(Logging::DEFAULT_LOG_LEVEL),
+    async(false),
+    queueCapacity(8192),
+    shardedQueue(false)
+{
+}
+
+Logging& Logging::getInstance()
+{
+    static Logging instance;
+    return instance;
+}
+
 Logging::Logging() : 
     NonCopyable(),
-    mInitialized(false)
+    mInitialized(false),
+    mWriters(std::make_shared<WriterList>()),
+    mAsync(false),
+    mQueue(&mSharedQueue)
 {
     mConfig.rootLogLevel = DEFAULT_LOG_LEVEL;
+
+    for (size_t i = 0; i < MAX_EMERGENCY_WRITERS; ++i) {
+        mEmergencySlots[i].writer.store(nullptr, std::memory_order_relaxed);
+        mEmergencySlots[i].queue.store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 Logging::~Logging()
 {
+    stopDispatcher();
+
+    std::shared_ptr<const WriterList> writers = getWriters();
+    for (size_t i = 0; i < writers->size(); ++i) {
+        stopWriterQueue(*(*writers)[i]);
+    }
 }
 
 void Logging::configure(const LoggingConfig& config)
 {
+    // drain and stop any running dispatcher; it is restarted
+    // below if the new config is still async
+    stopDispatcher();
+
     std::lock_guard<std::mutex> lock(mMutex);
 
     // store the config
@@ -42,6 +123,11 @@ void Logging::init()
     doInit();
 }
 
+const LoggingConfig& Logging::getConfig() const
+{
+    return mConfig;
+}
+
 void Logging::registerLogger(Logger* logger)
 {
     std::lock_guard<std::mutex> lock(mMutex);
@@ -65,37 +151,437 @@ void Logging::unregisterLogger(Logger* logger)
     }
 }
 
-void Logging::registerLogWriter(LogWriter* writer)
+void Logging::registerLogWriter(LogWriter* writer, const LogWriterOptions& options)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::lock_guard<std::mutex> lock(mWritersMutex);
 
-    mWriters.insert(writer);
+    for (size_t i = 0; i < mWriters->size(); ++i) {
+        if ((*mWriters)[i]->writer == writer) {
+            return;
+        }
+    }
+
+    std::shared_ptr<WriterList> writers = std::make_shared<WriterList>(*mWriters);
+    std::shared_ptr<WriterEntry> entry = std::make_shared<WriterEntry>();
+    entry->writer = writer;
+
+    if (options.queued) {
+        entry->queue.reset(new LogQueue(options.queueCapacity, options.backpressure));
+        entry->thread = std::thread(&Logging::runWriterQueue, this, entry.get());
+    }
+
+    writers->push_back(entry);
+
+    for (size_t i = 0; i < MAX_EMERGENCY_WRITERS; ++i) {
+        EmergencySlot& slot = mEmergencySlots[i];
+        if (slot.writer.load(std::memory_order_relaxed) == nullptr) {
+            slot.queue.store(entry->queue.get(), std::memory_order_relaxed);
+            slot.writer.store(writer, std::memory_order_release);
+            break;
+        }
+    }
+
+    mWriters = writers;
 }
 
 void Logging::unregisterLogWriter(LogWriter* writer)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::shared_ptr<WriterEntry> removed;
+    {
+        std::lock_guard<std::mutex> lock(mWritersMutex);
+
+        std::shared_ptr<WriterList> writers = std::make_shared<WriterList>();
+        for (size_t i = 0; i < mWriters->size(); ++i) {
+            if ((*mWriters)[i]->writer != writer) {
+                writers->push_back((*mWriters)[i]);
+            }
+            else {
+                removed = (*mWriters)[i];
+            }
+        }
+
+        for (size_t i = 0; i < MAX_EMERGENCY_WRITERS; ++i) {
+            EmergencySlot& slot = mEmergencySlots[i];
+            if (slot.writer.load(std::memory_order_relaxed) == writer) {
+                slot.writer.store(nullptr, std::memory_order_release);
+                slot.queue.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        mWriters = writers;
+    }
 
-    std::set<LogWriter*>::iterator it = mWriters.find(writer);
-    if (it != mWriters.end()) {
-        mWriters.erase(it);
+    {
+        // wait out any write that picked up the old list so the caller
+        // is free to destroy the writer once we return
+        std::lock_guard<std::mutex> lock(mWriteMutex);
     }
+
+    if (removed) {
+        stopWriterQueue(*removed);
+    }
+}
+
+std::shared_ptr<const Logging::WriterList> Logging::getWriters() const
+{
+    std::lock_guard<std::mutex> lock(mWritersMutex);
+    return mWriters;
+}
+
+// Returns the number of nanoseconds between two time points.
+static uint64_t elapsedNs(std::chrono::steady_clock::time_point start,
+                          std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
 }
 
 void Logging::dispatchMessage(const LogMessage& message)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-    if (!mInitialized) {
-        doInit();
+    bool queued = false;
+    if (mAsync.load(std::memory_order_acquire)) {
+        LogMessagePtr shared = std::make_shared<LogMessage>(message);
+        LogMessageQueue::PushResult result = mQueue.load()->push(shared);
+
+        if (result == LogMessageQueue::PushResult::DROPPED ||
+                result == LogMessageQueue::PushResult::QUEUED_WITH_DROP) {
+            mStats.countDropped();
+        }
+
+        // a closed queue means async mode is being turned off; fall
+        // through and write the message directly
+        queued = (result != LogMessageQueue::PushResult::CLOSED);
+    }
+
+    if (!queued) {
+        if (!mInitialized.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mInitialized) {
+                doInit();
+            }
+        }
+
+        writeToWriters(message, LogMessagePtr());
+    }
+
+    uint64_t ns = elapsedNs(start, std::chrono::steady_clock::now());
+    mStats.countMessage(message.logLevel);
+    mStats.addDispatchTime(ns);
+    mDispatchLatency.record(ns);
+}
+
+void Logging::flush()
+{
+    if (mAsync.load(std::memory_order_acquire)) {
+        mQueue.load()->waitUntilDone();
+    }
+
+    std::shared_ptr<const WriterList> writers = getWriters();
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        for (size_t i = 0; i < writers->size(); ++i) {
+            if (!(*writers)[i]->queue) {
+                (*writers)[i]->writer->flush();
+            }
+        }
+    }
+
+    // queued writers drain on their own threads; waiting for them
+    // under mWriteMutex would stall every direct write meanwhile
+    for (size_t i = 0; i < writers->size(); ++i) {
+        WriterEntry& entry = *(*writers)[i];
+        if (entry.queue) {
+            entry.queue->waitUntilDone();
+
+            std::lock_guard<std::mutex> entryLock(entry.mutex);
+            entry.writer->flush();
+        }
+    }
+}
+
+void Logging::emergencyFlush()
+{
+    LogWriter* writers[MAX_EMERGENCY_WRITERS];
+    size_t count = 0;
+
+    for (size_t i = 0; i < MAX_EMERGENCY_WRITERS; ++i) {
+        LogWriter* writer = mEmergencySlots[i].writer.load(std::memory_order_acquire);
+        if (writer == nullptr) {
+            continue;
+        }
+        writers[count++] = writer;
+
+        // anything the writer has buffered is older than what is
+        // still waiting in its queue
+        writer->emergencyFlush();
+
+        LogMessageQueue* queue = mEmergencySlots[i].queue.load(std::memory_order_relaxed);
+        if (queue != nullptr) {
+            queue->emergencyDrain(&writer, 1);
+        }
+    }
+
+    // messages the dispatcher has not picked up yet go to every writer
+    if (mAsync.load(std::memory_order_acquire)) {
+        mQueue.load()->emergencyDrain(writers, count);
+    }
+}
+
+bool Logging::installCrashHandler()
+{
+    std::lock_guard<std::mutex> lock(crashHandlerMutex);
+
+    if (crashHandlerInstalled) {
+        return true;
+    }
+
+    // the handler must not be the one to construct the instance
+    getInstance();
+
+    stack_t current;
+    if (sigaltstack(nullptr, &current) == 0 && (current.ss_flags & SS_DISABLE)) {
+        stack_t stack;
+        stack.ss_sp = crashStack;
+        stack.ss_size = CRASH_STACK_SIZE;
+        stack.ss_flags = 0;
+        sigaltstack(&stack, nullptr);
     }
 
-    std::set<LogWriter*>::iterator it;
-    for (it = mWriters.begin(); it != mWriters.end(); ++it) {
-        (*it)->write(message);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = crashHandler;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+
+    for (size_t i = 0; i < NUM_CRASH_SIGNALS; ++i) {
+        if (sigaction(CRASH_SIGNALS[i], &action, &previousActions[i]) != 0) {
+            while (i > 0) {
+                --i;
+                sigaction(CRASH_SIGNALS[i], &previousActions[i], nullptr);
+            }
+            return false;
+        }
+    }
+
+    crashFlushed.store(false);
+    crashHandlerInstalled = true;
+    return true;
+}
+
+void Logging::uninstallCrashHandler()
+{
+    std::lock_guard<std::mutex> lock(crashHandlerMutex);
+
+    if (!crashHandlerInstalled) {
+        return;
+    }
+
+    for (size_t i = 0; i < NUM_CRASH_SIGNALS; ++i) {
+        sigaction(CRASH_SIGNALS[i], &previousActions[i], nullptr);
+    }
+    crashHandlerInstalled = false;
+}
+
+void Logging::writeToWriters(const LogMessage& message, LogMessagePtr shared)
+{
+    std::shared_ptr<const WriterList> writers = getWriters();
+
+    bool anyQueued;
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        anyQueued = writeDirect(*writers, message);
+    }
+
+    if (anyQueued) {
+        pushToQueues(*writers, message, shared);
+    }
+}
+
+void Logging::writeBatchToWriters(const std::vector<LogMessagePtr>& batch)
+{
+    std::shared_ptr<const WriterList> writers = getWriters();
+
+    bool anyQueued = false;
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (writeDirect(*writers, *batch[i])) {
+                anyQueued = true;
+            }
+        }
+    }
+
+    if (anyQueued) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            LogMessagePtr shared = batch[i];
+            pushToQueues(*writers, *batch[i], shared);
+        }
+    }
+}
+
+bool Logging::writeDirect(const WriterList& writers, const LogMessage& message)
+{
+    // must be called with mWriteMutex held
+    bool anyQueued = false;
+
+    // time each writer using the end of the previous one as
+    // its start to avoid an extra clock read per writer
+    std::chrono::steady_clock::time_point writeStart = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < writers.size(); ++i) {
+        WriterEntry& entry = *writers[i];
+
+        if (entry.queue) {
+            // queued writers are timed on their own thread
+            anyQueued = true;
+            continue;
+        }
+
+        entry.writer->write(message);
+
+        std::chrono::steady_clock::time_point writeEnd = std::chrono::steady_clock::now();
+        entry.writeLatency.record(elapsedNs(writeStart, writeEnd));
+        writeStart = writeEnd;
+    }
+
+    return anyQueued;
+}
+
+void Logging::pushToQueues(const WriterList& writers, const LogMessage& message, LogMessagePtr& shared)
+{
+    for (size_t i = 0; i < writers.size(); ++i) {
+        WriterEntry& entry = *writers[i];
+
+        if (entry.queue) {
+            if (!shared) {
+                shared = std::make_shared<LogMessage>(message);
+            }
+            entry.queue->push(shared);
+        }
     }
 }
 
+void Logging::startDispatcher()
+{
+    std::lock_guard<std::mutex> lock(mLifecycleMutex);
+
+    if (!mDispatcher.joinable()) {
+        LogMessageQueue* queue = mConfig.shardedQueue ?
+            static_cast<LogMessageQueue*>(&mShardedQueue) : &mSharedQueue;
+        queue->configure(mConfig.queueCapacity, mConfig.backpressure);
+        queue->open();
+        mQueue.store(queue);
+
+        mDispatcher = std::thread(&Logging::runDispatcher, this);
+        mAsync.store(true, std::memory_order_release);
+    }
+}
+
+void Logging::stopDispatcher()
+{
+    std::thread dispatcher;
+    {
+        std::lock_guard<std::mutex> lock(mLifecycleMutex);
+
+        mAsync.store(false, std::memory_order_release);
+        mQueue.load()->close();
+        dispatcher.swap(mDispatcher);
+    }
+
+    // join without holding any locks; the dispatcher needs
+    // mWriteMutex to write out whatever is left in the queue
+    if (dispatcher.joinable()) {
+        dispatcher.join();
+    }
+}
+
+void Logging::runDispatcher()
+{
+    std::vector<LogMessagePtr> batch;
+
+    LogMessageQueue* queue = mQueue.load();
+
+    while (queue->popAll(batch, DISPATCH_WAIT)) {
+        if (!batch.empty()) {
+            writeBatchToWriters(batch);
+        }
+
+        queue->markDone(batch.size());
+        batch.clear();
+    }
+}
+
+void Logging::runWriterQueue(WriterEntry* entry)
+{
+    std::vector<LogMessagePtr> batch;
+
+    while (entry->queue->popAll(batch, DISPATCH_WAIT)) {
+        if (!batch.empty()) {
+            std::lock_guard<std::mutex> lock(entry->mutex);
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            entry->writer->writeBatch(&batch[0], batch.size());
+            entry->writeLatency.record(elapsedNs(start, std::chrono::steady_clock::now()));
+        }
+
+        entry->queue->markDone(batch.size());
+        batch.clear();
+    }
+}
+
+void Logging::stopWriterQueue(WriterEntry& entry)
+{
+    if (entry.queue) {
+        // the drain thread writes out what is left before exiting
+        entry.queue->close();
+        if (entry.thread.joinable()) {
+            entry.thread.join();
+        }
+    }
+}
+
+LoggingStats Logging::getStats()
+{
+    LoggingStats stats;
+    mStats.aggregate(stats);
+    stats.dispatchLatency = mDispatchLatency.snapshot();
+    stats.queueDepth = mQueue.load()->size();
+
+    std::shared_ptr<const WriterList> writers = getWriters();
+    for (size_t i = 0; i < writers->size(); ++i) {
+        LogWriterStats writerStats;
+        writerStats.name = (*writers)[i]->writer->getName();
+        writerStats.writeLatency = (*writers)[i]->writeLatency.snapshot();
+
+        const std::unique_ptr<LogQueue>& queue = (*writers)[i]->queue;
+        if (queue) {
+            writerStats.queued = true;
+            writerStats.dropped = queue->getDropped();
+            writerStats.queueDepth = queue->size();
+        }
+        stats.writers.push_back(writerStats);
+    }
+
+    return stats;
+}
+
+void Logging::dumpStats(LogWriter& writer)
+{
+    std::vector<std::string> lines = getStats().toLines();
+
+    LogMessage message;
+    message.loggerName = "dkm.logging";
+    message.lineNum = 0;
+    message.logLevel = LogLevel::INFO;
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        message.message = lines[i];
+        writer.write(message);
+    }
+    writer.flush();
+}
+
 void Logging::doInit()
 {
     std::set<Logger*>::iterator it;
@@ -105,6 +591,10 @@ void Logging::doInit()
         initLogger(*it);
     }
 
+    if (mConfig.async) {
+        startDispatcher();
+    }
+
     mInitialized = true;
 }
 
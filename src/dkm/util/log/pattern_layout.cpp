@@ -0,0 +1,250 @@
+#include "dkm/util/log/pattern_layout.h"
+
+#include <stdint.h>
+#include <time.h>
+
+#include <stdexcept>
+
+#include "dkm/util/format_util.h"
+#include "dkm/util/log/log_fields.h"
+
+namespace dkm
+{
+
+const char* const PatternLayout::DEFAULT_PATTERN = "[%p] %c:%L - %m%n";
+
+// Formatted date and time for a single second. Converting a time to
+// calendar fields is by far the most expensive part of a timestamp,
+// so each thread keeps the text for the last second it formatted in
+// each style and only appends the milliseconds for later messages in
+// the same second.
+struct DateCache
+{
+    bool valid;
+    time_t second;
+    size_t len;
+    char text[32];
+};
+
+static const size_t NUM_DATE_STYLES = 3;
+
+// indexed by style and then by utc
+static __thread DateCache dateCaches[NUM_DATE_STYLES][2];
+
+PatternLayout::PatternLayout(const std::string& pattern, bool utc) :
+    mPattern(pattern),
+    mUtc(utc)
+{
+    parse();
+}
+
+void PatternLayout::format(const LogMessage& message, std::string& out) const
+{
+    for (size_t i = 0; i < mOps.size(); ++i) {
+        const Op& op = mOps[i];
+        size_t start = out.size();
+
+        switch (op.type) {
+        case OpType::LITERAL:
+            out += op.literal;
+            break;
+        case OpType::DATE:
+            appendDate(message, op.dateStyle, out);
+            break;
+        case OpType::LEVEL:
+            out += logLevelName(message.logLevel);
+            break;
+        case OpType::THREAD:
+            FormatUtil::appendUnsigned(out, message.threadId);
+            break;
+        case OpType::LOGGER:
+            out += message.loggerName;
+            break;
+        case OpType::LINE:
+            FormatUtil::appendSigned(out, message.lineNum);
+            break;
+        case OpType::MESSAGE:
+            out += message.message;
+            break;
+        case OpType::FIELDS:
+            LogFields::appendLogfmt(message.fields, out);
+            break;
+        }
+
+        size_t len = out.size() - start;
+        if (len < op.minWidth) {
+            if (op.leftAlign) {
+                out.append(op.minWidth - len, ' ');
+            }
+            else {
+                out.insert(start, op.minWidth - len, ' ');
+            }
+        }
+    }
+}
+
+void PatternLayout::parse()
+{
+    std::string literal;
+
+    size_t i = 0;
+    while (i < mPattern.size()) {
+        char c = mPattern[i++];
+        if (c != '%') {
+            literal += c;
+            continue;
+        }
+
+        if (i < mPattern.size() && mPattern[i] == '%') {
+            literal += '%';
+            ++i;
+            continue;
+        }
+
+        Op op;
+        op.minWidth = 0;
+        op.leftAlign = false;
+        op.dateStyle = DateStyle::ISO8601;
+
+        if (i < mPattern.size() && mPattern[i] == '-') {
+            op.leftAlign = true;
+            ++i;
+        }
+        while (i < mPattern.size() && mPattern[i] >= '0' && mPattern[i] <= '9') {
+            op.minWidth = op.minWidth * 10 + (mPattern[i] - '0');
+            ++i;
+        }
+
+        if (i >= mPattern.size()) {
+            throw std::invalid_argument("incomplete conversion at end of log pattern: " + mPattern);
+        }
+
+        char conversion = mPattern[i++];
+        switch (conversion) {
+        case 'n':
+            literal += '\n';
+            continue;
+        case 'd':
+            op.type = OpType::DATE;
+            if (i < mPattern.size() && mPattern[i] == '{') {
+                size_t close = mPattern.find('}', i);
+                if (close == std::string::npos) {
+                    throw std::invalid_argument("unterminated date style in log pattern: " + mPattern);
+                }
+
+                std::string style = mPattern.substr(i + 1, close - i - 1);
+                if (style == "ISO8601") {
+                    op.dateStyle = DateStyle::ISO8601;
+                }
+                else if (style == "ABSOLUTE") {
+                    op.dateStyle = DateStyle::ABSOLUTE;
+                }
+                else if (style == "UNIX") {
+                    op.dateStyle = DateStyle::UNIX;
+                }
+                else {
+                    throw std::invalid_argument("unknown date style '" + style +
+                                                "' in log pattern: " + mPattern);
+                }
+                i = close + 1;
+            }
+            break;
+        case 'p':
+            op.type = OpType::LEVEL;
+            break;
+        case 't':
+            op.type = OpType::THREAD;
+            break;
+        case 'c':
+            op.type = OpType::LOGGER;
+            break;
+        case 'L':
+            op.type = OpType::LINE;
+            break;
+        case 'm':
+            op.type = OpType::MESSAGE;
+            break;
+        case 'K':
+            op.type = OpType::FIELDS;
+            break;
+        default:
+            throw std::invalid_argument(std::string("unknown conversion '%") + conversion +
+                                        "' in log pattern: " + mPattern);
+        }
+
+        addLiteral(literal);
+        literal.clear();
+        mOps.push_back(op);
+    }
+
+    addLiteral(literal);
+}
+
+void PatternLayout::addLiteral(const std::string& text)
+{
+    if (text.empty()) {
+        return;
+    }
+
+    // merge with a preceding literal, e.g. the text either side of %%
+    if (!mOps.empty() && mOps.back().type == OpType::LITERAL) {
+        mOps.back().literal += text;
+        return;
+    }
+
+    Op op;
+    op.type = OpType::LITERAL;
+    op.minWidth = 0;
+    op.leftAlign = false;
+    op.dateStyle = DateStyle::ISO8601;
+    op.literal = text;
+    mOps.push_back(op);
+}
+
+void PatternLayout::appendDate(const LogMessage& message, DateStyle style, std::string& out) const
+{
+    int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        message.timestamp.time_since_epoch()).count();
+
+    // floor division so times before the epoch still get 0-999 ms
+    int64_t seconds = ms / 1000;
+    int64_t millis = ms % 1000;
+    if (millis < 0) {
+        millis += 1000;
+        --seconds;
+    }
+
+    if (style == DateStyle::UNIX) {
+        FormatUtil::appendSigned(out, seconds);
+    }
+    else {
+        DateCache& cache = dateCaches[static_cast<size_t>(style)][mUtc ? 1 : 0];
+        time_t second = static_cast<time_t>(seconds);
+
+        if (!cache.valid || cache.second != second) {
+            struct tm fields;
+            if (mUtc) {
+                gmtime_r(&second, &fields);
+            }
+            else {
+                localtime_r(&second, &fields);
+            }
+
+            const char* fmt = (style == DateStyle::ISO8601) ? "%Y-%m-%dT%H:%M:%S" : "%H:%M:%S";
+            cache.len = strftime(cache.text, sizeof(cache.text), fmt, &fields);
+            cache.second = second;
+            cache.valid = true;
+        }
+
+        out.append(cache.text, cache.len);
+    }
+
+    out += '.';
+    FormatUtil::appendZeroPadded(out, static_cast<unsigned int>(millis), 3);
+
+    if (style == DateStyle::ISO8601 && mUtc) {
+        out += 'Z';
+    }
+}
+
+}
@@ -0,0 +1,251 @@
+#include "dkm/util/log/sharded_log_queue.h"
+
+#include <algorithm>
+
+namespace dkm
+{
+
+static std::atomic<uint64_t> nextQueueId(1);
+
+// Orders messages by creation time.
+static bool earlier(const LogMessagePtr& a, const LogMessagePtr& b)
+{
+    return a->timestamp < b->timestamp;
+}
+
+ShardedLogQueue::ShardedLogQueue(size_t shardCapacity, const BackpressureConfig& config) :
+    LogMessageQueue(),
+    mId(nextQueueId.fetch_add(1)),
+    mShardCapacity(shardCapacity),
+    mConfig(config),
+    mClosed(false),
+    mConsumerWaiting(false)
+{
+}
+
+ShardedLogQueue::~ShardedLogQueue()
+{
+}
+
+void ShardedLogQueue::configure(size_t shardCapacity, const BackpressureConfig& config)
+{
+    std::lock_guard<std::mutex> lock(mShardsMutex);
+
+    mShardCapacity = shardCapacity;
+    mConfig = config;
+
+    std::map<std::thread::id, std::unique_ptr<LogQueue> >::iterator it;
+    for (it = mShards.begin(); it != mShards.end(); ++it) {
+        it->second->configure(shardCapacity, config);
+    }
+}
+
+LogMessageQueue::PushResult ShardedLogQueue::push(const LogMessagePtr& message)
+{
+    PushResult result = local().push(message);
+
+    if (result == PushResult::QUEUED || result == PushResult::QUEUED_WITH_DROP) {
+        // pairs with the fence in popAll(): either the consumer sees
+        // this message when it re-checks the shards, or we see that it
+        // is about to sleep and wake it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mConsumerWaiting.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mWaitMutex);
+            mWorkReady.notify_one();
+        }
+    }
+    return result;
+}
+
+bool ShardedLogQueue::popAll(std::vector<LogMessagePtr>& out, std::chrono::milliseconds timeout)
+{
+    size_t start = out.size();
+    mPending.clear();
+
+    std::vector<LogQueue*> shards = getShards();
+    if (drain(shards, out) == 0 && timeout.count() > 0) {
+        std::unique_lock<std::mutex> lock(mWaitMutex);
+
+        mConsumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (drain(shards, out) == 0) {
+            mWorkReady.wait_for(lock, timeout);
+        }
+        mConsumerWaiting.store(false, std::memory_order_relaxed);
+        lock.unlock();
+
+        if (out.size() == start) {
+            // we may have been woken by a thread with a brand new shard
+            shards = getShards();
+            drain(shards, out);
+        }
+    }
+
+    if (out.size() == start) {
+        bool closed;
+        {
+            std::lock_guard<std::mutex> lock(mShardsMutex);
+            closed = mClosed;
+        }
+        // a push that landed after the last drain but before close()
+        // is still in its shard, and nothing can be pushed once the
+        // shards are closed, so one more drain picks up the last of it
+        if (!closed || drain(getShards(), out) == 0) {
+            return !closed;
+        }
+    }
+
+    // each shard's run is already in order, so merge neighbouring runs
+    // until one is left
+    std::vector<size_t> bounds;
+    bounds.push_back(start);
+    for (size_t i = 0; i < mPending.size(); ++i) {
+        bounds.push_back(bounds.back() + mPending[i].second);
+    }
+
+    while (bounds.size() > 2) {
+        std::vector<size_t> merged;
+        size_t i = 0;
+        for (; i + 2 < bounds.size(); i += 2) {
+            std::inplace_merge(out.begin() + bounds[i], out.begin() + bounds[i + 1],
+                               out.begin() + bounds[i + 2], earlier);
+            merged.push_back(bounds[i]);
+        }
+        for (; i < bounds.size(); ++i) {
+            merged.push_back(bounds[i]);
+        }
+        bounds.swap(merged);
+    }
+
+    return true;
+}
+
+void ShardedLogQueue::markDone(size_t /*count*/)
+{
+    // popAll() recorded how many messages came from each shard, which
+    // is what the shards need; the total adds nothing
+    for (size_t i = 0; i < mPending.size(); ++i) {
+        mPending[i].first->markDone(mPending[i].second);
+    }
+    mPending.clear();
+}
+
+void ShardedLogQueue::waitUntilDone()
+{
+    std::vector<LogQueue*> shards = getShards();
+    for (size_t i = 0; i < shards.size(); ++i) {
+        shards[i]->waitUntilDone();
+    }
+}
+
+void ShardedLogQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mShardsMutex);
+
+        mClosed = true;
+
+        std::map<std::thread::id, std::unique_ptr<LogQueue> >::iterator it;
+        for (it = mShards.begin(); it != mShards.end(); ++it) {
+            it->second->close();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mWaitMutex);
+    mWorkReady.notify_all();
+}
+
+void ShardedLogQueue::open()
+{
+    std::lock_guard<std::mutex> lock(mShardsMutex);
+
+    mClosed = false;
+
+    std::map<std::thread::id, std::unique_ptr<LogQueue> >::iterator it;
+    for (it = mShards.begin(); it != mShards.end(); ++it) {
+        it->second->open();
+    }
+}
+
+size_t ShardedLogQueue::size() const
+{
+    std::vector<LogQueue*> shards = getShards();
+
+    size_t total = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        total += shards[i]->size();
+    }
+    return total;
+}
+
+uint64_t ShardedLogQueue::getDropped() const
+{
+    std::vector<LogQueue*> shards = getShards();
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        total += shards[i]->getDropped();
+    }
+    return total;
+}
+
+void ShardedLogQueue::emergencyDrain(LogWriter* const* writers, size_t count) const
+{
+    std::map<std::thread::id, std::unique_ptr<LogQueue> >::const_iterator it;
+    for (it = mShards.begin(); it != mShards.end(); ++it) {
+        it->second->emergencyDrain(writers, count);
+    }
+}
+
+size_t ShardedLogQueue::getShardCount() const
+{
+    std::lock_guard<std::mutex> lock(mShardsMutex);
+    return mShards.size();
+}
+
+LogQueue& ShardedLogQueue::lookup()
+{
+    std::lock_guard<std::mutex> lock(mShardsMutex);
+
+    std::unique_ptr<LogQueue>& shard = mShards[std::this_thread::get_id()];
+    if (!shard) {
+        shard.reset(new LogQueue(mShardCapacity, mConfig));
+        if (mClosed) {
+            shard->close();
+        }
+    }
+    return *shard;
+}
+
+std::vector<LogQueue*> ShardedLogQueue::getShards() const
+{
+    std::lock_guard<std::mutex> lock(mShardsMutex);
+
+    std::vector<LogQueue*> shards;
+    shards.reserve(mShards.size());
+
+    std::map<std::thread::id, std::unique_ptr<LogQueue> >::const_iterator it;
+    for (it = mShards.begin(); it != mShards.end(); ++it) {
+        shards.push_back(it->second.get());
+    }
+    return shards;
+}
+
+size_t ShardedLogQueue::drain(const std::vector<LogQueue*>& shards, std::vector<LogMessagePtr>& out)
+{
+    size_t taken = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        size_t before = out.size();
+        shards[i]->popAll(out, std::chrono::milliseconds(0));
+
+        size_t count = out.size() - before;
+        if (count > 0) {
+            mPending.push_back(std::make_pair(shards[i], count));
+            taken += count;
+        }
+    }
+    return taken;
+}
+
+}
@@ -0,0 +1,224 @@
+#include "dkm/util/log/shm_log_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dkm
+{
+
+// stall sequence value meaning no slot is being waited on
+static const uint64_t NO_STALL = std::numeric_limits<uint64_t>::max();
+
+ShmLogReader::ShmLogReader(const std::string& name,
+                           std::chrono::milliseconds stallTimeout,
+                           std::chrono::milliseconds reopenInterval) :
+    NonCopyable(),
+    mName(name),
+    mStallTimeout(stallTimeout),
+    mReopenInterval(reopenInterval),
+    mBase(nullptr),
+    mSize(0),
+    mHeader(nullptr),
+    mDevice(0),
+    mInode(0),
+    mNext(0),
+    mStallSeq(NO_STALL),
+    mLost(0),
+    mTruncated(0),
+    mAttachCount(0)
+{
+    attach();
+    mNextCheck = Clock::now() + mReopenInterval;
+}
+
+ShmLogReader::~ShmLogReader()
+{
+    detach();
+}
+
+size_t ShmLogReader::poll(std::string& out, size_t maxMessages)
+{
+    Clock::time_point now = Clock::now();
+
+    if (mHeader == nullptr && !attach()) {
+        return 0;
+    }
+
+    size_t count = 0;
+    while (count < maxMessages) {
+        ReadResult result = readOne(out, now);
+        if (result == ReadResult::NONE) {
+            break;
+        }
+        if (result == ReadResult::MESSAGE) {
+            ++count;
+        }
+    }
+    mHeader->readPos.store(mNext, std::memory_order_release);
+
+    // only look for a replacement ring once this one is drained
+    if (count == 0 && now >= mNextCheck) {
+        mNextCheck = now + mReopenInterval;
+        if (segmentReplaced()) {
+            detach();
+            if (attach()) {
+                return poll(out, maxMessages);
+            }
+        }
+    }
+    return count;
+}
+
+ShmLogReader::ReadResult ShmLogReader::readOne(std::string& out, Clock::time_point now)
+{
+    const ShmRingSlot* slot = ShmRing::slotAt(mBase, *mHeader, mNext);
+    uint64_t expected = ShmRing::committedStamp(mNext);
+    uint64_t stamp = slot->stamp.load(std::memory_order_acquire);
+
+    if (stamp == expected) {
+        size_t len = slot->length;
+        uint32_t flags = slot->flags;
+        size_t capacity = ShmRing::slotCapacity(mHeader->slotSize);
+        if (len > capacity) {
+            len = capacity;
+        }
+
+        size_t start = out.size();
+        out.append(slot->data(), len);
+
+        // a producer that lapped us may have rewritten the slot while
+        // we copied it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->stamp.load(std::memory_order_relaxed) != expected) {
+            out.resize(start);
+            return skipOverwritten();
+        }
+
+        if (flags & SHM_SLOT_TRUNCATED) {
+            ++mTruncated;
+        }
+        ++mNext;
+        mStallSeq = NO_STALL;
+        return ReadResult::MESSAGE;
+    }
+
+    if (stamp > expected) {
+        return skipOverwritten();
+    }
+
+    // the slot still holds an older message or is being written
+    if (mHeader->head.load(std::memory_order_acquire) <= mNext) {
+        return ReadResult::NONE;
+    }
+
+    // claimed but not finished; give the producer a little while
+    // before deciding it died part way through
+    if (mStallSeq != mNext) {
+        mStallSeq = mNext;
+        mStallStart = now;
+        return ReadResult::NONE;
+    }
+    if (now - mStallStart < mStallTimeout) {
+        return ReadResult::NONE;
+    }
+
+    ++mLost;
+    ++mNext;
+    mStallSeq = NO_STALL;
+    return ReadResult::SKIPPED;
+}
+
+ShmLogReader::ReadResult ShmLogReader::skipOverwritten()
+{
+    uint64_t head = mHeader->head.load(std::memory_order_acquire);
+    uint64_t oldest = (head > mHeader->slotCount) ? head - mHeader->slotCount : 0;
+    uint64_t next = (oldest > mNext + 1) ? oldest : mNext + 1;
+
+    mLost += next - mNext;
+    mNext = next;
+    mStallSeq = NO_STALL;
+    return ReadResult::SKIPPED;
+}
+
+bool ShmLogReader::attach()
+{
+    int fd = shm_open(mName.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < ShmRing::HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = st.st_size;
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    // a segment that is still being set up is tried again next poll
+    ShmRingHeader* header = static_cast<ShmRingHeader*>(base);
+    bool valid = header->magic.load(std::memory_order_acquire) == SHM_RING_MAGIC &&
+        header->version == SHM_RING_VERSION &&
+        header->slotCount > 0 &&
+        (header->slotCount & (header->slotCount - 1)) == 0 &&
+        header->slotSize > sizeof(ShmRingSlot) &&
+        ShmRing::segmentSize(header->slotCount, header->slotSize) == size;
+    if (!valid) {
+        munmap(base, size);
+        return false;
+    }
+
+    mBase = base;
+    mSize = size;
+    mHeader = header;
+    mDevice = st.st_dev;
+    mInode = st.st_ino;
+    ++mAttachCount;
+
+    // resume from where the last reader stopped, less anything that
+    // has since been overwritten
+    uint64_t head = mHeader->head.load(std::memory_order_acquire);
+    mNext = mHeader->readPos.load(std::memory_order_acquire);
+    if (mNext > head) {
+        mNext = head;
+    }
+    if (head - mNext > mHeader->slotCount) {
+        mLost += head - mNext - mHeader->slotCount;
+        mNext = head - mHeader->slotCount;
+    }
+    mStallSeq = NO_STALL;
+    return true;
+}
+
+void ShmLogReader::detach()
+{
+    if (mBase != nullptr) {
+        munmap(mBase, mSize);
+        mBase = nullptr;
+        mHeader = nullptr;
+        mSize = 0;
+    }
+}
+
+bool ShmLogReader::segmentReplaced() const
+{
+    int fd = shm_open(mName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        // removed without a replacement; keep the one we have
+        return false;
+    }
+
+    struct stat st;
+    bool replaced = fstat(fd, &st) == 0 && (st.st_dev != mDevice || st.st_ino != mInode);
+    close(fd);
+    return replaced;
+}
+
+}
@@ -0,0 +1,264 @@
+#include "dkm/util/log/shm_log_writer.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+#include "dkm/util/log/pattern_layout.h"
+
+namespace dkm
+{
+
+// how long to wait for another producer to finish creating a ring
+static const int INITIALIZE_WAIT_MS = 1000;
+
+static uint32_t roundUpPowerOfTwo(size_t value)
+{
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static uint32_t roundUpSlotSize(size_t value)
+{
+    size_t minimum = sizeof(ShmRingSlot) + 1;
+    size_t size = (value < minimum) ? minimum : value;
+    return static_cast<uint32_t>((size + 63) & ~static_cast<size_t>(63));
+}
+
+ShmLogWriterConfig::ShmLogWriterConfig(const std::string& ringName) :
+    name(ringName),
+    slotCount(16384),
+    slotSize(512)
+{
+}
+
+ShmLogWriter::ShmLogWriter(const ShmLogWriterConfig& config) :
+    LogWriter(),
+    mConfig(config),
+    mLayout(config.layout ? config.layout : std::make_shared<PatternLayout>()),
+    mSlotCount(roundUpPowerOfTwo(config.slotCount)),
+    mSlotSize(roundUpSlotSize(config.slotSize)),
+    mBase(nullptr),
+    mSize(ShmRing::segmentSize(mSlotCount, mSlotSize)),
+    mHeader(nullptr),
+    mOverruns(0),
+    mTruncated(0),
+    mLost(0)
+{
+    // another producer may be creating the ring right now, so one
+    // without its magic yet is given a while to finish before it is
+    // taken to be abandoned and replaced
+    ino_t waitingFor = 0;
+    int waited = 0;
+    while (true) {
+        ino_t inode = 0;
+        AttachResult result = attachExisting(inode);
+        if (result == AttachResult::ATTACHED) {
+            break;
+        }
+        if (result == AttachResult::INITIALIZING) {
+            if (inode != waitingFor) {
+                waitingFor = inode;
+                waited = 0;
+            }
+            if (waited < INITIALIZE_WAIT_MS) {
+                usleep(1000);
+                ++waited;
+                continue;
+            }
+        }
+        if (createSegment(result != AttachResult::MISSING, inode)) {
+            break;
+        }
+    }
+}
+
+ShmLogWriter::~ShmLogWriter()
+{
+    munmap(mBase, mSize);
+}
+
+void ShmLogWriter::write(const LogMessage& message)
+{
+    // formatted into a per-thread buffer that keeps its capacity
+    static thread_local std::string line;
+    line.clear();
+    mLayout->format(message, line);
+
+    uint64_t seq = mHeader->head.fetch_add(1, std::memory_order_relaxed);
+    ShmRingSlot* slot = ShmRing::slotAt(mBase, *mHeader, seq);
+
+    if (seq >= mHeader->readPos.load(std::memory_order_relaxed) + mSlotCount) {
+        mHeader->overruns.fetch_add(1, std::memory_order_relaxed);
+        mOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t capacity = ShmRing::slotCapacity(mSlotSize);
+    size_t len = line.size();
+    uint32_t flags = 0;
+    if (len > capacity) {
+        len = capacity;
+        flags |= SHM_SLOT_TRUNCATED;
+        mTruncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // the reader re-checks the stamp after copying, so it throws away
+    // anything it read while the slot was being rewritten; a writer a
+    // whole lap ahead may already have the slot, in which case it wins
+    uint64_t writing = ShmRing::writingStamp(seq);
+    uint64_t stamp = slot->stamp.load(std::memory_order_relaxed);
+    do {
+        if (stamp > writing) {
+            mLost.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!slot->stamp.compare_exchange_weak(stamp, writing, std::memory_order_relaxed,
+                                                std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(slot->data(), line.data(), len);
+    slot->length = static_cast<uint32_t>(len);
+    slot->flags = flags;
+
+    stamp = writing;
+    if (!slot->stamp.compare_exchange_strong(stamp, ShmRing::committedStamp(seq),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        // the writer that lapped us took the slot while we were copying,
+        // so ours is lost. If it has committed already our copy may have
+        // torn its message, so put its stamp back to writing; the reader
+        // then gives up on that message instead of reading it torn.
+        mLost.fetch_add(1, std::memory_order_relaxed);
+        if ((stamp & 1) == 0) {
+            slot->stamp.compare_exchange_strong(stamp, stamp - 1, std::memory_order_relaxed,
+                                                std::memory_order_relaxed);
+        }
+    }
+}
+
+std::string ShmLogWriter::getName() const
+{
+    return "shm:" + mConfig.name;
+}
+
+bool ShmLogWriter::unlink(const std::string& name)
+{
+    return shm_unlink(name.c_str()) == 0;
+}
+
+ShmLogWriter::AttachResult ShmLogWriter::attachExisting(ino_t& inode)
+{
+    int fd = shm_open(mConfig.name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return AttachResult::MISSING;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return AttachResult::MISSING;
+    }
+    inode = st.st_ino;
+
+    // the creator sizes the segment before it writes the header
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size < ShmRing::HEADER_SIZE) {
+        close(fd);
+        return AttachResult::INITIALIZING;
+    }
+
+    // only the header is needed to find out a ring is incompatible
+    size = (size == mSize) ? mSize : ShmRing::HEADER_SIZE;
+    void* base = map(fd, size);
+    ShmRingHeader* header = static_cast<ShmRingHeader*>(base);
+
+    if (header->magic.load(std::memory_order_acquire) != SHM_RING_MAGIC) {
+        munmap(base, size);
+        return AttachResult::INITIALIZING;
+    }
+    if (size != mSize ||
+            header->version != SHM_RING_VERSION ||
+            header->slotCount != mSlotCount ||
+            header->slotSize != mSlotSize) {
+        munmap(base, size);
+        return AttachResult::INCOMPATIBLE;
+    }
+
+    mBase = base;
+    mHeader = header;
+    return AttachResult::ATTACHED;
+}
+
+bool ShmLogWriter::createSegment(bool replace, ino_t inode)
+{
+    if (replace) {
+        // a reader attached to the old segment notices it has been
+        // replaced and moves over to the new one. Only the segment we
+        // looked at is unlinked; if another producer has replaced it
+        // since, we attach to theirs instead.
+        int fd = shm_open(mConfig.name.c_str(), O_RDWR, 0);
+        if (fd >= 0) {
+            struct stat st;
+            bool same = fstat(fd, &st) == 0 && st.st_ino == inode;
+            close(fd);
+            if (!same) {
+                return false;
+            }
+            shm_unlink(mConfig.name.c_str());
+        }
+    }
+
+    int fd = shm_open(mConfig.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            return false;
+        }
+        throw std::system_error(errno, std::system_category(),
+                                "unable to create shared memory ring " + mConfig.name);
+    }
+
+    if (ftruncate(fd, mSize) != 0) {
+        int err = errno;
+        close(fd);
+        shm_unlink(mConfig.name.c_str());
+        throw std::system_error(err, std::system_category(),
+                                "unable to size shared memory ring " + mConfig.name);
+    }
+
+    mBase = map(fd, mSize);
+    mHeader = static_cast<ShmRingHeader*>(mBase);
+
+    // the new segment is zero filled, so every slot stamp already
+    // reads as never written
+    mHeader->version = SHM_RING_VERSION;
+    mHeader->slotCount = mSlotCount;
+    mHeader->slotSize = mSlotSize;
+    mHeader->head.store(0, std::memory_order_relaxed);
+    mHeader->readPos.store(0, std::memory_order_relaxed);
+    mHeader->overruns.store(0, std::memory_order_relaxed);
+    mHeader->magic.store(SHM_RING_MAGIC, std::memory_order_release);
+    return true;
+}
+
+void* ShmLogWriter::map(int fd, size_t size)
+{
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    int err = errno;
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        throw std::system_error(err, std::system_category(),
+                                "unable to map shared memory ring " + mConfig.name);
+    }
+    return base;
+}
+
+}
@@ -0,0 +1,263 @@
+#include "dkm/util/log/trace.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace dkm
+{
+
+static std::atomic<uint64_t> nextTracerId(1);
+
+// shortest interval used to work out the TSC frequency
+static const uint64_t MIN_CALIBRATION_NS = 10 * 1000 * 1000;
+
+// Returns true if the CPU has a TSC that ticks at a constant rate
+// regardless of frequency scaling and sleep states.
+static bool tscUsable()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 5, "flags") == 0) {
+            return line.find(" constant_tsc") != std::string::npos &&
+                line.find(" nonstop_tsc") != std::string::npos;
+        }
+    }
+#endif
+    return false;
+}
+
+static TraceClock resolveClock(TraceClock requested)
+{
+    if (requested == TraceClock::TSC) {
+        static const bool usable = tscUsable();
+        return usable ? TraceClock::TSC : TraceClock::MONOTONIC;
+    }
+    return requested;
+}
+
+// Writes value as a JSON string, with quotes.
+static void writeJsonString(std::ostream& out, const char* value)
+{
+    out << '"';
+    for (const char* p = value; *p != '\0'; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *p;
+        }
+        else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out << buf;
+        }
+        else {
+            out << *p;
+        }
+    }
+    out << '"';
+}
+
+const size_t TraceBuffer::BLOCK_EVENTS;
+
+TraceBuffer::TraceBuffer(unsigned long threadId, size_t maxEvents) :
+    NonCopyable(),
+    mThreadId(threadId),
+    mMaxBlocks(std::max<size_t>(1, (maxEvents + BLOCK_EVENTS - 1) / BLOCK_EVENTS)),
+    mHead(new Block()),
+    mTail(mHead),
+    mBlocks(1),
+    mDropped(0)
+{
+}
+
+TraceBuffer::~TraceBuffer()
+{
+    Block* block = mHead;
+    while (block != nullptr) {
+        Block* next = block->next.load(std::memory_order_relaxed);
+        delete block;
+        block = next;
+    }
+}
+
+void TraceBuffer::copyEvents(std::vector<TraceEvent>& out) const
+{
+    const Block* block = mHead;
+    while (block != nullptr) {
+        size_t count = block->count.load(std::memory_order_acquire);
+        out.insert(out.end(), block->events, block->events + count);
+        block = block->next.load(std::memory_order_acquire);
+    }
+}
+
+bool TraceBuffer::grow()
+{
+    if (mBlocks >= mMaxBlocks) {
+        return false;
+    }
+
+    Block* block = new Block();
+    mTail->next.store(block, std::memory_order_release);
+    mTail = block;
+    ++mBlocks;
+    return true;
+}
+
+Tracer& Tracer::getInstance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::Tracer(TraceClock clock, size_t maxEventsPerThread) :
+    NonCopyable(),
+    mId(nextTracerId.fetch_add(1)),
+    mClock(resolveClock(clock)),
+    mMaxEventsPerThread(maxEventsPerThread),
+    mEnabled(false),
+    mGeneration(0),
+    mStartTicks(now()),
+    mStartNs(readMonotonic())
+{
+}
+
+Tracer::~Tracer()
+{
+}
+
+size_t Tracer::getEventCount() const
+{
+    std::vector<TraceEvent> events;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::map<unsigned long, std::unique_ptr<TraceBuffer> >::const_iterator it;
+    for (it = mBuffers.begin(); it != mBuffers.end(); ++it) {
+        it->second->copyEvents(events);
+    }
+    return events.size();
+}
+
+uint64_t Tracer::getDropped() const
+{
+    uint64_t dropped = 0;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::map<unsigned long, std::unique_ptr<TraceBuffer> >::const_iterator it;
+    for (it = mBuffers.begin(); it != mBuffers.end(); ++it) {
+        dropped += it->second->getDropped();
+    }
+    return dropped;
+}
+
+void Tracer::exportChromeJson(std::ostream& out) const
+{
+    double scale = nsPerTick() / 1000.0;
+    unsigned long pid = static_cast<unsigned long>(getpid());
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    out << "{\"traceEvents\":[";
+
+    bool first = true;
+    char buf[128];
+    std::vector<TraceEvent> events;
+
+    std::map<unsigned long, std::unique_ptr<TraceBuffer> >::const_iterator it;
+    for (it = mBuffers.begin(); it != mBuffers.end(); ++it) {
+        events.clear();
+        it->second->copyEvents(events);
+
+        for (size_t i = 0; i < events.size(); ++i) {
+            const TraceEvent& event = events[i];
+
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":";
+            writeJsonString(out, event.category);
+
+            double ts = static_cast<double>(event.start - mStartTicks) * scale;
+            if (event.phase == 'X') {
+                snprintf(buf, sizeof(buf), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                         ts, static_cast<double>(event.duration) * scale);
+            }
+            else {
+                snprintf(buf, sizeof(buf), ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", ts);
+            }
+            out << buf << ",\"pid\":" << pid << ",\"tid\":" << it->first << '}';
+
+            first = false;
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+bool Tracer::writeChromeJson(const std::string& path) const
+{
+    std::ofstream out(path.c_str(), std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    exportChromeJson(out);
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mBuffers.clear();
+    mGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+TraceBuffer& Tracer::cacheMiss(ThreadCache& cache, uint64_t generation)
+{
+    ThreadCacheEntry& entry = cache.entries[cache.next];
+    cache.next = (cache.next + 1) % THREAD_CACHE_SIZE;
+
+    entry.buffer = &lookup();
+    entry.generation = generation;
+    entry.ownerId = mId;
+    return *entry.buffer;
+}
+
+TraceBuffer& Tracer::lookup()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    unsigned long threadId = logThreadId();
+
+    std::unique_ptr<TraceBuffer>& buffer = mBuffers[threadId];
+    if (!buffer) {
+        buffer.reset(new TraceBuffer(threadId, mMaxEventsPerThread));
+    }
+    return *buffer;
+}
+
+double Tracer::nsPerTick() const
+{
+    if (mClock == TraceClock::MONOTONIC) {
+        return 1.0;
+    }
+
+    // compare the TSC with CLOCK_MONOTONIC over the life of the tracer,
+    // waiting first if that has been too short for a stable figure
+    uint64_t elapsedNs = readMonotonic() - mStartNs;
+    if (elapsedNs < MIN_CALIBRATION_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(MIN_CALIBRATION_NS - elapsedNs));
+    }
+
+    uint64_t ticks = readTsc();
+    uint64_t ns = readMonotonic();
+    return static_cast<double>(ns - mStartNs) / static_cast<double>(ticks - mStartTicks);
+}
+
+}
@@ -0,0 +1,201 @@
+#include "dkm/util/lz_codec.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace dkm
+{
+
+namespace LzCodec
+{
+
+static const size_t MIN_MATCH = 4;
+static const size_t MAX_OFFSET = 65535;
+static const int HASH_BITS = 13;
+static const size_t HASH_SIZE = 1 << HASH_BITS;
+
+// no match may start this close to the end, so the match search can
+// always read four bytes
+static const size_t END_LITERALS = 5;
+
+static uint32_t read32(const char* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t hash(uint32_t value)
+{
+    return (value * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static char* writeLength(char* out, size_t length)
+{
+    while (length >= 255) {
+        *out++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *out++ = static_cast<char>(length);
+    return out;
+}
+
+static char* writeSequence(char* out, const char* literals, size_t literalCount,
+                           size_t offset, size_t matchLength)
+{
+    char* token = out++;
+
+    size_t literalNibble = literalCount < 15 ? literalCount : 15;
+    if (literalCount >= 15) {
+        out = writeLength(out, literalCount - 15);
+    }
+    memcpy(out, literals, literalCount);
+    out += literalCount;
+
+    size_t matchNibble = 0;
+    if (matchLength > 0) {
+        size_t extra = matchLength - MIN_MATCH;
+        matchNibble = extra < 15 ? extra : 15;
+
+        *out++ = static_cast<char>(offset & 0xff);
+        *out++ = static_cast<char>(offset >> 8);
+        if (extra >= 15) {
+            out = writeLength(out, extra - 15);
+        }
+    }
+
+    *token = static_cast<char>((literalNibble << 4) | matchNibble);
+    return out;
+}
+
+size_t compress(const char* in, size_t length, char* out)
+{
+    char* start = out;
+
+    // positions are stored relative to in, plus one so zero means empty
+    uint32_t table[HASH_SIZE];
+    memset(table, 0, sizeof(table));
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    size_t misses = 0;
+
+    if (length > END_LITERALS + MIN_MATCH) {
+        size_t limit = length - END_LITERALS;
+
+        while (pos < limit) {
+            uint32_t value = read32(in + pos);
+            uint32_t h = hash(value);
+            size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(pos + 1);
+
+            if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET ||
+                    read32(in + candidate - 1) != value) {
+                // skip ahead faster through data that isn't matching
+                pos += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            size_t match = candidate - 1;
+            size_t matchLength = MIN_MATCH;
+            while (pos + matchLength < limit && in[match + matchLength] == in[pos + matchLength]) {
+                ++matchLength;
+            }
+
+            // extend backwards over literals that also match
+            while (pos > anchor && match > 0 && in[pos - 1] == in[match - 1]) {
+                --pos;
+                --match;
+                ++matchLength;
+            }
+
+            out = writeSequence(out, in + anchor, pos - anchor, pos - match, matchLength);
+
+            pos += matchLength;
+            anchor = pos;
+            if (pos < limit) {
+                table[hash(read32(in + pos - 2))] = static_cast<uint32_t>(pos - 2 + 1);
+            }
+        }
+    }
+
+    out = writeSequence(out, in + anchor, length - anchor, 0, 0);
+    return out - start;
+}
+
+// Reads an extended length. Returns false if the input runs out.
+static bool readLength(const unsigned char*& in, const unsigned char* end, size_t& length)
+{
+    unsigned char c;
+    do {
+        if (in >= end) {
+            return false;
+        }
+        c = *in++;
+        length += c;
+    } while (c == 255);
+    return true;
+}
+
+bool decompress(const char* input, size_t length, char* out, size_t outLength)
+{
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(input);
+    const unsigned char* end = in + length;
+    size_t pos = 0;
+
+    while (in < end) {
+        unsigned char token = *in++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(in, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(end - in) || literalCount > outLength - pos) {
+            return false;
+        }
+        memcpy(out + pos, in, literalCount);
+        in += literalCount;
+        pos += literalCount;
+
+        if (in == end) {
+            // the last sequence has no match
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+
+        size_t matchLength = (token & 0xf);
+        if (matchLength == 15 && !readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > pos || matchLength > outLength - pos) {
+            return false;
+        }
+
+        char* dest = out + pos;
+        const char* src = dest - offset;
+        if (offset >= matchLength) {
+            memcpy(dest, src, matchLength);
+        }
+        else {
+            // overlapping copy repeats the last offset bytes
+            for (size_t i = 0; i < matchLength; ++i) {
+                dest[i] = src[i];
+            }
+        }
+        pos += matchLength;
+    }
+
+    return pos == outLength;
+}
+
+} // end namespace LzCodec
+
+}
@@ -0,0 +1,129 @@
+#include "dkm/util/perf_counters.h"
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace dkm
+{
+
+static const uint64_t EVENT_CONFIGS[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static const char* EVENT_NAMES[] = {
+    "cycles",
+    "instructions",
+    "cache-misses",
+    "branch-misses"
+};
+
+// layout of read() with the read_format used below
+struct CounterReading
+{
+    uint64_t value;
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+};
+
+static int openEvent(uint64_t config, int groupFd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled = (groupFd < 0) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+const char* perfEventName(PerfEvent event)
+{
+    int idx = static_cast<int>(event);
+    if (idx < 0 || idx >= static_cast<int>(PerfEvent::COUNT)) {
+        return "unknown";
+    }
+    return EVENT_NAMES[idx];
+}
+
+PerfCounters::PerfCounters() :
+    NonCopyable(),
+    mLeader(-1)
+{
+    // the first event that opens leads the group so the rest are
+    // scheduled on and off the PMU with it
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        mFds[i] = openEvent(EVENT_CONFIGS[i], mLeader);
+        if (mFds[i] >= 0 && mLeader < 0) {
+            mLeader = mFds[i];
+        }
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    // close the followers before the leader
+    for (int i = EVENT_COUNT - 1; i >= 0; --i) {
+        if (mFds[i] >= 0) {
+            close(mFds[i]);
+        }
+    }
+}
+
+bool PerfCounters::isAvailable(PerfEvent event) const
+{
+    int idx = static_cast<int>(event);
+    return idx >= 0 && idx < EVENT_COUNT && mFds[idx] >= 0;
+}
+
+void PerfCounters::start()
+{
+    if (mLeader >= 0) {
+        ioctl(mLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounters::stop()
+{
+    if (mLeader >= 0) {
+        ioctl(mLeader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounters::reset()
+{
+    if (mLeader >= 0) {
+        ioctl(mLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+uint64_t PerfCounters::value(PerfEvent event) const
+{
+    if (!isAvailable(event)) {
+        return 0;
+    }
+
+    CounterReading reading;
+    if (read(mFds[static_cast<int>(event)], &reading, sizeof(reading)) !=
+            static_cast<ssize_t>(sizeof(reading))) {
+        return 0;
+    }
+
+    // scale up if the group only had the PMU for part of the time
+    if (reading.timeRunning > 0 && reading.timeRunning < reading.timeEnabled) {
+        return static_cast<uint64_t>(static_cast<double>(reading.value) *
+                                     reading.timeEnabled / reading.timeRunning);
+    }
+    return reading.value;
+}
+
+}
@@ -0,0 +1,273 @@
+/**
+ * affine_transform_test.cpp
+ *
+ * Unit tests for AffineTransform and the AffineTransformUtil functions.
+ */
+
+#include "dkm/math/affine_transform_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/math/affine_transform.h"
+#include "dkm/math/math_test_helpers.h"
+
+// add some macros for degree to radian conversion
+#define PI 3.14159265
+#define DEG_TO_RAD( x ) ( x * ( PI / 180 ))
+
+using namespace dkm;
+
+// common inputs and outputs for testing
+// 90 degrees around z, then translate by (1, 2, 3)
+const double rigid3x4d[] = { 0, -1, 0, 1,
+                             1,  0, 0, 2,
+                             0,  0, 1, 3 };
+const double rigidInverse3x4d[] = {  0, 1, 0, -2,
+                                    -1, 0, 0,  1,
+                                     0, 0, 1, -3 };
+// shear and non-uniform scale, then translate by (-1, 0, 4)
+const double affine3x4d[] = { 2, 1, 0, -1,
+                              0, 3, 1,  0,
+                              1, 0, 4,  4 };
+
+// double comparison accuracy
+const double DoubleComparisonAccuracy = 0.0001;
+
+TEST_F(AffineTransformTest, defaultConstructorAndIdentity){
+    // arrange
+    const double expected[] = { 1, 0, 0, 0,
+                                0, 1, 0, 0,
+                                0, 0, 1, 0 };
+
+    // act
+    AffineTransformd zero;
+    AffineTransformd identity = AffineTransformd::identity();
+
+    // assert
+    for (int i=0; i<12; ++i) {
+        ASSERT_EQ(0, zero.data()[i]);
+    }
+    ASSERT_ARRAY_EQ(expected, identity.data(), 12);
+}
+
+TEST_F(AffineTransformTest, elementAccess){
+    // arrange
+    AffineTransformd t(rigid3x4d);
+
+    // act
+    t(1, 3) = 5;
+    Matrix<3, 3> linear = t.linear();
+    Vector<3> translation = t.translation();
+
+    // assert
+    ASSERT_EQ(-1, t(0, 1));
+    ASSERT_EQ(-1, linear(0, 1));
+    ASSERT_EQ(1, linear(1, 0));
+    ASSERT_EQ(1, translation.x());
+    ASSERT_EQ(5, translation.y());
+    ASSERT_EQ(3, translation.z());
+    ASSERT_EQ(5, t.matrix()(1, 3));
+}
+
+TEST_F(AffineTransformTest, transformPointAndDirection){
+    // arrange
+    AffineTransformd t(rigid3x4d);
+    Vector<3> v(1, 0, 0);
+
+    // act
+    Vector<3> point = t.transformPoint(v);
+    Vector<3> direction = t.transformDirection(v);
+
+    // assert
+    ASSERT_EQ(1, point.x());
+    ASSERT_EQ(3, point.y());
+    ASSERT_EQ(3, point.z());
+    ASSERT_EQ(0, direction.x());
+    ASSERT_EQ(1, direction.y());
+    ASSERT_EQ(0, direction.z());
+}
+
+TEST_F(AffineTransformTest, composeMatchesMatrixProduct){
+    // arrange
+    AffineTransformd a(rigid3x4d);
+    AffineTransformd b(affine3x4d);
+
+    // act
+    AffineTransformd ab = a * b;
+    Matrix<4, 4> expected = a.toMatrix4x4() * b.toMatrix4x4();
+
+    // assert
+    ASSERT_ARRAY_NEAR(expected.data(), ab.data(), 12, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, composeAppliesRightOperandFirst){
+    // arrange
+    AffineTransformd a(rigid3x4d);
+    AffineTransformd b(affine3x4d);
+    Vector<3> p(1, -2, 0.5);
+
+    // act
+    Vector<3> composed = (a * b).transformPoint(p);
+    Vector<3> sequential = a.transformPoint(b.transformPoint(p));
+
+    // assert
+    ASSERT_ARRAY_NEAR(sequential.data(), composed.data(), 3, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, multiplyAssign){
+    // arrange
+    AffineTransformd a(rigid3x4d);
+    AffineTransformd b(affine3x4d);
+    AffineTransformd expected = a * b;
+    AffineTransformd square = a * a;
+
+    // act
+    a *= b;
+    b = AffineTransformd(rigid3x4d);
+    b *= b;
+
+    // assert
+    ASSERT_ARRAY_NEAR(expected.data(), a.data(), 12, DoubleComparisonAccuracy);
+    ASSERT_ARRAY_NEAR(square.data(), b.data(), 12, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, rigidInverse){
+    // arrange
+    AffineTransformd t(rigid3x4d);
+
+    // act
+    AffineTransformd inv = t.rigidInverse();
+    AffineTransformd product = t * inv;
+
+    // assert
+    AffineTransformd identity = AffineTransformd::identity();
+    ASSERT_ARRAY_NEAR(rigidInverse3x4d, inv.data(), 12, DoubleComparisonAccuracy);
+    ASSERT_ARRAY_NEAR(identity.data(), product.data(), 12, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, inverse){
+    // arrange
+    AffineTransformd t(affine3x4d);
+    AffineTransformd rigid(rigid3x4d);
+
+    // act
+    AffineTransformd inv = t.inverse();
+    AffineTransformd left = inv * t;
+    AffineTransformd right = t * inv;
+
+    // assert
+    AffineTransformd identity = AffineTransformd::identity();
+    ASSERT_ARRAY_NEAR(identity.data(), left.data(), 12, DoubleComparisonAccuracy);
+    ASSERT_ARRAY_NEAR(identity.data(), right.data(), 12, DoubleComparisonAccuracy);
+    ASSERT_ARRAY_NEAR(rigidInverse3x4d, rigid.inverse().data(), 12, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, inverseInPlace){
+    // arrange
+    double elements[12];
+    MatrixUtil::copy(affine3x4d, elements, 12);
+    AffineTransformd expected = AffineTransformd(affine3x4d).inverse();
+
+    // act
+    int written = AffineTransformUtil::inverse(elements, elements);
+
+    // assert
+    ASSERT_EQ(12, written);
+    ASSERT_ARRAY_NEAR(expected.data(), elements, 12, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, matrix4x4RoundTrip){
+    // arrange
+    AffineTransformd t(affine3x4d);
+
+    // act
+    Matrix<4, 4> mat = t.toMatrix4x4();
+    Matrix<4, 4, double, MatrixLayout::COLUMN_MAJOR> columnMajor(mat);
+    AffineTransformd fromRowMajor(mat);
+    AffineTransformd fromColumnMajor(columnMajor);
+
+    // assert
+    const double bottom[] = { 0, 0, 0, 1 };
+    ASSERT_ARRAY_EQ(affine3x4d, mat.data(), 12);
+    ASSERT_ARRAY_EQ(bottom, mat[3], 4);
+    ASSERT_ARRAY_EQ(affine3x4d, fromRowMajor.data(), 12);
+    ASSERT_ARRAY_EQ(affine3x4d, fromColumnMajor.data(), 12);
+}
+
+TEST_F(AffineTransformTest, quaternionRoundTrip){
+    // arrange
+    Quaternion<double> rotation(Vector<3>(1, 1, 0), DEG_TO_RAD(60));
+    Vector<3> translation(4, 5, 6);
+
+    // act
+    AffineTransformd t(rotation, translation);
+    Quaternion<double> q = t.rotation();
+    Matrix<4, 4> mat = rotation.toRotationMatrix4x4();
+
+    // assert
+    ASSERT_ARRAY_NEAR(rotation.data(), q.data(), 4, DoubleComparisonAccuracy);
+    ASSERT_ARRAY_NEAR(translation.data(), t.translation().data(), 3, DoubleComparisonAccuracy);
+    for (int r=0; r<3; ++r) {
+        for (int c=0; c<3; ++c) {
+            ASSERT_NEAR(mat(r, c), t(r, c), DoubleComparisonAccuracy);
+        }
+    }
+}
+
+TEST_F(AffineTransformTest, linearAndTranslationConstructor){
+    // arrange
+    Matrix<3, 3> linear = AffineTransformd(affine3x4d).linear();
+    Vector<3> translation(-1, 0, 4);
+
+    // act
+    AffineTransformd t(linear, translation);
+
+    // assert
+    ASSERT_ARRAY_EQ(affine3x4d, t.data(), 12);
+}
+
+TEST_F(AffineTransformTest, transformPointArrays){
+    // arrange
+    const float affine3x4f[] = { 2, 1, 0, -1,
+                                 0, 3, 1,  0,
+                                 1, 0, 4,  4 };
+    AffineTransformf t(affine3x4f);
+    float points[] = { 1, 0, 0,
+                       0, 1, 0,
+                       1, 2, 3 };
+    float dirs[9];
+    MatrixUtil::copy(points, dirs, 9);
+
+    // act
+    int written = AffineTransformUtil::transformPoints(t.data(), points, points, 3);
+    AffineTransformUtil::transformDirections(t.data(), dirs, dirs, 3);
+
+    // assert
+    const float expectedPoints[] = { 1, 0, 5,
+                                     0, 3, 4,
+                                     3, 9, 17 };
+    const float expectedDirs[] = { 2, 0, 1,
+                                   1, 3, 0,
+                                   4, 9, 13 };
+    ASSERT_EQ(9, written);
+    ASSERT_ARRAY_NEAR(expectedPoints, points, 9, DoubleComparisonAccuracy);
+    ASSERT_ARRAY_NEAR(expectedDirs, dirs, 9, DoubleComparisonAccuracy);
+}
+
+TEST_F(AffineTransformTest, transformVectorArrays){
+    // arrange
+    AffineTransformd t(rigid3x4d);
+    Vector<3> vecs[] = { Vector<3>(1, 0, 0), Vector<3>(0, 1, 0) };
+    Vector<3> points[2];
+    Vector<3> dirs[2];
+
+    // act
+    t.transformPoints(vecs, points, 2);
+    t.transformDirections(vecs, dirs, 2);
+
+    // assert
+    const double expectedPoint1[] = { 0, 2, 3 };
+    const double expectedDir0[] = { 0, 1, 0 };
+    ASSERT_ARRAY_EQ(expectedPoint1, points[1].data(), 3);
+    ASSERT_ARRAY_EQ(expectedDir0, dirs[0].data(), 3);
+}
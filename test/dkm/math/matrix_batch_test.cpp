@@ -0,0 +1,319 @@
+/**
+ * matrix_batch_test.cpp
+ *
+ * Unit tests for MatrixBatch and the MatrixBatchUtil kernels.
+ */
+
+#include "dkm/math/matrix_batch_test.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dkm/math/matrix_batch.h"
+#include "dkm/math/math_test_helpers.h"
+
+using namespace dkm;
+
+// double comparison accuracy
+const double DoubleComparisonAccuracy = 0.0001;
+
+// Returns count matrices filled from a fixed sequence. The diagonal is
+// weighted so that every square matrix is well conditioned.
+template<unsigned int RowsArg, unsigned int ColsArg, typename T>
+std::vector<Matrix<RowsArg, ColsArg, T> > testMatrices(size_t count, int seed = 1) {
+    std::vector<Matrix<RowsArg, ColsArg, T> > result(count);
+    int state = seed;
+    for (size_t k=0; k<count; ++k) {
+        for (int i=0; i<RowsArg; ++i) {
+            for (int j=0; j<ColsArg; ++j) {
+                state = (state * 37 + 11) % 101;
+                result[k](i, j) = static_cast<T>(state - 50) / 25 + ((i == j) ? 5 : 0);
+            }
+        }
+    }
+    return result;
+}
+
+TEST_F(MatrixBatchTest, defaultConstructor){
+    // act
+    MatrixBatch<4, 4, float> batch;
+
+    // assert
+    ASSERT_EQ(0u, batch.size());
+    ASSERT_EQ(0u, batch.groups());
+    ASSERT_EQ(8u, (MatrixBatch<4, 4, float>::lanes()));
+}
+
+TEST_F(MatrixBatchTest, interleavesElements){
+    // arrange
+    std::vector<Matrix<2, 2> > matrices = testMatrices<2, 2, double>(6);
+
+    // act
+    MatrixBatch<2, 2, double, 4> batch(matrices.data(), matrices.size());
+
+    // assert
+    ASSERT_EQ(6u, batch.size());
+    ASSERT_EQ(2u, batch.groups());
+    ASSERT_EQ(matrices[0](0, 0), batch.data()[0]);
+    ASSERT_EQ(matrices[1](0, 0), batch.data()[1]);
+    ASSERT_EQ(matrices[0](0, 1), batch.data()[4]);
+    ASSERT_EQ(matrices[3](1, 1), batch.data()[15]);
+    ASSERT_EQ(matrices[5](1, 0), batch.data()[16 + 8 + 1]);
+}
+
+TEST_F(MatrixBatchTest, roundTripsMatrices){
+    // arrange
+    std::vector<Matrix<3, 4> > matrices = testMatrices<3, 4, double>(11);
+    std::vector<Matrix<3, 4> > copies(11);
+
+    // act
+    MatrixBatch<3, 4> batch(matrices.data(), matrices.size());
+    batch.copyTo(copies.data());
+
+    // assert
+    for (size_t k=0; k<matrices.size(); ++k) {
+        ASSERT_ARRAY_EQ(matrices[k].data(), copies[k].data(), 12);
+        Matrix<3, 4> single = batch.get(k);
+        ASSERT_ARRAY_EQ(matrices[k].data(), single.data(), 12);
+    }
+}
+
+TEST_F(MatrixBatchTest, convertsColumnMajorMatrices){
+    // arrange
+    std::vector<Matrix<2, 3> > matrices = testMatrices<2, 3, double>(3);
+    std::vector<Matrix<2, 3, double, MatrixLayout::COLUMN_MAJOR> > colMajor(matrices.begin(), matrices.end());
+    std::vector<Matrix<2, 3, double, MatrixLayout::COLUMN_MAJOR> > copies(3);
+
+    // act
+    MatrixBatch<2, 3> batch(colMajor.data(), colMajor.size());
+    batch.copyTo(copies.data());
+
+    // assert
+    for (size_t k=0; k<matrices.size(); ++k) {
+        Matrix<2, 3> single = batch.get(k);
+        ASSERT_ARRAY_EQ(matrices[k].data(), single.data(), 6);
+        ASSERT_ARRAY_EQ(colMajor[k].data(), copies[k].data(), 6);
+    }
+}
+
+TEST_F(MatrixBatchTest, elementAccessAndSet){
+    // arrange
+    MatrixBatch<2, 2, int> batch(10);
+    const int elements[] = { 1, 2, 3, 4 };
+
+    // act
+    batch.set(9, Matrix<2, 2, int>(elements));
+    batch(3, 1, 0) = 7;
+
+    // assert
+    ASSERT_EQ(3, batch(9, 1, 0));
+    ASSERT_EQ(7, batch.get(3)(1, 0));
+    ASSERT_EQ(0, batch(3, 0, 0));
+}
+
+TEST_F(MatrixBatchTest, resizeKeepsMatrices){
+    // arrange
+    std::vector<Matrix<2, 2> > matrices = testMatrices<2, 2, double>(5);
+    MatrixBatch<2, 2> batch(matrices.data(), matrices.size());
+
+    // act
+    batch.resize(20);
+
+    // assert
+    ASSERT_EQ(20u, batch.size());
+    ASSERT_EQ(3u, batch.groups());
+    Matrix<2, 2> kept = batch.get(4);
+    Matrix<2, 2> added = batch.get(19);
+    ASSERT_ARRAY_EQ(matrices[4].data(), kept.data(), 4);
+    ASSERT_EQ(0, added(1, 1));
+}
+
+TEST_F(MatrixBatchTest, resizeShrinkThenGrowClearsLanes){
+    // arrange
+    std::vector<Matrix<2, 2> > matrices = testMatrices<2, 2, double>(8);
+    MatrixBatch<2, 2, double, 4> batch(matrices.data(), matrices.size());
+
+    // act
+    batch.resize(3);
+    batch.resize(6);
+
+    // assert
+    const double zero[] = { 0, 0, 0, 0 };
+    Matrix<2, 2> kept = batch.get(2);
+    ASSERT_ARRAY_EQ(matrices[2].data(), kept.data(), 4);
+    for (size_t k=3; k<6; ++k) {
+        Matrix<2, 2> added = batch.get(k);
+        ASSERT_ARRAY_EQ(zero, added.data(), 4);
+    }
+}
+
+TEST_F(MatrixBatchTest, multiply){
+    // arrange
+    std::vector<Matrix<4, 4> > a = testMatrices<4, 4, double>(13, 1);
+    std::vector<Matrix<4, 4> > b = testMatrices<4, 4, double>(13, 2);
+    MatrixBatch<4, 4> batchA(a.data(), a.size());
+    MatrixBatch<4, 4> batchB(b.data(), b.size());
+
+    // act
+    MatrixBatch<4, 4> product = batchA * batchB;
+
+    // assert
+    ASSERT_EQ(13u, product.size());
+    for (size_t k=0; k<a.size(); ++k) {
+        Matrix<4, 4> expected = a[k] * b[k];
+        Matrix<4, 4> actual = product.get(k);
+        ASSERT_ARRAY_NEAR(expected.data(), actual.data(), 16, DoubleComparisonAccuracy);
+    }
+}
+
+TEST_F(MatrixBatchTest, multiplyRectangular){
+    // arrange
+    std::vector<Matrix<2, 3, float> > a = testMatrices<2, 3, float>(5, 3);
+    std::vector<Matrix<3, 2, float> > b = testMatrices<3, 2, float>(9, 4);
+    MatrixBatch<2, 3, float, 16> batchA(a.data(), a.size());
+    MatrixBatch<3, 2, float, 16> batchB(b.data(), b.size());
+
+    // act
+    MatrixBatch<2, 2, float, 16> product = batchA.multiply(batchB);
+
+    // assert
+    ASSERT_EQ(5u, product.size());
+    for (size_t k=0; k<a.size(); ++k) {
+        Matrix<2, 2, float> expected = a[k] * b[k];
+        Matrix<2, 2, float> actual = product.get(k);
+        ASSERT_ARRAY_NEAR(expected.data(), actual.data(), 4, DoubleComparisonAccuracy);
+    }
+}
+
+TEST_F(MatrixBatchTest, multiplyAssign){
+    // arrange
+    std::vector<Matrix<3, 3> > a = testMatrices<3, 3, double>(9, 5);
+    std::vector<Matrix<3, 3> > b = testMatrices<3, 3, double>(9, 6);
+    MatrixBatch<3, 3> batch(a.data(), a.size());
+
+    // act
+    batch *= MatrixBatch<3, 3>(b.data(), b.size());
+
+    // assert
+    ASSERT_EQ(9u, batch.size());
+    for (size_t k=0; k<a.size(); ++k) {
+        Matrix<3, 3> expected = a[k] * b[k];
+        Matrix<3, 3> actual = batch.get(k);
+        ASSERT_ARRAY_NEAR(expected.data(), actual.data(), 9, DoubleComparisonAccuracy);
+    }
+}
+
+TEST_F(MatrixBatchTest, transformVectors){
+    // arrange
+    std::vector<Matrix<4, 4, float> > m = testMatrices<4, 4, float>(10, 7);
+    std::vector<Vector<4, float> > v(10);
+    for (size_t k=0; k<v.size(); ++k) {
+        v[k] = Vector<4, float>(k, 1, -2.0f * k, 1);
+    }
+    std::vector<Vector<4, float> > out(10);
+
+    // act
+    MatrixBatch<4, 4, float> batch(m.data(), m.size());
+    MatrixBatch<4, 1, float> result = batch.transformVectors(MatrixBatch<4, 1, float>(v.data(), v.size()));
+    result.copyTo(out.data());
+
+    // assert
+    ASSERT_EQ(10u, result.size());
+    for (size_t k=0; k<m.size(); ++k) {
+        Vector<4, float> expected = m[k].transformVector(v[k]);
+        ASSERT_ARRAY_NEAR(expected.data(), out[k].data(), 4, DoubleComparisonAccuracy);
+    }
+}
+
+TEST_F(MatrixBatchTest, inverse3x3){
+    // arrange
+    std::vector<Matrix<3, 3> > m = testMatrices<3, 3, double>(12, 8);
+    MatrixBatch<3, 3> batch(m.data(), m.size());
+
+    // act
+    MatrixBatch<3, 3> inv = batch.inverse();
+
+    // assert
+    Matrix<3, 3> identity = Matrix<3, 3>::identity();
+    for (size_t k=0; k<m.size(); ++k) {
+        Matrix<3, 3> product = m[k] * inv.get(k);
+        ASSERT_ARRAY_NEAR(identity.data(), product.data(), 9, DoubleComparisonAccuracy);
+    }
+}
+
+TEST_F(MatrixBatchTest, inverse4x4){
+    // arrange
+    std::vector<Matrix<4, 4, float> > m = testMatrices<4, 4, float>(21, 9);
+    MatrixBatch<4, 4, float, 16> batch(m.data(), m.size());
+
+    // act
+    MatrixBatch<4, 4, float, 16> inv = batch.inverse();
+
+    // assert
+    Matrix<4, 4, float> identity = Matrix<4, 4, float>::identity();
+    for (size_t k=0; k<m.size(); ++k) {
+        Matrix<4, 4, float> product = inv.get(k) * m[k];
+        ASSERT_ARRAY_NEAR(identity.data(), product.data(), 16, DoubleComparisonAccuracy);
+    }
+}
+
+TEST_F(MatrixBatchTest, determinant){
+    // arrange
+    const double elements3[] = { 2, 0, 1,
+                                 1, 3, 2,
+                                 1, 1, 2 };
+    const double elements4[] = { 1, 0, 2, -1,
+                                 3, 0, 0, 5,
+                                 2, 1, 4, -3,
+                                 1, 0, 5, 0 };
+    MatrixBatch<3, 3> batch3(2);
+    MatrixBatch<4, 4> batch4(3);
+    batch3.set(1, Matrix<3, 3>(elements3));
+    batch4.set(2, Matrix<4, 4>(elements4));
+
+    // act
+    MatrixBatch<1, 1> det3 = batch3.determinant();
+    MatrixBatch<1, 1> det4 = batch4.determinant();
+
+    // assert
+    ASSERT_EQ(2u, det3.size());
+    ASSERT_NEAR(0, det3(0, 0, 0), DoubleComparisonAccuracy);
+    ASSERT_NEAR(6, det3(1, 0, 0), DoubleComparisonAccuracy);
+    ASSERT_NEAR(30, det4(2, 0, 0), DoubleComparisonAccuracy);
+}
+
+TEST_F(MatrixBatchTest, inverseSingularLaneIsIsolated){
+    // arrange
+    std::vector<Matrix<3, 3> > m = testMatrices<3, 3, double>(4, 10);
+    m[1] = Matrix<3, 3>();
+    MatrixBatch<3, 3> batch(m.data(), m.size());
+
+    // act
+    MatrixBatch<3, 3> inv = batch.inverse();
+
+    // assert
+    ASSERT_FALSE(std::isfinite(inv(1, 0, 0)));
+    Matrix<3, 3> product = m[2] * inv.get(2);
+    Matrix<3, 3> identity = Matrix<3, 3>::identity();
+    ASSERT_ARRAY_NEAR(identity.data(), product.data(), 9, DoubleComparisonAccuracy);
+}
+
+TEST_F(MatrixBatchTest, utilMultiplySingleGroup){
+    // arrange
+    // two 2x2 matrices interleaved: { 1, 2, 3, 4 } and { 5, 6, 7, 8 }
+    int a[] = { 1, 5, 2, 6, 3, 7, 4, 8 };
+    // { 1, 0, 0, 1 } and { 0, 1, 1, 0 }
+    int b[] = { 1, 0, 0, 1, 0, 1, 1, 0 };
+    int out[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixBatchUtil::multiply<2, 2, 2, 2>(a, b, out, 1);
+
+    // assert
+    ASSERT_EQ(8, written);
+
+    int expected[] = { 1, 6, 2, 5, 3, 8, 4, 7 };
+    ASSERT_ARRAY_EQ(expected, out, 8);
+}
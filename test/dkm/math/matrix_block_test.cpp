@@ -0,0 +1,197 @@
+/**
+ * matrix_block_test.cpp
+ *
+ * Unit tests for MatrixBlock and the Matrix block, row, col and diagonal views.
+ */
+
+#include "dkm/math/matrix_block_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/math_test_helpers.h"
+
+using namespace dkm;
+
+// common inputs and outputs for testing
+const double base4x4d[] = { 1,  2,  3,  4,
+                            5,  6,  7,  8,
+                            9,  10, 11, 12,
+                            13, 14, 15, 16 };
+
+TEST_F(MatrixBlockTest, blockViewsMatrixMemory){
+    // arrange
+    Matrix<4, 4> m(base4x4d);
+
+    // act
+    MatrixBlock<2, 3> b = m.block<2, 3>(1, 1);
+
+    // assert
+    ASSERT_EQ(m.data() + 5, b.data());
+    ASSERT_EQ(4u, b.stride());
+    ASSERT_FALSE(b.isContiguous());
+    ASSERT_EQ(6, b(0, 0));
+    ASSERT_EQ(12, b(1, 2));
+}
+
+TEST_F(MatrixBlockTest, copyToMatrix){
+    // arrange
+    Matrix<4, 4> m(base4x4d);
+
+    // act
+    Matrix<3, 3> rotation = m.block<3, 3>(0, 0);
+
+    // assert
+    const double expected[] = { 1, 2, 3,
+                                5, 6, 7,
+                                9, 10, 11 };
+    ASSERT_ARRAY_EQ(expected, rotation.data(), 9);
+}
+
+TEST_F(MatrixBlockTest, assignVectorToColumnBlock){
+    // arrange
+    Matrix<4, 4> m = Matrix<4, 4>::identity();
+    Vector<3> translation(7, 8, 9);
+
+    // act
+    m.block<3, 1>(0, 3) = translation;
+
+    // assert
+    const double expected[] = { 1, 0, 0, 7,
+                                0, 1, 0, 8,
+                                0, 0, 1, 9,
+                                0, 0, 0, 1 };
+    ASSERT_ARRAY_EQ(expected, m.data(), 16);
+}
+
+TEST_F(MatrixBlockTest, rowAndCol){
+    // arrange
+    Matrix<4, 4> m(base4x4d);
+
+    // act
+    MatrixBlock<1, 4> r = m.row(2);
+    MatrixBlock<4, 1> c = m.col(1);
+    c *= 10;
+
+    // assert
+    ASSERT_TRUE(r.isContiguous());
+    ASSERT_EQ(9, r(0, 0));
+    ASSERT_EQ(100, r(0, 1));
+    const double expected[] = { 1,  20,  3,  4,
+                                5,  60,  7,  8,
+                                9,  100, 11, 12,
+                                13, 140, 15, 16 };
+    ASSERT_ARRAY_EQ(expected, m.data(), 16);
+}
+
+TEST_F(MatrixBlockTest, diagonal){
+    // arrange
+    Matrix<4, 4> m(base4x4d);
+    const Matrix<2, 3> rect(base4x4d);
+
+    // act
+    MatrixBlock<4, 1> d = m.diagonal();
+    d = Matrix<4, 1>();
+    MatrixBlock<2, 1, const double> rectDiag = rect.diagonal();
+
+    // assert
+    const double expected[] = { 0,  2,  3,  4,
+                                5,  0,  7,  8,
+                                9,  10, 0,  12,
+                                13, 14, 15, 0 };
+    ASSERT_ARRAY_EQ(expected, m.data(), 16);
+    ASSERT_EQ(1, rectDiag(0, 0));
+    ASSERT_EQ(5, rectDiag(1, 0));
+}
+
+TEST_F(MatrixBlockTest, arithmetic){
+    // arrange
+    Matrix<4, 4> m(base4x4d);
+    Matrix<2, 2> ones;
+    ones(0, 0) = ones(0, 1) = ones(1, 0) = ones(1, 1) = 1;
+
+    // act
+    Matrix<2, 2> sum = m.block<2, 2>(0, 0) + m.block<2, 2>(2, 2);
+    Matrix<2, 2> diff = m.block<2, 2>(2, 0) - ones;
+    Matrix<2, 2> scaled = m.block<2, 2>(0, 2) * 2.0;
+    m.block<2, 2>(0, 0) += ones;
+    Matrix<2, 2> topLeft = m.block<2, 2>(0, 0);
+
+    // assert
+    const double expectedSum[] = { 12, 14, 20, 22 };
+    const double expectedDiff[] = { 8, 9, 12, 13 };
+    const double expectedScaled[] = { 6, 8, 14, 16 };
+    const double expectedTopLeft[] = { 2, 3, 6, 7 };
+    ASSERT_ARRAY_EQ(expectedSum, sum.data(), 4);
+    ASSERT_ARRAY_EQ(expectedDiff, diff.data(), 4);
+    ASSERT_ARRAY_EQ(expectedScaled, scaled.data(), 4);
+    ASSERT_ARRAY_EQ(expectedTopLeft, topLeft.data(), 4);
+}
+
+TEST_F(MatrixBlockTest, multiply){
+    // arrange
+    Matrix<4, 4> m(base4x4d);
+    Matrix<3, 1> point;
+    point(0, 0) = 1;
+    point(1, 0) = 0;
+    point(2, 0) = -1;
+
+    // act
+    Matrix<3, 1> rotated = m.block<3, 3>(0, 0) * point;
+    Matrix<1, 1> dot = m.row(0) * m.col(3);
+    Matrix<4, 1> product = m * m.col(0);
+
+    // assert
+    const double expectedRotated[] = { -2, -2, -2 };
+    const double expectedProduct[] = { 90, 202, 314, 426 };
+    ASSERT_ARRAY_EQ(expectedRotated, rotated.data(), 3);
+    ASSERT_EQ(1 * 4 + 2 * 8 + 3 * 12 + 4 * 16, dot(0, 0));
+    ASSERT_ARRAY_EQ(expectedProduct, product.data(), 4);
+}
+
+TEST_F(MatrixBlockTest, multiplyIntoBlock){
+    // arrange
+    Matrix<4, 4> m = Matrix<4, 4>::identity();
+    Matrix<2, 2> a(base4x4d);
+    MatrixBlock<2, 2> dest = m.block<2, 2>(2, 2);
+
+    // act
+    MatrixUtil::matrixMultiply(a.data(), 2, 2, 2,
+                               a.data(), 2, 2,
+                               dest.data(), dest.stride());
+
+    // assert
+    const double expected[] = { 1, 0, 0,  0,
+                                0, 1, 0,  0,
+                                0, 0, 7,  10,
+                                0, 0, 15, 22 };
+    ASSERT_ARRAY_EQ(expected, m.data(), 16);
+}
+
+TEST_F(MatrixBlockTest, transpose){
+    // arrange
+    const Matrix<4, 4> m(base4x4d);
+
+    // act
+    Matrix<3, 2> t = m.block<2, 3>(1, 0).transpose();
+
+    // assert
+    const double expected[] = { 5, 9,
+                                6, 10,
+                                7, 11 };
+    ASSERT_ARRAY_EQ(expected, t.data(), 6);
+}
+
+TEST_F(MatrixBlockTest, blockOfMatrixMap){
+    // arrange
+    double buffer[16];
+    MatrixUtil::copy(base4x4d, buffer, 16);
+    MatrixMap<4, 4> m(buffer);
+
+    // act
+    m.row(3) = m.row(0);
+
+    // assert
+    ASSERT_EQ(1, buffer[12]);
+    ASSERT_EQ(4, buffer[15]);
+}
@@ -0,0 +1,232 @@
+/**
+ * matrix_layout_test.cpp
+ *
+ * Unit tests for column-major and mixed-layout Matrix operations.
+ */
+
+#include "dkm/math/matrix_layout_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/math_test_helpers.h"
+
+using namespace dkm;
+
+// shorthand for column-major matrices
+template<unsigned int RowsArg, unsigned int ColsArg>
+using ColMatrix = Matrix<RowsArg, ColsArg, double, MatrixLayout::COLUMN_MAJOR>;
+
+// common inputs and outputs for testing
+const double base2x3d[] = { 1, 2, 3,
+                            4, 5, 6 };
+const double base2x3ColMajord[] = { 1, 4,
+                                    2, 5,
+                                    3, 6 };
+const double base3x2d[] = { 1, 2,
+                            3, 4,
+                            5, 6 };
+const double product2x2d[] = { 22, 28,
+                               49, 64 };
+const double product2x2ColMajord[] = { 22, 49,
+                                       28, 64 };
+
+TEST_F(MatrixLayoutTest, strides){
+    // assert
+    ASSERT_EQ(MatrixLayout::ROW_MAJOR, (Matrix<2, 3>::layout()));
+    ASSERT_EQ(3u, (Matrix<2, 3>::rowStride()));
+    ASSERT_EQ(1u, (Matrix<2, 3>::colStride()));
+    ASSERT_EQ(MatrixLayout::COLUMN_MAJOR, (ColMatrix<2, 3>::layout()));
+    ASSERT_EQ(1u, (ColMatrix<2, 3>::rowStride()));
+    ASSERT_EQ(2u, (ColMatrix<2, 3>::colStride()));
+}
+
+TEST_F(MatrixLayoutTest, elementAccess){
+    // arrange
+    ColMatrix<2, 3> m(base2x3ColMajord);
+
+    // act
+    m(0, 2) = 7;
+    m[1][1] = 8;
+
+    // assert
+    ASSERT_EQ(4, m(1, 0));
+    ASSERT_EQ(2, m(0, 1));
+    ASSERT_EQ(m.data() + 2, m[1]);
+    ASSERT_EQ(7, m.data()[4]);
+    ASSERT_EQ(8, m(1, 1));
+}
+
+TEST_F(MatrixLayoutTest, convertsBetweenLayouts){
+    // arrange
+    Matrix<2, 3> row(base2x3d);
+
+    // act
+    ColMatrix<2, 3> col(row);
+    Matrix<2, 3> back(col);
+
+    // assert
+    ASSERT_ARRAY_EQ(base2x3ColMajord, col.data(), 6);
+    ASSERT_ARRAY_EQ(base2x3d, back.data(), 6);
+}
+
+TEST_F(MatrixLayoutTest, assignFromOtherLayout){
+    // arrange
+    double buffer[6] = { 0 };
+    MatrixMap<2, 3, double, MatrixLayout::COLUMN_MAJOR> m(buffer);
+
+    // act
+    m = Matrix<2, 3>(base2x3d);
+
+    // assert
+    ASSERT_ARRAY_EQ(base2x3ColMajord, buffer, 6);
+}
+
+TEST_F(MatrixLayoutTest, assignFromMapOfSameMemory){
+    // arrange
+    double buffer[6] = { 1, 2, 3, 4, 5, 6 };
+    MatrixMap<2, 3> row(buffer);
+    MatrixMap<2, 3, double, MatrixLayout::COLUMN_MAJOR> col(buffer);
+
+    // act
+    col = row;
+
+    // assert
+    ASSERT_ARRAY_EQ(base2x3ColMajord, buffer, 6);
+    ASSERT_EQ(6, col(1, 2));
+}
+
+TEST_F(MatrixLayoutTest, mixedAddSubtract){
+    // arrange
+    ColMatrix<2, 3> a(base2x3ColMajord);
+    Matrix<2, 3> b(base2x3d);
+
+    // act
+    ColMatrix<2, 3> sum = a + b;
+    Matrix<2, 3> diff = b - a;
+    a += b;
+
+    // assert
+    const double expectedSum[] = { 2, 8, 4, 10, 6, 12 };
+    ASSERT_ARRAY_EQ(expectedSum, sum.data(), 6);
+    ASSERT_ARRAY_EQ(expectedSum, a.data(), 6);
+    for (int i=0; i<6; ++i) {
+        ASSERT_EQ(0, diff.data()[i]);
+    }
+}
+
+TEST_F(MatrixLayoutTest, multiplyMixedLayouts){
+    // arrange
+    Matrix<2, 3> rowA(base2x3d);
+    Matrix<3, 2> rowB(base3x2d);
+    ColMatrix<2, 3> colA(rowA);
+    ColMatrix<3, 2> colB(rowB);
+
+    // act
+    ColMatrix<2, 2> cc = colA * colB;
+    ColMatrix<2, 2> cr = colA * rowB;
+    Matrix<2, 2> rc = rowA * colB;
+
+    // assert
+    ASSERT_ARRAY_EQ(product2x2ColMajord, cc.data(), 4);
+    ASSERT_ARRAY_EQ(product2x2ColMajord, cr.data(), 4);
+    ASSERT_ARRAY_EQ(product2x2d, rc.data(), 4);
+}
+
+TEST_F(MatrixLayoutTest, multiplyAssign){
+    // arrange
+    const double swap[] = { 0, 1,
+                            1, 0 };
+    ColMatrix<2, 2> m;
+    m = Matrix<2, 2>(product2x2d);
+
+    // act
+    m *= Matrix<2, 2>(swap);
+
+    // assert
+    ASSERT_EQ(28, m(0, 0));
+    ASSERT_EQ(22, m(0, 1));
+    ASSERT_EQ(64, m(1, 0));
+    ASSERT_EQ(49, m(1, 1));
+}
+
+TEST_F(MatrixLayoutTest, multiplyByRowMajorTranspose){
+    // arrange
+    ColMatrix<2, 3> a;
+    a = Matrix<2, 3>(base2x3d);
+    Matrix<2, 3> b(base3x2d);
+
+    // act
+    ColMatrix<2, 2> result = a * b.transpose();
+
+    // assert
+    ASSERT_EQ(14, result(0, 0));
+    ASSERT_EQ(32, result(0, 1));
+    ASSERT_EQ(32, result(1, 0));
+    ASSERT_EQ(77, result(1, 1));
+}
+
+TEST_F(MatrixLayoutTest, transformVector){
+    // arrange
+    ColMatrix<2, 3> m(base2x3ColMajord);
+    Vector<3> v(1, 1, 1);
+
+    // act
+    Vector<2> result = m.transformVector(v);
+
+    // assert
+    ASSERT_EQ(6, result.x());
+    ASSERT_EQ(15, result.y());
+}
+
+TEST_F(MatrixLayoutTest, transposeIsRowMajorMap){
+    // arrange
+    ColMatrix<2, 3> m(base2x3ColMajord);
+
+    // act
+    Matrix<3, 2, double, MatrixLayout::ROW_MAJOR, _MappedStorage<const double> > t = m.transpose();
+    Matrix<3, 2> copy = m.transpose();
+
+    // assert
+    ASSERT_EQ(m.data(), t.data());
+    ASSERT_EQ(4, t(0, 1));
+    ASSERT_EQ(3, t(2, 0));
+    ASSERT_EQ(4, copy(0, 1));
+}
+
+TEST_F(MatrixLayoutTest, transposeSquareInPlace){
+    // arrange
+    ColMatrix<2, 2> m(product2x2ColMajord);
+
+    // act
+    m = m.transpose();
+
+    // assert
+    ASSERT_ARRAY_EQ(product2x2d, m.data(), 4);
+    ASSERT_EQ(49, m(0, 1));
+}
+
+TEST_F(MatrixLayoutTest, columnAndDiagonalBlocks){
+    // arrange
+    ColMatrix<3, 3> m = ColMatrix<3, 3>::identity();
+
+    // act
+    m.col(2) = Vector<3>(7, 8, 9);
+    m.block<2, 1>(1, 0) = Vector<2>(4, 5);
+    m.diagonal() *= 2.0;
+
+    // assert
+    const double expected[] = { 2, 4, 5,
+                                0, 2, 0,
+                                7, 8, 18 };
+    ASSERT_ARRAY_EQ(expected, m.data(), 9);
+}
+
+TEST_F(MatrixLayoutTest, toStringIsRowByRow){
+    // arrange
+    ColMatrix<2, 3> col(base2x3ColMajord);
+    Matrix<2, 3> row(base2x3d);
+
+    // act / assert
+    ASSERT_EQ(row.toString(), col.toString());
+}
@@ -0,0 +1,67 @@
+/**
+ * matrix_map_reject.cpp
+ *
+ * Compile checks for MatrixMap, VectorMap and QuaternionMap. A map has no
+ * memory of its own, so every constructor that does not take caller
+ * memory must be rejected at compile time. DKM_MAP_REJECT_CASE picks the
+ * construction to try: case 0 is valid and must build, every other case
+ * must fail to build.
+ */
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/quaternion.h"
+
+using namespace dkm;
+
+int main() {
+    float elements[16] = { 0 };
+
+#if DKM_MAP_REJECT_CASE == 0
+    MatrixMap<4, 4, float> m(elements);
+    VectorMap<2, float> v2(elements);
+    VectorMap<3, float> v3(elements);
+    VectorMap<4, float> v4(elements);
+    VectorMap<5, float> v5(elements);
+    QuaternionMap<float> q(elements);
+    Vector<3, float> axis(1.0f, 0.0f, 0.0f);
+    Quaternion<float> owned(axis, 0.5);
+    q = owned;
+    MatrixMap<4, 4, const float> fromMap((MatrixMap<4, 4, float>(elements)));
+    Matrix<4, 4, float> fromTemporary((Matrix<4, 4, float>(elements)));
+    return static_cast<int>(m(0, 0) + v2.x() + v3.x() + v4.x() + v5[0] + q.x() +
+                            fromMap(0, 0) + fromTemporary(0, 0));
+#elif DKM_MAP_REJECT_CASE == 1
+    MatrixMap<4, 4, float> m;
+    return static_cast<int>(m(0, 0) + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 2
+    VectorMap<5, float> v;
+    return static_cast<int>(v[0] + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 3
+    VectorMap<2, float> v(1.0f, 2.0f);
+    return static_cast<int>(v.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 4
+    VectorMap<3, float> v(1.0f, 2.0f, 3.0f);
+    return static_cast<int>(v.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 5
+    VectorMap<4, float> v(1.0f, 2.0f, 3.0f, 4.0f);
+    return static_cast<int>(v.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 6
+    QuaternionMap<float> q;
+    return static_cast<int>(q.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 7
+    QuaternionMap<float> q(1.0f, 2.0f, 3.0f, 4.0f);
+    return static_cast<int>(q.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 8
+    QuaternionMap<float> q(Vector<3, float>(1.0f, 0.0f, 0.0f), 0.5);
+    return static_cast<int>(q.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 9
+    MatrixMap<4, 4, const float> m((Matrix<4, 4, float>(elements)));
+    return static_cast<int>(m(0, 0));
+#elif DKM_MAP_REJECT_CASE == 10
+    VectorMap<3, const float> v((Vector<3, float>(1.0f, 2.0f, 3.0f)));
+    return static_cast<int>(v.x() + elements[0]);
+#elif DKM_MAP_REJECT_CASE == 11
+    QuaternionMap<const float> q((Quaternion<float>(1.0f, 2.0f, 3.0f, 4.0f)));
+    return static_cast<int>(q.data()[0] + elements[0]);
+#endif
+}
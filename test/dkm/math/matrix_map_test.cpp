@@ -0,0 +1,216 @@
+/**
+ * matrix_map_test.cpp
+ *
+ * Unit tests for MatrixMap, VectorMap and QuaternionMap.
+ */
+
+#include "dkm/math/matrix_map_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/quaternion.h"
+#include "dkm/math/math_test_helpers.h"
+
+// add some macros for degree to radian conversion
+#define PI 3.14159265
+#define DEG_TO_RAD( x ) ( x * ( PI / 180 ))
+
+using namespace dkm;
+
+// common inputs and outputs for testing
+const double base2x3d[] = { 1, 2, 3,
+                            4, 5, 6 };
+const double addend2x3d[] = { 6, 5, 4,
+                              3, 2, 1 };
+const double sum2x3d[] = { 7, 7, 7,
+                           7, 7, 7 };
+const double transpose3x2d[] = { 1, 4,
+                                 2, 5,
+                                 3, 6 };
+const double base3x2d[] = { 1, 2,
+                            3, 4,
+                            5, 6 };
+const double product2x2d[] = { 22, 28,
+                               49, 64 };
+
+// double comparison accuracy
+const double DoubleComparisonAccuracy = 0.0001;
+
+TEST_F(MatrixMapTest, mapsCallerMemory){
+    // arrange
+    double buffer[6] = { 1, 2, 3, 4, 5, 6 };
+
+    // act
+    MatrixMap<2, 3> m(buffer);
+
+    // assert
+    ASSERT_EQ(buffer, m.data());
+    ASSERT_EQ(5, m(1, 1));
+    ASSERT_EQ(buffer + 3, m[1]);
+}
+
+TEST_F(MatrixMapTest, writesGoToCallerMemory){
+    // arrange
+    double buffer[6] = { 0 };
+    MatrixMap<2, 3> m(buffer);
+
+    // act
+    m(0, 1) = 7;
+    m[1][2] = 8;
+    m += Matrix<2, 3>(base2x3d);
+
+    // assert
+    const double expected[] = { 1, 9, 3, 4, 5, 14 };
+    ASSERT_ARRAY_EQ(expected, buffer, 6);
+}
+
+TEST_F(MatrixMapTest, assignmentCopiesIntoCallerMemory){
+    // arrange
+    double buffer[6] = { 0 };
+    MatrixMap<2, 3> m(buffer);
+    Matrix<2, 3> source(base2x3d);
+
+    // act
+    m = source;
+
+    // assert
+    ASSERT_EQ(buffer, m.data());
+    ASSERT_ARRAY_EQ(base2x3d, buffer, 6);
+}
+
+TEST_F(MatrixMapTest, constMapArithmetic){
+    // arrange
+    MatrixMap<2, 3, const double> a(base2x3d);
+    MatrixMap<2, 3, const double> b(addend2x3d);
+
+    // act
+    Matrix<2, 3> sum = a + b;
+    Matrix<2, 3> scaled = 2.0 * a;
+
+    // assert
+    ASSERT_EQ(base2x3d, a.data());
+    ASSERT_ARRAY_EQ(sum2x3d, sum.data(), 6);
+    ASSERT_EQ(2, scaled(0, 0));
+    ASSERT_EQ(12, scaled(1, 2));
+}
+
+TEST_F(MatrixMapTest, mixedOwningAndMappedOperands){
+    // arrange
+    Matrix<2, 3> a(base2x3d);
+    MatrixMap<2, 3, const double> b(addend2x3d);
+
+    // act
+    Matrix<2, 3> sum = a + b;
+    Matrix<2, 3> diff = b - a;
+
+    // assert
+    ASSERT_ARRAY_EQ(sum2x3d, sum.data(), 6);
+    ASSERT_EQ(5, diff(0, 0));
+    ASSERT_EQ(-5, diff(1, 2));
+}
+
+TEST_F(MatrixMapTest, transposeAndMultiply){
+    // arrange
+    MatrixMap<2, 3, const double> a(base2x3d);
+    MatrixMap<3, 2, const double> b(base3x2d);
+
+    // act
+    Matrix<3, 2> t = a.transpose();
+    Matrix<2, 2> product = a * b;
+
+    // assert
+    ASSERT_ARRAY_EQ(transpose3x2d, t.data(), 6);
+    ASSERT_ARRAY_EQ(product2x2d, product.data(), 4);
+}
+
+TEST_F(MatrixMapTest, multiplyAssignWritesToCallerMemory){
+    // arrange
+    double buffer[4] = { 1, 2, 3, 4 };
+    MatrixMap<2, 2> m(buffer);
+    const double swap[] = { 0, 1,
+                            1, 0 };
+
+    // act
+    m *= MatrixMap<2, 2, const double>(swap);
+
+    // assert
+    const double expected[] = { 2, 1, 4, 3 };
+    ASSERT_ARRAY_EQ(expected, buffer, 4);
+}
+
+TEST_F(MatrixMapTest, mapOfOwningMatrix){
+    // arrange
+    Matrix<2, 3> owner(base2x3d);
+
+    // act
+    MatrixMap<2, 3> m = owner;
+    m(0, 0) = 10;
+
+    // assert
+    ASSERT_EQ(owner.data(), m.data());
+    ASSERT_EQ(10, owner(0, 0));
+}
+
+TEST_F(MatrixMapTest, vectorMap){
+    // arrange
+    float buffer[3] = { 1, 0, 0 };
+    const float y[] = { 0, 1, 0 };
+    VectorMap<3, float> v(buffer);
+    VectorMap<3, const float> yMap(y);
+
+    // act
+    Vector<3, float> z = v.cross(yMap);
+    float dot = v.dot(yMap);
+    v.y(2);
+
+    // assert
+    ASSERT_EQ(buffer, v.data());
+    ASSERT_EQ(1, z.z());
+    ASSERT_EQ(0, dot);
+    ASSERT_EQ(2, buffer[1]);
+}
+
+TEST_F(MatrixMapTest, transformVectorMap){
+    // arrange
+    const double vec[] = { 1, 1, 1 };
+    MatrixMap<2, 3, const double> m(base2x3d);
+    VectorMap<3, const double> v(vec);
+
+    // act
+    Vector<2> result = m.transformVector(v);
+
+    // assert
+    ASSERT_EQ(6, result.x());
+    ASSERT_EQ(15, result.y());
+}
+
+TEST_F(MatrixMapTest, quaternionMapRotate){
+    // arrange
+    double buffer[4] = { 0, 0, 0, 1 };
+    QuaternionMap<double> q(buffer);
+
+    // act
+    q.rotate(Vector<3>::zAxis(), DEG_TO_RAD(90));
+
+    // assert
+    ASSERT_EQ(buffer, q.data());
+    ASSERT_NEAR(0.7071, buffer[2], DoubleComparisonAccuracy);
+    ASSERT_NEAR(0.7071, buffer[3], DoubleComparisonAccuracy);
+}
+
+TEST_F(MatrixMapTest, constQuaternionMapToRotationMatrix){
+    // arrange
+    const double quat[] = { 0, 0, 0.70710678, 0.70710678 };
+    QuaternionMap<const double> q(quat);
+    Vector<3> x = Vector<3>::xAxis();
+
+    // act
+    Matrix<3, 3> rot = q.toRotationMatrix3x3();
+    Vector<3> result = rot.transformVector(x);
+
+    // assert
+    ASSERT_NEAR(0, result.x(), DoubleComparisonAccuracy);
+    ASSERT_NEAR(1, result.y(), DoubleComparisonAccuracy);
+    ASSERT_NEAR(0, result.z(), DoubleComparisonAccuracy);
+}
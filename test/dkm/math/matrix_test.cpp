@@ -194,6 +194,18 @@ TEST_F(MatrixTest, transpose){
     ASSERT_ARRAY_EQ(expected, x.data(), 4);
 }
 
+TEST_F(MatrixTest, transposeInPlace){
+    // arrange
+    Matrix<2, 2, int> m(base4i);
+
+    // act
+    m.transposeInPlace();
+
+    // assert
+    int expected[] = { 1, 3, 2, 4};
+    ASSERT_ARRAY_EQ(expected, m.data(), 4);
+}
+
 TEST_F(MatrixTest, subscriptOperator){
     // arrange
     Matrix<2, 2, int> m;
@@ -0,0 +1,157 @@
+/**
+ * matrix_transpose_test.cpp
+ *
+ * Unit tests for MatrixTranspose, the view returned by Matrix::transpose().
+ */
+
+#include "dkm/math/matrix_transpose_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/math/matrix.h"
+#include "dkm/math/math_test_helpers.h"
+
+using namespace dkm;
+
+// common inputs and outputs for testing
+const double base2x3d[] = { 1, 2, 3,
+                            4, 5, 6 };
+const double transpose3x2d[] = { 1, 4,
+                                 2, 5,
+                                 3, 6 };
+const double base3x3d[] = { 1, 2, 3,
+                            4, 5, 6,
+                            7, 8, 9 };
+
+TEST_F(MatrixTransposeTest, viewsSourceWithoutCopy){
+    // arrange
+    Matrix<2, 3> m(base2x3d);
+
+    // act
+    MatrixTranspose<3, 2> t = m.transpose();
+
+    // assert
+    ASSERT_EQ(m.data(), t.data());
+    ASSERT_EQ(3u, t.rows());
+    ASSERT_EQ(2u, t.cols());
+    ASSERT_EQ(4, t(0, 1));
+    ASSERT_EQ(3, t(2, 0));
+}
+
+TEST_F(MatrixTransposeTest, materializeOnAssignment){
+    // arrange
+    Matrix<2, 3> m(base2x3d);
+    Matrix<3, 2> assigned;
+
+    // act
+    Matrix<3, 2> constructed = m.transpose();
+    assigned = m.transpose();
+
+    // assert
+    ASSERT_ARRAY_EQ(transpose3x2d, constructed.data(), 6);
+    ASSERT_ARRAY_EQ(transpose3x2d, assigned.data(), 6);
+}
+
+TEST_F(MatrixTransposeTest, assignToSelf){
+    // arrange
+    Matrix<3, 3> m(base3x3d);
+
+    // act
+    m = m.transpose();
+
+    // assert
+    const double expected[] = { 1, 4, 7,
+                                2, 5, 8,
+                                3, 6, 9 };
+    ASSERT_ARRAY_EQ(expected, m.data(), 9);
+}
+
+TEST_F(MatrixTransposeTest, multiplyByTranspose){
+    // arrange
+    Matrix<2, 3> a(base2x3d);
+
+    // act
+    Matrix<2, 2> product = a * a.transpose();
+
+    // assert
+    const double expected[] = { 14, 32,
+                                32, 77 };
+    ASSERT_ARRAY_EQ(expected, product.data(), 4);
+}
+
+TEST_F(MatrixTransposeTest, transposeTimesMatrix){
+    // arrange
+    Matrix<2, 3> a(base2x3d);
+
+    // act
+    Matrix<3, 3> product = a.transpose() * a;
+
+    // assert
+    const double expected[] = { 17, 22, 27,
+                                22, 29, 36,
+                                27, 36, 45 };
+    ASSERT_ARRAY_EQ(expected, product.data(), 9);
+}
+
+TEST_F(MatrixTransposeTest, transposeTimesTranspose){
+    // arrange
+    Matrix<2, 3> a(base2x3d);
+    Matrix<3, 3> b(base3x3d);
+
+    // act
+    Matrix<3, 2> product = b.transpose() * a.transpose();
+
+    // assert
+    const double expected[] = { 30, 66,
+                                36, 81,
+                                42, 96 };
+    ASSERT_ARRAY_EQ(expected, product.data(), 6);
+}
+
+TEST_F(MatrixTransposeTest, multiplyAssignByTranspose){
+    // arrange
+    Matrix<3, 3> m(base3x3d);
+    Matrix<3, 3> expected = m * Matrix<3, 3>(m.transpose());
+
+    // act
+    m *= m.transpose();
+
+    // assert
+    ASSERT_ARRAY_EQ(expected.data(), m.data(), 9);
+}
+
+TEST_F(MatrixTransposeTest, transformVector){
+    // arrange
+    Matrix<2, 3> m(base2x3d);
+    Vector<2> v(1, 1);
+
+    // act
+    Vector<3> result = m.transpose().transformVector(v);
+
+    // assert
+    ASSERT_EQ(5, result.x());
+    ASSERT_EQ(7, result.y());
+    ASSERT_EQ(9, result.z());
+}
+
+TEST_F(MatrixTransposeTest, blockTranspose){
+    // arrange
+    Matrix<3, 3> m(base3x3d);
+    Matrix<2, 2> ident = Matrix<2, 2>::identity();
+
+    // act
+    Matrix<2, 2> t = m.block<2, 2>(1, 1).transpose();
+    Matrix<2, 2> product = m.block<2, 2>(0, 0).transpose() * ident;
+    Matrix<2, 3> back = m.block<3, 2>(0, 0).transpose().transpose().transpose();
+
+    // assert
+    const double expectedT[] = { 5, 8,
+                                 6, 9 };
+    const double expectedProduct[] = { 1, 4,
+                                       2, 5 };
+    const double expectedBack[] = { 1, 4, 7,
+                                    2, 5, 8 };
+    ASSERT_ARRAY_EQ(expectedT, t.data(), 4);
+    ASSERT_ARRAY_EQ(expectedProduct, product.data(), 4);
+    ASSERT_ARRAY_EQ(expectedBack, back.data(), 6);
+}
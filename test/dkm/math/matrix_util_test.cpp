@@ -7,6 +7,7 @@
 #include "dkm/math/matrix_util_test.h"
 
 #include <iostream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -222,6 +223,124 @@ TEST_F(MatrixUtilTest, transpose_NoCols){
     ASSERT_ARRAY_EQ(expected, dest, 7);
 }
 
+TEST_F(MatrixUtilTest, transpose_LargerThanTile){
+    // arrange
+    const int rows = 37;
+    const int cols = 70;
+    std::vector<double> src(rows * cols);
+    for (int i=0; i<rows*cols; ++i) {
+        src[i] = i;
+    }
+    std::vector<double> dest(rows * cols);
+
+    // act
+    int written = MatrixUtil::transpose(src.data(), rows, cols, dest.data());
+
+    // assert
+    ASSERT_EQ(rows * cols, written);
+    for (int i=0; i<rows; ++i) {
+        for (int j=0; j<cols; ++j) {
+            ASSERT_EQ(src[i*cols + j], dest[j*rows + i]);
+        }
+    }
+}
+
+TEST_F(MatrixUtilTest, transpose_FloatLargerThanTile){
+    // arrange
+    const int rows = 45;
+    const int cols = 67;
+    std::vector<float> src(rows * cols);
+    for (int i=0; i<rows*cols; ++i) {
+        src[i] = static_cast<float>(i);
+    }
+    std::vector<float> dest(rows * cols);
+
+    // act
+    int written = MatrixUtil::transpose(src.data(), rows, cols, dest.data());
+
+    // assert
+    ASSERT_EQ(rows * cols, written);
+    for (int i=0; i<rows; ++i) {
+        for (int j=0; j<cols; ++j) {
+            ASSERT_EQ(src[i*cols + j], dest[j*rows + i]);
+        }
+    }
+}
+
+TEST_F(MatrixUtilTest, transposeInPlace_Square){
+    // arrange
+    const int dim = 35;
+    std::vector<int> data(dim * dim);
+    for (int i=0; i<dim*dim; ++i) {
+        data[i] = i;
+    }
+
+    // act
+    int written = MatrixUtil::transposeInPlace(data.data(), dim);
+
+    // assert
+    ASSERT_EQ(dim * dim, written);
+    for (int i=0; i<dim; ++i) {
+        for (int j=0; j<dim; ++j) {
+            ASSERT_EQ(j*dim + i, data[i*dim + j]);
+        }
+    }
+}
+
+TEST_F(MatrixUtilTest, transposeInPlace_Rectangular){
+    // arrange
+    int data[] = { 1, 2, 3, 4, 5,
+                   6, 7, 8, 9, 10,
+                   11, 12, 13, 14, 15 };
+
+    // act
+    int written = MatrixUtil::transposeInPlace(data, 3, 5);
+
+    // assert
+    ASSERT_EQ(15, written);
+
+    int expected[] = { 1, 6, 11,
+                       2, 7, 12,
+                       3, 8, 13,
+                       4, 9, 14,
+                       5, 10, 15 };
+    ASSERT_ARRAY_EQ(expected, data, 15);
+}
+
+TEST_F(MatrixUtilTest, transposeInPlace_RectangularLarge){
+    // arrange
+    const int rows = 17;
+    const int cols = 40;
+    std::vector<int> data(rows * cols);
+    for (int i=0; i<rows*cols; ++i) {
+        data[i] = i;
+    }
+
+    // act
+    MatrixUtil::transposeInPlace(data.data(), rows, cols);
+
+    // assert
+    for (int i=0; i<rows; ++i) {
+        for (int j=0; j<cols; ++j) {
+            ASSERT_EQ(i*cols + j, data[j*rows + i]);
+        }
+    }
+}
+
+TEST_F(MatrixUtilTest, transposeInPlace_SingleRow){
+    // arrange
+    int data[] = { 1, 2, 3 };
+
+    // act
+    int written = MatrixUtil::transposeInPlace(data, 1, 3);
+
+    // assert
+    ASSERT_EQ(3, written);
+
+    int expected[] = { 1, 2, 3 };
+    ASSERT_ARRAY_EQ(expected, data, 3);
+}
+
 TEST_F(MatrixUtilTest, matrixMultiply){
     // arrange
     int a[] = { 3, 2, 1, 4, -5, 6 }; // 2x3 matrix
@@ -285,6 +404,396 @@ TEST_F(MatrixUtilTest, matrixMultiply_NoOutputCols){
     ASSERT_ARRAY_EQ(expected, dest, 6);
 }
 
+TEST_F(MatrixUtilTest, copy_Strided){
+    // arrange
+    int src[] = { 1, 2, 3,
+                  4, 5, 6 };
+    int dest[] = { 0, 0, 0, 0,
+                   0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::copy(src + 1, 3, dest + 2, 4, 2, 2);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 0, 0, 2, 3,
+                       0, 0, 5, 6 };
+    ASSERT_ARRAY_EQ(expected, dest, 8);
+}
+
+TEST_F(MatrixUtilTest, set_Strided){
+    // arrange
+    int dest[] = { 0, 0, 0,
+                   0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::set(dest + 1, 3, 7, 2, 1);
+
+    // assert
+    ASSERT_EQ(2, written);
+
+    int expected[] = { 0, 7, 0,
+                       0, 7, 0 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, add_Strided){
+    // arrange
+    int a[] = { 1, 2, 3,
+                4, 5, 6 };
+    int b[] = { 10, 20,
+                30, 40 };
+    int dest[] = { 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::add(a + 1, 3, b, 2, dest, 2, 2, 2);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 12, 23, 35, 46 };
+    ASSERT_ARRAY_EQ(expected, dest, 4);
+}
+
+TEST_F(MatrixUtilTest, add_StridedContiguous){
+    // arrange
+    int a[] = { 1, 2, 3, 4 };
+    int b[] = { 10, 20, 30, 40 };
+    int dest[] = { 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::add(a, 2, b, 2, dest, 2, 2, 2);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 11, 22, 33, 44 };
+    ASSERT_ARRAY_EQ(expected, dest, 4);
+}
+
+TEST_F(MatrixUtilTest, sub_Strided){
+    // arrange
+    int a[] = { 10, 20, 30,
+                40, 50, 60 };
+    int b[] = { 1, 2,
+                3, 4 };
+    int dest[] = { 0, 0, 0,
+                   0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::subtract(a, 3, b, 2, dest, 3, 2, 2);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 9, 18, 0,
+                       37, 46, 0 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, scalarMultiply_Strided){
+    // arrange
+    int a[] = { 1, 2, 3,
+                4, 5, 6,
+                7, 8, 9 };
+
+    // act
+    int written = MatrixUtil::scalarMultiply(a, 4, 2, a, 4, 3, 1);
+
+    // assert
+    ASSERT_EQ(3, written);
+
+    int expected[] = { 2, 2, 3,
+                       4, 10, 6,
+                       7, 8, 18 };
+    ASSERT_ARRAY_EQ(expected, a, 9);
+}
+
+TEST_F(MatrixUtilTest, transpose_Strided){
+    // arrange
+    int src[] = { 1, 2, 3,
+                  4, 5, 6,
+                  7, 8, 9 };
+    int dest[] = { 0, 0, 0,
+                   0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::transpose(src + 3, 3, 2, 3, dest, 2);
+
+    // assert
+    ASSERT_EQ(6, written);
+
+    int expected[] = { 4, 7,
+                       5, 8,
+                       6, 9 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, matrixMultiply_Strided){
+    // arrange
+    int a[] = { 3, 2, 1, 0,
+                4, -5, 6, 0 }; // 2x3 block of a 2x4 matrix
+    int b[] = { 2, 1, 0,
+                7, -4, 0,
+                8, 0, 0 }; // 3x2 block of a 3x3 matrix
+    int dest[] = { 0, 0, 0,
+                   0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::matrixMultiply(a, 2, 3, 4, b, 2, 3, dest + 1, 3);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 0, 28, -5,
+                       0, 21, 24 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, matrixMultiply_StridedNoInputRows){
+    // arrange
+    int a[] = { 3, 2, 1, 0 };
+    int b[] = { 2, 1, 0 };
+    int dest[] = { 9, 9, 9 };
+
+    // act
+    int written = MatrixUtil::matrixMultiply(a, 0, 3, 4, b, 2, 3, dest, 3);
+
+    // assert
+    ASSERT_EQ(0, written);
+
+    int expected[] = { 9, 9, 9 };
+    ASSERT_ARRAY_EQ(expected, dest, 3);
+}
+
+TEST_F(MatrixUtilTest, matrixMultiplyTransposed){
+    // arrange
+    int a[] = { 3, 2, 1, 4, -5, 6 }; // 2x3 matrix
+    int b[] = { 2, 7, 8, 1, -4, 0 }; // 2x3 matrix, the transpose of the b in matrixMultiply
+    int dest[] = { 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::matrixMultiplyTransposed(a, 2, 3, b, 2, dest);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 28, -5, 21, 24, 0, 0 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, matrixMultiplyTransposed_NoInputCols){
+    // arrange
+    int a[] = { 3, 2, 1, 4, -5, 6 };
+    int b[] = { 2, 7, 8, 1, -4, 0 };
+    int dest[] = { 9, 9, 9, 9 };
+
+    // act
+    int written = MatrixUtil::matrixMultiplyTransposed(a, 2, 0, b, 2, dest);
+
+    // assert
+    ASSERT_EQ(0, written);
+
+    int expected[] = { 9, 9, 9, 9 };
+    ASSERT_ARRAY_EQ(expected, dest, 4);
+}
+
+TEST_F(MatrixUtilTest, matrixMultiplyTransposed_Strided){
+    // arrange
+    int a[] = { 3, 2, 1, 0,
+                4, -5, 6, 0 }; // 2x3 block of a 2x4 matrix
+    int b[] = { 0, 2, 7, 8,
+                0, 1, -4, 0 }; // 2x3 block of a 2x4 matrix
+    int dest[] = { 0, 0, 0,
+                   0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::matrixMultiplyTransposed(a, 2, 3, 4, b + 1, 2, 4, dest, 3);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 28, -5, 0,
+                       21, 24, 0 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, transposedMatrixMultiply){
+    // arrange
+    int a[] = { 3, 4, 2, -5, 1, 6 }; // 3x2 matrix, the transpose of the a in matrixMultiply
+    int b[] = { 2, 1, 7, -4, 8, 0 }; // 3x2 matrix
+    int dest[] = { 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::transposedMatrixMultiply(a, 3, 2, b, 2, dest);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 28, -5, 21, 24, 0, 0 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, transposedMatrixMultiply_NoOutputCols){
+    // arrange
+    int a[] = { 3, 4, 2, -5, 1, 6 };
+    int b[] = { 2, 1, 7, -4, 8, 0 };
+    int dest[] = { 9, 9, 9, 9 };
+
+    // act
+    int written = MatrixUtil::transposedMatrixMultiply(a, 3, 2, b, 0, dest);
+
+    // assert
+    ASSERT_EQ(0, written);
+
+    int expected[] = { 9, 9, 9, 9 };
+    ASSERT_ARRAY_EQ(expected, dest, 4);
+}
+
+TEST_F(MatrixUtilTest, transposedMatrixMultiply_Strided){
+    // arrange
+    int a[] = { 3, 4, 0,
+                2, -5, 0,
+                1, 6, 0 }; // 3x2 block of a 3x3 matrix
+    int b[] = { 2, 1,
+                7, -4,
+                8, 0 };
+    int dest[] = { 9, 9, 9,
+                   9, 9, 9 };
+
+    // act
+    int written = MatrixUtil::transposedMatrixMultiply(a, 3, 2, 3, b, 2, 2, dest, 3);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 28, -5, 9,
+                       21, 24, 9 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, copy_Layout){
+    // arrange
+    int src[] = { 1, 2, 3,
+                  4, 5, 6 };
+    int dest[] = { 0, 0, 0, 0, 0, 0 };
+    int back[] = { 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::copy(src, MatrixLayout::ROW_MAJOR, dest, MatrixLayout::COLUMN_MAJOR, 2, 3);
+    MatrixUtil::copy(dest, MatrixLayout::COLUMN_MAJOR, back, MatrixLayout::ROW_MAJOR, 2, 3);
+
+    // assert
+    ASSERT_EQ(6, written);
+
+    int expected[] = { 1, 4, 2, 5, 3, 6 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+    ASSERT_ARRAY_EQ(src, back, 6);
+}
+
+TEST_F(MatrixUtilTest, copy_GeneralStrides){
+    // arrange
+    int src[] = { 1, 0, 2, 0,
+                  3, 0, 4, 0 }; // 2x2 matrix using every other column
+    int dest[] = { 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::copy(src, 4, 2, dest, 1, 3, 2, 2);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    int expected[] = { 1, 3, 0, 2, 4, 0 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, add_MixedLayout){
+    // arrange
+    int a[] = { 1, 2, 3,
+                4, 5, 6 };
+    int b[] = { 6, 3, 5, 2, 4, 1 }; // column-major { 6, 5, 4 }, { 3, 2, 1 }
+    int dest[] = { 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::add(a, MatrixLayout::ROW_MAJOR, b, MatrixLayout::COLUMN_MAJOR,
+                                  dest, MatrixLayout::COLUMN_MAJOR, 2, 3);
+
+    // assert
+    ASSERT_EQ(6, written);
+
+    int expected[] = { 7, 7, 7, 7, 7, 7 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, sub_MixedLayout){
+    // arrange
+    int a[] = { 1, 2, 3,
+                4, 5, 6 };
+    int b[] = { 6, 3, 5, 2, 4, 1 }; // column-major { 6, 5, 4 }, { 3, 2, 1 }
+    int dest[] = { 0, 0, 0, 0, 0, 0 };
+
+    // act
+    int written = MatrixUtil::subtract(a, MatrixLayout::ROW_MAJOR, b, MatrixLayout::COLUMN_MAJOR,
+                                       dest, MatrixLayout::ROW_MAJOR, 2, 3);
+
+    // assert
+    ASSERT_EQ(6, written);
+
+    int expected[] = { -5, -3, -1,
+                       1, 3, 5 };
+    ASSERT_ARRAY_EQ(expected, dest, 6);
+}
+
+TEST_F(MatrixUtilTest, matrixMultiply_Layouts){
+    // arrange
+    const MatrixLayout layouts[] = { MatrixLayout::ROW_MAJOR, MatrixLayout::COLUMN_MAJOR };
+    int aRow[] = { 3, 2, 1,
+                   4, -5, 6 }; // 2x3 matrix
+    int aCol[] = { 3, 4, 2, -5, 1, 6 };
+    int bRow[] = { 2, 1,
+                   7, -4,
+                   8, 0 }; // 3x2 matrix
+    int bCol[] = { 2, 7, 8, 1, -4, 0 };
+    int expectedRow[] = { 28, -5,
+                          21, 24 };
+    int expectedCol[] = { 28, 21, -5, 24 };
+
+    for (int combo=0; combo<8; ++combo) {
+        MatrixLayout aLayout = layouts[combo & 1];
+        MatrixLayout bLayout = layouts[(combo >> 1) & 1];
+        MatrixLayout outLayout = layouts[(combo >> 2) & 1];
+        int dest[] = { 0, 0, 0, 0 };
+
+        // act
+        int written = MatrixUtil::matrixMultiply((aLayout == MatrixLayout::ROW_MAJOR) ? aRow : aCol, aLayout, 2, 3,
+                                                 (bLayout == MatrixLayout::ROW_MAJOR) ? bRow : bCol, bLayout, 2,
+                                                 dest, outLayout);
+
+        // assert
+        ASSERT_EQ(4, written);
+
+        int* expected = (outLayout == MatrixLayout::ROW_MAJOR) ? expectedRow : expectedCol;
+        ASSERT_ARRAY_EQ(expected, dest, 4);
+    }
+}
+
+TEST_F(MatrixUtilTest, matrixMultiply_LayoutsNoInputRows){
+    // arrange
+    int a[] = { 1 };
+    int b[] = { 1 };
+    int dest[] = { 9 };
+
+    // act
+    int written = MatrixUtil::matrixMultiply(a, MatrixLayout::COLUMN_MAJOR, 0, 1,
+                                             b, MatrixLayout::ROW_MAJOR, 1,
+                                             dest, MatrixLayout::COLUMN_MAJOR);
+
+    // assert
+    ASSERT_EQ(0, written);
+    ASSERT_EQ(9, dest[0]);
+}
+
 TEST_F(MatrixUtilTest, identity){
     // arrange
 
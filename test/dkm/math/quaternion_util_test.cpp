@@ -394,4 +394,47 @@ TEST_F(QuaternionUtilTest, testRotations4x4_NonAxisRotations){
     // assert
     float expected[] = { 0.5, 0.5, 0.7071, 1.0 };
     ASSERT_ARRAY_NEAR(expected, result4, 4, DoubleComparisonAccuracy);
-}
\ No newline at end of file
+}
+
+TEST_F(QuaternionUtilTest, rotationMatrixToQuaternion){
+    // arrange
+    double mat[] = { 0.0, 0.0, 1.0,
+                     0.0, 1.0, 0.0,
+                    -1.0, 0.0, 0.0 }; // 90 degrees around y axis
+    double dest[] = { 0.0, 0.0, 0.0, 0.0 };
+
+    // act
+    int written = QuaternionUtil::rotationMatrixToQuaternion(mat, 3, dest);
+
+    // assert
+    ASSERT_EQ(4, written);
+
+    double expected[] = { 0.0, 0.7071, 0.0, 0.7071 };
+    ASSERT_ARRAY_NEAR(expected, dest, 4, DoubleComparisonAccuracy);
+}
+
+TEST_F(QuaternionUtilTest, rotationMatrixToQuaternion_HalfTurns){
+    // arrange
+    double axes[][3] = { { 1.0, 0.0, 0.0 },
+                         { 0.0, 1.0, 0.0 },
+                         { 0.0, 0.0, 1.0 },
+                         { 1.0, 2.0, 3.0 } };
+
+    for (int k=0; k<4; ++k) {
+        double quat[4];
+        double mat[16];
+        double dest[4];
+        QuaternionUtil::rotationToQuaternion(axes[k], DEG_TO_RAD(180.0), quat);
+        QuaternionUtil::toRotationMatrix4x4(quat, mat);
+
+        // act
+        QuaternionUtil::rotationMatrixToQuaternion(mat, 4, dest);
+
+        // assert
+        // q and -q are the same rotation
+        double sign = (dest[0]*quat[0] + dest[1]*quat[1] + dest[2]*quat[2] + dest[3]*quat[3]) < 0 ? -1.0 : 1.0;
+        for (int j=0; j<4; ++j) {
+            ASSERT_NEAR(quat[j], sign * dest[j], 1e-6);
+        }
+    }
+}
@@ -0,0 +1,272 @@
+/**
+ * file_log_writer_test.cpp
+ *
+ * Unit tests for the FileLogWriter class.
+ */
+
+#include "dkm/util/log/file_log_writer_test.h"
+
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/file_log_writer.h"
+#include "dkm/util/log/log_frame.h"
+
+using namespace dkm;
+
+TEST_F(FileLogWriterTest, flush_writesBufferedMessages){
+    // arrange
+    FileLogWriter writer((FileLogWriterConfig(mPath)));
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "first", "a", 10));
+    writer.write(makeLogMessage(LogLevel::ERROR, "second", "b", 20));
+    writer.flush();
+
+    // assert
+    ASSERT_EQ("[INFO] a:10 - first\n[ERROR] b:20 - second\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, write_usesConfiguredLayout){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.layout = std::make_shared<PatternLayout>("%-5p %c - %m%n");
+    FileLogWriter writer(config);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "first", "a", 10));
+    writer.flush();
+
+    // assert
+    ASSERT_EQ("INFO  a - first\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, write_buffersUntilSizeTrigger){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.flushInterval = std::chrono::milliseconds(60 * 1000);
+    FileLogWriter writer(config);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "buffered"));
+
+    // assert
+    ASSERT_EQ("", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, write_flushesAfterInterval){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.flushInterval = std::chrono::milliseconds(10);
+    FileLogWriter writer(config);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::WARN, "timed", "t", 5));
+
+    // assert
+    std::string contents;
+    for (int i = 0; i < 200 && contents.empty(); ++i) {
+        usleep(5000);
+        contents = readFile(mPath);
+    }
+    ASSERT_EQ("[WARN] t:5 - timed\n", contents);
+}
+
+TEST_F(FileLogWriterTest, emergencyFlush_writesBufferedData){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.flushInterval = std::chrono::milliseconds(60 * 1000);
+    FileLogWriter writer(config);
+    writer.write(makeLogMessage(LogLevel::INFO, "buffered", "a", 10));
+
+    // act
+    writer.emergencyFlush();
+
+    // assert
+    ASSERT_EQ("[INFO] a:10 - buffered\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, emergencyFlush_notWrittenAgain){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.flushInterval = std::chrono::milliseconds(60 * 1000);
+    config.bufferSize = 16;
+
+    // act
+    {
+        FileLogWriter writer(config);
+        writer.write(makeLogMessage(LogLevel::INFO, "full", "a", 1));
+        writer.write(makeLogMessage(LogLevel::INFO, "x", "a", 2));
+        writer.emergencyFlush();
+        writer.write(makeLogMessage(LogLevel::INFO, "after", "a", 3));
+        writer.flush();
+    }
+
+    // assert
+    ASSERT_EQ("[INFO] a:1 - full\n"
+              "[INFO] a:2 - x\n"
+              "[INFO] a:3 - after\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, emergencyWrite_formatsMessage){
+    // arrange
+    FileLogWriter writer((FileLogWriterConfig(mPath)));
+
+    // act
+    writer.emergencyWrite(makeLogMessage(LogLevel::ERROR, "queued", "q", -3));
+
+    // assert
+    ASSERT_EQ("[ERROR] q:-3 - queued\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, emergencyWrite_truncatesLongMessage){
+    // arrange
+    FileLogWriter writer((FileLogWriterConfig(mPath)));
+
+    // act
+    writer.emergencyWrite(makeLogMessage(LogLevel::INFO, std::string(5000, 'x')));
+
+    // assert
+    std::string contents = readFile(mPath);
+    ASSERT_EQ(1024u, contents.size());
+    ASSERT_EQ('\n', contents[contents.size() - 1]);
+}
+
+TEST_F(FileLogWriterTest, destructor_writesRemainingMessages){
+    // act
+    {
+        FileLogWriter writer((FileLogWriterConfig(mPath)));
+        writer.write(makeLogMessage(LogLevel::DEBUG, "last", "d", 1));
+    }
+
+    // assert
+    ASSERT_EQ("[DEBUG] d:1 - last\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, write_appendsToExistingFile){
+    // arrange
+    {
+        FileLogWriter writer((FileLogWriterConfig(mPath)));
+        writer.write(makeLogMessage(LogLevel::INFO, "one", "x", 1));
+    }
+
+    // act
+    {
+        FileLogWriter writer((FileLogWriterConfig(mPath)));
+        writer.write(makeLogMessage(LogLevel::INFO, "two", "x", 2));
+    }
+
+    // assert
+    ASSERT_EQ("[INFO] x:1 - one\n[INFO] x:2 - two\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, sizeRotation){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.bufferSize = 1;
+    config.rotation = RotationPolicy::SIZE;
+    config.rotateSize = 1;
+    config.maxFiles = 2;
+    FileLogWriter writer(config);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "a", "r", 1));
+    writer.flush();
+    writer.write(makeLogMessage(LogLevel::INFO, "b", "r", 2));
+    writer.flush();
+    writer.write(makeLogMessage(LogLevel::INFO, "c", "r", 3));
+    writer.flush();
+
+    // assert
+    ASSERT_EQ("", readFile(mPath));
+    ASSERT_EQ("[INFO] r:3 - c\n", readFile(mPath + ".1"));
+    ASSERT_EQ("[INFO] r:2 - b\n", readFile(mPath + ".2"));
+    ASSERT_EQ("", readFile(mPath + ".3"));
+}
+
+TEST_F(FileLogWriterTest, fsyncEveryBatch){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.fsyncPolicy = FsyncPolicy::EVERY_BATCH;
+    FileLogWriter writer(config);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "synced", "s", 1));
+    writer.flush();
+
+    // assert
+    ASSERT_EQ("[INFO] s:1 - synced\n", readFile(mPath));
+}
+
+TEST_F(FileLogWriterTest, compression_writesFramesByBatch){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.compression = FileCompression::LZ;
+    config.flushInterval = std::chrono::milliseconds(60 * 1000);
+    FileLogWriter writer(config);
+
+    LogMessage early = makeLogMessage(LogLevel::INFO, "early", "z", 1);
+    early.timestamp = std::chrono::system_clock::time_point(std::chrono::seconds(1000));
+    LogMessage late = makeLogMessage(LogLevel::INFO, "late", "z", 2);
+    late.timestamp = std::chrono::system_clock::time_point(std::chrono::seconds(2000));
+
+    // act
+    for (int i = 0; i < 100; ++i) {
+        writer.write(early);
+    }
+    writer.flush();
+    for (int i = 0; i < 100; ++i) {
+        writer.write(late);
+    }
+    writer.flush();
+
+    // assert
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        expected += "[INFO] z:2 - late\n";
+    }
+
+    LogFrameReader reader(mPath);
+    reader.seek(1500 * 1000000LL);
+
+    LogFrameHeader header;
+    uint64_t offset;
+    std::string text;
+    ASSERT_TRUE(reader.nextHeader(header, offset));
+    ASSERT_EQ(LogFrameCodec::LZ, header.codec);
+    ASSERT_EQ(2000 * 1000000LL, header.firstTime);
+    ASSERT_EQ(2000 * 1000000LL, header.lastTime);
+    ASSERT_LT(header.payloadLength, header.decodedLength / 4);
+    ASSERT_TRUE(reader.readPayload(text));
+    ASSERT_EQ(expected, text);
+    ASSERT_FALSE(reader.nextHeader(header, offset));
+}
+
+TEST_F(FileLogWriterTest, compression_emergencyFlushWritesPlainFrame){
+    // arrange
+    FileLogWriterConfig config(mPath);
+    config.compression = FileCompression::LZ;
+    config.flushInterval = std::chrono::milliseconds(60 * 1000);
+    FileLogWriter writer(config);
+    writer.write(makeLogMessage(LogLevel::INFO, "buffered", "a", 10));
+
+    // act
+    writer.emergencyFlush();
+
+    // assert
+    LogFrameReader reader(mPath);
+    LogFrameHeader header;
+    uint64_t offset;
+    std::string text;
+    ASSERT_TRUE(reader.nextHeader(header, offset));
+    ASSERT_EQ(LogFrameCodec::NONE, header.codec);
+    ASSERT_TRUE(reader.readPayload(text));
+    ASSERT_EQ("[INFO] a:10 - buffered\n", text);
+}
+
+TEST_F(FileLogWriterTest, constructor_invalidPath){
+    // act/assert
+    ASSERT_THROW(FileLogWriter((FileLogWriterConfig(mDir + "/missing/test.log"))),
+                 std::system_error);
+}
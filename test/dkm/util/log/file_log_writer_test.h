@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class FileLogWriterTest : public ::testing::Test {
+
+protected:
+
+    FileLogWriterTest(){}
+
+    virtual ~FileLogWriterTest(){}
+
+    // Each test gets its own scratch directory.
+    virtual void SetUp(){
+        mDir = makeTempDir();
+        mPath = mDir + "/test.log";
+    }
+
+    virtual void TearDown(){
+        removeTempDir(mDir);
+    }
+
+    std::string mDir;
+    std::string mPath;
+};
@@ -0,0 +1,55 @@
+/**
+ * json_layout_test.cpp
+ *
+ * Unit tests for the JsonLayout class.
+ */
+
+#include "dkm/util/log/json_layout_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_fields.h"
+
+using namespace dkm;
+
+// 2026-10-18T13:45:07.089Z
+static const long long TEST_TIME_MS = 1792331107089LL;
+
+static LogMessage testMessage()
+{
+    LogMessage message = makeLogMessage(LogLevel::WARN, "disk \"full\"", "dkm.io", 42);
+    message.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(TEST_TIME_MS));
+    message.threadId = 1234;
+    return message;
+}
+
+TEST_F(JsonLayoutTest, withoutFields){
+    // arrange
+    JsonLayout layout;
+    std::string out;
+
+    // act
+    layout.format(testMessage(), out);
+
+    // assert
+    ASSERT_EQ("{\"time\":\"2026-10-18T13:45:07.089Z\",\"level\":\"WARN\",\"logger\":\"dkm.io\","
+              "\"line\":42,\"thread\":1234,\"msg\":\"disk \\\"full\\\"\"}\n", out);
+}
+
+TEST_F(JsonLayoutTest, withFields){
+    // arrange
+    JsonLayout layout;
+    LogMessage message = testMessage();
+    LogField fields[] = { kv("free_mb", 12), kv("mount", "/var") };
+    LogFields::encode(fields, 2, message.fields);
+    std::string out;
+
+    // act
+    layout.format(message, out);
+
+    // assert
+    ASSERT_EQ("{\"time\":\"2026-10-18T13:45:07.089Z\",\"level\":\"WARN\",\"logger\":\"dkm.io\","
+              "\"line\":42,\"thread\":1234,\"msg\":\"disk \\\"full\\\"\","
+              "\"free_mb\":12,\"mount\":\"/var\"}\n", out);
+}
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/json_layout.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class JsonLayoutTest : public ::testing::Test {
+
+protected:
+
+    JsonLayoutTest(){}
+
+    virtual ~JsonLayoutTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
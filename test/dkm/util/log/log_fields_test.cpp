@@ -0,0 +1,197 @@
+/**
+ * log_fields_test.cpp
+ *
+ * Unit tests for structured log fields: encoding, logfmt and JSON
+ * output, and logging with fields through a Logger.
+ */
+
+#include "dkm/util/log/log_fields_test.h"
+
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/logger.h"
+#include "dkm/util/log/logging.h"
+
+using namespace dkm;
+
+static std::string encode(const LogField* fields, size_t count)
+{
+    std::string encoded;
+    LogFields::encode(fields, count, encoded);
+    return encoded;
+}
+
+static std::string logfmt(const std::string& encoded)
+{
+    std::string out;
+    LogFields::appendLogfmt(encoded, out);
+    return out;
+}
+
+static std::string json(const std::string& encoded)
+{
+    std::string out;
+    LogFields::appendJson(encoded, out);
+    return out;
+}
+
+TEST_F(LogFieldsTest, reader_roundTripsEachType){
+    // arrange
+    std::string text("with\0nul", 8);
+    LogField fields[] = {
+        kv("i", std::numeric_limits<long long>::min()),
+        kv("u", std::numeric_limits<unsigned long long>::max()),
+        kv("d", 0.1),
+        kv("b", true),
+        kv("s", text)
+    };
+    std::string encoded = encode(fields, 5);
+
+    // act
+    LogFields::Reader reader(encoded);
+    LogField read[5];
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(reader.next(read[i]));
+    }
+
+    // assert
+    ASSERT_FALSE(reader.next(read[0]));
+
+    ASSERT_EQ(LogFieldType::INT, read[0].type);
+    ASSERT_EQ("i", std::string(read[0].name, read[0].nameLength));
+    ASSERT_EQ(std::numeric_limits<long long>::min(), read[0].value.i);
+    ASSERT_EQ(LogFieldType::UINT, read[1].type);
+    ASSERT_EQ(std::numeric_limits<unsigned long long>::max(), read[1].value.u);
+    ASSERT_EQ(LogFieldType::DOUBLE, read[2].type);
+    ASSERT_EQ(0.1, read[2].value.d);
+    ASSERT_EQ(LogFieldType::BOOL, read[3].type);
+    ASSERT_TRUE(read[3].value.b);
+    ASSERT_EQ(LogFieldType::STRING, read[4].type);
+    ASSERT_EQ(text, std::string(read[4].str, read[4].strLength));
+}
+
+TEST_F(LogFieldsTest, encode_smallIntsAreCompact){
+    // arrange
+    LogField field = kv("n", -3);
+
+    // act
+    std::string encoded = encode(&field, 1);
+
+    // assert
+    // type, name length, name, one varint byte
+    ASSERT_EQ(4u, encoded.size());
+}
+
+TEST_F(LogFieldsTest, reader_stopsOnTruncatedBuffer){
+    // arrange
+    LogField field = kv("path", "/some/where");
+    std::string encoded = encode(&field, 1);
+    encoded.resize(encoded.size() - 1);
+
+    // act
+    LogFields::Reader reader(encoded);
+    LogField read;
+
+    // assert
+    ASSERT_FALSE(reader.next(read));
+}
+
+TEST_F(LogFieldsTest, logfmt){
+    // arrange
+    LogField fields[] = {
+        kv("lat_us", 123),
+        kv("ratio", 0.25),
+        kv("ok", false),
+        kv("path", "/x"),
+        kv("msg", "two words"),
+        kv("empty", ""),
+        kv("bad key", 1)
+    };
+
+    // act
+    std::string result = logfmt(encode(fields, 7));
+
+    // assert
+    ASSERT_EQ(" lat_us=123 ratio=0.25 ok=false path=/x msg=\"two words\" empty=\"\" bad_key=1",
+              result);
+}
+
+TEST_F(LogFieldsTest, nullString){
+    // arrange
+    const char* value = NULL;
+    LogField field = kv("s", value);
+
+    // act
+    std::string result = logfmt(encode(&field, 1));
+
+    // assert
+    ASSERT_EQ(" s=(null)", result);
+}
+
+TEST_F(LogFieldsTest, json){
+    // arrange
+    LogField fields[] = {
+        kv("lat_us", 123u),
+        kv("delta", -5),
+        kv("ok", true),
+        kv("path", "a\"b\\c\n\x01"),
+        kv("nan", std::numeric_limits<double>::quiet_NaN())
+    };
+
+    // act
+    std::string result = json(encode(fields, 5));
+
+    // assert
+    ASSERT_EQ(",\"lat_us\":123,\"delta\":-5,\"ok\":true,\"path\":\"a\\\"b\\\\c\\n\\u0001\",\"nan\":null",
+              result);
+}
+
+TEST_F(LogFieldsTest, appendDouble_shortestRoundTrip){
+    // arrange
+    std::string a, b, c, d, e;
+
+    // act
+    LogFields::appendDouble(0.1, a);
+    LogFields::appendDouble(1.0 / 3.0, b);
+    LogFields::appendDouble(1e21, c);
+    LogFields::appendDouble(-12.005, d);
+    LogFields::appendDouble(-0.0, e);
+
+    // assert
+    ASSERT_EQ("0.1", a);
+    ASSERT_EQ(1.0 / 3.0, strtod(b.c_str(), nullptr));
+    ASSERT_EQ("1e+21", c);
+    ASSERT_EQ("-12.005", d);
+    ASSERT_EQ("-0", e);
+}
+
+TEST_F(LogFieldsTest, logger){
+    // arrange
+    Logging& logging = Logging::getInstance();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+    Logger logger("dkm.log_fields_test");
+    logger.setLogLevel(LogLevel::INFO);
+    std::string path = "/index.html";
+
+    // act
+    logger.info("request done", kv("lat_us", 123), kv("path", path));
+    logger.debug("not logged", kv("x", 1));
+    DKM_LOG_WARN(logger, "slow", kv("lat_us", 9000));
+    logger.info("plain %d", 5);
+
+    // assert
+    logging.unregisterLogWriter(&writer);
+
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(3u, messages.size());
+    ASSERT_EQ("request done", messages[0].message);
+    ASSERT_EQ(" lat_us=123 path=/index.html", logfmt(messages[0].fields));
+    ASSERT_EQ(LogLevel::WARN, messages[1].logLevel);
+    ASSERT_GT(messages[1].lineNum, 0);
+    ASSERT_EQ(" lat_us=9000", logfmt(messages[1].fields));
+    ASSERT_EQ("plain 5", messages[2].message);
+    ASSERT_TRUE(messages[2].fields.empty());
+}
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_fields.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class LogFieldsTest : public ::testing::Test {
+
+protected:
+
+    LogFieldsTest(){}
+
+    virtual ~LogFieldsTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
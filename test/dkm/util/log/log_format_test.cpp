@@ -0,0 +1,141 @@
+/**
+ * log_format_test.cpp
+ *
+ * Unit tests for compile-time checked log formats. Each test
+ * compares against snprintf with the same format and arguments.
+ */
+
+#include "dkm/util/log/log_format_test.h"
+
+#include <limits.h>
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/logging.h"
+
+using namespace dkm;
+
+#define EXPECT_FORMAT_MATCHES(fmt, ...) \
+    do { \
+        char expected[512]; \
+        snprintf(expected, sizeof(expected), fmt, ##__VA_ARGS__); \
+        std::string actual; \
+        DKM_FORMAT(actual, fmt, ##__VA_ARGS__); \
+        EXPECT_EQ(std::string(expected), actual); \
+    } while (0)
+
+TEST_F(LogFormatTest, parse){
+    // arrange
+    const char* fmt = "a%db%%c%5.2fd";
+
+    // act/assert
+    ASSERT_TRUE(LogFormat::isValid(fmt));
+    ASSERT_EQ(2u, LogFormat::argCount(fmt));
+    ASSERT_EQ(5u, LogFormat::literalLength(fmt));
+
+    ASSERT_EQ(LogFormat::OpKind::SIGNED, LogFormat::opKind(fmt, 0));
+    ASSERT_EQ(LogFormat::OpKind::PERCENT, LogFormat::opKind(fmt, 1));
+    ASSERT_EQ(LogFormat::OpKind::FLOAT, LogFormat::opKind(fmt, 2));
+    ASSERT_EQ(LogFormat::OpKind::END, LogFormat::opKind(fmt, 3));
+
+    ASSERT_EQ(3u, LogFormat::opBegin(fmt, 1));
+    ASSERT_EQ(7u, LogFormat::opSpec(fmt, 2));
+    ASSERT_EQ(12u, LogFormat::opBegin(fmt, 3));
+}
+
+TEST_F(LogFormatTest, parse_rejectsUnsupportedSpecs){
+    // act/assert
+    ASSERT_FALSE(LogFormat::isValid("%5d"));
+    ASSERT_FALSE(LogFormat::isValid("%-s"));
+    ASSERT_FALSE(LogFormat::isValid("%n"));
+    ASSERT_FALSE(LogFormat::isValid("trailing %"));
+    ASSERT_TRUE(LogFormat::isValid("%lld %zu %lx"));
+}
+
+TEST_F(LogFormatTest, literalOnly){
+    EXPECT_FORMAT_MATCHES("no conversions here");
+    EXPECT_FORMAT_MATCHES("100%% done");
+}
+
+TEST_F(LogFormatTest, emptyFormat){
+    // arrange
+    std::string actual("kept");
+
+    // act
+    DKM_FORMAT(actual, "");
+
+    // assert
+    ASSERT_EQ("kept", actual);
+}
+
+TEST_F(LogFormatTest, integers){
+    EXPECT_FORMAT_MATCHES("%d", 0);
+    EXPECT_FORMAT_MATCHES("%d %i", -7, 42);
+    EXPECT_FORMAT_MATCHES("%d", INT_MIN);
+    EXPECT_FORMAT_MATCHES("%lld", LLONG_MIN);
+    EXPECT_FORMAT_MATCHES("%lld", LLONG_MAX);
+    EXPECT_FORMAT_MATCHES("%u", 4000000000u);
+    EXPECT_FORMAT_MATCHES("%llu", ULLONG_MAX);
+    EXPECT_FORMAT_MATCHES("%zu", sizeof(double));
+    EXPECT_FORMAT_MATCHES("%x %X", 0xbeefu, 0xbeefu);
+    EXPECT_FORMAT_MATCHES("%x", -1);
+    EXPECT_FORMAT_MATCHES("%hd", static_cast<short>(-300));
+}
+
+TEST_F(LogFormatTest, decimalDigitCounts){
+    unsigned long long value = 1;
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_FORMAT_MATCHES("%llu", value);
+        EXPECT_FORMAT_MATCHES("%llu", value - 1);
+        value *= 10;
+    }
+}
+
+TEST_F(LogFormatTest, strings){
+    const char* cstr = "abc";
+    std::string str("def");
+    char array[] = "ghi";
+
+    std::string actual;
+    DKM_FORMAT(actual, "[%s|%s|%s|%c]", cstr, str, array, 'j');
+
+    ASSERT_EQ("[abc|def|ghi|j]", actual);
+}
+
+TEST_F(LogFormatTest, floats){
+    EXPECT_FORMAT_MATCHES("%f", 1.5);
+    EXPECT_FORMAT_MATCHES("%.3f|%8.2e|%-10g|", 3.14159, 12345.678, 0.5f);
+    EXPECT_FORMAT_MATCHES("%f", 1e300);
+}
+
+TEST_F(LogFormatTest, pointers){
+    int value = 0;
+    EXPECT_FORMAT_MATCHES("%p", static_cast<void*>(&value));
+    EXPECT_FORMAT_MATCHES("%p", static_cast<void*>(NULL));
+}
+
+TEST_F(LogFormatTest, logger){
+    // arrange
+    Logging& logging = Logging::getInstance();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+    Logger logger("dkm.log_format_test");
+    logger.setLogLevel(LogLevel::INFO);
+
+    // act
+    DKM_LOGF_INFO(logger, "count=%d name=%s", 3, "x");
+    DKM_LOGF_DEBUG(logger, "not logged %d", 4);
+    DKM_LOGF_WARN(logger, "plain");
+
+    // assert
+    logging.unregisterLogWriter(&writer);
+
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(2u, messages.size());
+    ASSERT_EQ("count=3 name=x", messages[0].message);
+    ASSERT_EQ(LogLevel::INFO, messages[0].logLevel);
+    ASSERT_EQ("dkm.log_format_test", messages[0].loggerName);
+    ASSERT_GT(messages[0].lineNum, 0);
+    ASSERT_EQ("plain", messages[1].message);
+}
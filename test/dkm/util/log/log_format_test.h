@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_format.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class LogFormatTest : public ::testing::Test {
+
+protected:
+
+    LogFormatTest(){}
+
+    virtual ~LogFormatTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
@@ -0,0 +1,152 @@
+/**
+ * log_frame_test.cpp
+ *
+ * Unit tests for the LogFrame functions and the LogFrameReader class.
+ */
+
+#include "dkm/util/log/log_frame_test.h"
+
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_frame.h"
+
+using namespace dkm;
+
+TEST_F(LogFrameTest, header_roundTrip){
+    // arrange
+    LogFrameHeader header;
+    header.codec = LogFrameCodec::LZ;
+    header.decodedLength = 100000;
+    header.payloadLength = 1234;
+    header.firstTime = 1792331107089000LL;
+    header.lastTime = -5;
+    char buf[LogFrame::HEADER_SIZE];
+
+    // act
+    LogFrame::encodeHeader(header, buf);
+    LogFrameHeader decoded;
+    bool valid = LogFrame::decodeHeader(buf, decoded);
+
+    // assert
+    ASSERT_TRUE(valid);
+    ASSERT_EQ(LogFrameCodec::LZ, decoded.codec);
+    ASSERT_EQ(100000u, decoded.decodedLength);
+    ASSERT_EQ(1234u, decoded.payloadLength);
+    ASSERT_EQ(1792331107089000LL, decoded.firstTime);
+    ASSERT_EQ(-5, decoded.lastTime);
+}
+
+TEST_F(LogFrameTest, header_badMagic){
+    // arrange
+    char buf[LogFrame::HEADER_SIZE] = "plain text log line\n";
+    LogFrameHeader header;
+
+    // act/assert
+    ASSERT_FALSE(LogFrame::decodeHeader(buf, header));
+}
+
+TEST_F(LogFrameTest, header_decodedLengthTooLarge){
+    // arrange
+    LogFrameHeader header;
+    header.codec = LogFrameCodec::LZ;
+    header.decodedLength = 0xffffffffu;
+    header.payloadLength = 16;
+    header.firstTime = 1;
+    header.lastTime = 2;
+    char buf[LogFrame::HEADER_SIZE];
+    LogFrame::encodeHeader(header, buf);
+
+    // act/assert
+    LogFrameHeader decoded;
+    ASSERT_FALSE(LogFrame::decodeHeader(buf, decoded));
+}
+
+TEST_F(LogFrameTest, appendFrame_storesIncompressibleTextAsIs){
+    // arrange
+    std::string frames;
+
+    // act
+    LogFrame::appendFrame("abc", 3, 1, 2, LogFrameCodec::LZ, frames);
+
+    // assert
+    LogFrameHeader header;
+    ASSERT_EQ(LogFrame::HEADER_SIZE + 3, frames.size());
+    ASSERT_TRUE(LogFrame::decodeHeader(frames.data(), header));
+    ASSERT_EQ(LogFrameCodec::NONE, header.codec);
+    ASSERT_EQ("abc", frames.substr(LogFrame::HEADER_SIZE));
+}
+
+TEST_F(LogFrameTest, reader_readsAndSeeks){
+    // arrange
+    std::string frames;
+    std::string text[3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 50; ++j) {
+            text[i] += "frame " + std::to_string(i) + " line " + std::to_string(j) + "\n";
+        }
+        LogFrame::appendFrame(text[i].data(), text[i].size(), i * 100, i * 100 + 50,
+                              LogFrameCodec::LZ, frames);
+    }
+    writeTestFile(frames);
+
+    LogFrameReader reader(mPath);
+    LogFrameHeader header;
+    uint64_t offset;
+    std::string out;
+
+    // act
+    reader.seek(160);
+
+    // assert
+    ASSERT_TRUE(reader.nextHeader(header, offset));
+    ASSERT_EQ(LogFrameCodec::LZ, header.codec);
+    ASSERT_EQ(200, header.firstTime);
+    ASSERT_TRUE(reader.readPayload(out));
+    ASSERT_EQ(text[2], out);
+    ASSERT_FALSE(reader.nextHeader(header, offset));
+}
+
+TEST_F(LogFrameTest, reader_skipsUnreadPayloads){
+    // arrange
+    std::string frames;
+    LogFrame::appendFrame("first\n", 6, 1, 1, LogFrameCodec::NONE, frames);
+    LogFrame::appendFrame("second\n", 7, 2, 2, LogFrameCodec::NONE, frames);
+    writeTestFile(frames);
+
+    LogFrameReader reader(mPath);
+    LogFrameHeader header;
+    uint64_t offset;
+    std::string out;
+
+    // act
+    ASSERT_TRUE(reader.nextHeader(header, offset));
+    ASSERT_TRUE(reader.nextHeader(header, offset));
+    ASSERT_TRUE(reader.readPayload(out));
+
+    // assert
+    ASSERT_EQ(LogFrame::HEADER_SIZE + 6, offset);
+    ASSERT_EQ("second\n", out);
+}
+
+TEST_F(LogFrameTest, reader_stopsAtTruncatedFrame){
+    // arrange
+    std::string frames;
+    LogFrame::appendFrame("complete\n", 9, 1, 1, LogFrameCodec::NONE, frames);
+    LogFrame::appendFrame("partial\n", 8, 2, 2, LogFrameCodec::NONE, frames);
+    frames.resize(frames.size() - 3);
+    writeTestFile(frames);
+
+    LogFrameReader reader(mPath);
+    LogFrameHeader header;
+    uint64_t offset;
+
+    // act/assert
+    ASSERT_TRUE(reader.nextHeader(header, offset));
+    ASSERT_FALSE(reader.nextHeader(header, offset));
+}
+
+TEST_F(LogFrameTest, reader_invalidPath){
+    ASSERT_THROW(LogFrameReader(mDir + "/missing"), std::system_error);
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class LogFrameTest : public ::testing::Test {
+
+protected:
+
+    LogFrameTest(){}
+
+    virtual ~LogFrameTest(){}
+
+    // Each test gets its own scratch directory.
+    virtual void SetUp(){
+        mDir = makeTempDir();
+        mPath = mDir + "/test.log.lz";
+    }
+
+    virtual void TearDown(){
+        removeTempDir(mDir);
+    }
+
+    // Writes data to the test file, replacing anything there.
+    void writeTestFile(const std::string& data){
+        std::ofstream out(mPath.c_str(), std::ios::binary | std::ios::trunc);
+        out << data;
+    }
+
+    std::string mDir;
+    std::string mPath;
+};
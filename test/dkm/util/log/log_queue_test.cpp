@@ -0,0 +1,217 @@
+/**
+ * log_queue_test.cpp
+ *
+ * Unit tests for the LogQueue class and its backpressure policies.
+ */
+
+#include "dkm/util/log/log_queue_test.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace dkm;
+
+static LogMessagePtr msg(LogLevel level, const std::string& text)
+{
+    return std::make_shared<LogMessage>(makeLogMessage(level, text));
+}
+
+static std::vector<std::string> drain(LogQueue& queue)
+{
+    std::vector<LogMessagePtr> messages;
+    queue.popAll(messages, std::chrono::milliseconds(0));
+    queue.markDone(messages.size());
+
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        texts.push_back(messages[i]->message);
+    }
+    return texts;
+}
+
+static BackpressureConfig policy(BackpressurePolicy value)
+{
+    BackpressureConfig config;
+    config.policy = value;
+    config.blockTimeout = std::chrono::milliseconds(20);
+    return config;
+}
+
+TEST_F(LogQueueTest, pushAndPop){
+    // arrange
+    LogQueue queue(4);
+
+    // act
+    ASSERT_EQ(LogQueue::PushResult::QUEUED, queue.push(msg(LogLevel::INFO, "a")));
+    ASSERT_EQ(LogQueue::PushResult::QUEUED, queue.push(msg(LogLevel::INFO, "b")));
+
+    // assert
+    ASSERT_EQ(2u, queue.size());
+    std::vector<std::string> texts = drain(queue);
+    ASSERT_EQ(2u, texts.size());
+    ASSERT_EQ("a", texts[0]);
+    ASSERT_EQ("b", texts[1]);
+    ASSERT_EQ(0u, queue.size());
+}
+
+TEST_F(LogQueueTest, dropNewest){
+    // arrange
+    LogQueue queue(2, policy(BackpressurePolicy::DROP_NEWEST));
+    queue.push(msg(LogLevel::INFO, "a"));
+    queue.push(msg(LogLevel::INFO, "b"));
+
+    // act
+    LogQueue::PushResult result = queue.push(msg(LogLevel::ERROR, "c"));
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::DROPPED, result);
+    ASSERT_EQ(1u, queue.getDropped());
+    std::vector<std::string> texts = drain(queue);
+    ASSERT_EQ(2u, texts.size());
+    ASSERT_EQ("a", texts[0]);
+    ASSERT_EQ("b", texts[1]);
+}
+
+TEST_F(LogQueueTest, dropOldest){
+    // arrange
+    LogQueue queue(2, policy(BackpressurePolicy::DROP_OLDEST));
+    queue.push(msg(LogLevel::INFO, "a"));
+    queue.push(msg(LogLevel::INFO, "b"));
+
+    // act
+    LogQueue::PushResult result = queue.push(msg(LogLevel::INFO, "c"));
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::QUEUED_WITH_DROP, result);
+    ASSERT_EQ(1u, queue.getDropped());
+    std::vector<std::string> texts = drain(queue);
+    ASSERT_EQ(2u, texts.size());
+    ASSERT_EQ("b", texts[0]);
+    ASSERT_EQ("c", texts[1]);
+}
+
+TEST_F(LogQueueTest, dropByLevel_shedsLowSeverity){
+    // arrange
+    BackpressureConfig config = policy(BackpressurePolicy::DROP_BY_LEVEL);
+    config.shedLevel = LogLevel::DEBUG;
+    LogQueue queue(2, config);
+    queue.push(msg(LogLevel::WARN, "a"));
+    queue.push(msg(LogLevel::WARN, "b"));
+
+    // act
+    LogQueue::PushResult result = queue.push(msg(LogLevel::TRACE, "c"));
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::DROPPED, result);
+    ASSERT_EQ(1u, queue.getDropped());
+}
+
+TEST_F(LogQueueTest, dropByLevel_evictsLowSeverity){
+    // arrange
+    BackpressureConfig config = policy(BackpressurePolicy::DROP_BY_LEVEL);
+    config.shedLevel = LogLevel::DEBUG;
+    LogQueue queue(3, config);
+    queue.push(msg(LogLevel::WARN, "a"));
+    queue.push(msg(LogLevel::DEBUG, "b"));
+    queue.push(msg(LogLevel::INFO, "c"));
+
+    // act
+    LogQueue::PushResult result = queue.push(msg(LogLevel::ERROR, "d"));
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::QUEUED_WITH_DROP, result);
+    std::vector<std::string> texts = drain(queue);
+    ASSERT_EQ(3u, texts.size());
+    ASSERT_EQ("a", texts[0]);
+    ASSERT_EQ("c", texts[1]);
+    ASSERT_EQ("d", texts[2]);
+}
+
+TEST_F(LogQueueTest, dropByLevel_blocksWhenNothingToShed){
+    // arrange
+    BackpressureConfig config = policy(BackpressurePolicy::DROP_BY_LEVEL);
+    config.shedLevel = LogLevel::DEBUG;
+    LogQueue queue(1, config);
+    queue.push(msg(LogLevel::ERROR, "a"));
+
+    // act
+    LogQueue::PushResult result = queue.push(msg(LogLevel::ERROR, "b"));
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::DROPPED, result);
+    ASSERT_EQ(1u, queue.getDropped());
+}
+
+TEST_F(LogQueueTest, block_timesOut){
+    // arrange
+    LogQueue queue(1, policy(BackpressurePolicy::BLOCK));
+    queue.push(msg(LogLevel::INFO, "a"));
+
+    // act
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LogQueue::PushResult result = queue.push(msg(LogLevel::INFO, "b"));
+    std::chrono::steady_clock::duration waited = std::chrono::steady_clock::now() - start;
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::DROPPED, result);
+    ASSERT_GE(waited, std::chrono::milliseconds(20));
+}
+
+TEST_F(LogQueueTest, block_waitsForSpace){
+    // arrange
+    BackpressureConfig config = policy(BackpressurePolicy::BLOCK);
+    config.blockTimeout = std::chrono::milliseconds(0);
+    LogQueue queue(1, config);
+    queue.push(msg(LogLevel::INFO, "a"));
+
+    // act
+    std::thread consumer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        drain(queue);
+    });
+    LogQueue::PushResult result = queue.push(msg(LogLevel::INFO, "b"));
+    consumer.join();
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::QUEUED, result);
+    ASSERT_EQ(0u, queue.getDropped());
+    ASSERT_EQ(1u, queue.size());
+}
+
+TEST_F(LogQueueTest, close){
+    // arrange
+    LogQueue queue(4);
+    queue.push(msg(LogLevel::INFO, "a"));
+
+    // act
+    queue.close();
+
+    // assert
+    ASSERT_EQ(LogQueue::PushResult::CLOSED, queue.push(msg(LogLevel::INFO, "b")));
+
+    std::vector<LogMessagePtr> messages;
+    ASSERT_TRUE(queue.popAll(messages, std::chrono::milliseconds(0)));
+    ASSERT_EQ(1u, messages.size());
+    ASSERT_FALSE(queue.popAll(messages, std::chrono::milliseconds(0)));
+}
+
+TEST_F(LogQueueTest, waitUntilDone){
+    // arrange
+    LogQueue queue(4, policy(BackpressurePolicy::DROP_NEWEST));
+    for (int i = 0; i < 6; ++i) {
+        queue.push(msg(LogLevel::INFO, "x"));
+    }
+
+    // act
+    std::thread consumer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        drain(queue);
+    });
+    queue.waitUntilDone();
+    consumer.join();
+
+    // assert
+    ASSERT_EQ(0u, queue.size());
+    ASSERT_EQ(2u, queue.getDropped());
+}
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_queue.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class LogQueueTest : public ::testing::Test {
+
+protected:
+
+    LogQueueTest(){}
+
+    virtual ~LogQueueTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
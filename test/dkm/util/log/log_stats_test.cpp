@@ -0,0 +1,177 @@
+/**
+ * log_stats_test.cpp
+ *
+ * Unit tests for the logging stats: LatencyHistogram, the per-thread
+ * counters, and the Logging stats surface.
+ */
+
+#include "dkm/util/log/log_stats_test.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_stats.h"
+
+using namespace dkm;
+
+TEST_F(LogStatsTest, histogram_empty){
+    // act
+    LatencySnapshot snapshot = LatencyHistogram().snapshot();
+
+    // assert
+    ASSERT_EQ(0u, snapshot.count);
+    ASSERT_EQ(0u, snapshot.percentileNs(50));
+    ASSERT_EQ(0.0, snapshot.meanNs());
+}
+
+TEST_F(LogStatsTest, histogram_record){
+    // arrange
+    LatencyHistogram histogram;
+
+    // act
+    for (int i = 0; i < 99; ++i) {
+        histogram.record(100);
+    }
+    histogram.record(10000);
+
+    // assert
+    LatencySnapshot snapshot = histogram.snapshot();
+    ASSERT_EQ(100u, snapshot.count);
+    ASSERT_EQ(99u * 100 + 10000, snapshot.totalNs);
+    ASSERT_EQ(10000u, snapshot.maxNs);
+
+    // 100 is in the [64, 128) bucket
+    ASSERT_EQ(99u, snapshot.buckets[7]);
+    ASSERT_EQ(127u, snapshot.percentileNs(50));
+    ASSERT_EQ(127u, snapshot.percentileNs(99));
+    ASSERT_EQ(10000u, snapshot.percentileNs(100));
+}
+
+TEST_F(LogStatsTest, histogram_zero){
+    // arrange
+    LatencyHistogram histogram;
+
+    // act
+    histogram.record(0);
+
+    // assert
+    LatencySnapshot snapshot = histogram.snapshot();
+    ASSERT_EQ(1u, snapshot.buckets[0]);
+    ASSERT_EQ(0u, snapshot.percentileNs(50));
+}
+
+TEST_F(LogStatsTest, collector_aggregatesThreads){
+    // arrange
+    LogStatsCollector collector;
+    std::vector<std::thread> threads;
+
+    // act
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&collector] {
+            for (int i = 0; i < 1000; ++i) {
+                collector.countMessage(LogLevel::DEBUG);
+            }
+            collector.countDropped(5);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    collector.countMessage(LogLevel::ERROR);
+
+    // assert
+    LoggingStats stats;
+    collector.aggregate(stats);
+    ASSERT_EQ(4000u, stats.messages[static_cast<size_t>(LogLevel::DEBUG)]);
+    ASSERT_EQ(1u, stats.messages[static_cast<size_t>(LogLevel::ERROR)]);
+    ASSERT_EQ(4001u, stats.totalMessages());
+    ASSERT_EQ(20u, stats.dropped);
+}
+
+TEST_F(LogStatsTest, collector_separateInstances){
+    // arrange
+    LogStatsCollector a;
+    LogStatsCollector b;
+
+    // act
+    a.countMessage(LogLevel::INFO);
+    b.countMessage(LogLevel::INFO);
+    b.countMessage(LogLevel::INFO);
+
+    // assert
+    LoggingStats statsA;
+    a.aggregate(statsA);
+    LoggingStats statsB;
+    b.aggregate(statsB);
+    ASSERT_EQ(1u, statsA.totalMessages());
+    ASSERT_EQ(2u, statsB.totalMessages());
+}
+
+TEST_F(LogStatsTest, collector_alternatingInstances){
+    // arrange
+    // more collectors than a thread caches, so entries get replaced
+    const size_t count = LogStatsCollector::THREAD_CACHE_SIZE + 2;
+    std::vector<std::unique_ptr<LogStatsCollector> > collectors;
+    for (size_t i = 0; i < count; ++i) {
+        collectors.push_back(std::unique_ptr<LogStatsCollector>(new LogStatsCollector()));
+    }
+
+    // act
+    for (int round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                collectors[i]->countMessage(LogLevel::WARN);
+            }
+        }
+    }
+
+    // assert
+    for (size_t i = 0; i < count; ++i) {
+        LoggingStats stats;
+        collectors[i]->aggregate(stats);
+        ASSERT_EQ(3 * (i + 1), stats.totalMessages());
+    }
+}
+
+TEST_F(LogStatsTest, logging_getStats){
+    // arrange
+    Logging logging;
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    // act
+    logging.dispatchMessage(makeLogMessage(LogLevel::WARN, "a"));
+    logging.dispatchMessage(makeLogMessage(LogLevel::WARN, "b"));
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "c"));
+
+    // assert
+    LoggingStats stats = logging.getStats();
+    ASSERT_EQ(2u, stats.messages[static_cast<size_t>(LogLevel::WARN)]);
+    ASSERT_EQ(1u, stats.messages[static_cast<size_t>(LogLevel::INFO)]);
+    ASSERT_EQ(0u, stats.dropped);
+    ASSERT_EQ(3u, stats.dispatchLatency.count);
+    ASSERT_EQ(1u, stats.writers.size());
+    ASSERT_EQ("writer", stats.writers[0].name);
+    ASSERT_EQ(3u, stats.writers[0].writeLatency.count);
+}
+
+TEST_F(LogStatsTest, logging_dumpStats){
+    // arrange
+    Logging logging;
+    CapturingLogWriter writer;
+    CapturingLogWriter statsWriter;
+    logging.registerLogWriter(&writer);
+    logging.dispatchMessage(makeLogMessage(LogLevel::ERROR, "a"));
+
+    // act
+    logging.dumpStats(statsWriter);
+
+    // assert
+    std::vector<LogMessage> messages = statsWriter.messages();
+    ASSERT_EQ(4u, messages.size());
+    ASSERT_EQ("dkm.logging", messages[0].loggerName);
+    ASSERT_EQ("messages: ERROR=1 WARN=0 INFO=0 DEBUG=0 TRACE=0", messages[0].message);
+    ASSERT_EQ(0u, messages[3].message.find("writer writer: count=1 "));
+}
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/logging.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class LogStatsTest : public ::testing::Test {
+
+protected:
+
+    LogStatsTest(){}
+
+    virtual ~LogStatsTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
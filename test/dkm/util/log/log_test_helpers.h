@@ -0,0 +1,137 @@
+#ifndef _DKM_LOG_TEST_HELPERS_H_
+#define _DKM_LOG_TEST_HELPERS_H_
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dkm/util/log/defs.h"
+#include "dkm/util/log/log_writer.h"
+
+// Creates a fresh temporary directory and returns its path.
+inline std::string makeTempDir()
+{
+    char dir[] = "/tmp/dkm_test_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        abort();
+    }
+    return dir;
+}
+
+// Removes the given directory and every file directly inside it.
+inline void removeTempDir(const std::string& dir)
+{
+    DIR* d = opendir(dir.c_str());
+    if (d != NULL) {
+        struct dirent* entry;
+        while ((entry = readdir(d)) != NULL) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                unlink((dir + "/" + name).c_str());
+            }
+        }
+        closedir(d);
+    }
+    rmdir(dir.c_str());
+}
+
+// Returns the full contents of the given file, or an empty string if
+// it does not exist.
+inline std::string readFile(const std::string& path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+inline dkm::LogMessage makeLogMessage(dkm::LogLevel level, const std::string& text,
+                                      const std::string& loggerName = "test", int lineNum = 1)
+{
+    dkm::LogMessage message;
+    message.loggerName = loggerName;
+    message.lineNum = lineNum;
+    message.logLevel = level;
+    message.message = text;
+    return message;
+}
+
+// LogWriter that keeps a copy of every message it receives.
+class CapturingLogWriter : public dkm::LogWriter
+{
+public:
+    virtual void write(const dkm::LogMessage& message) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMessages.push_back(message);
+    }
+
+    // Not signal safe; only for tests that call emergencyFlush()
+    // directly.
+    virtual void emergencyWrite(const dkm::LogMessage& message) {
+        mEmergencyMessages.push_back(message);
+    }
+
+    std::vector<dkm::LogMessage> messages() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMessages;
+    }
+
+    const std::vector<dkm::LogMessage>& emergencyMessages() const {
+        return mEmergencyMessages;
+    }
+
+private:
+    std::mutex mMutex;
+    std::vector<dkm::LogMessage> mMessages;
+    std::vector<dkm::LogMessage> mEmergencyMessages;
+};
+
+// CapturingLogWriter that holds up every write() until release() is
+// called, for simulating a stalled destination.
+class BlockingLogWriter : public CapturingLogWriter
+{
+public:
+    BlockingLogWriter() : mReleased(false), mWaiting(0) { }
+
+    virtual void write(const dkm::LogMessage& message) {
+        {
+            std::unique_lock<std::mutex> lock(mGateMutex);
+            ++mWaiting;
+            while (!mReleased) {
+                mGate.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            --mWaiting;
+        }
+        CapturingLogWriter::write(message);
+    }
+
+    // Waits until a call to write() is blocked.
+    void waitForWriter() {
+        std::unique_lock<std::mutex> lock(mGateMutex);
+        while (mWaiting == 0) {
+            mGate.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mGateMutex);
+        mReleased = true;
+        mGate.notify_all();
+    }
+
+private:
+    std::mutex mGateMutex;
+    std::condition_variable mGate;
+    bool mReleased;
+    int mWaiting;
+};
+
+#endif
@@ -0,0 +1,493 @@
+/**
+ * logging_test.cpp
+ *
+ * Unit tests for message dispatch in the Logging class.
+ */
+
+#include "dkm/util/log/logging_test.h"
+
+#include <stdlib.h>
+
+#include <future>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/file_log_writer.h"
+
+using namespace dkm;
+
+static LoggingConfig asyncConfig(size_t capacity, BackpressurePolicy policy)
+{
+    LoggingConfig config;
+    config.async = true;
+    config.queueCapacity = capacity;
+    config.backpressure.policy = policy;
+    return config;
+}
+
+TEST_F(LoggingTest, sync_writesImmediately){
+    // arrange
+    Logging logging;
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    // act
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "a"));
+
+    // assert
+    ASSERT_EQ(1u, writer.messages().size());
+}
+
+TEST_F(LoggingTest, async_flush){
+    // arrange
+    Logging logging;
+    logging.configure(asyncConfig(1024, BackpressurePolicy::BLOCK));
+    logging.init();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    // act
+    for (int i = 0; i < 100; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+    logging.flush();
+
+    // assert
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(100u, messages.size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(std::to_string(i), messages[i].message);
+    }
+}
+
+TEST_F(LoggingTest, async_dropNewestWithStalledWriter){
+    // arrange
+    Logging logging;
+    logging.configure(asyncConfig(2, BackpressurePolicy::DROP_NEWEST));
+    logging.init();
+    BlockingLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    // the dispatcher takes the first message and stalls on it, then
+    // two more fill the queue
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    writer.waitForWriter();
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "1"));
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "2"));
+
+    // act
+    for (int i = 3; i < 10; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+
+    // assert
+    LoggingStats stats = logging.getStats();
+    ASSERT_EQ(7u, stats.dropped);
+    ASSERT_EQ(2u, stats.queueDepth);
+    ASSERT_EQ(10u, stats.totalMessages());
+
+    writer.release();
+    logging.flush();
+
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(3u, messages.size());
+    ASSERT_EQ("2", messages[2].message);
+}
+
+TEST_F(LoggingTest, async_dropByLevelKeepsErrors){
+    // arrange
+    Logging logging;
+    LoggingConfig config = asyncConfig(2, BackpressurePolicy::DROP_BY_LEVEL);
+    config.backpressure.shedLevel = LogLevel::DEBUG;
+    logging.configure(config);
+    logging.init();
+    BlockingLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "first"));
+    writer.waitForWriter();
+    logging.dispatchMessage(makeLogMessage(LogLevel::DEBUG, "debug1"));
+    logging.dispatchMessage(makeLogMessage(LogLevel::DEBUG, "debug2"));
+
+    // act
+    logging.dispatchMessage(makeLogMessage(LogLevel::TRACE, "trace"));
+    logging.dispatchMessage(makeLogMessage(LogLevel::ERROR, "error"));
+
+    // assert
+    writer.release();
+    logging.flush();
+
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(3u, messages.size());
+    ASSERT_EQ("first", messages[0].message);
+    ASSERT_EQ("debug2", messages[1].message);
+    ASSERT_EQ("error", messages[2].message);
+    ASSERT_EQ(2u, logging.getStats().dropped);
+}
+
+TEST_F(LoggingTest, async_multipleProducers){
+    // arrange
+    Logging logging;
+    logging.configure(asyncConfig(64, BackpressurePolicy::BLOCK));
+    logging.init();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+    std::vector<std::thread> threads;
+
+    // act
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&logging] {
+            for (int i = 0; i < 500; ++i) {
+                logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "x"));
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    logging.flush();
+
+    // assert
+    ASSERT_EQ(2000u, writer.messages().size());
+    ASSERT_EQ(0u, logging.getStats().dropped);
+}
+
+TEST_F(LoggingTest, configure_asyncToSyncDrainsQueue){
+    // arrange
+    Logging logging;
+    logging.configure(asyncConfig(1024, BackpressurePolicy::BLOCK));
+    logging.init();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+    for (int i = 0; i < 10; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "queued"));
+    }
+
+    // act
+    logging.configure(LoggingConfig());
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "sync"));
+
+    // assert
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(11u, messages.size());
+    ASSERT_EQ("sync", messages[10].message);
+}
+
+static LogWriterOptions queuedOptions(size_t capacity, BackpressurePolicy policy)
+{
+    LogWriterOptions options;
+    options.queued = true;
+    options.queueCapacity = capacity;
+    options.backpressure.policy = policy;
+    return options;
+}
+
+TEST_F(LoggingTest, queuedWriter_slowWriterDoesNotStallOthers){
+    // arrange
+    Logging logging;
+    BlockingLogWriter slow;
+    CapturingLogWriter fast;
+    logging.registerLogWriter(&slow, queuedOptions(4, BackpressurePolicy::DROP_NEWEST));
+    logging.registerLogWriter(&fast);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    slow.waitForWriter();
+
+    // act
+    for (int i = 1; i < 20; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+
+    // assert
+    ASSERT_EQ(20u, fast.messages().size());
+
+    LoggingStats stats = logging.getStats();
+    ASSERT_EQ(2u, stats.writers.size());
+    ASSERT_TRUE(stats.writers[0].queued);
+    ASSERT_EQ(15u, stats.writers[0].dropped);
+    ASSERT_EQ(4u, stats.writers[0].queueDepth);
+    ASSERT_FALSE(stats.writers[1].queued);
+    ASSERT_EQ(0u, stats.dropped);
+
+    slow.release();
+    logging.flush();
+
+    std::vector<LogMessage> messages = slow.messages();
+    ASSERT_EQ(5u, messages.size());
+    ASSERT_EQ("0", messages[0].message);
+    ASSERT_EQ("4", messages[4].message);
+}
+
+TEST_F(LoggingTest, queuedWriter_blockedPushDoesNotStallDirectWriters){
+    // arrange
+    Logging logging;
+    BlockingLogWriter slow;
+    CapturingLogWriter direct;
+    logging.registerLogWriter(&slow, queuedOptions(1, BackpressurePolicy::BLOCK));
+    logging.registerLogWriter(&direct);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    slow.waitForWriter();
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "1"));
+
+    // the queue is full, so this producer waits in push indefinitely
+    std::thread blocked([&logging] {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "2"));
+    });
+    while (direct.messages().size() < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // act
+    // this producer also ends up waiting on the full queue, but only
+    // after its direct write
+    std::thread other([&logging] {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "3"));
+    });
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (direct.messages().size() < 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    size_t written = direct.messages().size();
+
+    // assert
+    slow.release();
+    blocked.join();
+    other.join();
+    logging.flush();
+    ASSERT_EQ(4u, written);
+    ASSERT_EQ(4u, slow.messages().size());
+}
+
+TEST_F(LoggingTest, queuedWriter_flushDoesNotStallDirectWriters){
+    // arrange
+    Logging logging;
+    BlockingLogWriter slow;
+    CapturingLogWriter direct;
+    LogWriterOptions options;
+    options.queued = true;
+    logging.registerLogWriter(&slow, options);
+    logging.registerLogWriter(&direct);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    slow.waitForWriter();
+
+    // waits for the stalled writer's queue to drain
+    std::thread flusher([&logging] {
+        logging.flush();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // act
+    std::future<void> other = std::async(std::launch::async, [&logging] {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "1"));
+    });
+    std::future_status status = other.wait_for(std::chrono::seconds(5));
+
+    // assert
+    slow.release();
+    flusher.join();
+    other.wait();
+    logging.flush();
+    ASSERT_EQ(std::future_status::ready, status);
+    ASSERT_EQ(2u, direct.messages().size());
+}
+
+TEST_F(LoggingTest, queuedWriter_defaultsToDropNewest){
+    // arrange
+    LogWriterOptions options;
+    options.queued = true;
+    options.queueCapacity = 2;
+    Logging logging;
+    BlockingLogWriter slow;
+    logging.registerLogWriter(&slow, options);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    slow.waitForWriter();
+
+    // act
+    for (int i = 1; i < 10; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+
+    // assert
+    ASSERT_EQ(BackpressurePolicy::DROP_NEWEST, options.backpressure.policy);
+    ASSERT_EQ(7u, logging.getStats().writers[0].dropped);
+
+    slow.release();
+    logging.flush();
+    ASSERT_EQ(3u, slow.messages().size());
+}
+
+TEST_F(LoggingTest, queuedWriter_withAsyncDispatch){
+    // arrange
+    Logging logging;
+    logging.configure(asyncConfig(1024, BackpressurePolicy::BLOCK));
+    logging.init();
+    CapturingLogWriter queued;
+    CapturingLogWriter direct;
+    logging.registerLogWriter(&queued, queuedOptions(1024, BackpressurePolicy::BLOCK));
+    logging.registerLogWriter(&direct);
+
+    // act
+    for (int i = 0; i < 100; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+    logging.flush();
+
+    // assert
+    std::vector<LogMessage> messages = queued.messages();
+    ASSERT_EQ(100u, messages.size());
+    ASSERT_EQ(100u, direct.messages().size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(std::to_string(i), messages[i].message);
+    }
+}
+
+TEST_F(LoggingTest, queuedWriter_unregisterDrainsQueue){
+    // arrange
+    Logging logging;
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer, queuedOptions(1024, BackpressurePolicy::BLOCK));
+    for (int i = 0; i < 50; ++i) {
+        logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "x"));
+    }
+
+    // act
+    logging.unregisterLogWriter(&writer);
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "after"));
+
+    // assert
+    ASSERT_EQ(50u, writer.messages().size());
+    ASSERT_EQ(0u, logging.getStats().writers.size());
+}
+
+TEST_F(LoggingTest, shardedQueue_multipleProducers){
+    // arrange
+    Logging logging;
+    LoggingConfig config = asyncConfig(64, BackpressurePolicy::BLOCK);
+    config.shardedQueue = true;
+    logging.configure(config);
+    logging.init();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+    std::vector<std::thread> threads;
+
+    // act
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&logging] {
+            for (int i = 0; i < 500; ++i) {
+                logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "x"));
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    logging.flush();
+
+    // assert
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(2000u, messages.size());
+    ASSERT_EQ(0u, logging.getStats().dropped);
+}
+
+TEST_F(LoggingTest, shardedQueue_switchToShared){
+    // arrange
+    Logging logging;
+    LoggingConfig config = asyncConfig(1024, BackpressurePolicy::BLOCK);
+    config.shardedQueue = true;
+    logging.configure(config);
+    logging.init();
+    CapturingLogWriter writer;
+    logging.registerLogWriter(&writer);
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "sharded"));
+
+    // act
+    logging.configure(asyncConfig(1024, BackpressurePolicy::BLOCK));
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "shared"));
+    logging.flush();
+
+    // assert
+    std::vector<LogMessage> messages = writer.messages();
+    ASSERT_EQ(2u, messages.size());
+    ASSERT_EQ("sharded", messages[0].message);
+    ASSERT_EQ("shared", messages[1].message);
+}
+
+TEST_F(LoggingTest, emergencyFlush_drainsAsyncQueue){
+    // arrange
+    Logging logging;
+    logging.configure(asyncConfig(1024, BackpressurePolicy::BLOCK));
+    logging.init();
+    BlockingLogWriter writer;
+    logging.registerLogWriter(&writer);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    writer.waitForWriter();
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "1"));
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "2"));
+
+    // act
+    logging.emergencyFlush();
+
+    // assert
+    std::vector<LogMessage> messages = writer.emergencyMessages();
+    ASSERT_EQ(2u, messages.size());
+    ASSERT_EQ("1", messages[0].message);
+    ASSERT_EQ("2", messages[1].message);
+
+    writer.release();
+    logging.flush();
+}
+
+TEST_F(LoggingTest, emergencyFlush_drainsWriterQueue){
+    // arrange
+    Logging logging;
+    BlockingLogWriter slow;
+    CapturingLogWriter direct;
+    logging.registerLogWriter(&slow, queuedOptions(1024, BackpressurePolicy::BLOCK));
+    logging.registerLogWriter(&direct);
+
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "0"));
+    slow.waitForWriter();
+    logging.dispatchMessage(makeLogMessage(LogLevel::INFO, "1"));
+
+    // act
+    logging.emergencyFlush();
+
+    // assert
+    ASSERT_EQ(1u, slow.emergencyMessages().size());
+    ASSERT_EQ("1", slow.emergencyMessages()[0].message);
+    ASSERT_EQ(0u, direct.emergencyMessages().size());
+
+    slow.release();
+    logging.flush();
+}
+
+TEST_F(LoggingTest, installCrashHandler_flushesOnAbort){
+    // arrange
+    std::string dir = makeTempDir();
+    std::string path = dir + "/crash.log";
+
+    // act
+    ASSERT_DEATH({
+        FileLogWriterConfig config(path);
+        config.flushInterval = std::chrono::milliseconds(60 * 1000);
+
+        // leaked on purpose; the process dies with it in use
+        FileLogWriter* writer = new FileLogWriter(config);
+        Logging::getInstance().registerLogWriter(writer);
+        Logging::getInstance().dispatchMessage(makeLogMessage(LogLevel::ERROR, "dying", "c", 7));
+
+        Logging::installCrashHandler();
+        abort();
+    }, "");
+
+    // assert
+    std::string contents = readFile(path);
+    removeTempDir(dir);
+    ASSERT_EQ("[ERROR] c:7 - dying\n", contents);
+}
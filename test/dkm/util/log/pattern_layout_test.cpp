@@ -0,0 +1,141 @@
+/**
+ * pattern_layout_test.cpp
+ *
+ * Unit tests for the PatternLayout class.
+ */
+
+#include "dkm/util/log/pattern_layout_test.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/log_fields.h"
+
+using namespace dkm;
+
+// 2026-10-18T13:45:07.089Z
+static const long long TEST_TIME_MS = 1792331107089LL;
+
+static LogMessage testMessage()
+{
+    LogMessage message = makeLogMessage(LogLevel::WARN, "disk full", "dkm.io", 42);
+    message.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(TEST_TIME_MS));
+    message.threadId = 1234;
+    return message;
+}
+
+static std::string format(const PatternLayout& layout, const LogMessage& message)
+{
+    std::string out;
+    layout.format(message, out);
+    return out;
+}
+
+TEST_F(PatternLayoutTest, defaultPattern){
+    // arrange
+    PatternLayout layout;
+
+    // act
+    std::string result = format(layout, testMessage());
+
+    // assert
+    ASSERT_EQ("[WARN] dkm.io:42 - disk full\n", result);
+}
+
+TEST_F(PatternLayoutTest, allConversions){
+    // arrange
+    PatternLayout layout("%d{ISO8601} %p [%t] %c:%L - %m%% %n", true);
+
+    // act
+    std::string result = format(layout, testMessage());
+
+    // assert
+    ASSERT_EQ("2026-10-18T13:45:07.089Z WARN [1234] dkm.io:42 - disk full% \n", result);
+}
+
+TEST_F(PatternLayoutTest, fieldsAsLogfmt){
+    // arrange
+    PatternLayout layout("%m%K%n");
+    LogMessage withFields = testMessage();
+    LogField fields[] = { kv("free_mb", 12), kv("mount", "/var") };
+    LogFields::encode(fields, 2, withFields.fields);
+
+    // act/assert
+    ASSERT_EQ("disk full free_mb=12 mount=/var\n", format(layout, withFields));
+    ASSERT_EQ("disk full\n", format(layout, testMessage()));
+}
+
+TEST_F(PatternLayoutTest, dateStyles){
+    // arrange
+    PatternLayout absolute("%d{ABSOLUTE}", true);
+    PatternLayout unix("%d{UNIX}", true);
+    PatternLayout plain("%d", true);
+
+    // act/assert
+    ASSERT_EQ("13:45:07.089", format(absolute, testMessage()));
+    ASSERT_EQ("1792331107.089", format(unix, testMessage()));
+    ASSERT_EQ("2026-10-18T13:45:07.089Z", format(plain, testMessage()));
+}
+
+TEST_F(PatternLayoutTest, dateCacheTracksSeconds){
+    // arrange
+    PatternLayout layout("%d{ABSOLUTE}", true);
+    LogMessage message = testMessage();
+
+    // act/assert
+    ASSERT_EQ("13:45:07.089", format(layout, message));
+
+    message.timestamp += std::chrono::milliseconds(500);
+    ASSERT_EQ("13:45:07.589", format(layout, message));
+
+    message.timestamp += std::chrono::milliseconds(500);
+    ASSERT_EQ("13:45:08.089", format(layout, message));
+}
+
+TEST_F(PatternLayoutTest, padding){
+    // arrange
+    PatternLayout layout("|%-5p|%5p|%3m|%2L|");
+
+    // act
+    std::string result = format(layout, testMessage());
+
+    // assert
+    ASSERT_EQ("|WARN | WARN|disk full|42|", result);
+}
+
+TEST_F(PatternLayoutTest, sharedAcrossThreads){
+    // arrange
+    PatternLayout layout("%c %m");
+    LogMessage message = testMessage();
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches(0);
+
+    // act
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&] {
+            for (int i = 0; i < 1000; ++i) {
+                if (format(layout, message) != "dkm.io disk full") {
+                    ++mismatches;
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    // assert
+    ASSERT_EQ(0, mismatches.load());
+}
+
+TEST_F(PatternLayoutTest, invalidPatterns){
+    // act/assert
+    ASSERT_THROW(PatternLayout("%q"), std::invalid_argument);
+    ASSERT_THROW(PatternLayout("trailing %"), std::invalid_argument);
+    ASSERT_THROW(PatternLayout("%d{ISO8601"), std::invalid_argument);
+    ASSERT_THROW(PatternLayout("%d{NOPE}"), std::invalid_argument);
+}
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/pattern_layout.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class PatternLayoutTest : public ::testing::Test {
+
+protected:
+
+    PatternLayoutTest(){}
+
+    virtual ~PatternLayoutTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
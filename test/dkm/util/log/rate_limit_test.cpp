@@ -0,0 +1,236 @@
+/**
+ * rate_limit_test.cpp
+ *
+ * Unit tests for LogRateLimiter, LogSampler, and the call-site
+ * macros built on them.
+ */
+
+#include "dkm/util/log/rate_limit_test.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/logger.h"
+#include "dkm/util/log/rate_limit.h"
+
+using namespace dkm;
+
+const int64_t MS = 1000000LL;
+
+TEST_F(RateLimitTest, limiter_allowsLimitPerInterval){
+    // arrange
+    LogRateLimiter limiter(3, 100 * MS);
+    uint64_t suppressed = 99;
+    int allowed = 0;
+
+    // act
+    for (int i = 0; i < 10; ++i) {
+        if (limiter.acquire(10 * MS, suppressed)) {
+            ++allowed;
+        }
+    }
+
+    // assert
+    ASSERT_EQ(3, allowed);
+    ASSERT_EQ(0u, suppressed);
+    ASSERT_EQ(7u, limiter.getSuppressed());
+}
+
+TEST_F(RateLimitTest, limiter_newIntervalReportsSuppressed){
+    // arrange
+    LogRateLimiter limiter(1, 100 * MS);
+    uint64_t suppressed = 0;
+    ASSERT_TRUE(limiter.acquire(0, suppressed));
+    ASSERT_FALSE(limiter.acquire(50 * MS, suppressed));
+    ASSERT_FALSE(limiter.acquire(99 * MS, suppressed));
+
+    // act
+    bool allowed = limiter.acquire(100 * MS, suppressed);
+
+    // assert
+    ASSERT_TRUE(allowed);
+    ASSERT_EQ(2u, suppressed);
+    ASSERT_EQ(0u, limiter.getSuppressed());
+}
+
+TEST_F(RateLimitTest, limiter_rolloverReportsSuppressedWithZeroLimit){
+    // arrange
+    LogRateLimiter limiter(0, 100 * MS);
+    uint64_t suppressed = 99;
+    ASSERT_FALSE(limiter.acquire(0, suppressed));
+    ASSERT_FALSE(limiter.acquire(10 * MS, suppressed));
+    ASSERT_FALSE(limiter.acquire(20 * MS, suppressed));
+
+    // act
+    bool allowed = limiter.acquire(150 * MS, suppressed);
+
+    // assert
+    ASSERT_FALSE(allowed);
+    ASSERT_EQ(3u, suppressed);
+    ASSERT_EQ(1u, limiter.getSuppressed());
+}
+
+TEST_F(RateLimitTest, limiter_staleClockDoesNotResetInterval){
+    // arrange
+    LogRateLimiter limiter(1, 100 * MS);
+    uint64_t suppressed = 0;
+    ASSERT_TRUE(limiter.acquire(250 * MS, suppressed));
+
+    // act
+    // a caller that read the clock before the interval started
+    bool allowed = limiter.acquire(199 * MS, suppressed);
+
+    // assert
+    ASSERT_FALSE(allowed);
+    ASSERT_EQ(0u, suppressed);
+    ASSERT_EQ(1u, limiter.getSuppressed());
+}
+
+TEST_F(RateLimitTest, limiter_concurrentRolloverKeepsLimit){
+    // arrange
+    const int threadCount = 8;
+    const int callsPerThread = 10000;
+    const int64_t intervals = 20;
+    LogRateLimiter limiter(5, 100 * MS);
+    std::atomic<int> allowed(0);
+    std::atomic<uint64_t> reported(0);
+    std::vector<std::thread> threads;
+
+    // act
+    for (int t = 0; t < threadCount; ++t) {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < callsPerThread; ++i) {
+                uint64_t suppressed = 0;
+                int64_t now = (i * intervals / callsPerThread) * 100 * MS;
+                if (limiter.acquire(now, suppressed)) {
+                    ++allowed;
+                }
+                reported += suppressed;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    // assert
+    ASSERT_LE(allowed.load(), 5 * intervals);
+    ASSERT_EQ(threadCount * callsPerThread,
+              allowed.load() + reported.load() + limiter.getSuppressed());
+}
+
+TEST_F(RateLimitTest, sampler_one){
+    // arrange
+    LogSampler sampler(1);
+
+    // act/assert
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(sampler.acquire());
+    }
+    ASSERT_EQ(0u, sampler.getSuppressed());
+}
+
+TEST_F(RateLimitTest, sampler_approximateRate){
+    // arrange
+    LogSampler sampler(10);
+    int allowed = 0;
+
+    // act
+    for (int i = 0; i < 100000; ++i) {
+        if (sampler.acquire()) {
+            ++allowed;
+        }
+    }
+
+    // assert
+    ASSERT_NEAR(10000, allowed, 1000);
+    ASSERT_EQ(100000u - allowed, sampler.getSuppressed());
+}
+
+TEST_F(RateLimitTest, rateLimitedMacro){
+    // arrange
+    Logger logger("rateLimitedMacro");
+
+    // act
+    for (int i = 0; i < 20; ++i) {
+        DKM_LOG_RATE_LIMITED(logger, LogLevel::WARN, 2, 60 * 1000, "failure %d", i);
+    }
+
+    // assert
+    std::vector<LogMessage> messages = mWriter.messages();
+    ASSERT_EQ(2u, messages.size());
+    ASSERT_EQ("failure 0", messages[0].message);
+    ASSERT_EQ("failure 1", messages[1].message);
+    ASSERT_EQ(LogLevel::WARN, messages[1].logLevel);
+    ASSERT_EQ("rateLimitedMacro", messages[1].loggerName);
+}
+
+TEST_F(RateLimitTest, rateLimitedMacro_summary){
+    // arrange
+    Logger logger("rateLimitedMacro_summary");
+
+    // act
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            DKM_LOG_RATE_LIMITED(logger, LogLevel::ERROR, 1, 20, "round %d", i);
+        }
+        usleep(40 * 1000);
+    }
+
+    // assert
+    std::vector<LogMessage> messages = mWriter.messages();
+    ASSERT_EQ(3u, messages.size());
+    ASSERT_EQ("round 0", messages[0].message);
+    ASSERT_EQ("suppressed 4 messages", messages[1].message);
+    ASSERT_EQ("round 1", messages[2].message);
+}
+
+TEST_F(RateLimitTest, rateLimitedMacro_summaryOnRollover){
+    // arrange
+    Logger logger("rateLimitedMacro_summaryOnRollover");
+
+    // act
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            DKM_LOG_RATE_LIMITED(logger, LogLevel::ERROR, 0, 20, "never");
+        }
+        usleep(40 * 1000);
+    }
+
+    // assert
+    std::vector<LogMessage> messages = mWriter.messages();
+    ASSERT_EQ(1u, messages.size());
+    ASSERT_EQ("suppressed 3 messages", messages[0].message);
+}
+
+TEST_F(RateLimitTest, rateLimitedMacro_disabledLevel){
+    // arrange
+    Logger logger("rateLimitedMacro_disabledLevel");
+    logger.setLogLevel(LogLevel::WARN);
+
+    // act
+    for (int i = 0; i < 5; ++i) {
+        DKM_LOG_RATE_LIMITED(logger, LogLevel::DEBUG, 1, 1000, "hidden");
+    }
+
+    // assert
+    ASSERT_EQ(0u, mWriter.messages().size());
+}
+
+TEST_F(RateLimitTest, sampledMacro){
+    // arrange
+    Logger logger("sampledMacro");
+
+    // act
+    for (int i = 0; i < 1000; ++i) {
+        DKM_LOG_SAMPLED(logger, LogLevel::INFO, 1, "every %d", i);
+    }
+
+    // assert
+    ASSERT_EQ(1000u, mWriter.messages().size());
+}
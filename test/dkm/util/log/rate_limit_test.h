@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/logging.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class RateLimitTest : public ::testing::Test {
+
+protected:
+
+    RateLimitTest(){}
+
+    virtual ~RateLimitTest(){}
+
+    // Capture everything dispatched through the global Logging instance.
+    virtual void SetUp(){
+        dkm::Logging::getInstance().registerLogWriter(&mWriter);
+    }
+
+    virtual void TearDown(){
+        dkm::Logging::getInstance().unregisterLogWriter(&mWriter);
+    }
+
+    CapturingLogWriter mWriter;
+};
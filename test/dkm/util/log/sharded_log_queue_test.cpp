@@ -0,0 +1,206 @@
+/**
+ * sharded_log_queue_test.cpp
+ *
+ * Unit tests for the ShardedLogQueue class.
+ */
+
+#include "dkm/util/log/sharded_log_queue_test.h"
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace dkm;
+
+static LogMessagePtr msgAt(const std::string& text, int ms)
+{
+    LogMessage message = makeLogMessage(LogLevel::INFO, text);
+    message.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+    return std::make_shared<LogMessage>(message);
+}
+
+// Pushes each list of messages from its own thread. The threads are
+// kept alive until all of them have pushed so that none of them can
+// be given a recycled thread id, and with it another's shard.
+static void pushFromThreads(ShardedLogQueue& queue,
+                            const std::vector<std::vector<LogMessagePtr> >& lists)
+{
+    std::atomic<size_t> finished(0);
+    std::vector<std::thread> producers;
+
+    for (size_t t = 0; t < lists.size(); ++t) {
+        const std::vector<LogMessagePtr>& messages = lists[t];
+        producers.push_back(std::thread([&queue, &messages, &finished, &lists] {
+            for (size_t i = 0; i < messages.size(); ++i) {
+                queue.push(messages[i]);
+            }
+            ++finished;
+            while (finished.load() < lists.size()) {
+                std::this_thread::yield();
+            }
+        }));
+    }
+    for (size_t t = 0; t < producers.size(); ++t) {
+        producers[t].join();
+    }
+}
+
+TEST_F(ShardedLogQueueTest, popAll_mergesShardsByTimestamp){
+    // arrange
+    ShardedLogQueue queue(16);
+
+    std::vector<LogMessagePtr> first;
+    first.push_back(msgAt("a1", 1));
+    first.push_back(msgAt("a4", 4));
+    first.push_back(msgAt("a5", 5));
+
+    std::vector<LogMessagePtr> second;
+    second.push_back(msgAt("b2", 2));
+    second.push_back(msgAt("b6", 6));
+
+    std::vector<LogMessagePtr> third;
+    third.push_back(msgAt("c3", 3));
+
+    std::vector<std::vector<LogMessagePtr> > lists;
+    lists.push_back(first);
+    lists.push_back(second);
+    lists.push_back(third);
+    pushFromThreads(queue, lists);
+
+    // act
+    std::vector<LogMessagePtr> messages;
+    ASSERT_TRUE(queue.popAll(messages, std::chrono::milliseconds(0)));
+    queue.markDone(messages.size());
+
+    // assert
+    ASSERT_EQ(3u, queue.getShardCount());
+    ASSERT_EQ(6u, messages.size());
+    const char* expected[] = { "a1", "b2", "c3", "a4", "a5", "b6" };
+    for (size_t i = 0; i < messages.size(); ++i) {
+        ASSERT_EQ(expected[i], messages[i]->message);
+    }
+    ASSERT_EQ(0u, queue.size());
+}
+
+TEST_F(ShardedLogQueueTest, backpressureIsPerShard){
+    // arrange
+    BackpressureConfig config;
+    config.policy = BackpressurePolicy::DROP_NEWEST;
+    ShardedLogQueue queue(2, config);
+
+    std::vector<LogMessagePtr> messages;
+    for (int i = 0; i < 3; ++i) {
+        messages.push_back(msgAt("x", i));
+    }
+
+    // act
+    std::vector<std::vector<LogMessagePtr> > lists(2, messages);
+    pushFromThreads(queue, lists);
+
+    // assert
+    ASSERT_EQ(4u, queue.size());
+    ASSERT_EQ(2u, queue.getDropped());
+}
+
+TEST_F(ShardedLogQueueTest, popAll_wakesForNewShard){
+    // arrange
+    ShardedLogQueue queue(16);
+    std::vector<LogMessagePtr> messages;
+
+    // act
+    std::thread producer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.push(msgAt("late", 1));
+    });
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    queue.popAll(messages, std::chrono::milliseconds(5000));
+    std::chrono::steady_clock::duration waited = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    // assert
+    ASSERT_EQ(1u, messages.size());
+    ASSERT_LT(waited, std::chrono::milliseconds(2000));
+}
+
+TEST_F(ShardedLogQueueTest, waitUntilDone){
+    // arrange
+    ShardedLogQueue queue(1024);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.push_back(std::thread([&queue] {
+            for (int i = 0; i < 100; ++i) {
+                queue.push(msgAt("x", i));
+            }
+        }));
+    }
+    for (size_t t = 0; t < producers.size(); ++t) {
+        producers[t].join();
+    }
+
+    // act
+    size_t consumed = 0;
+    std::thread consumer([&queue, &consumed] {
+        std::vector<LogMessagePtr> messages;
+        while (queue.popAll(messages, std::chrono::milliseconds(10))) {
+            consumed += messages.size();
+            queue.markDone(messages.size());
+            messages.clear();
+        }
+    });
+    queue.waitUntilDone();
+    queue.close();
+    consumer.join();
+
+    // assert
+    ASSERT_EQ(400u, consumed);
+}
+
+TEST_F(ShardedLogQueueTest, close){
+    // arrange
+    ShardedLogQueue queue(4);
+    queue.push(msgAt("a", 1));
+
+    // act
+    queue.close();
+
+    // assert
+    ASSERT_EQ(LogMessageQueue::PushResult::CLOSED, queue.push(msgAt("b", 2)));
+
+    std::vector<LogMessagePtr> messages;
+    ASSERT_TRUE(queue.popAll(messages, std::chrono::milliseconds(0)));
+    queue.markDone(messages.size());
+    ASSERT_EQ(1u, messages.size());
+    ASSERT_FALSE(queue.popAll(messages, std::chrono::milliseconds(0)));
+}
+
+TEST_F(ShardedLogQueueTest, close_keepsMessagesPushedBeforeClose){
+    for (int round = 0; round < 50; ++round) {
+        // arrange
+        ShardedLogQueue queue(1024);
+        size_t accepted = 0;
+        std::thread producer([&queue, &accepted] {
+            while (queue.push(msgAt("x", 1)) == LogMessageQueue::PushResult::QUEUED) {
+                ++accepted;
+            }
+        });
+        size_t consumed = 0;
+        std::thread consumer([&queue, &consumed] {
+            std::vector<LogMessagePtr> messages;
+            while (queue.popAll(messages, std::chrono::milliseconds(1))) {
+                consumed += messages.size();
+                queue.markDone(messages.size());
+                messages.clear();
+            }
+        });
+
+        // act
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        queue.close();
+        producer.join();
+        consumer.join();
+
+        // assert
+        ASSERT_EQ(accepted, consumed);
+    }
+}
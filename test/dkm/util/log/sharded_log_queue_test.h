@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/sharded_log_queue.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class ShardedLogQueueTest : public ::testing::Test {
+
+protected:
+
+    ShardedLogQueueTest(){}
+
+    virtual ~ShardedLogQueueTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
@@ -0,0 +1,270 @@
+/**
+ * shm_log_writer_test.cpp
+ *
+ * Unit tests for the ShmLogWriter and ShmLogReader classes.
+ */
+
+#include "dkm/util/log/shm_log_writer_test.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dkm;
+
+static const std::chrono::milliseconds NO_WAIT(0);
+
+TEST_F(ShmLogWriterTest, readerReceivesMessages){
+    // arrange
+    ShmLogWriter writer(config(16));
+    ShmLogReader reader(mName);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "first"));
+    writer.write(makeLogMessage(LogLevel::INFO, "second"));
+    std::string out;
+    size_t count = reader.poll(out);
+
+    // assert
+    ASSERT_EQ(2u, count);
+    ASSERT_EQ("first\nsecond\n", out);
+    ASSERT_EQ(0u, reader.poll(out));
+}
+
+TEST_F(ShmLogWriterTest, poll_respectsMaxMessages){
+    // arrange
+    ShmLogWriter writer(config(16));
+    ShmLogReader reader(mName);
+    for (int i = 0; i < 5; ++i) {
+        writer.write(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+
+    // act
+    std::string first;
+    std::string rest;
+    size_t firstCount = reader.poll(first, 2);
+    size_t restCount = reader.poll(rest);
+
+    // assert
+    ASSERT_EQ(2u, firstCount);
+    ASSERT_EQ("0\n1\n", first);
+    ASSERT_EQ(3u, restCount);
+    ASSERT_EQ("2\n3\n4\n", rest);
+}
+
+TEST_F(ShmLogWriterTest, overrunsAreCounted){
+    // arrange
+    ShmLogWriter writer(config(4));
+    ShmLogReader reader(mName);
+
+    // act
+    for (int i = 0; i < 10; ++i) {
+        writer.write(makeLogMessage(LogLevel::INFO, std::to_string(i)));
+    }
+    std::string out;
+    reader.poll(out);
+
+    // assert
+    ASSERT_EQ(6u, writer.getOverruns());
+    ASSERT_EQ(6u, reader.getLost());
+    ASSERT_EQ("6\n7\n8\n9\n", out);
+}
+
+TEST_F(ShmLogWriterTest, longMessagesAreTruncated){
+    // arrange
+    ShmLogWriter writer(config(4, 64));
+    ShmLogReader reader(mName);
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, std::string(100, 'x')));
+    std::string out;
+    reader.poll(out);
+
+    // assert
+    ASSERT_EQ(1u, writer.getTruncated());
+    ASSERT_EQ(1u, reader.getTruncated());
+    ASSERT_EQ(std::string(64 - sizeof(ShmRingSlot), 'x'), out);
+}
+
+TEST_F(ShmLogWriterTest, restartedWriterContinuesSequence){
+    // arrange
+    ShmLogReader reader(mName);
+    {
+        ShmLogWriter writer(config(16));
+        writer.write(makeLogMessage(LogLevel::INFO, "before"));
+    }
+
+    // act
+    ShmLogWriter writer(config(16));
+    writer.write(makeLogMessage(LogLevel::INFO, "after"));
+    std::string out;
+    reader.poll(out);
+
+    // assert
+    ASSERT_EQ("before\nafter\n", out);
+    ASSERT_EQ(1u, reader.getAttachCount());
+}
+
+TEST_F(ShmLogWriterTest, readerMovesToReplacedRing){
+    // arrange
+    ShmLogReader reader(mName, std::chrono::milliseconds(100), NO_WAIT);
+    ShmLogWriter first(config(16));
+    first.write(makeLogMessage(LogLevel::INFO, "old"));
+    std::string out;
+    reader.poll(out);
+
+    // act
+    // a different geometry forces a new segment
+    ShmLogWriter second(config(32));
+    second.write(makeLogMessage(LogLevel::INFO, "new"));
+    reader.poll(out);
+
+    // assert
+    ASSERT_EQ("old\nnew\n", out);
+    ASSERT_EQ(2u, reader.getAttachCount());
+}
+
+TEST_F(ShmLogWriterTest, restartedReaderResumes){
+    // arrange
+    ShmLogWriter writer(config(16));
+    writer.write(makeLogMessage(LogLevel::INFO, "read"));
+    {
+        ShmLogReader reader(mName);
+        std::string out;
+        reader.poll(out);
+    }
+    writer.write(makeLogMessage(LogLevel::INFO, "unread"));
+
+    // act
+    ShmLogReader reader(mName);
+    std::string out;
+    reader.poll(out);
+
+    // assert
+    ASSERT_EQ("unread\n", out);
+}
+
+TEST_F(ShmLogWriterTest, abandonedSlotIsSkipped){
+    // arrange
+    ShmLogWriter writer(config(16));
+    ShmLogReader reader(mName, NO_WAIT);
+
+    // simulate a producer that claimed a sequence number and died
+    // before committing it
+    int fd = shm_open(mName.c_str(), O_RDWR, 0);
+    void* base = mmap(nullptr, ShmRing::HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    static_cast<ShmRingHeader*>(base)->head.fetch_add(1);
+    munmap(base, ShmRing::HEADER_SIZE);
+
+    writer.write(makeLogMessage(LogLevel::INFO, "next"));
+
+    // act
+    std::string out;
+    reader.poll(out);
+    reader.poll(out);
+
+    // assert
+    ASSERT_EQ("next\n", out);
+    ASSERT_EQ(1u, reader.getLost());
+}
+
+TEST_F(ShmLogWriterTest, slotTakenByLaterLapIsLeftAlone){
+    // arrange
+    ShmLogWriter writer(config(16));
+    size_t size = ShmRing::segmentSize(16, 128);
+    int fd = shm_open(mName.c_str(), O_RDWR, 0);
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ShmRingHeader* header = static_cast<ShmRingHeader*>(base);
+
+    // simulate a producer a whole lap ahead that has already
+    // committed into the slot the next write will claim
+    ShmRingSlot* slot = ShmRing::slotAt(base, *header, 0);
+    slot->stamp.store(ShmRing::committedStamp(16));
+
+    // act
+    writer.write(makeLogMessage(LogLevel::INFO, "late"));
+
+    // assert
+    ASSERT_EQ(1u, writer.getLost());
+    ASSERT_EQ(ShmRing::committedStamp(16), slot->stamp.load());
+    munmap(base, size);
+}
+
+TEST_F(ShmLogWriterTest, waitsForRingBeingCreated){
+    // arrange
+    // another producer has created and sized the ring but not yet
+    // written its header
+    size_t size = ShmRing::segmentSize(16, 128);
+    int fd = shm_open(mName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    ASSERT_EQ(0, ftruncate(fd, size));
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ShmRingHeader* header = static_cast<ShmRingHeader*>(base);
+
+    std::thread creator([header] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        header->version = SHM_RING_VERSION;
+        header->slotCount = 16;
+        header->slotSize = 128;
+        header->magic.store(SHM_RING_MAGIC, std::memory_order_release);
+    });
+
+    // act
+    ShmLogWriter writer(config(16));
+    writer.write(makeLogMessage(LogLevel::INFO, "shared"));
+    creator.join();
+
+    // assert
+    ASSERT_EQ(1u, header->head.load());
+    munmap(base, size);
+}
+
+TEST_F(ShmLogWriterTest, multipleProducers){
+    // arrange
+    ShmLogWriter writer(config(8192));
+    ShmLogReader reader(mName);
+    std::vector<std::thread> threads;
+
+    // act
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&writer] {
+            for (int i = 0; i < 1000; ++i) {
+                writer.write(makeLogMessage(LogLevel::INFO, "x"));
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    std::string out;
+    size_t count = reader.poll(out);
+
+    // assert
+    ASSERT_EQ(4000u, count);
+    ASSERT_EQ(0u, reader.getLost());
+    ASSERT_EQ(0u, writer.getOverruns());
+}
+
+TEST_F(ShmLogWriterTest, readerWaitsForRing){
+    // arrange
+    ShmLogReader reader(mName);
+    std::string out;
+    ASSERT_EQ(0u, reader.poll(out));
+    ASSERT_FALSE(reader.isAttached());
+
+    // act
+    ShmLogWriter writer(config(16));
+    writer.write(makeLogMessage(LogLevel::INFO, "hello"));
+    reader.poll(out);
+
+    // assert
+    ASSERT_TRUE(reader.isAttached());
+    ASSERT_EQ("hello\n", out);
+}
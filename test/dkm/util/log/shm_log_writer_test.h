@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <string>
+
+#include "dkm/util/log/shm_log_writer.h"
+#include "dkm/util/log/shm_log_reader.h"
+#include "dkm/util/log/pattern_layout.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class ShmLogWriterTest : public ::testing::Test {
+
+protected:
+
+    ShmLogWriterTest(){}
+
+    virtual ~ShmLogWriterTest(){}
+
+    // Each test gets its own ring name.
+    virtual void SetUp(){
+        static int counter = 0;
+        mName = "/dkm_test_" + std::to_string(getpid()) + "_" + std::to_string(++counter);
+    }
+
+    virtual void TearDown(){
+        dkm::ShmLogWriter::unlink(mName);
+    }
+
+    dkm::ShmLogWriterConfig config(size_t slotCount, size_t slotSize = 128){
+        dkm::ShmLogWriterConfig config(mName);
+        config.slotCount = slotCount;
+        config.slotSize = slotSize;
+        config.layout = std::make_shared<dkm::PatternLayout>("%m%n");
+        return config;
+    }
+
+    std::string mName;
+};
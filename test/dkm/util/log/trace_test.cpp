@@ -0,0 +1,193 @@
+/**
+ * trace_test.cpp
+ *
+ * Unit tests for trace spans and the Tracer class.
+ */
+
+#include "dkm/util/log/trace_test.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace dkm;
+
+static size_t countOccurrences(const std::string& text, const std::string& pattern)
+{
+    size_t count = 0;
+    size_t pos = text.find(pattern);
+    while (pos != std::string::npos) {
+        ++count;
+        pos = text.find(pattern, pos + pattern.size());
+    }
+    return count;
+}
+
+static std::string exportJson(const Tracer& tracer)
+{
+    std::ostringstream out;
+    tracer.exportChromeJson(out);
+    return out.str();
+}
+
+TEST_F(TraceTest, disabled_recordsNothing){
+    // arrange
+    Tracer tracer(TraceClock::MONOTONIC);
+
+    // act
+    {
+        TraceSpan span("ignored", "test", tracer);
+    }
+
+    // assert
+    ASSERT_EQ(0u, tracer.getEventCount());
+}
+
+TEST_F(TraceTest, spansAndInstants){
+    // arrange
+    Tracer tracer(TraceClock::MONOTONIC);
+    tracer.enable();
+
+    // act
+    {
+        TraceSpan outer("outer", "test", tracer);
+        {
+            TraceSpan inner("inner", "test", tracer);
+            usleep(1000);
+        }
+        tracer.instant("marker", "test");
+    }
+
+    // assert
+    ASSERT_EQ(3u, tracer.getEventCount());
+
+    std::string json = exportJson(tracer);
+    ASSERT_EQ(0u, json.find("{\"traceEvents\":["));
+    ASSERT_EQ(2u, countOccurrences(json, "\"ph\":\"X\""));
+    ASSERT_EQ(1u, countOccurrences(json, "\"ph\":\"i\""));
+    ASSERT_NE(std::string::npos, json.find("{\"name\":\"inner\",\"cat\":\"test\""));
+    ASSERT_NE(std::string::npos, json.find("\"name\":\"marker\""));
+
+    // the inner span slept for a millisecond, which is 1000us
+    size_t inner = json.find("\"name\":\"inner\"");
+    size_t dur = json.find("\"dur\":", inner);
+    ASSERT_GE(atof(json.c_str() + dur + 6), 1000.0);
+}
+
+TEST_F(TraceTest, tscClock){
+    // arrange
+    Tracer tracer(TraceClock::TSC);
+    tracer.enable();
+
+    // act
+    {
+        TraceSpan span("sleep", "test", tracer);
+        usleep(2000);
+    }
+
+    // assert
+    std::string json = exportJson(tracer);
+    size_t dur = json.find("\"dur\":");
+    ASSERT_NE(std::string::npos, dur);
+    double us = atof(json.c_str() + dur + 6);
+    ASSERT_GE(us, 1900.0);
+    ASSERT_LT(us, 1000000.0);
+}
+
+TEST_F(TraceTest, perThreadBuffers){
+    // arrange
+    Tracer tracer(TraceClock::MONOTONIC);
+    tracer.enable();
+    std::vector<std::thread> threads;
+
+    // act
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&tracer] {
+            for (int i = 0; i < 5000; ++i) {
+                TraceSpan span("work", "test", tracer);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    // assert
+    ASSERT_EQ(20000u, tracer.getEventCount());
+    ASSERT_EQ(0u, tracer.getDropped());
+}
+
+TEST_F(TraceTest, alternatingTracers){
+    // arrange
+    // more tracers than a thread caches, so entries get replaced
+    const size_t count = Tracer::THREAD_CACHE_SIZE + 2;
+    std::vector<std::unique_ptr<Tracer> > tracers;
+    for (size_t i = 0; i < count; ++i) {
+        tracers.push_back(std::unique_ptr<Tracer>(new Tracer(TraceClock::MONOTONIC)));
+        tracers[i]->enable();
+    }
+
+    // act
+    for (int round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                tracers[i]->instant("tick", "test");
+            }
+        }
+        tracers[0]->clear();
+    }
+    tracers[0]->instant("tick", "test");
+
+    // assert
+    ASSERT_EQ(1u, tracers[0]->getEventCount());
+    for (size_t i = 1; i < count; ++i) {
+        ASSERT_EQ(3 * (i + 1), tracers[i]->getEventCount());
+    }
+}
+
+TEST_F(TraceTest, dropsWhenFull){
+    // arrange
+    Tracer tracer(TraceClock::MONOTONIC, TraceBuffer::BLOCK_EVENTS);
+    tracer.enable();
+
+    // act
+    for (size_t i = 0; i < TraceBuffer::BLOCK_EVENTS + 10; ++i) {
+        tracer.instant("tick", "test");
+    }
+
+    // assert
+    ASSERT_EQ(TraceBuffer::BLOCK_EVENTS, tracer.getEventCount());
+    ASSERT_EQ(10u, tracer.getDropped());
+}
+
+TEST_F(TraceTest, clear){
+    // arrange
+    Tracer tracer(TraceClock::MONOTONIC);
+    tracer.enable();
+    tracer.instant("before", "test");
+
+    // act
+    tracer.clear();
+    tracer.instant("after", "test");
+
+    // assert
+    ASSERT_EQ(1u, tracer.getEventCount());
+    ASSERT_NE(std::string::npos, exportJson(tracer).find("\"name\":\"after\""));
+}
+
+TEST_F(TraceTest, escapesNames){
+    // arrange
+    Tracer tracer(TraceClock::MONOTONIC);
+    tracer.enable();
+
+    // act
+    tracer.instant("say \"hi\"\n", "test");
+
+    // assert
+    ASSERT_NE(std::string::npos, exportJson(tracer).find("\"name\":\"say \\\"hi\\\"\\u000a\""));
+}
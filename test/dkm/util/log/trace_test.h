@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/log/trace.h"
+
+#include "dkm/util/log/log_test_helpers.h"
+
+class TraceTest : public ::testing::Test {
+
+protected:
+
+    TraceTest(){}
+
+    virtual ~TraceTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
@@ -0,0 +1,114 @@
+/**
+ * lz_codec_test.cpp
+ *
+ * Unit tests for the LzCodec functions.
+ */
+
+#include "dkm/util/lz_codec_test.h"
+
+#include <stdlib.h>
+
+#include <gtest/gtest.h>
+
+using namespace dkm;
+
+TEST_F(LzCodecTest, roundTrip_empty){
+    // act
+    std::string block = compress("");
+    std::string out;
+
+    // assert
+    ASSERT_TRUE(decompress(block, 0, out));
+    ASSERT_EQ("", out);
+}
+
+TEST_F(LzCodecTest, roundTrip_logText){
+    // arrange
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += "2026-10-18 13:45:07,089 [INFO] dkm.io:42 - wrote block " +
+            std::to_string(i) + "\n";
+    }
+
+    // act
+    std::string block = compress(text);
+    std::string out;
+
+    // assert
+    ASSERT_LT(block.size(), text.size() / 4);
+    ASSERT_TRUE(decompress(block, text.size(), out));
+    ASSERT_EQ(text, out);
+}
+
+TEST_F(LzCodecTest, roundTrip_incompressible){
+    // arrange
+    srand(7);
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += static_cast<char>(rand());
+    }
+
+    // act
+    std::string block = compress(text);
+    std::string out;
+
+    // assert
+    ASSERT_LE(block.size(), LzCodec::compressBound(text.size()));
+    ASSERT_TRUE(decompress(block, text.size(), out));
+    ASSERT_EQ(text, out);
+}
+
+TEST_F(LzCodecTest, roundTrip_longRun){
+    // arrange
+    std::string text(1000000, 'a');
+
+    // act
+    std::string block = compress(text);
+    std::string out;
+
+    // assert
+    ASSERT_GE(LzCodec::decompressBound(block.size()), text.size());
+    ASSERT_TRUE(decompress(block, text.size(), out));
+    ASSERT_EQ(text, out);
+}
+
+TEST_F(LzCodecTest, roundTrip_overlappingMatch){
+    // arrange
+    std::string text = "ab" + std::string(5000, 'x') + "abababababababababab";
+
+    // act
+    std::string block = compress(text);
+    std::string out;
+
+    // assert
+    ASSERT_LT(block.size(), 100u);
+    ASSERT_TRUE(decompress(block, text.size(), out));
+    ASSERT_EQ(text, out);
+}
+
+TEST_F(LzCodecTest, decompress_wrongLength){
+    // arrange
+    std::string text(200, 'a');
+    std::string block = compress(text);
+    std::string out;
+
+    // act/assert
+    ASSERT_FALSE(decompress(block, text.size() - 1, out));
+    ASSERT_FALSE(decompress(block, text.size() + 1, out));
+}
+
+TEST_F(LzCodecTest, decompress_malformed){
+    std::string out;
+
+    // truncated inside the literals
+    ASSERT_FALSE(decompress(std::string("\x50" "ab", 3), 5, out));
+
+    // offset reaching back before the start of the output
+    ASSERT_FALSE(decompress(std::string("\x10" "a" "\x05\x00" "\x00", 5), 5, out));
+
+    // zero offset
+    ASSERT_FALSE(decompress(std::string("\x10" "a" "\x00\x00" "\x00", 5), 5, out));
+
+    // missing offset
+    ASSERT_FALSE(decompress(std::string("\x11" "a" "\x01", 3), 5, out));
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "dkm/util/lz_codec.h"
+
+class LzCodecTest : public ::testing::Test {
+
+protected:
+
+    LzCodecTest(){}
+
+    virtual ~LzCodecTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+
+    // Compresses text and returns the block.
+    std::string compress(const std::string& text){
+        std::string out(dkm::LzCodec::compressBound(text.size()), '\0');
+        out.resize(dkm::LzCodec::compress(text.data(), text.size(), &out[0]));
+        return out;
+    }
+
+    // Decompresses a block of the given original size, returning false
+    // if it is rejected.
+    bool decompress(const std::string& block, size_t length, std::string& out){
+        out.assign(length, '\0');
+        return dkm::LzCodec::decompress(block.data(), block.size(), &out[0], length);
+    }
+};
@@ -0,0 +1,76 @@
+/**
+ * perf_counters_test.cpp
+ *
+ * Unit tests for the PerfCounters class. Hardware counters are often
+ * unavailable in containers and VMs, so tests that need them pass
+ * trivially there.
+ */
+
+#include "dkm/util/perf_counters_test.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace dkm;
+
+// Does some work the compiler can't remove.
+static unsigned long long spin(int count)
+{
+    volatile unsigned long long sum = 0;
+    for (int i = 0; i < count; ++i) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+TEST_F(PerfCountersTest, eventNames){
+    ASSERT_EQ(std::string("cycles"), perfEventName(PerfEvent::CYCLES));
+    ASSERT_EQ(std::string("instructions"), perfEventName(PerfEvent::INSTRUCTIONS));
+    ASSERT_EQ(std::string("cache-misses"), perfEventName(PerfEvent::CACHE_MISSES));
+    ASSERT_EQ(std::string("branch-misses"), perfEventName(PerfEvent::BRANCH_MISSES));
+}
+
+TEST_F(PerfCountersTest, unavailableEventsReadZero){
+    // arrange
+    PerfCounters counters;
+
+    // act
+    counters.start();
+    spin(1000);
+    counters.stop();
+
+    // assert
+    for (int i = 0; i < static_cast<int>(PerfEvent::COUNT); ++i) {
+        PerfEvent event = static_cast<PerfEvent>(i);
+        if (!counters.isAvailable(event)) {
+            ASSERT_EQ(0u, counters.value(event));
+        }
+    }
+    ASSERT_FALSE(counters.isAvailable(PerfEvent::COUNT));
+}
+
+TEST_F(PerfCountersTest, countsOnlyWhileStarted){
+    // arrange
+    PerfCounters counters;
+    if (!counters.isAvailable(PerfEvent::INSTRUCTIONS)) {
+        return;
+    }
+
+    // act
+    counters.start();
+    spin(100000);
+    counters.stop();
+    uint64_t afterRun = counters.value(PerfEvent::INSTRUCTIONS);
+
+    spin(100000);
+    uint64_t afterIdle = counters.value(PerfEvent::INSTRUCTIONS);
+
+    counters.reset();
+    uint64_t afterReset = counters.value(PerfEvent::INSTRUCTIONS);
+
+    // assert
+    ASSERT_GT(afterRun, 100000u);
+    ASSERT_EQ(afterRun, afterIdle);
+    ASSERT_EQ(0u, afterReset);
+}
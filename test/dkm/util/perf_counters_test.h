@@ -0,0 +1,16 @@
+#include <gtest/gtest.h>
+
+#include "dkm/util/perf_counters.h"
+
+class PerfCountersTest : public ::testing::Test {
+
+protected:
+
+    PerfCountersTest(){}
+
+    virtual ~PerfCountersTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+};
@@ -0,0 +1,54 @@
+/**
+ * simple_log_coarse_clock_test.cpp
+ *
+ * Unit tests for the simple_log.h helpers with DKM_LOG_COARSE_CLOCK
+ * defined.
+ */
+
+#define DKM_LOG_COARSE_CLOCK
+
+#include "dkm/util/simple_log_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/simple_log.h"
+
+TEST_F(SimpleLogTest, coarseClock_usesCoarseClock){
+    // assert
+    ASSERT_EQ(CLOCK_REALTIME_COARSE, _DKM_LOG_CLOCK);
+}
+
+TEST_F(SimpleLogTest, coarseClock_matchesClock){
+    // arrange
+    long long before = clockMillis(CLOCK_REALTIME_COARSE);
+
+    // act
+    size_t len = 0;
+    const char* prefixBuf = _dkm_log_time_prefix(&len);
+    std::string prefix(prefixBuf, len);
+    long long after = clockMillis(CLOCK_REALTIME_COARSE);
+
+    // assert
+    ASSERT_EQ(26u, len);
+    ASSERT_LE(before, prefixMillis(prefix));
+    ASSERT_GE(after, prefixMillis(prefix));
+}
+
+TEST_F(SimpleLogTest, coarseClock_rebuildsEachSecond){
+    // arrange
+    size_t len = 0;
+    const char* firstBuf = _dkm_log_time_prefix(&len);
+    std::string first(firstBuf, len);
+
+    // act
+    sleepToNextSecond(CLOCK_REALTIME_COARSE);
+    long long before = clockMillis(CLOCK_REALTIME_COARSE);
+    const char* secondBuf = _dkm_log_time_prefix(&len);
+    std::string second(secondBuf, len);
+    long long after = clockMillis(CLOCK_REALTIME_COARSE);
+
+    // assert
+    ASSERT_NE(first.substr(0, 20), second.substr(0, 20));
+    ASSERT_LE(before, prefixMillis(second));
+    ASSERT_GE(after, prefixMillis(second));
+}
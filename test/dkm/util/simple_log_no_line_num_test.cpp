@@ -0,0 +1,29 @@
+/**
+ * simple_log_no_line_num_test.cpp
+ *
+ * Unit tests for the simple_log.h helpers with DKM_LOG_NO_LINE_NUM
+ * defined.
+ */
+
+#define DKM_LOG_NO_LINE_NUM
+
+#include "dkm/util/simple_log_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/simple_log.h"
+
+TEST_F(SimpleLogTest, noLineNum_lineLayout){
+    // arrange
+    FILE* f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+
+    // act
+    _DKM_LOG_EMIT(f, "[INFO] " _DKM_LOG_LINE_NUM, "x=%d", 5);
+    std::string out = readAll(f);
+    fclose(f);
+
+    // assert
+    ASSERT_NE(-1, prefixMillis(out.substr(0, 26)));
+    ASSERT_EQ("[INFO] x=5\n", out.substr(26));
+}
@@ -0,0 +1,37 @@
+/**
+ * simple_log_no_time_test.cpp
+ *
+ * Unit tests for the simple_log.h helpers with DKM_LOG_NO_TIME defined.
+ */
+
+#define DKM_LOG_NO_TIME
+
+#include "dkm/util/simple_log_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/simple_log.h"
+
+TEST_F(SimpleLogTest, noTime_emptyPrefix){
+    // act
+    size_t len = 1;
+    const char* prefix = _dkm_log_time_prefix(&len);
+
+    // assert
+    ASSERT_EQ(0u, len);
+    ASSERT_STREQ("", prefix);
+}
+
+TEST_F(SimpleLogTest, noTime_lineStartsWithTag){
+    // arrange
+    FILE* f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+
+    // act
+    _DKM_LOG_EMIT(f, "[WARN] ", "value %d", 7);
+    std::string out = readAll(f);
+    fclose(f);
+
+    // assert
+    ASSERT_EQ("[WARN] value 7\n", out);
+}
@@ -0,0 +1,159 @@
+/**
+ * simple_log_test.cpp
+ *
+ * Unit tests for the simple_log.h helpers with the default options.
+ */
+
+#include "dkm/util/simple_log_test.h"
+
+#include <gtest/gtest.h>
+
+#include "dkm/util/simple_log.h"
+
+TEST_F(SimpleLogTest, timePrefix_format){
+    // act
+    size_t len = 0;
+    std::string prefix = _dkm_log_time_prefix(&len);
+
+    // assert
+    ASSERT_EQ(26u, len);
+    ASSERT_EQ(len, prefix.size());
+    ASSERT_NE(-1, prefixMillis(prefix));
+    ASSERT_EQ('-', prefix[5]);
+    ASSERT_EQ(' ', prefix[11]);
+    ASSERT_EQ(':', prefix[14]);
+    ASSERT_EQ('.', prefix[20]);
+}
+
+TEST_F(SimpleLogTest, timePrefix_matchesClock){
+    // arrange
+    long long before = clockMillis(CLOCK_REALTIME);
+
+    // act
+    size_t len = 0;
+    const char* prefixBuf = _dkm_log_time_prefix(&len);
+    std::string prefix(prefixBuf, len);
+    long long after = clockMillis(CLOCK_REALTIME);
+
+    // assert
+    ASSERT_LE(before, prefixMillis(prefix));
+    ASSERT_GE(after, prefixMillis(prefix));
+}
+
+TEST_F(SimpleLogTest, timePrefix_patchesMilliseconds){
+    // arrange
+    // stay clear of the end of the second so both calls share it
+    while (clockMillis(CLOCK_REALTIME) % 1000 > 800) {
+        struct timespec delay = { 0, 10000000L };
+        nanosleep(&delay, NULL);
+    }
+    size_t len = 0;
+    const char* firstBuf = _dkm_log_time_prefix(&len);
+    std::string first(firstBuf, len);
+
+    // act
+    struct timespec delay = { 0, 50000000L };
+    nanosleep(&delay, NULL);
+    long long before = clockMillis(CLOCK_REALTIME);
+    const char* secondBuf = _dkm_log_time_prefix(&len);
+    std::string second(secondBuf, len);
+    long long after = clockMillis(CLOCK_REALTIME);
+
+    // assert
+    ASSERT_EQ(first.substr(0, 20), second.substr(0, 20));
+    ASSERT_GE(prefixMillis(second) - prefixMillis(first), 50);
+    ASSERT_LE(before, prefixMillis(second));
+    ASSERT_GE(after, prefixMillis(second));
+}
+
+TEST_F(SimpleLogTest, timePrefix_rebuildsEachSecond){
+    // arrange
+    size_t len = 0;
+    const char* firstBuf = _dkm_log_time_prefix(&len);
+    std::string first(firstBuf, len);
+
+    // act
+    sleepToNextSecond(CLOCK_REALTIME);
+    long long before = clockMillis(CLOCK_REALTIME);
+    const char* secondBuf = _dkm_log_time_prefix(&len);
+    std::string second(secondBuf, len);
+    long long after = clockMillis(CLOCK_REALTIME);
+
+    // assert
+    ASSERT_NE(first.substr(0, 20), second.substr(0, 20));
+    ASSERT_LE(before, prefixMillis(second));
+    ASSERT_GE(after, prefixMillis(second));
+}
+
+TEST_F(SimpleLogTest, emit_lineLayout){
+    // arrange
+    FILE* f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+
+    // act
+    int line = __LINE__; _DKM_LOG_EMIT(f, "[INFO] " _DKM_LOG_LINE_NUM, "x=%d, name=%s", 5, "abc");
+    std::string out = readAll(f);
+    fclose(f);
+
+    // assert
+    std::string expected = "[INFO] (" __FILE__ ", line " + std::to_string(line) + ") x=5, name=abc\n";
+    ASSERT_EQ(26 + expected.size(), out.size());
+    ASSERT_NE(-1, prefixMillis(out.substr(0, 26)));
+    ASSERT_EQ(expected, out.substr(26));
+}
+
+TEST_F(SimpleLogTest, emit_eachCallWritesOneLine){
+    // arrange
+    FILE* f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+
+    // act
+    _DKM_LOG_EMIT(f, "[WARN] ", "first");
+    _DKM_LOG_EMIT(f, "[WARN] ", "%s", "");
+    std::string out = readAll(f);
+    fclose(f);
+
+    // assert
+    ASSERT_EQ(26 + 13 + 26 + 8, out.size());
+    ASSERT_EQ("[WARN] first\n", out.substr(26, 13));
+    ASSERT_EQ("[WARN] \n", out.substr(26 + 13 + 26));
+}
+
+TEST_F(SimpleLogTest, emit_messageLongerThanBuffer){
+    // arrange
+    FILE* f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+    std::string message;
+    for (int i = 0; message.size() < 4 * DKM_LOG_LINE_BUF_SIZE; ++i) {
+        message += std::to_string(i) + " ";
+    }
+
+    // act
+    _DKM_LOG_EMIT(f, "[ERROR] ", "<%s>", message.c_str());
+    std::string out = readAll(f);
+    fclose(f);
+
+    // assert
+    ASSERT_EQ("[ERROR] <" + message + ">\n", out.substr(26));
+}
+
+TEST_F(SimpleLogTest, emit_headerLongerThanBuffer){
+    // arrange
+    FILE* f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+    std::string tag = "[DEBUG] (" + std::string(2 * DKM_LOG_LINE_BUF_SIZE, 'f') + ".cpp, line 1) ";
+    std::string message(3 * DKM_LOG_LINE_BUF_SIZE, 'm');
+
+    // act
+    _dkm_log_emit(f, tag.c_str(), tag.size(), "short %d", 1);
+    _dkm_log_emit(f, tag.c_str(), tag.size(), "%s", message.c_str());
+    std::string out = readAll(f);
+    fclose(f);
+
+    // assert
+    std::string first = tag + "short 1\n";
+    std::string second = tag + message + "\n";
+    ASSERT_EQ(26 + first.size() + 26 + second.size(), out.size());
+    ASSERT_EQ(first, out.substr(26, first.size()));
+    ASSERT_EQ(second, out.substr(26 + first.size() + 26));
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+
+// Each simple_log test file includes simple_log.h itself, after
+// defining the options it tests.
+class SimpleLogTest : public ::testing::Test {
+
+protected:
+
+    SimpleLogTest(){}
+
+    virtual ~SimpleLogTest(){}
+
+    virtual void SetUp(){}
+
+    virtual void TearDown(){}
+
+    // Returns the time in a "[YYYY-MM-DD HH:MM:SS.mmm] " prefix as
+    // milliseconds since the epoch, or -1 if the prefix is malformed.
+    static long long prefixMillis(const std::string& prefix){
+        struct tm tm;
+        memset(&tm, 0, sizeof(tm));
+        int ms = 0;
+        if (prefix.size() != 26 || prefix[0] != '[' || prefix.substr(24) != "] ") {
+            return -1;
+        }
+        if (sscanf(prefix.c_str(), "[%4d-%2d-%2d %2d:%2d:%2d.%3d",
+                   &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                   &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &ms) != 7) {
+            return -1;
+        }
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        tm.tm_isdst = -1;
+        return mktime(&tm) * 1000LL + ms;
+    }
+
+    // Returns the current time of the given clock in milliseconds.
+    static long long clockMillis(clockid_t clock){
+        struct timespec ts;
+        clock_gettime(clock, &ts);
+        return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+    }
+
+    // Sleeps until just after the start of the next second of the given clock.
+    static void sleepToNextSecond(clockid_t clock){
+        struct timespec ts;
+        clock_gettime(clock, &ts);
+        struct timespec delay = { 0, 1000000000L - ts.tv_nsec + 5000000L };
+        if (delay.tv_nsec >= 1000000000L) {
+            delay.tv_sec = 1;
+            delay.tv_nsec -= 1000000000L;
+        }
+        nanosleep(&delay, NULL);
+    }
+
+    // Returns everything written to f so far.
+    static std::string readAll(FILE* f){
+        fflush(f);
+        rewind(f);
+        std::string result;
+        char buf[256];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            result.append(buf, n);
+        }
+        return result;
+    }
+};
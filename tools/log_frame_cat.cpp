@@ -0,0 +1,146 @@
+/**
+ * log_frame_cat.cpp
+ *
+ * Prints a compressed log file written by FileLogWriter with
+ * FileCompression::LZ.
+ *
+ *     log_frame_cat [--from=TIME] [--to=TIME] [--index] FILE
+ *
+ * TIME is either seconds since the epoch or a UTC time such as
+ * 2024-05-01T12:00:00. Only frame headers are read until the first
+ * frame that reaches --from, so finding a period late in a large file
+ * is cheap. Whole frames are printed, so output may start a little
+ * before --from and end a little after --to. --index lists the frames
+ * instead of printing them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <limits>
+#include <string>
+#include <system_error>
+
+#include "dkm/util/log/log_frame.h"
+
+using namespace dkm;
+
+static void usage(const char* program)
+{
+    fprintf(stderr,
+            "usage: %s [--from=TIME] [--to=TIME] [--index] FILE\n"
+            "  --from   skip frames that end before TIME\n"
+            "  --to     stop at the first frame that starts after TIME\n"
+            "  --index  list frame offsets, sizes and times instead of the text\n"
+            "TIME is seconds since the epoch or a UTC time like 2024-05-01T12:00:00\n",
+            program);
+}
+
+// Parses a TIME argument into microseconds since the epoch.
+static bool parseTime(const char* text, int64_t& micros)
+{
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    const char* end = strptime(text, "%Y-%m-%dT%H:%M:%S", &tm);
+    if (end != nullptr && *end == '\0') {
+        micros = static_cast<int64_t>(timegm(&tm)) * 1000000;
+        return true;
+    }
+
+    char* numEnd;
+    double seconds = strtod(text, &numEnd);
+    if (numEnd == text || *numEnd != '\0') {
+        return false;
+    }
+    micros = static_cast<int64_t>(seconds * 1e6);
+    return true;
+}
+
+static void formatTime(int64_t micros, char* buf, size_t size)
+{
+    time_t seconds = static_cast<time_t>(micros / 1000000);
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    size_t len = strftime(buf, size, "%Y-%m-%dT%H:%M:%S", &tm);
+    snprintf(buf + len, size - len, ".%06lld", static_cast<long long>(micros % 1000000));
+}
+
+int main(int argc, char** argv)
+{
+    std::string path;
+    int64_t from = std::numeric_limits<int64_t>::min();
+    int64_t to = std::numeric_limits<int64_t>::max();
+    bool index = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 7, "--from=") == 0) {
+            if (!parseTime(argv[i] + 7, from)) {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else if (arg.compare(0, 5, "--to=") == 0) {
+            if (!parseTime(argv[i] + 5, to)) {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else if (arg == "--index") {
+            index = true;
+        }
+        else if (arg.compare(0, 2, "--") != 0 && path.empty()) {
+            path = arg;
+        }
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (path.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        LogFrameReader reader(path);
+        reader.seek(from);
+
+        LogFrameHeader header;
+        uint64_t offset;
+        std::string text;
+        while (reader.nextHeader(header, offset)) {
+            if (header.firstTime > to) {
+                break;
+            }
+
+            if (index) {
+                char first[40];
+                char last[40];
+                formatTime(header.firstTime, first, sizeof(first));
+                formatTime(header.lastTime, last, sizeof(last));
+                printf("%llu %s %u %u %s %s\n",
+                       static_cast<unsigned long long>(offset),
+                       header.codec == LogFrameCodec::LZ ? "lz" : "none",
+                       header.payloadLength, header.decodedLength, first, last);
+                continue;
+            }
+
+            text.clear();
+            if (!reader.readPayload(text)) {
+                fprintf(stderr, "corrupt frame at offset %llu\n",
+                        static_cast<unsigned long long>(offset));
+                return 1;
+            }
+            fwrite(text.data(), 1, text.size(), stdout);
+        }
+    }
+    catch (const std::system_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * shm_log_drain.cpp
+ *
+ * Drains a shared memory log ring written by ShmLogWriter into a file.
+ *
+ *     shm_log_drain --name=/myapp.log --out=/var/log/myapp.log
+ *
+ * The output file is reopened on SIGHUP so it can be rotated with
+ * logrotate or similar. SIGINT and SIGTERM drain whatever is left and
+ * exit. Lost and truncated message counts are reported on exit.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "dkm/util/log/shm_log_reader.h"
+
+using namespace dkm;
+
+static volatile sig_atomic_t stopRequested = 0;
+static volatile sig_atomic_t reopenRequested = 0;
+
+static void onStop(int)
+{
+    stopRequested = 1;
+}
+
+static void onHangup(int)
+{
+    reopenRequested = 1;
+}
+
+static void usage(const char* program)
+{
+    fprintf(stderr,
+            "usage: %s --name=RING --out=PATH [--poll-ms=N]\n"
+            "  --name     shared memory ring written by ShmLogWriter, e.g. /myapp.log\n"
+            "  --out      file to append messages to\n"
+            "  --poll-ms  how long to sleep when the ring is empty (default 10)\n",
+            program);
+}
+
+static int openOutput(const std::string& path)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "unable to open %s: %s\n", path.c_str(), strerror(errno));
+    }
+    return fd;
+}
+
+static bool writeAll(int fd, const std::string& data)
+{
+    const char* p = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = write(fd, p, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += written;
+        remaining -= written;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::string name;
+    std::string outPath;
+    long pollMs = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 7, "--name=") == 0) {
+            name = arg.substr(7);
+        }
+        else if (arg.compare(0, 6, "--out=") == 0) {
+            outPath = arg.substr(6);
+        }
+        else if (arg.compare(0, 10, "--poll-ms=") == 0) {
+            pollMs = atol(arg.c_str() + 10);
+        }
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (name.empty() || outPath.empty() || pollMs < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = onStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    action.sa_handler = onHangup;
+    sigaction(SIGHUP, &action, nullptr);
+
+    int fd = openOutput(outPath);
+    if (fd < 0) {
+        return 1;
+    }
+
+    ShmLogReader reader(name);
+    std::string buffer;
+    int status = 0;
+
+    while (true) {
+        if (reopenRequested) {
+            reopenRequested = 0;
+            int newFd = openOutput(outPath);
+            if (newFd >= 0) {
+                close(fd);
+                fd = newFd;
+            }
+        }
+
+        // read the stop flag first so a final poll picks up anything
+        // published before the signal
+        bool stopping = stopRequested;
+
+        buffer.clear();
+        size_t count = reader.poll(buffer);
+        if (!buffer.empty() && !writeAll(fd, buffer)) {
+            fprintf(stderr, "write to %s failed: %s\n", outPath.c_str(), strerror(errno));
+            status = 1;
+            break;
+        }
+
+        if (stopping) {
+            break;
+        }
+        if (count == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(pollMs));
+        }
+    }
+
+    close(fd);
+
+    fprintf(stderr, "shm_log_drain: lost=%llu truncated=%llu\n",
+            static_cast<unsigned long long>(reader.getLost()),
+            static_cast<unsigned long long>(reader.getTruncated()));
+    return status;
+}